@@ -0,0 +1,216 @@
+#include "benchmark.h"
+
+#include "../include/yds_animation_action.h"
+#include "../include/yds_animation_action_binding.h"
+#include "../include/yds_animation_mixer.h"
+#include "../include/yds_animation_target.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr float FrameTime = 1 / 60.0f;
+    constexpr int FramesPerIteration = 60;
+    constexpr int KeysPerCurve = 16;
+
+    constexpr int ChannelCount = 2;
+
+    // --
+    // A synthetic rig with one location and one rotation target per bone
+    // and two actions (e.g. walk and run) authored for every bone. Each
+    // channel keeps cross-fading between the two actions so both are
+    // sampled and blended every frame. Compressed scenes resample both
+    // actions into clips at 60 Hz.
+    // --
+    class SkeletalMixScene {
+    public:
+        SkeletalMixScene(int boneCount, bool compress = false) {
+            m_locations.resize(boneCount);
+            m_rotations.resize(boneCount);
+
+            for (int i = 0; i < 2; ++i) {
+                BuildAction(&m_actions[i], boneCount, 1.0f + i * 0.25f, (float)i);
+
+                if (compress) {
+                    ysAnimationClip::Settings settings;
+                    settings.SampleRate = 1 / FrameTime;
+                    m_actions[i].Compress(settings);
+                }
+
+                m_bindings[i].SetAction(&m_actions[i]);
+                for (int bone = 0; bone < boneCount; ++bone) {
+                    m_bindings[i].AddTarget(GetBoneName(bone), &m_locations[bone], &m_rotations[bone]);
+                }
+            }
+
+            for (int i = 0; i < ChannelCount; ++i) {
+                m_channels[i].AddSegment(&m_bindings[i % 2]);
+                m_next[i] = (i + 1) % 2;
+            }
+        }
+
+        void Update(float dt) {
+            for (int bone = 0; bone < (int)m_locations.size(); ++bone) {
+                m_locations[bone].ClearLocation(ysMath::Constants::Zero);
+                m_rotations[bone].ClearRotation(ysMath::Constants::QuatIdentity);
+            }
+
+            for (int i = 0; i < ChannelCount; ++i) {
+                ysAnimationChannel &channel = m_channels[i];
+                if (channel.IsActionComplete()) {
+                    ysAnimationChannel::ActionSettings settings;
+                    settings.FadeIn = 0.2f;
+
+                    channel.AddSegment(&m_bindings[m_next[i]], settings);
+                    m_next[i] = (m_next[i] + 1) % 2;
+                }
+
+                channel.Advance(dt);
+                channel.Sample();
+            }
+        }
+
+        const TransformTarget &GetLocation(int bone) const { return m_locations[bone]; }
+
+    protected:
+        static std::string GetBoneName(int bone) {
+            return "Bone" + std::to_string(bone);
+        }
+
+        static void BuildAction(ysAnimationAction *action, int boneCount, float length, float phase) {
+            action->SetLength(length);
+
+            const ysAnimationCurve::CurveType types[] = {
+                ysAnimationCurve::CurveType::LocationX,
+                ysAnimationCurve::CurveType::LocationY,
+                ysAnimationCurve::CurveType::LocationZ,
+                ysAnimationCurve::CurveType::RotationQuatW,
+                ysAnimationCurve::CurveType::RotationQuatX,
+                ysAnimationCurve::CurveType::RotationQuatY,
+                ysAnimationCurve::CurveType::RotationQuatZ
+            };
+
+            for (int bone = 0; bone < boneCount; ++bone) {
+                for (int c = 0; c < 7; ++c) {
+                    ysAnimationCurve *curve = action->NewCurve(GetBoneName(bone));
+                    curve->SetCurveType(types[c]);
+
+                    for (int k = 0; k < KeysPerCurve; ++k) {
+                        const float s = length * k / (KeysPerCurve - 1);
+                        const float angle = 0.25f * std::sin(s * 6.0f + phase + bone * 0.1f);
+
+                        float value;
+                        switch (c) {
+                        case 3: value = std::cos(angle); break;
+                        case 4: value = std::sin(angle); break;
+                        case 5:
+                        case 6: value = 0.0f; break;
+                        default: value = std::sin(s * 3.0f + c + phase);
+                        }
+
+                        curve->AddLinearSamplePoint(s, value);
+                    }
+                }
+            }
+        }
+
+    protected:
+        std::vector<TransformTarget> m_locations;
+        std::vector<TransformTarget> m_rotations;
+
+        ysAnimationAction m_actions[2];
+        ysAnimationActionBinding m_bindings[2];
+
+        ysAnimationChannel m_channels[ChannelCount];
+        int m_next[ChannelCount];
+    };
+}
+
+// --
+// Argument: bone count. Each iteration advances and samples one second of
+// animation at 60 Hz.
+// --
+void SkeletalMix(dbenchmark::State &state) {
+    const int boneCount = (int)state.GetArgument();
+
+    // Timing starts with the first call to KeepRunning()
+    std::unique_ptr<SkeletalMixScene> scene(new SkeletalMixScene(boneCount));
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < FramesPerIteration; ++i) {
+            scene->Update(FrameTime);
+        }
+
+        dbenchmark::DoNotOptimize(scene->GetLocation(0));
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * FramesPerIteration * boneCount);
+    state.SetCounter("bones", boneCount);
+    state.SetCounter("channels", ChannelCount);
+}
+DELTA_BENCHMARK(SkeletalMix)->Arg(16)->Arg(64)->Arg(256);
+
+// --
+// Argument: bone count. Same as SkeletalMix with both actions compressed.
+// --
+void SkeletalMixCompressed(dbenchmark::State &state) {
+    const int boneCount = (int)state.GetArgument();
+
+    std::unique_ptr<SkeletalMixScene> scene(new SkeletalMixScene(boneCount, true));
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < FramesPerIteration; ++i) {
+            scene->Update(FrameTime);
+        }
+
+        dbenchmark::DoNotOptimize(scene->GetLocation(0));
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * FramesPerIteration * boneCount);
+    state.SetCounter("bones", boneCount);
+    state.SetCounter("channels", ChannelCount);
+}
+DELTA_BENCHMARK(SkeletalMixCompressed)->Arg(16)->Arg(64)->Arg(256);
+
+// --
+// Argument: key count. Plays a single Bezier curve forward through every
+// key at 60 Hz, keeping a cursor like a binding does.
+// --
+void CurvePlayback(dbenchmark::State &state) {
+    const int keyCount = (int)state.GetArgument();
+    const float length = keyCount * 0.1f;
+
+    ysAnimationCurve curve;
+    for (int k = 0; k < keyCount; ++k) {
+        ysAnimationCurve::CurveHandle handle;
+        handle.mode = ysAnimationCurve::CurveHandle::InterpolationMode::Bezier;
+        handle.s = k * 0.1f;
+        handle.v = std::sin(handle.s * 3.0f);
+        handle.l_handle_x = handle.s - 0.03f;
+        handle.l_handle_y = handle.v;
+        handle.r_handle_x = handle.s + 0.03f;
+        handle.r_handle_y = handle.v;
+
+        curve.AddSamplePoint(handle);
+    }
+
+    curve.Bake();
+
+    const int frameCount = (int)(length / FrameTime);
+
+    float sum = 0.0f;
+    while (state.KeepRunning()) {
+        int cursor = 0;
+        for (int i = 0; i < frameCount; ++i) {
+            sum += curve.Sample(i * FrameTime, &cursor);
+        }
+    }
+
+    dbenchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.GetIterations() * frameCount);
+    state.SetCounter("keys", keyCount);
+}
+DELTA_BENCHMARK(CurvePlayback)->Arg(16)->Arg(256);
@@ -0,0 +1,147 @@
+#include "benchmark.h"
+
+#include "../engines/basic/include/asset_manager.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    constexpr int MaterialCount = 64;
+
+    std::string ObjectName(int index) {
+        return "Object_" + std::to_string(index);
+    }
+
+    std::string MaterialName(int index) {
+        return "Material_" + std::to_string(index);
+    }
+
+    ysInterchangeObject MakeQuad(int index) {
+        const float offset = (float)index;
+
+        ysInterchangeObject object;
+        object.Name = ObjectName(index);
+        object.MaterialName = MaterialName(index % MaterialCount);
+        object.Type = ysInterchangeObject::ObjectType::Geometry;
+        object.ModelIndex = index;
+        object.ParentIndex = -1;
+        object.InstanceIndex = -1;
+        object.Length = object.Width = 0.0f;
+        object.Scale = ysVector3(1.0f, 1.0f, 1.0f);
+
+        object.Vertices = {
+            ysVector3(offset, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 1.0f, 0.0f),
+            ysVector3(offset, 1.0f, 0.0f)
+        };
+
+        object.Normals = { ysVector3(0.0f, 0.0f, 1.0f) };
+
+        ysInterchangeObject::IndexSet a, b, n;
+        a.x = 0; a.y = 1; a.z = 2;
+        b.x = 0; b.y = 2; b.z = 3;
+        n.x = 0; n.y = 0; n.z = 0;
+        object.VertexIndices = { a, b };
+        object.NormalIndices = { n, n };
+
+        return object;
+    }
+
+    // Scene file with objectCount quads that share MaterialCount materials
+    std::string BuildScene(int objectCount) {
+        const std::string path = "asset_lookup_" + std::to_string(objectCount);
+
+        std::vector<ysInterchangeObject> objects;
+        objects.reserve(objectCount);
+        for (int i = 0; i < objectCount; ++i) objects.push_back(MakeQuad(i));
+
+        ysSceneCompiler::Settings settings;
+        settings.UseCache = false;
+
+        ysSceneCompiler compiler;
+        if (compiler.Compile(objects, (path + ".ysce").c_str(), settings) != ysError::None) return "";
+
+        return path;
+    }
+
+    ysError LoadScene(dbasic::AssetManager *assetManager, const std::string &path) {
+        for (int i = 0; i < MaterialCount; ++i) {
+            assetManager->NewMaterial()->SetName(MaterialName(i).c_str());
+        }
+
+        return assetManager->LoadSceneFile(path.c_str(), false);
+    }
+}
+
+// --
+// Argument: object count. Loads a generated scene where every object
+// looks up its material by name, without uploading anything to a device.
+// --
+void SceneLoadManyObjects(dbenchmark::State &state) {
+    const int objectCount = (int)state.GetArgument();
+    const std::string path = BuildScene(objectCount);
+    if (path.empty()) {
+        state.SkipWithError("Could not compile the scene");
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        dbasic::AssetManager assetManager;
+        if (LoadScene(&assetManager, path) != ysError::None) {
+            state.SkipWithError("Could not load " + path + ".ysce");
+            return;
+        }
+
+        assetManager.ResolveNodeHierarchy();
+
+        state.PauseTiming();
+        assetManager.Destroy();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * objectCount);
+}
+DELTA_BENCHMARK(SceneLoadManyObjects)->Arg(1000)->Arg(10000);
+
+// --
+// Argument: object count. Finds every scene object, model and material of
+// a loaded scene by name.
+// --
+void AssetNameLookup(dbenchmark::State &state) {
+    const int objectCount = (int)state.GetArgument();
+    const std::string path = BuildScene(objectCount);
+    if (path.empty()) {
+        state.SkipWithError("Could not compile the scene");
+        return;
+    }
+
+    dbasic::AssetManager assetManager;
+    if (LoadScene(&assetManager, path) != ysError::None) {
+        state.SkipWithError("Could not load " + path + ".ysce");
+        return;
+    }
+
+    std::vector<std::string> names, materialNames;
+    for (int i = 0; i < objectCount; ++i) names.push_back(ObjectName(i));
+    for (int i = 0; i < MaterialCount; ++i) materialNames.push_back(MaterialName(i));
+
+    int found = 0;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < objectCount; ++i) {
+            const char *name = names[i].c_str();
+            found += (assetManager.GetSceneObject(name) != nullptr) ? 1 : 0;
+            found += (assetManager.GetModelAsset(name) != nullptr) ? 1 : 0;
+            found += (assetManager.FindMaterial(materialNames[i % MaterialCount].c_str()) != nullptr) ? 1 : 0;
+        }
+    }
+
+    dbenchmark::DoNotOptimize(found);
+
+    assetManager.Destroy();
+
+    state.SetItemsProcessed(state.GetIterations() * objectCount * 3);
+    state.SetCounter("objects", objectCount);
+}
+DELTA_BENCHMARK(AssetNameLookup)->Arg(1000)->Arg(10000);
@@ -0,0 +1,571 @@
+#include "benchmark.h"
+
+#include "../include/yds_timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <stdio.h>
+#include <thread>
+#include <time.h>
+
+namespace {
+    constexpr double DefaultMinTime = 0.5;
+    constexpr int64_t MaxIterations = 1000000000;
+
+    struct Result {
+        std::string Name;
+        std::string RunName;
+        std::string AggregateName;
+        std::string Label;
+        std::string Error;
+
+        int64_t Iterations = 0;
+        int Repetitions = 1;
+        int RepetitionIndex = 0;
+
+        double RealTime = 0.0;
+        double ItemsPerSecond = 0.0;
+        double BytesPerSecond = 0.0;
+
+        std::vector<dbenchmark::State::UserCounter> Counters;
+    };
+
+    std::vector<dbenchmark::Benchmark *> &GetRegistry() {
+        static std::vector<dbenchmark::Benchmark *> registry;
+        return registry;
+    }
+
+    std::map<std::string, std::string> &GetOptions() {
+        static std::map<std::string, std::string> options;
+        return options;
+    }
+
+    std::string EscapeJson(const std::string &s) {
+        std::string escaped;
+        for (char c : s) {
+            switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buffer[8];
+                    sprintf_s(buffer, sizeof(buffer), "\\u%04x", (unsigned int)c);
+                    escaped += buffer;
+                }
+                else escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+
+    std::string EscapeCsv(const std::string &s) {
+        if (s.find_first_of(",\"\n") == std::string::npos) return s;
+
+        std::string escaped = "\"";
+        for (char c : s) {
+            if (c == '"') escaped += "\"\"";
+            else escaped += c;
+        }
+
+        return escaped + "\"";
+    }
+
+    std::string FormatTime(double ns) {
+        char buffer[32];
+        if (ns < 1e4) sprintf_s(buffer, sizeof(buffer), "%.1f ns", ns);
+        else if (ns < 1e7) sprintf_s(buffer, sizeof(buffer), "%.1f us", ns / 1e3);
+        else sprintf_s(buffer, sizeof(buffer), "%.1f ms", ns / 1e6);
+
+        return buffer;
+    }
+
+    std::string FormatRate(double perSecond, const char *unit) {
+        const char *prefixes[] = { "", "k", "M", "G", "T" };
+
+        int prefix = 0;
+        while (perSecond >= 1000.0 && prefix < 4) {
+            perSecond /= 1000.0;
+            ++prefix;
+        }
+
+        char buffer[32];
+        sprintf_s(buffer, sizeof(buffer), "%.2f %s%s/s", perSecond, prefixes[prefix], unit);
+
+        return buffer;
+    }
+
+    Result RunOnce(dbenchmark::Benchmark *benchmark, int64_t argument, double minTime) {
+        Result result;
+
+        const int64_t fixed = benchmark->GetFixedIterations();
+        int64_t iterations = (fixed > 0) ? fixed : 1;
+
+        for (;;) {
+            dbenchmark::State state(iterations, argument);
+            benchmark->GetFunction()(state);
+
+            const double elapsed = state.GetElapsedNanoseconds() / 1e9;
+
+            const bool done = state.HasError()
+                || fixed > 0
+                || elapsed >= minTime
+                || iterations >= MaxIterations;
+
+            if (done) {
+                result.Iterations = iterations;
+                result.Label = state.GetLabel();
+                result.Error = state.GetError();
+                result.Counters = state.GetCounters();
+                result.RealTime = (elapsed * 1e9) / iterations;
+
+                if (elapsed > 0.0) {
+                    result.ItemsPerSecond = state.GetItemsProcessed() / elapsed;
+                    result.BytesPerSecond = state.GetBytesProcessed() / elapsed;
+                }
+
+                return result;
+            }
+
+            // Overshoot a little so the next run is likely to be the last
+            double multiplier = (elapsed > 0.0)
+                ? minTime * 1.4 / elapsed
+                : 10.0;
+            multiplier = std::min(multiplier, 10.0);
+
+            const int64_t next = (int64_t)std::ceil(iterations * multiplier);
+            iterations = std::min(std::max(next, iterations + 1), MaxIterations);
+        }
+    }
+
+    void AddAggregates(std::vector<Result> &results, size_t first) {
+        const size_t count = results.size() - first;
+        if (count < 2) return;
+
+        std::vector<double> times;
+        for (size_t i = first; i < results.size(); ++i) {
+            if (!results[i].Error.empty()) return;
+            times.push_back(results[i].RealTime);
+        }
+
+        double mean = 0.0;
+        for (double t : times) mean += t;
+        mean /= count;
+
+        double variance = 0.0;
+        for (double t : times) variance += (t - mean) * (t - mean);
+        variance /= (count - 1);
+
+        std::sort(times.begin(), times.end());
+        const double median = (count % 2 == 1)
+            ? times[count / 2]
+            : 0.5 * (times[count / 2 - 1] + times[count / 2]);
+
+        const Result base = results[first];
+        const char *names[] = { "mean", "median", "stddev" };
+        const double values[] = { mean, median, std::sqrt(variance) };
+
+        for (int i = 0; i < 3; ++i) {
+            Result aggregate;
+            aggregate.Name = base.RunName + "_" + names[i];
+            aggregate.RunName = base.RunName;
+            aggregate.AggregateName = names[i];
+            aggregate.Label = base.Label;
+            aggregate.Iterations = (int64_t)count;
+            aggregate.Repetitions = (int)count;
+            aggregate.RealTime = values[i];
+
+            results.push_back(aggregate);
+        }
+    }
+
+    std::vector<std::string> CollectCounterNames(const std::vector<Result> &results) {
+        std::vector<std::string> names;
+        for (const Result &result : results) {
+            for (const dbenchmark::State::UserCounter &counter : result.Counters) {
+                if (std::find(names.begin(), names.end(), counter.Name) == names.end()) {
+                    names.push_back(counter.Name);
+                }
+            }
+        }
+
+        return names;
+    }
+
+    size_t GetNameWidth(const std::vector<std::string> &names) {
+        size_t width = 10;
+        for (const std::string &name : names) {
+            width = std::max(width, name.size());
+        }
+
+        return width;
+    }
+
+    void WriteConsoleHeader(std::ostream &out, size_t nameWidth) {
+        char line[512];
+        sprintf_s(line, sizeof(line), "%-*s %15s %12s  %s\n", (int)nameWidth, "Benchmark", "Time", "Iterations", "UserCounters...");
+        out << line << std::string(nameWidth + 45, '-') << "\n";
+    }
+
+    void WriteConsoleRows(std::ostream &out, const std::vector<Result> &results, size_t nameWidth) {
+        char line[512];
+        for (const Result &result : results) {
+            if (!result.Error.empty()) {
+                sprintf_s(line, sizeof(line), "%-*s ERROR: %s\n", (int)nameWidth, result.Name.c_str(), result.Error.c_str());
+                out << line;
+                continue;
+            }
+
+            sprintf_s(
+                line, sizeof(line), "%-*s %15s %12lld ",
+                (int)nameWidth, result.Name.c_str(), FormatTime(result.RealTime).c_str(), (long long)result.Iterations);
+            out << line;
+
+            if (result.ItemsPerSecond > 0.0) out << " items=" << FormatRate(result.ItemsPerSecond, "");
+            if (result.BytesPerSecond > 0.0) out << " bytes=" << FormatRate(result.BytesPerSecond, "B");
+
+            for (const dbenchmark::State::UserCounter &counter : result.Counters) {
+                out << " " << counter.Name << "=" << counter.Value;
+            }
+
+            if (!result.Label.empty()) out << " " << result.Label;
+            out << "\n";
+        }
+
+        out.flush();
+    }
+
+    void WriteConsole(std::ostream &out, const std::vector<Result> &results) {
+        std::vector<std::string> names;
+        for (const Result &result : results) names.push_back(result.Name);
+
+        const size_t nameWidth = GetNameWidth(names);
+        WriteConsoleHeader(out, nameWidth);
+        WriteConsoleRows(out, results, nameWidth);
+    }
+
+    void WriteJson(std::ostream &out, const std::vector<Result> &results) {
+        const time_t now = time(nullptr);
+        struct tm local;
+        localtime_s(&local, &now);
+
+        char date[64];
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &local);
+
+        const bool tsc = ysTimingSystem::GetClockSource() == ysTimingSystem::ClockSource::Tsc;
+
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+        out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "    \"clock_source\": \"" << (tsc ? "tsc" : "system") << "\",\n";
+#ifdef NDEBUG
+        out << "    \"library_build_type\": \"release\"\n";
+#else
+        out << "    \"library_build_type\": \"debug\"\n";
+#endif
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result &result = results[i];
+            const bool aggregate = !result.AggregateName.empty();
+
+            out << ((i == 0) ? "\n" : ",\n");
+            out << "    {\n";
+            out << "      \"name\": \"" << EscapeJson(result.Name) << "\",\n";
+            out << "      \"run_name\": \"" << EscapeJson(result.RunName) << "\",\n";
+            out << "      \"run_type\": \"" << (aggregate ? "aggregate" : "iteration") << "\",\n";
+            out << "      \"repetitions\": " << result.Repetitions << ",\n";
+            if (aggregate) {
+                out << "      \"aggregate_name\": \"" << result.AggregateName << "\",\n";
+            }
+            else {
+                out << "      \"repetition_index\": " << result.RepetitionIndex << ",\n";
+            }
+
+            if (!result.Error.empty()) {
+                out << "      \"error_occurred\": true,\n";
+                out << "      \"error_message\": \"" << EscapeJson(result.Error) << "\"\n";
+                out << "    }";
+                continue;
+            }
+
+            out << "      \"iterations\": " << result.Iterations << ",\n";
+            out << "      \"real_time\": " << result.RealTime << ",\n";
+            out << "      \"time_unit\": \"ns\"";
+
+            if (result.ItemsPerSecond > 0.0) out << ",\n      \"items_per_second\": " << result.ItemsPerSecond;
+            if (result.BytesPerSecond > 0.0) out << ",\n      \"bytes_per_second\": " << result.BytesPerSecond;
+            if (!result.Label.empty()) out << ",\n      \"label\": \"" << EscapeJson(result.Label) << "\"";
+
+            for (const dbenchmark::State::UserCounter &counter : result.Counters) {
+                out << ",\n      \"" << EscapeJson(counter.Name) << "\": " << counter.Value;
+            }
+
+            out << "\n    }";
+        }
+
+        out << "\n  ]\n}\n";
+        out.flush();
+    }
+
+    void WriteCsv(std::ostream &out, const std::vector<Result> &results) {
+        const std::vector<std::string> counterNames = CollectCounterNames(results);
+
+        out << "name,iterations,real_time,time_unit,bytes_per_second,items_per_second,label,error_occurred,error_message";
+        for (const std::string &name : counterNames) out << "," << EscapeCsv(name);
+        out << "\n";
+
+        for (const Result &result : results) {
+            out << EscapeCsv(result.Name) << ",";
+
+            if (!result.Error.empty()) {
+                out << ",,,,,," << "true," << EscapeCsv(result.Error);
+                for (size_t i = 0; i < counterNames.size(); ++i) out << ",";
+                out << "\n";
+                continue;
+            }
+
+            out << result.Iterations << "," << result.RealTime << ",ns,";
+            if (result.BytesPerSecond > 0.0) out << result.BytesPerSecond;
+            out << ",";
+            if (result.ItemsPerSecond > 0.0) out << result.ItemsPerSecond;
+            out << "," << EscapeCsv(result.Label) << ",,";
+
+            for (const std::string &name : counterNames) {
+                out << ",";
+                for (const dbenchmark::State::UserCounter &counter : result.Counters) {
+                    if (counter.Name == name) {
+                        out << counter.Value;
+                        break;
+                    }
+                }
+            }
+
+            out << "\n";
+        }
+
+        out.flush();
+    }
+
+    bool WriteResults(std::ostream &out, const std::string &format, const std::vector<Result> &results) {
+        if (format == "console") WriteConsole(out, results);
+        else if (format == "json") WriteJson(out, results);
+        else if (format == "csv") WriteCsv(out, results);
+        else return false;
+
+        return true;
+    }
+}
+
+const void *volatile dbenchmark::g_sink = nullptr;
+
+dbenchmark::State::State(int64_t maxIterations, int64_t argument) {
+    m_maxIterations = maxIterations;
+    m_remaining = maxIterations;
+    m_argument = argument;
+
+    m_running = false;
+    m_startTicks = 0;
+    m_elapsedTicks = 0;
+
+    m_itemsProcessed = 0;
+    m_bytesProcessed = 0;
+}
+
+void dbenchmark::State::SetCounter(const char *name, double value) {
+    for (UserCounter &counter : m_counters) {
+        if (counter.Name == name) {
+            counter.Value = value;
+            return;
+        }
+    }
+
+    m_counters.push_back({ name, value });
+}
+
+void dbenchmark::State::SkipWithError(const std::string &error) {
+    m_error = error;
+    m_remaining = 0;
+}
+
+uint64_t dbenchmark::State::GetElapsedNanoseconds() const {
+    return ysTimingSystem::TicksToNanoseconds(m_elapsedTicks);
+}
+
+void dbenchmark::State::StartTimer() {
+    if (m_running) return;
+
+    m_running = true;
+    m_startTicks = ysTimingSystem::Now();
+}
+
+void dbenchmark::State::StopTimer() {
+    if (!m_running) return;
+
+    m_elapsedTicks += ysTimingSystem::Now() - m_startTicks;
+    m_running = false;
+}
+
+dbenchmark::Benchmark::Benchmark(const char *name, BenchmarkFunction function) {
+    m_name = name;
+    m_function = function;
+
+    m_iterations = 0;
+    m_minTime = 0.0;
+}
+
+dbenchmark::Benchmark *dbenchmark::Benchmark::Arg(int64_t argument) {
+    m_arguments.push_back(argument);
+    return this;
+}
+
+dbenchmark::Benchmark *dbenchmark::Benchmark::Range(int64_t lo, int64_t hi, int64_t multiplier) {
+    for (int64_t i = lo; i < hi; i *= multiplier) {
+        m_arguments.push_back(i);
+    }
+
+    m_arguments.push_back(hi);
+    return this;
+}
+
+dbenchmark::Benchmark *dbenchmark::Benchmark::Iterations(int64_t iterations) {
+    m_iterations = iterations;
+    return this;
+}
+
+dbenchmark::Benchmark *dbenchmark::Benchmark::MinTime(double seconds) {
+    m_minTime = seconds;
+    return this;
+}
+
+dbenchmark::Benchmark *dbenchmark::RegisterBenchmark(const char *name, BenchmarkFunction function) {
+    Benchmark *benchmark = new Benchmark(name, function);
+    GetRegistry().push_back(benchmark);
+
+    return benchmark;
+}
+
+std::string dbenchmark::GetOption(const char *name, const char *defaultValue) {
+    const std::map<std::string, std::string> &options = GetOptions();
+
+    auto option = options.find(name);
+    return (option == options.end()) ? std::string(defaultValue) : option->second;
+}
+
+int dbenchmark::RunBenchmarks(int argc, char **argv) {
+    std::map<std::string, std::string> &options = GetOptions();
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            fprintf(stderr, "Unrecognized argument: %s\n", argv[i]);
+            return 1;
+        }
+
+        const size_t equals = arg.find('=');
+        if (equals == std::string::npos) options[arg.substr(2)] = "true";
+        else options[arg.substr(2, equals - 2)] = arg.substr(equals + 1);
+    }
+
+    const std::string format = GetOption("benchmark_format", "console");
+    const std::string outFile = GetOption("benchmark_out", "");
+    const std::string outFormat = GetOption("benchmark_out_format", "json");
+    const double minTime = atof(GetOption("benchmark_min_time", "0").c_str());
+    const int repetitions = std::max(1, atoi(GetOption("benchmark_repetitions", "1").c_str()));
+    const bool listOnly = GetOption("benchmark_list_tests", "false") == "true";
+
+    std::regex filter;
+    try {
+        filter = std::regex(GetOption("benchmark_filter", "."));
+    }
+    catch (const std::regex_error &) {
+        fprintf(stderr, "Invalid --benchmark_filter\n");
+        return 1;
+    }
+
+    // Expand every benchmark into one run per argument
+    std::vector<std::pair<Benchmark *, int64_t>> runs;
+    std::vector<std::string> runNames;
+    for (Benchmark *benchmark : GetRegistry()) {
+        std::vector<int64_t> arguments = benchmark->GetArguments();
+        const bool hasArguments = !arguments.empty();
+        if (!hasArguments) arguments.push_back(0);
+
+        for (int64_t argument : arguments) {
+            std::string name = benchmark->GetName();
+            if (hasArguments) name += "/" + std::to_string(argument);
+
+            if (!std::regex_search(name, filter)) continue;
+
+            runs.push_back({ benchmark, argument });
+            runNames.push_back(name);
+        }
+    }
+
+    if (listOnly) {
+        for (const std::string &name : runNames) printf("%s\n", name.c_str());
+        return 0;
+    }
+
+    std::vector<Result> results;
+    bool failed = false;
+
+    // Leave room for the aggregate suffixes
+    std::vector<std::string> paddedNames = runNames;
+    if (repetitions > 1) {
+        for (std::string &name : paddedNames) name += "_stddev";
+    }
+
+    const size_t nameWidth = GetNameWidth(paddedNames);
+    if (format == "console") WriteConsoleHeader(std::cout, nameWidth);
+
+    for (size_t i = 0; i < runs.size(); ++i) {
+        Benchmark *benchmark = runs[i].first;
+        const double runMinTime = (benchmark->GetMinTime() > 0.0)
+            ? benchmark->GetMinTime()
+            : ((minTime > 0.0) ? minTime : DefaultMinTime);
+
+        const size_t first = results.size();
+        for (int r = 0; r < repetitions; ++r) {
+            Result result = RunOnce(benchmark, runs[i].second, runMinTime);
+            result.RunName = runNames[i];
+            result.Name = runNames[i];
+            result.Repetitions = repetitions;
+            result.RepetitionIndex = r;
+
+            if (!result.Error.empty()) failed = true;
+
+            results.push_back(result);
+        }
+
+        AddAggregates(results, first);
+
+        // Results are printed as they come in on the console
+        if (format == "console") {
+            const std::vector<Result> latest(results.begin() + first, results.end());
+            WriteConsoleRows(std::cout, latest, nameWidth);
+        }
+    }
+
+    if (format != "console" && !WriteResults(std::cout, format, results)) {
+        fprintf(stderr, "Unknown --benchmark_format: %s\n", format.c_str());
+        return 1;
+    }
+
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        if (!out.is_open() || !WriteResults(out, outFormat, results)) {
+            fprintf(stderr, "Could not write %s results to %s\n", outFormat.c_str(), outFile.c_str());
+            return 1;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
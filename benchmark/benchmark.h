@@ -0,0 +1,169 @@
+#ifndef DELTA_BENCHMARK_H
+#define DELTA_BENCHMARK_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// --
+// Minimal benchmark harness modelled on Google Benchmark.
+//
+// Benchmarks are free functions registered with DELTA_BENCHMARK() and run
+// once per argument. Each function loops on State::KeepRunning(); the
+// harness grows the iteration count until a run takes at least the minimum
+// time and reports the time per iteration. Results are printed as a table
+// and can be written as JSON or CSV for regression tracking. Nothing in
+// here needs a window or a graphics device.
+// --
+namespace dbenchmark {
+
+    class State {
+    public:
+        State(int64_t maxIterations, int64_t argument);
+
+        // --
+        // Returns true while there are iterations left to run. Timing starts
+        // on the first call and stops once the last iteration is done.
+        // --
+        bool KeepRunning() {
+            if (m_remaining > 0) {
+                if (m_remaining == m_maxIterations) StartTimer();
+                --m_remaining;
+                return true;
+            }
+
+            if (m_running) StopTimer();
+            return false;
+        }
+
+        // --
+        // Exclude per-iteration setup (e.g. building a scene) from the
+        // measurement.
+        // --
+        void PauseTiming() { StopTimer(); }
+        void ResumeTiming() { StartTimer(); }
+
+        int64_t GetArgument() const { return m_argument; }
+        int64_t GetIterations() const { return m_maxIterations; }
+
+        void SetItemsProcessed(int64_t items) { m_itemsProcessed = items; }
+        int64_t GetItemsProcessed() const { return m_itemsProcessed; }
+
+        void SetBytesProcessed(int64_t bytes) { m_bytesProcessed = bytes; }
+        int64_t GetBytesProcessed() const { return m_bytesProcessed; }
+
+        void SetLabel(const std::string &label) { m_label = label; }
+        const std::string &GetLabel() const { return m_label; }
+
+        // User counters are reported as-is next to the timing results
+        void SetCounter(const char *name, double value);
+
+        void SkipWithError(const std::string &error);
+        bool HasError() const { return !m_error.empty(); }
+        const std::string &GetError() const { return m_error; }
+
+        uint64_t GetElapsedNanoseconds() const;
+
+        struct UserCounter {
+            std::string Name;
+            double Value;
+        };
+
+        const std::vector<UserCounter> &GetCounters() const { return m_counters; }
+
+    protected:
+        void StartTimer();
+        void StopTimer();
+
+    protected:
+        int64_t m_maxIterations;
+        int64_t m_remaining;
+        int64_t m_argument;
+
+        bool m_running;
+        uint64_t m_startTicks;
+        uint64_t m_elapsedTicks;
+
+        int64_t m_itemsProcessed;
+        int64_t m_bytesProcessed;
+
+        std::string m_label;
+        std::string m_error;
+        std::vector<UserCounter> m_counters;
+    };
+
+    typedef void (*BenchmarkFunction)(State &state);
+
+    class Benchmark {
+    public:
+        Benchmark(const char *name, BenchmarkFunction function);
+
+        Benchmark *Arg(int64_t argument);
+
+        // Adds lo, lo * multiplier, ... up to and including hi
+        Benchmark *Range(int64_t lo, int64_t hi, int64_t multiplier = 8);
+
+        // Skip calibration and always run a fixed number of iterations
+        Benchmark *Iterations(int64_t iterations);
+
+        // Overrides the global minimum time for slow benchmarks
+        Benchmark *MinTime(double seconds);
+
+        const std::string &GetName() const { return m_name; }
+        BenchmarkFunction GetFunction() const { return m_function; }
+        const std::vector<int64_t> &GetArguments() const { return m_arguments; }
+        int64_t GetFixedIterations() const { return m_iterations; }
+        double GetMinTime() const { return m_minTime; }
+
+    protected:
+        std::string m_name;
+        BenchmarkFunction m_function;
+        std::vector<int64_t> m_arguments;
+
+        int64_t m_iterations;
+        double m_minTime;
+    };
+
+    Benchmark *RegisterBenchmark(const char *name, BenchmarkFunction function);
+
+    // --
+    // Returns the value of a --name=value command line option, or the
+    // default if it was not given. Only valid once RunBenchmarks() started.
+    // --
+    std::string GetOption(const char *name, const char *defaultValue);
+
+    // --
+    // Runs every registered benchmark matching --benchmark_filter.
+    //
+    // Options:
+    //  --benchmark_filter=<regex>
+    //  --benchmark_min_time=<seconds>
+    //  --benchmark_repetitions=<n>
+    //  --benchmark_format=<console|json|csv>
+    //  --benchmark_out=<file>
+    //  --benchmark_out_format=<json|csv>
+    //  --benchmark_list_tests
+    //
+    // Returns non-zero if any benchmark reported an error.
+    // --
+    int RunBenchmarks(int argc, char **argv);
+
+    // Written by DoNotOptimize(), defined in benchmark.cpp
+    extern const void *volatile g_sink;
+
+    // Keeps the compiler from optimizing away a computed value
+    template <typename T>
+    inline void DoNotOptimize(const T &value) {
+        g_sink = &value;
+    }
+
+} /* namespace dbenchmark */
+
+#define DELTA_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define DELTA_BENCHMARK_CONCAT(a, b) DELTA_BENCHMARK_CONCAT_INNER(a, b)
+
+#define DELTA_BENCHMARK(function) \
+    static dbenchmark::Benchmark *DELTA_BENCHMARK_CONCAT(s_benchmark_, __LINE__) = \
+        dbenchmark::RegisterBenchmark(#function, function)
+
+#endif /* DELTA_BENCHMARK_H */
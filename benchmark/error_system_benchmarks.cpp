@@ -0,0 +1,65 @@
+#include "benchmark.h"
+
+#include "../include/yds_error_system.h"
+
+namespace {
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    ysError Baseline(ysObject *object, int *counter) {
+        (void)object;
+        ++*counter;
+        return ysError::None;
+    }
+
+#if defined(_MSC_VER)
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    ysError Instrumented(ysObject *object, int *counter) {
+        YDS_ERROR_DECLARE("Instrumented");
+        ++*counter;
+        return ysErrorSystem::Return(ysError::None, __LINE__, object, __FILE__, "");
+    }
+}
+
+// --
+// A call that returns an error code without touching the error system, to
+// compare ErrorSystemCall against.
+// --
+void ErrorSystemBaselineCall(dbenchmark::State &state) {
+    ysObject object;
+    int counter = 0;
+
+    while (state.KeepRunning()) {
+        Baseline(&object, &counter);
+    }
+
+    dbenchmark::DoNotOptimize(counter);
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(ErrorSystemBaselineCall);
+
+// --
+// A call that pushes onto the error stack and returns through the fast
+// path without an error.
+// --
+void ErrorSystemCall(dbenchmark::State &state) {
+    ysObject object;
+    int counter = 0;
+
+    while (state.KeepRunning()) {
+        Instrumented(&object, &counter);
+    }
+
+    dbenchmark::DoNotOptimize(counter);
+
+    if (ysErrorSystem::GetStackLevel() != 0) state.SkipWithError("Error stack is unbalanced");
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(ErrorSystemCall);
@@ -0,0 +1,91 @@
+#include "benchmark.h"
+
+#include "../include/yds_allocator.h"
+#include "../include/yds_geometry_preprocessing.h"
+
+#include <memory>
+
+namespace {
+
+    // --
+    // A size x size grid of quads, two triangles each. Every other row is
+    // tilted so that automatic smoothing groups and vertex splitting both
+    // have real work to do, like a large architectural mesh with creases.
+    // --
+    void BuildGrid(ysObjectData *object, int size) {
+        const int row = size + 1;
+        const int vertexCount = row * row;
+        const int faceCount = size * size * 2;
+
+        object->Clear();
+        object->m_objectInformation.ObjectType = ysObjectData::ObjectType::Geometry;
+        object->m_objectStatistics.NumVertices = vertexCount;
+        object->m_objectStatistics.NumFaces = faceCount;
+
+        object->m_vertices.Allocate(vertexCount);
+        object->m_vertexIndexSet.Allocate(faceCount);
+        object->m_smoothingGroups.Allocate(faceCount);
+
+        for (int y = 0; y <= size; ++y) {
+            for (int x = 0; x <= size; ++x) {
+                object->m_vertices[y * row + x] = ysVector3((float)x, (float)y, (y % 2) ? 0.5f : 0.0f);
+            }
+        }
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const int v = y * row + x;
+                const int face = (y * size + x) * 2;
+
+                ysObjectData::IndexSet &a = object->m_vertexIndexSet[face + 0];
+                ysObjectData::IndexSet &b = object->m_vertexIndexSet[face + 1];
+                a.x = v; a.y = v + 1; a.z = v + row + 1;
+                b.x = v; b.y = v + row + 1; b.z = v + row;
+
+                object->m_smoothingGroups[face + 0] = 0;
+                object->m_smoothingGroups[face + 1] = 0;
+            }
+        }
+    }
+
+    void FreeHardNormals(ysObjectData *object) {
+        if (object->m_hardNormalCache != nullptr) {
+            ysAllocator::BlockFree(object->m_hardNormalCache, 16);
+            object->m_hardNormalCache = nullptr;
+        }
+    }
+
+} /* namespace */
+
+// --
+// Argument: grid size. Each iteration runs smoothing group resolution,
+// automatic smoothing groups, vertex separation and normal generation on
+// a mesh with 2 * size^2 triangles.
+// --
+void SmoothingGroups(dbenchmark::State &state) {
+    const int size = (int)state.GetArgument();
+    std::unique_ptr<ysObjectData> object(new ysObjectData);
+
+    int64_t faces = 0;
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        FreeHardNormals(object.get());
+        BuildGrid(object.get(), size);
+        state.ResumeTiming();
+
+        ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(object.get());
+        ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(object.get());
+        ysGeometryPreprocessing::SeparateBySmoothingGroups(object.get());
+        ysGeometryPreprocessing::CalculateNormals(object.get());
+
+        faces += object->m_objectStatistics.NumFaces;
+        dbenchmark::DoNotOptimize(object->m_normals[0]);
+    }
+
+    FreeHardNormals(object.get());
+
+    state.SetItemsProcessed(faces);
+    state.SetCounter("triangles", 2.0 * size * size);
+    state.SetCounter("vertices", object->m_objectStatistics.NumVertices);
+}
+DELTA_BENCHMARK(SmoothingGroups)->Arg(64)->Arg(256)->Arg(512);
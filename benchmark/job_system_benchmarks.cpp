@@ -0,0 +1,37 @@
+#include "benchmark.h"
+
+#include "../include/yds_job_system.h"
+
+#include <vector>
+
+namespace {
+    void Empty(void *, int) {
+        /* void */
+    }
+}
+
+// --
+// Argument: batch size. Each iteration runs a batch of empty jobs and
+// waits for it, so the time per item is the scheduling overhead per job.
+// --
+void JobSchedulingOverhead(dbenchmark::State &state) {
+    const int batchSize = (int)state.GetArgument();
+
+    ysJobSystem jobSystem;
+    jobSystem.Initialize();
+
+    std::vector<ysJobSystem::Job> jobs(batchSize, { Empty, nullptr, 0 });
+
+    while (state.KeepRunning()) {
+        ysJobCounter counter;
+        jobSystem.Run(jobs.data(), batchSize, &counter);
+        jobSystem.Wait(&counter);
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * batchSize);
+    state.SetCounter("workers", jobSystem.GetWorkerCount());
+    state.SetCounter("stolen", (double)jobSystem.GetJobsStolen());
+
+    jobSystem.Destroy();
+}
+DELTA_BENCHMARK(JobSchedulingOverhead)->Arg(100)->Arg(1000);
@@ -0,0 +1,55 @@
+#include "benchmark.h"
+
+#include "../include/yds_logger.h"
+
+namespace {
+    // Formats every message and throws it away
+    class NullOutput : public ysLoggerOutput {
+    public:
+        NullOutput() : ysLoggerOutput("NullOutput") {
+            SetFormatParameters(0);
+        }
+
+        virtual void Initialize() { /* void */ }
+        virtual void Close() { /* void */ }
+
+    protected:
+        virtual void Write(const char *data) {
+            dbenchmark::DoNotOptimize(data);
+        }
+    };
+}
+
+// --
+// Argument: 0 for synchronous logging, 1 for deferred. Only the time spent
+// on the calling thread is measured; the ring is flushed outside of the
+// measurement whenever half of it is used so bursts never overflow.
+// --
+void LoggerMessage(dbenchmark::State &state) {
+    constexpr int BatchSize = ysLogger::RingCapacity / 2;
+
+    const bool deferred = state.GetArgument() != 0;
+    state.SetLabel(deferred ? "deferred" : "synchronous");
+
+    ysLogger logger;
+    logger.NewLoggerOutput<NullOutput>();
+    logger.SetOverflowPolicy(ysLogger::OverflowPolicy::Synchronous);
+    if (deferred) logger.Start();
+
+    int pending = 0;
+    while (state.KeepRunning()) {
+        logger.LogMessage("frame %d took %.3f ms in %s", "benchmark", 0, YDS_LOG_LEVEL_INFO, pending, 16.6, "Render");
+
+        if (++pending == BatchSize) {
+            state.PauseTiming();
+            logger.Flush();
+            pending = 0;
+            state.ResumeTiming();
+        }
+    }
+
+    if (deferred) logger.End();
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(LoggerMessage)->Arg(0)->Arg(1);
@@ -0,0 +1,5 @@
+#include "benchmark.h"
+
+int main(int argc, char **argv) {
+    return dbenchmark::RunBenchmarks(argc, argv);
+}
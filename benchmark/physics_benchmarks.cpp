@@ -0,0 +1,158 @@
+#include "benchmark.h"
+
+#include "../physics/include/delta_physics.h"
+
+#include <memory>
+
+namespace {
+    constexpr float TimeStep = 1 / 120.0f;
+    constexpr int StepsPerIteration = 120;
+
+    constexpr int StackHeight = 8;
+    constexpr float BoxSize = 1.0f;
+
+    // --
+    // Columns of unit boxes resting on a static floor. Most of the cost
+    // is contact generation and resolution between neighbouring boxes.
+    // --
+    class BoxStackScene {
+    public:
+        BoxStackScene(int boxCount) {
+            const int columns = (boxCount + StackHeight - 1) / StackHeight;
+            const float floorWidth = columns * BoxSize * 2.0f + 4.0f;
+
+            m_boxes.reset(new dphysics::RigidBody[boxCount]);
+
+            m_floor.SetHint(dphysics::RigidBody::RigidBodyHint::Static);
+            m_floor.SetInverseMass(0.0f);
+            m_floor.Transform.SetPosition(ysMath::LoadVector(0.0f, -0.5f, 0.0f));
+            m_floor.Transform.SetOrientation(ysMath::Constants::QuatIdentity);
+            AddBox(&m_floor, floorWidth * 0.5f, 0.5f);
+            m_system.RegisterRigidBody(&m_floor);
+
+            ysVector gravity = ysMath::LoadVector(0.0f, -10.0f, 0.0f);
+            for (int i = 0; i < boxCount; ++i) {
+                const int column = i / StackHeight;
+                const int row = i % StackHeight;
+
+                dphysics::RigidBody &box = m_boxes[i];
+                box.SetHint(dphysics::RigidBody::RigidBodyHint::Dynamic);
+                box.SetInverseMass(1.0f);
+                box.SetInverseInertiaTensor(box.GetRectangleTensor(BoxSize * 0.5f, BoxSize * 0.5f));
+                box.SetAcceleration(gravity);
+                box.Transform.SetPosition(ysMath::LoadVector(
+                    (column - columns * 0.5f) * BoxSize * 2.0f,
+                    BoxSize * (row + 0.5f),
+                    0.0f));
+                box.Transform.SetOrientation(ysMath::Constants::QuatIdentity);
+                AddBox(&box, BoxSize * 0.5f, BoxSize * 0.5f);
+
+                m_system.RegisterRigidBody(&box);
+            }
+        }
+
+        dphysics::RigidBodySystem &GetSystem() { return m_system; }
+
+    protected:
+        static void AddBox(dphysics::RigidBody *body, float halfWidth, float halfHeight) {
+            dphysics::CollisionObject *col;
+            body->CollisionGeometry.NewBoxObject(&col);
+            col->SetMode(dphysics::CollisionObject::Mode::Fine);
+            col->GetAsBox()->Position = ysMath::Constants::Zero;
+            col->GetAsBox()->HalfWidth = halfWidth;
+            col->GetAsBox()->HalfHeight = halfHeight;
+            col->GetAsBox()->Orientation = ysMath::Constants::QuatIdentity;
+        }
+
+    protected:
+        // Bodies have to outlive the system that references them
+        std::unique_ptr<dphysics::RigidBody[]> m_boxes;
+        dphysics::RigidBody m_floor;
+
+        dphysics::RigidBodySystem m_system;
+    };
+
+    void BuildSpringGrid(dphysics::MassSpringSystem *system, int size) {
+        constexpr float Spacing = 0.1f;
+
+        std::vector<dphysics::MSSParticle *> particles(size * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                dphysics::MSSParticle *particle = system->NewParticle();
+                particle->SetPosition(ysMath::LoadVector(x * Spacing, -y * Spacing, 0.0f));
+                particle->SetVelocity(ysMath::Constants::Zero);
+                particle->SetExternalAcceleration(ysMath::LoadVector(0.0f, -10.0f, 0.0f));
+                particle->SetDrag(0.99f);
+
+                // The top row is pinned so the grid hangs like a cloth
+                particle->SetInverseMass((y == 0) ? 0.0f : 1.0f);
+
+                particles[y * size + x] = particle;
+            }
+        }
+
+        auto connect = [system](dphysics::MSSParticle *a, dphysics::MSSParticle *b, float length) {
+            dphysics::MSSSpring *spring = system->NewSpring();
+            spring->SetLength(length);
+            spring->SetConstant(500.0f);
+            spring->SetParticle0(a);
+            spring->SetParticle1(b);
+        };
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                dphysics::MSSParticle *particle = particles[y * size + x];
+                if (x + 1 < size) connect(particle, particles[y * size + x + 1], Spacing);
+                if (y + 1 < size) connect(particle, particles[(y + 1) * size + x], Spacing);
+            }
+        }
+    }
+}
+
+// --
+// Argument: number of boxes. Each iteration simulates one second from rest.
+// --
+void BoxStack(dbenchmark::State &state) {
+    const int boxCount = (int)state.GetArgument();
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        BoxStackScene scene(boxCount);
+        state.ResumeTiming();
+
+        for (int i = 0; i < StepsPerIteration; ++i) {
+            scene.GetSystem().Update(TimeStep);
+        }
+
+        state.PauseTiming();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * StepsPerIteration);
+    state.SetCounter("bodies", boxCount);
+}
+DELTA_BENCHMARK(BoxStack)->Arg(8)->Arg(64)->Arg(256)->MinTime(2.0);
+
+// --
+// Argument: grid resolution. Each iteration simulates one second from rest.
+// --
+void SpringGrid(dbenchmark::State &state) {
+    const int size = (int)state.GetArgument();
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        dphysics::MassSpringSystem system;
+        system.SetStep(TimeStep);
+        BuildSpringGrid(&system, size);
+        state.ResumeTiming();
+
+        for (int i = 0; i < StepsPerIteration; ++i) {
+            system.Update();
+        }
+
+        state.PauseTiming();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * StepsPerIteration);
+    state.SetCounter("particles", size * size);
+}
+DELTA_BENCHMARK(SpringGrid)->Arg(8)->Arg(16)->Arg(32);
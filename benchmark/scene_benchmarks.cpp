@@ -0,0 +1,97 @@
+#include "benchmark.h"
+
+#include "../engines/basic/include/asset_manager.h"
+
+#include <fstream>
+#include <string>
+
+namespace {
+    // Ordered roughly by size so the argument doubles as a scale
+    const char *SceneFiles[] = {
+        "cube",
+        "instance_test",
+        "armature_test",
+        "ant",
+        "ant_rigged"
+    };
+
+    constexpr int SceneFileCount = sizeof(SceneFiles) / sizeof(SceneFiles[0]);
+
+    std::string GetScenePath(int index) {
+        // Same layout the test projects assume, relative to the output directory
+        const std::string directory = dbenchmark::GetOption("asset_dir", "../../../test/geometry_files");
+        return directory + "/" + SceneFiles[index];
+    }
+
+    int64_t GetFileSize(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file.is_open() ? (int64_t)file.tellg() : 0;
+    }
+}
+
+// --
+// Argument: index into SceneFiles. Compiles the interchange (.dia) file to
+// a scene file (.ysce) from scratch every iteration.
+// --
+void SceneCompile(dbenchmark::State &state) {
+    const int index = (int)state.GetArgument();
+    const std::string path = GetScenePath(index);
+
+    state.SetLabel(SceneFiles[index]);
+
+    while (state.KeepRunning()) {
+        dbasic::AssetManager assetManager;
+        if (assetManager.CompileInterchangeFile(path.c_str(), 1.0f, true) != ysError::None) {
+            state.SkipWithError("Could not compile " + path + ".dia");
+            return;
+        }
+
+        state.PauseTiming();
+        assetManager.Destroy();
+        state.ResumeTiming();
+    }
+
+    state.SetBytesProcessed(state.GetIterations() * GetFileSize(path + ".dia"));
+}
+DELTA_BENCHMARK(SceneCompile)->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4);
+
+// --
+// Argument: index into SceneFiles. Loads a compiled scene file without
+// uploading anything to a device.
+// --
+void SceneLoad(dbenchmark::State &state) {
+    const int index = (int)state.GetArgument();
+    const std::string path = GetScenePath(index);
+
+    state.SetLabel(SceneFiles[index]);
+
+    {
+        dbasic::AssetManager assetManager;
+        if (assetManager.CompileInterchangeFile(path.c_str(), 1.0f, true) != ysError::None) {
+            state.SkipWithError("Could not compile " + path + ".dia");
+            return;
+        }
+
+        assetManager.Destroy();
+    }
+
+    int sceneObjects = 0;
+    while (state.KeepRunning()) {
+        dbasic::AssetManager assetManager;
+        if (assetManager.LoadSceneFile(path.c_str(), false) != ysError::None) {
+            state.SkipWithError("Could not load " + path + ".ysce");
+            return;
+        }
+
+        assetManager.ResolveNodeHierarchy();
+        sceneObjects = assetManager.GetSceneObjectCount();
+
+        state.PauseTiming();
+        assetManager.Destroy();
+        state.ResumeTiming();
+    }
+
+    state.SetBytesProcessed(state.GetIterations() * GetFileSize(path + ".ysce"));
+    state.SetCounter("objects", sceneObjects);
+}
+DELTA_BENCHMARK(SceneLoad)->Arg(0)->Arg(1)->Arg(2)->Arg(3)->Arg(4);
@@ -0,0 +1,83 @@
+#include "benchmark.h"
+
+#include "../include/yds_breakdown_timer.h"
+#include "../include/yds_timing.h"
+
+#include <string>
+
+namespace {
+    std::string ChannelName(int index) {
+        return "Channel " + std::to_string(index);
+    }
+
+    void CreateChannels(ysBreakdownTimer *timer, int channelCount) {
+        for (int i = 0; i < channelCount; ++i) {
+            timer->CreateChannel(ChannelName(i), 16);
+        }
+    }
+}
+
+// --
+// Argument: channel count. Each iteration is one frame with a single scoped
+// measurement of the last channel, resolved to an ID up front.
+// --
+void BreakdownTimerScope(dbenchmark::State &state) {
+    const int channelCount = (int)state.GetArgument();
+
+    ysBreakdownTimer timer;
+    CreateChannels(&timer, channelCount);
+
+    const ysBreakdownTimer::ChannelId channel = timer.FindChannelId(ChannelName(channelCount - 1));
+
+    while (state.KeepRunning()) {
+        timer.StartFrame();
+        {
+            YDS_PROFILE_SCOPE(&timer, channel);
+        }
+        timer.EndFrame();
+    }
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(BreakdownTimerScope)->Arg(16)->Arg(128);
+
+// --
+// Argument: channel count. Same as BreakdownTimerScope with the channel
+// looked up by name on every measurement.
+// --
+void BreakdownTimerScopeByName(dbenchmark::State &state) {
+    const int channelCount = (int)state.GetArgument();
+
+    ysBreakdownTimer timer;
+    CreateChannels(&timer, channelCount);
+
+    const std::string name = ChannelName(channelCount - 1);
+
+    while (state.KeepRunning()) {
+        timer.StartFrame();
+        timer.StartMeasurement(name);
+        timer.EndMeasurement(name);
+        timer.EndFrame();
+    }
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(BreakdownTimerScopeByName)->Arg(16)->Arg(128);
+
+// --
+// Cost of reading the clock, labeled with the clock source in use.
+// --
+void TimingNow(dbenchmark::State &state) {
+    state.SetLabel(
+        (ysTimingSystem::GetClockSource() == ysTimingSystem::ClockSource::Tsc) ? "TSC" : "system");
+
+    uint64_t sum = 0;
+    while (state.KeepRunning()) {
+        sum += ysTimingSystem::Now();
+    }
+
+    dbenchmark::DoNotOptimize(sum);
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+DELTA_BENCHMARK(TimingNow);
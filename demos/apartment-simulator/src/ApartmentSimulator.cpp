@@ -86,7 +86,8 @@ void ApartmentSimulator::CompileSceneFile(const char *fname) {
     strcpy_s(fullPath, MAX_PATH_LENGTH, fname);
     ysGeometryExportFile exportFile;
     strcat_s(fullPath, MAX_PATH_LENGTH, ".ysce");
-    exportFile.Open(GetAssetPath(fullPath).c_str());
+    // The demo reads back the original layout with its own loader
+    exportFile.Open(GetAssetPath(fullPath).c_str(), 1);
 
     ysObjectData **objects = new ysObjectData * [testFile.GetObjectCount()];
     int objectCount = testFile.GetObjectCount();
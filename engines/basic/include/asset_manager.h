@@ -13,14 +13,13 @@
 #include "texture_asset.h"
 #include "audio_asset.h"
 
+#include <deque>
+#include <memory>
+#include <string>
 #include <vector>
 
 namespace dbasic {
 
-    struct CompiledHeader {
-        int ObjectCount;
-    };
-
     class DeltaEngine;
 
     class AssetManager : public ysObject {
@@ -32,13 +31,34 @@ namespace dbasic {
 
         ysError CompileSceneFile(const char *fname, float scale = 1.0f, bool force = false);
         ysError CompileInterchangeFile(const char *fname, float scale = 1.0f, bool force = false);
+
+        // Stage timings and cache hits of the last file that was compiled
+        const ysSceneCompiler::Statistics &GetCompileStatistics() const { return m_compileStatistics; }
+
         ysError LoadSceneFile(const char *fname, bool placeInVram = true);
 
-        ysError LoadAnimationFile(const char *fname);
+        // --
+        // Loads a scene file's objects and models without their geometry,
+        // which is read on a background thread the first time each model
+        // is drawn. Models appear once UpdateStreaming() has uploaded them.
+        // --
+        ysError StreamSceneFile(const char *fname);
+
+        // Loads a single model out of a scene file without reading the rest
+        ysError LoadModelAsset(const char *fname, const char *objectName, bool placeInVram = true, ModelAsset **model = nullptr);
+
+        // Actions are compressed into clips if compression is set
+        ysError LoadAnimationFile(const char *fname, const ysAnimationClip::Settings *compression = nullptr);
         ysAnimationAction *GetAction(const char *name);
         int GetActionCount() const { return m_actions.GetNumObjects(); }
 
         ysError LoadTexture(const char *fname, const char *name);
+
+        // --
+        // Returns the texture asset right away, without a texture until
+        // UpdateStreaming() has created it
+        // --
+        TextureAsset *RequestTexture(const char *fname, const char *name);
         TextureAsset *GetTexture(const char *name);
         int GetTextureCount() const { return m_textures.GetNumObjects(); }
 
@@ -71,6 +91,28 @@ namespace dbasic {
 
         AnimationObjectController *BuildAnimationObjectController(const char *name, ysTransform *transform);
 
+        // --
+        // Uploads finished loads, creates requested textures and evicts
+        // streamed models that haven't been drawn recently. Call once per
+        // frame before drawing.
+        // --
+        ysError UpdateStreaming();
+
+        // Bytes of streamed geometry kept resident, zero or less for no limit
+        void SetResidencyBudget(int64_t bytes) { m_residency.SetBudget(bytes); }
+        int64_t GetResidencyBudget() const { return m_residency.GetBudget(); }
+        int64_t GetResidentBytes() const { return m_residency.GetResidentBytes(); }
+
+        // Bytes uploaded by UpdateStreaming() per frame
+        void SetUploadBudget(int64_t bytes) { m_uploadBudget = bytes; }
+        int64_t GetUploadBudget() const { return m_uploadBudget; }
+
+        // Loads and textures requested but not yet uploaded
+        int GetPendingLoadCount() const { return m_streamer.GetPendingCount() + (int)m_pendingTextures.size(); }
+
+        // Called through ModelAsset::Acquire()
+        bool AcquireModel(ModelAsset *model);
+
         void SetEngine(DeltaEngine *engine) { m_engine = engine; }
         DeltaEngine *GetEngine() const { return m_engine; }
 
@@ -88,9 +130,86 @@ namespace dbasic {
         ysDynamicArray<TextureAsset, 4> m_textures;
         ysDynamicArray<AudioAsset, 4> m_audioAssets;
 
+        // Name lookups, indexed alongside the arrays above
+        ysNameIndex m_modelNames;
+        ysNameIndex m_sceneObjectNames;
+        ysNameIndex m_materialNames;
+        ysNameIndex m_actionNames;
+        ysNameIndex m_textureNames;
+        ysNameIndex m_audioNames;
+
         DeltaEngine *m_engine;
 
         std::vector<ysGPUBuffer *> m_buffers;
+
+        // Scene files loaded without placing them in VRAM stay mapped so
+        // that their models can reference the geometry in place
+        std::vector<std::unique_ptr<ysGeometryExportFileReader>> m_sceneFiles;
+
+        ysSceneCompiler::Statistics m_compileStatistics;
+
+    protected:
+        enum class GeometryStorage {
+            Vram,
+            Mapped,
+            Streamed
+        };
+
+        enum class StreamState {
+            Evicted,
+            Loading,
+            Resident,
+            Failed
+        };
+
+        struct StreamedModel {
+            ModelAsset *Model;
+
+            // Points into a file in m_sceneFiles, read by the I/O thread. The
+            // file is owned before the entry is added so it can't go away.
+            ysGeometryExportFileReader::Object Object;
+
+            StreamState State;
+        };
+
+        struct PendingTexture {
+            TextureAsset *Asset;
+            std::string Path;
+        };
+
+        // A deque so that the I/O thread's pointers stay valid as it grows
+        std::deque<StreamedModel> m_streamedModels;
+        std::vector<PendingTexture> m_pendingTextures;
+
+        ysAssetStreamer m_streamer;
+        ysResidencySet m_residency;
+        int64_t m_uploadBudget;
+
+        ysError LoadSceneFile(const char *fname, GeometryStorage storage);
+        ysError UploadStreamedModel(StreamedModel *streamed, std::vector<char> &data);
+        void EvictStreamedModel(StreamedModel *streamed);
+
+    protected:
+        ysError InitializeModelAsset(
+            ModelAsset *model,
+            const ysGeometryExportFileReader::Object &object,
+            ysGPUBuffer *vertexBuffer,
+            int vertexByteOffset,
+            ysGPUBuffer *indexBuffer,
+            int indexOffset,
+            int boneOffset);
+
+    protected:
+        // Runtime metrics
+        void PublishMetrics();
+
+        ysMetrics::MetricId m_modelCountMetric;
+        ysMetrics::MetricId m_textureCountMetric;
+        ysMetrics::MetricId m_bufferBytesMetric;
+        ysMetrics::MetricId m_textureBytesMetric;
+        ysMetrics::MetricId m_bytesUploadedMetric;
+        ysMetrics::MetricId m_residentBytesMetric;
+        ysMetrics::MetricId m_pendingLoadsMetric;
     };
 
 } /* namespace dbasic */
@@ -91,6 +91,9 @@ namespace dbasic {
 
         int GetTotalNotWhitespace() const;
 
+        // Metrics overlay, one line per metric starting at the current location
+        void DrawMetrics(const ysMetrics *metrics);
+
         // Drawing Shapes
         void DrawLineRectangle(int width, int height);
         void DrawHorizontalLine(int length);
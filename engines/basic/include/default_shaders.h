@@ -105,6 +105,10 @@ namespace dbasic {
         void ConfigureBox(float width, float height);
         void ConfigureAxis(const ysVector &position, const ysVector &direction, float length);
         virtual void ConfigureModel(float scale, ModelAsset *model);
+        virtual float GetPixelsPerUnit(const ysVector &position) const;
+
+        // Back to full precision vertices, set by ConfigureModel() for quantized models
+        void ResetQuantization();
 
         void SetDiffuseTexture(ysTexture *texture);
 
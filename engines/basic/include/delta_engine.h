@@ -38,6 +38,9 @@ namespace dbasic {
             int BaseVertex = 0;
             int FaceCount = 0;
             bool DepthTest = true;
+
+            // Overrides the stage's input layout if set
+            ysInputLayout *InputLayout = nullptr;
         };
 
         struct GameEngineSettings {
@@ -80,7 +83,7 @@ namespace dbasic {
         ysError DrawImage(StageEnableFlags flags, ysTexture *image, int layer = 0);
         ysError DrawBox(StageEnableFlags flags, int layer = 0);
         ysError DrawAxis(StageEnableFlags flags, int layer = 0);
-        ysError DrawModel(StageEnableFlags flags, ModelAsset *model, int layer = 0);
+        ysError DrawModel(StageEnableFlags flags, ModelAsset *model, int layer = 0, int lod = 0);
         ysError DrawRenderSkeleton(
             StageEnableFlags flags, RenderSkeleton *skeleton, float scale, ShaderBase *shaders, int layer);
         ysError DrawGeneric(
@@ -132,6 +135,19 @@ namespace dbasic {
 
         ysAudioDevice *GetAudioDevice() const { return m_audioDevice; }
         ysBreakdownTimer &GetBreakdownTimer() { return m_breakdownTimer; }
+        ysFrameAllocator &GetFrameAllocator() { return m_frameAllocator; }
+
+        // Draws the last frame's metrics into the console
+        void SetMetricsOverlayEnabled(bool enabled) { m_metricsOverlayEnabled = enabled; }
+        bool IsMetricsOverlayEnabled() const { return m_metricsOverlayEnabled; }
+        void SetMetricsOverlayLocation(const GuiPoint &location) { m_metricsOverlayLocation = location; }
+
+        // --
+        // Largest screen space error, in pixels, allowed when picking levels
+        // of detail for render skeletons
+        // --
+        void SetLodErrorThreshold(float pixels) { m_lodErrorThreshold = pixels; }
+        float GetLodErrorThreshold() const { return m_lodErrorThreshold; }
 
         ysWindowSystem *GetWindowSystem() const { return m_windowSystem; }
         ysWindow *GetGameWindow() const { return m_gameWindow; }
@@ -145,6 +161,7 @@ namespace dbasic {
         ysInputLayout *GetSaqInputLayout() const { return m_saqInputLayout; }
         ysInputLayout *GetDefaultInputLayout() const { return m_inputLayout; }
         ysInputLayout *GetConsoleInputLayout() const { return m_consoleInputLayout; }
+        ysInputLayout *GetQuantizedInputLayout() const { return m_quantizedInputLayout; }
 
         const ysRenderGeometryFormat *GetGeometryFormat() const { return &m_standardFormat; }
 
@@ -192,10 +209,12 @@ namespace dbasic {
         ysRenderGeometryFormat m_skinnedFormat;
         ysRenderGeometryFormat m_standardFormat;
         ysRenderGeometryFormat m_consoleVertexFormat;
+        ysRenderGeometryFormat m_quantizedFormat;
         ysInputLayout *m_skinnedInputLayout;
         ysInputLayout *m_inputLayout;
         ysInputLayout *m_consoleInputLayout;
         ysInputLayout *m_saqInputLayout;
+        ysInputLayout *m_quantizedInputLayout;
 
         // Text Support
         UiRenderer m_uiRenderer;
@@ -206,6 +225,23 @@ namespace dbasic {
         // Timing
         ysTimingSystem *m_timingSystem;
         ysBreakdownTimer m_breakdownTimer;
+        ysBreakdownTimer::ChannelId m_frameBreakdownFullChannel;
+        ysBreakdownTimer::ChannelId m_frameBreakdownRenderSceneChannel;
+
+        // Per-frame scratch memory
+        ysFrameAllocator m_frameAllocator;
+
+        // Runtime metrics
+        ysMetrics::MetricId m_drawCallsMetric;
+        ysMetrics::MetricId m_objectDataBytesMetric;
+        ysMetrics::MetricId m_frameTimeMetric;
+        ysMetrics::MetricId m_heapAllocationsMetric;
+        ysMetrics::MetricId m_layerDrawCallsMetrics[MaxLayers];
+
+        bool m_metricsOverlayEnabled;
+        GuiPoint m_metricsOverlayLocation;
+
+        float m_lodErrorThreshold;
 
         DrawCall *NewDrawCall(int layer, int objectDataSize);
 
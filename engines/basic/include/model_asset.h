@@ -3,6 +3,8 @@
 
 #include "delta_core.h"
 
+#include <vector>
+
 namespace dbasic {
 
     class Material;
@@ -12,6 +14,30 @@ namespace dbasic {
     class ModelAsset : public ysObject {
         friend AssetManager;
 
+    public:
+        // --
+        // A range of the model that can be drawn with one call. Offsets are
+        // absolute in the model's buffers. Models too large for 16 bit
+        // indices may be split into several, every other model has one.
+        // --
+        struct Submesh {
+            int BaseIndex;
+            int BaseVertex;
+            int FaceCount;
+        };
+
+        // --
+        // A level of detail, drawn as a range of the submeshes. Error is
+        // how far the surface may have moved from the full detail mesh, in
+        // model units. Models without levels of detail have one.
+        // --
+        struct Lod {
+            int FirstSubmesh;
+            int SubmeshCount;
+            int FaceCount;
+            float Error;
+        };
+
     public:
         ModelAsset();
         ~ModelAsset();
@@ -26,6 +52,49 @@ namespace dbasic {
         int GetBaseVertex() { return m_baseVertex; }
         int GetBaseIndex() { return m_baseIndex; }
         int GetVertexSize() const { return m_vertexSize; }
+
+        // Bytes per index, 2 or 4
+        int GetIndexSize() const { return m_indexSize; }
+
+        int GetSubmeshCount() const { return (int)m_submeshes.size(); }
+
+        // --
+        // Quantized models store 16 bit positions relative to their bounds
+        // and octahedral normals. Positions decode as input * scale + offset.
+        // --
+        bool IsQuantized() const { return m_quantized; }
+        const ysVector3 &GetQuantizationOffset() const { return m_quantizationOffset; }
+        const ysVector3 &GetQuantizationScale() const { return m_quantizationScale; }
+
+        const Submesh &GetSubmesh(int index) const { return m_submeshes[index]; }
+
+        int GetLodCount() const { return (int)m_lods.size(); }
+        const Lod &GetLod(int index) const { return m_lods[index]; }
+
+        // --
+        // Coarsest level of detail whose error stays within maxError pixels
+        // when one model unit covers pixelsPerUnit pixels on screen.
+        // --
+        int SelectLod(float pixelsPerUnit, float maxError) const;
+
+        // --
+        // Vertices and indices of models loaded without placing them in
+        // VRAM, or null. Points into the mapped scene file and is valid
+        // until the owning AssetManager is destroyed.
+        // --
+        const char *GetVertexData() const { return m_vertexData; }
+        const char *GetIndexData() const { return m_indexData; }
+
+        // Whether the model's geometry is loaded, only false for streamed models
+        bool IsResident() const { return m_vertexBuffer != nullptr || m_vertexData != nullptr; }
+
+        // --
+        // Marks the model as used this frame. Streamed models that aren't
+        // resident are requested and false is returned, in which case there
+        // is nothing to draw yet.
+        // --
+        bool Acquire();
+
         int GetBoneMap(int boneIndex) const { return m_boneMap[boneIndex]; }
         int GetBoneCount() const { return m_boneMap.GetNumObjects(); }
 
@@ -40,7 +109,12 @@ namespace dbasic {
         ysGPUBuffer *m_vertexBuffer;
         ysGPUBuffer *m_indexBuffer;
 
+        const char *m_vertexData;
+        const char *m_indexData;
+
         ysExpandingArray<int, 0> m_boneMap;
+        std::vector<Submesh> m_submeshes;
+        std::vector<Lod> m_lods;
 
         int m_baseVertex;
         int m_baseIndex;
@@ -50,6 +124,14 @@ namespace dbasic {
         int m_UVChannelCount;
 
         int m_vertexSize;
+        int m_indexSize;
+
+        // Index into the owning AssetManager's streamed models, or -1
+        int m_streamIndex;
+
+        bool m_quantized;
+        ysVector3 m_quantizationOffset;
+        ysVector3 m_quantizationScale;
 
         AssetManager *m_manager;
     };
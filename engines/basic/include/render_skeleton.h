@@ -30,6 +30,7 @@ namespace dbasic {
     protected:
         // Container for all nodes
         ysDynamicArray<RenderNode, 4> m_renderNodes;
+        ysNameIndex m_nodeNames;
     };
     
 } /* namespace dbasic */
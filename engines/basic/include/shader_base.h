@@ -17,6 +17,13 @@ namespace dbasic {
 
 		virtual void SetObjectTransform(const ysMatrix& mat) = 0;
 		virtual void ConfigureModel(float scale, ModelAsset* model) = 0;
+
+		// --
+		// Screen pixels covered by one world unit at the given position,
+		// used to pick levels of detail. Shaders without a perspective
+		// camera return FLT_MAX so the full detail mesh is always drawn.
+		// --
+		virtual float GetPixelsPerUnit(const ysVector& position) const;
 	};
 
 } /* namespace dbasic */
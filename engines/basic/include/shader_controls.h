@@ -34,6 +34,12 @@ namespace dbasic {
 
         int ColorReplace = 0;
         int Lit = 1;
+
+        // Decoding of quantized models, position = input * scale + offset
+        ysVector4 QuantizationOffset = { 0.0f, 0.0f, 0.0f, 0.0f };
+        ysVector4 QuantizationScale = { 1.0f, 1.0f, 1.0f, 1.0f };
+        int OctahedralNormals = 0;
+        int Padding[3];
     };
 
     struct ConsoleShaderObjectVariables {
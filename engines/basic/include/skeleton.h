@@ -28,6 +28,7 @@ namespace dbasic {
         Bone *m_rootBone;
 
         ysDynamicArray<Bone, 4> m_bones;
+        ysNameIndex m_boneNames;
     };
 
 } /* namespace dbasic */
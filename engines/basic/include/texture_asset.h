@@ -13,7 +13,7 @@ namespace dbasic {
         ~TextureAsset();
 
         void SetName(const std::string &name) { m_name = name; }
-        std::string GetName() const { return m_name; }
+        const std::string &GetName() const { return m_name; }
 
         void SetTexture(ysTexture *texture) { m_texture = texture; }
         ysTexture *GetTexture() const { return m_texture; }
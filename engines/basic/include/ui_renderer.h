@@ -87,6 +87,10 @@ namespace dbasic {
         unsigned short *m_indexBuffer;
 
         Font *m_font;
+
+        // Runtime metrics
+        ysMetrics::MetricId m_bytesUploadedMetric;
+        ysMetrics::MetricId m_vertexCountMetric;
     };
 
 } /* namespace dbasic */
@@ -35,6 +35,10 @@ layout (binding = 1) uniform ObjectVariables {
 
 	int ColorReplace;
 	int Lit;
+
+	vec4 QuantizationOffset;
+	vec4 QuantizationScale;
+	int OctahedralNormals;
 };
 
 struct Light {
@@ -35,14 +35,31 @@ layout (binding = 1) uniform ObjectVariables {
 	
 	int ColorReplace;
 	int Lit;
+
+	vec4 QuantizationOffset;
+	vec4 QuantizationScale;
+	int OctahedralNormals;
 };
 
 layout (binding = 2) uniform SkinningVariables {
 	mat4 BoneTransform[256];
 };
 
+vec4 DecodeNormal(vec4 normal) {
+	if (OctahedralNormals == 0) return normal;
+
+	// Octahedral encoding, the lower hemisphere is folded over the diagonals
+	vec3 n = vec3(normal.xy, 1.0 - abs(normal.x) - abs(normal.y));
+	if (n.z < 0.0) {
+		n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	}
+
+	return vec4(normalize(n), 0.0);
+}
+
 void main(void) {
-	vec4 inputPos = vec4(in_Position.xyz, 1.0);
+	// Identity unless the model is quantized
+	vec4 inputPos = vec4(in_Position.xyz * QuantizationScale.xyz + QuantizationOffset.xyz, 1.0);
 
 	inputPos.xyz *= Scale.xyz;
 
@@ -52,7 +69,7 @@ void main(void) {
 	inputPos = inputPos * CameraView;
 	inputPos = inputPos * Projection;
 
-	vec4 finalNormal = vec4(in_Normal.xyz, 0.0);
+	vec4 finalNormal = vec4(DecodeNormal(in_Normal).xyz, 0.0);
 	ex_Normal = vec3(finalNormal * Transform);
 
 	gl_Position = vec4(inputPos.xyzw);
@@ -52,6 +52,10 @@ cbuffer ObjectVariables : register(b1) {
 
 	int ColorReplace;
 	int Lit;
+
+	float4 QuantizationOffset;
+	float4 QuantizationScale;
+	int OctahedralNormals;
 };
 
 cbuffer SkinningVariables : register(b2) {
@@ -123,15 +127,28 @@ VS_OUTPUT VS_SKINNED(VS_INPUT_SKINNED input) {
 	return output;
 }
 
+float4 DecodeNormal(float4 normal) {
+	if (OctahedralNormals == 0) return normal;
+
+	// Octahedral encoding, the lower hemisphere is folded over the diagonals
+	float3 n = float3(normal.xy, 1.0 - abs(normal.x) - abs(normal.y));
+	if (n.z < 0) {
+		n.xy = (1.0 - abs(n.yx)) * float2(n.x >= 0 ? 1.0 : -1.0, n.y >= 0 ? 1.0 : -1.0);
+	}
+
+	return float4(normalize(n), 0.0);
+}
+
 VS_OUTPUT VS_STANDARD(VS_INPUT_STANDARD input) {
-	float4 inputPos = float4(input.Pos);
+	// Identity unless the model is quantized
+	float4 inputPos = float4(input.Pos.xyz * QuantizationScale.xyz + QuantizationOffset.xyz, 1.0);
 	
 	VS_OUTPUT output = (VS_OUTPUT) 0;
 
 	float4 final = float4(0.0f, 0.0f, 0.0f, 0.0f);
 	float4 finalNormal = float4(0.0f, 0.0f, 0.0f, 0.0f);
 
-	output.Normal = mul(input.Normal, Transform).xyz;
+	output.Normal = mul(DecodeNormal(input.Normal), Transform).xyz;
 
 	final = inputPos;
 	finalNormal = float4(output.Normal, 1.0);
@@ -3,10 +3,24 @@
 #include "../include/animation_export_file.h"
 #include "../include/delta_engine.h"
 
+#include <limits.h>
+#include <memory>
+#include <string.h>
 #include <sys/stat.h>
 
 dbasic::AssetManager::AssetManager() : ysObject("AssetManager") {
     m_engine = nullptr;
+    m_uploadBudget = 8 * 1024 * 1024;
+    memset(&m_compileStatistics, 0, sizeof(ysSceneCompiler::Statistics));
+
+    ysMetrics *metrics = ysMetrics::Get();
+    m_modelCountMetric = metrics->RegisterGauge("Assets/Models");
+    m_textureCountMetric = metrics->RegisterGauge("Assets/Textures");
+    m_bufferBytesMetric = metrics->RegisterGauge("Assets/GpuBufferBytes");
+    m_textureBytesMetric = metrics->RegisterGauge("Assets/TextureBytes");
+    m_bytesUploadedMetric = metrics->RegisterCounter("Assets/BytesUploaded");
+    m_residentBytesMetric = metrics->RegisterGauge("Assets/StreamedResidentBytes");
+    m_pendingLoadsMetric = metrics->RegisterGauge("Assets/PendingLoads");
 }
 
 dbasic::AssetManager::~AssetManager() {
@@ -16,6 +30,17 @@ dbasic::AssetManager::~AssetManager() {
 ysError dbasic::AssetManager::Destroy() {
     YDS_ERROR_DECLARE("Destroy");
 
+    // The I/O thread reads from the scene files, stop it before they're closed
+    m_streamer.Destroy();
+
+    for (StreamedModel &streamed : m_streamedModels) {
+        if (streamed.State == StreamState::Resident) EvictStreamedModel(&streamed);
+    }
+
+    m_streamedModels.clear();
+    m_pendingTextures.clear();
+    m_residency.Clear();
+
     int textureCount = m_textures.GetNumObjects();
     for (int i = 0; i < textureCount; ++i) {
         m_textures.Get(i)->Destroy(m_engine->GetDevice());
@@ -25,6 +50,9 @@ ysError dbasic::AssetManager::Destroy() {
         m_engine->GetDevice()->DestroyGPUBuffer(buffer);
     }
 
+    m_buffers.clear();
+    m_sceneFiles.clear();
+
     return YDS_ERROR_RETURN(ysError::None);
 }
 
@@ -34,11 +62,10 @@ dbasic::Material *dbasic::AssetManager::NewMaterial() {
 }
 
 dbasic::Material *dbasic::AssetManager::FindMaterial(const char *name) {
-    for (int i = 0; i < m_materials.GetNumObjects(); i++) {
-        if (strcmp(m_materials.Get(i)->GetName(), name) == 0) return m_materials.Get(i);
-    }
+    const int index = m_materialNames.Lookup(name, m_materials.GetNumObjects(),
+        [this](int i) { return m_materials.Get(i)->GetName(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_materials.Get(index);
 }
 
 dbasic::SceneObjectAsset *dbasic::AssetManager::NewSceneObject() {
@@ -49,15 +76,10 @@ dbasic::SceneObjectAsset *dbasic::AssetManager::NewSceneObject() {
 }
 
 dbasic::SceneObjectAsset *dbasic::AssetManager::GetSceneObject(const char *name) {
-    int objectCount = m_sceneObjects.GetNumObjects();
+    const int index = m_sceneObjectNames.Lookup(name, m_sceneObjects.GetNumObjects(),
+        [this](int i) { return m_sceneObjects.Get(i)->GetName(); });
 
-    for (int i = 0; i < objectCount; i++) {
-        if (strcmp(m_sceneObjects.Get(i)->GetName(), name) == 0) {
-            return m_sceneObjects.Get(i);
-        }
-    }
-
-    return nullptr;
+    return (index < 0) ? nullptr : m_sceneObjects.Get(index);
 }
 
 dbasic::SceneObjectAsset *dbasic::AssetManager::GetRoot(SceneObjectAsset *object) {
@@ -75,18 +97,15 @@ dbasic::ModelAsset *dbasic::AssetManager::NewModelAsset() {
 }
 
 dbasic::ModelAsset *dbasic::AssetManager::GetModelAsset(const char *name) {
-    int modelCount = m_modelAssets.GetNumObjects();
-    for (int i = 0; i < modelCount; i++) {
-        if (strcmp(m_modelAssets.Get(i)->GetName(), name) == 0) {
-            return m_modelAssets.Get(i);
-        }
-    }
+    const int index = m_modelNames.Lookup(name, m_modelAssets.GetNumObjects(),
+        [this](int i) { return m_modelAssets.Get(i)->GetName(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_modelAssets.Get(index);
 }
 
 ysError dbasic::AssetManager::CompileSceneFile(const char *fname, float scale, bool force) {
     YDS_ERROR_DECLARE("CompileSceneFile");
+    YDS_ALLOCATION_TAG("assets");
 
     char total_path[512];
     strcpy_s(total_path, 512, fname);
@@ -109,75 +128,63 @@ ysError dbasic::AssetManager::CompileSceneFile(const char *fname, float scale, b
         }
     }
 
-    ysGeometryExportFile exportFile;
-    exportFile.Open(total_path);
+    // Materials are looked up here, the preprocessing that depends on them
+    // runs on the compiler's worker threads
+    const uint64_t readStart = ysTimingSystem::Now();
 
-    ysObjectData **objects = new ysObjectData * [toolFile.GetObjectCount()];
-    int objectCount = toolFile.GetObjectCount();
-
-    CompiledHeader header;
-    header.ObjectCount = objectCount;
-
-    YDS_NESTED_ERROR_CALL(exportFile.WriteCustomData(&header, sizeof(CompiledHeader)));
+    const int objectCount = toolFile.GetObjectCount();
+    std::vector<std::unique_ptr<ysObjectData>> ownedObjects(objectCount);
+    std::vector<ysObjectData *> objects(objectCount, nullptr);
+    std::vector<ysSceneCompiler::ToolObjectSettings> objectSettings(objectCount);
 
     for (int i = 0; i < objectCount; i++) {
         YDS_NESTED_ERROR_CALL(toolFile.ReadObject(&objects[i]));
-        Material *material = FindMaterial(objects[i]->m_materialName);
-
-        if (objects[i]->m_objectInformation.ObjectType == ysObjectData::ObjectType::Geometry) {
-            ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(objects[i]);
-            ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(objects[i]);
-            ysGeometryPreprocessing::SeparateBySmoothingGroups(objects[i]);
-            ysGeometryPreprocessing::CalculateNormals(objects[i]);
-
-            if ((material != NULL) && material->UsesNormalMap())
-                ysGeometryPreprocessing::CalculateTangents(objects[i], 0);
-
-            if ((material != NULL) && (material->UsesNormalMap() || material->UsesSpecularMap() || material->UsesDiffuseMap())) {
-                int startingVerts = objects[i]->m_objectStatistics.NumVertices;
-                for (int ii = 0; ii < objects[i]->m_objectStatistics.NumUVChannels; ii++) {
-                    ysGeometryPreprocessing::SeparateByUVGroups(objects[i], ii);
-                }
-            }
+        ownedObjects[i].reset(objects[i]);
 
-            ysGeometryPreprocessing::SortBoneWeights(objects[i]);
+        const Material *material = FindMaterial(objects[i]->m_materialName);
+        if (material != nullptr) {
+            objectSettings[i].CalculateTangents = material->UsesNormalMap();
+            objectSettings[i].SeparateByUVs =
+                material->UsesNormalMap() || material->UsesSpecularMap() || material->UsesDiffuseMap();
         }
-
-        ysGeometryPreprocessing::CalculateNormals(objects[i]);
-        ysGeometryPreprocessing::UniformScale(objects[i], scale);
-
-        YDS_NESTED_ERROR_CALL(exportFile.WriteObject(objects[i]));
     }
 
-    // Clear memory
-    for (int i = 0; i < objectCount; i++) {
-        delete objects[i];
-    }
+    const double readTime = ysTimingSystem::TicksToSeconds(ysTimingSystem::Now() - readStart);
 
-    delete[] objects;
+    // Objects that haven't changed since the last compile are reused unless forced
+    ysSceneCompiler::Settings settings;
+    settings.Scale = scale;
+    settings.UseCache = !force;
 
-    // Update compilation status
-    YDS_NESTED_ERROR_CALL(toolFile.UpdateCompilationStatus(ysToolGeometryFile::CompilationStatus::Compiled));
+    ysSceneCompiler compiler;
+    const ysError result = compiler.Compile(objects, objectSettings, total_path, settings);
+    m_compileStatistics = compiler.GetStatistics();
+    m_compileStatistics.ReadTime = readTime;
+    m_compileStatistics.TotalTime += readTime;
+
+    if (result == ysError::None) {
+        YDS_NESTED_ERROR_CALL(toolFile.UpdateCompilationStatus(ysToolGeometryFile::CompilationStatus::Compiled));
+    }
 
-    // Close files
-    exportFile.Close();
     toolFile.Close();
 
-    return YDS_ERROR_RETURN(ysError::None);
+    return YDS_ERROR_RETURN(result);
 }
 
 ysError dbasic::AssetManager::CompileInterchangeFile(const char *fname, float scale, bool force) {
     YDS_ERROR_DECLARE("CompileInterchangeFile");
+    YDS_ALLOCATION_TAG("assets");
+
+    char inputPath[512];
+    strcpy_s(inputPath, 512, fname);
+    strcat_s(inputPath, 512, ".dia");
 
     char completePath[512];
     strcpy_s(completePath, 512, fname);
+    strcat_s(completePath, 512, ".ysce");
 
     ysInterchangeFile0_1 toolFile;
-    strcat_s(completePath, 512, ".dia");
-    YDS_NESTED_ERROR_CALL(toolFile.Open(completePath));
-
-    strcpy_s(completePath, 512, fname);
-    strcat_s(completePath, 512, ".ysce");
+    YDS_NESTED_ERROR_CALL(toolFile.Open(inputPath));
 
     if (toolFile.GetCompilationStatus() && !force) {
         // Check if the file actually exists
@@ -190,78 +197,202 @@ ysError dbasic::AssetManager::CompileInterchangeFile(const char *fname, float sc
         }
     }
 
-    ysGeometryExportFile exportFile;
-    exportFile.Open(completePath);
+    toolFile.Close();
+
+    // Objects that haven't changed since the last compile are reused unless forced
+    ysSceneCompiler::Settings settings;
+    settings.Scale = scale;
+    settings.UseCache = !force;
 
-    ysInterchangeObject *objects = new ysInterchangeObject[toolFile.GetObjectCount()];
-    int objectCount = toolFile.GetObjectCount();
+    ysSceneCompiler compiler;
+    const ysError result = compiler.Compile(inputPath, completePath, settings);
+    m_compileStatistics = compiler.GetStatistics();
 
-    CompiledHeader header;
-    header.ObjectCount = objectCount;
+    // TODO: update compilation status
 
-    YDS_NESTED_ERROR_CALL(exportFile.WriteCustomData(&header, sizeof(CompiledHeader)));
+    return YDS_ERROR_RETURN(result);
+}
 
-    for (int i = 0; i < objectCount; i++) {
-        YDS_NESTED_ERROR_CALL(toolFile.ReadObject(&objects[i]));
-        Material *material = FindMaterial(objects[i].MaterialName.c_str());
+namespace {
 
-        ysGeometryExportFile::VertexInfo vertexInfo;
-        if (objects[i].Type == ysInterchangeObject::ObjectType::Geometry) {
-            if (vertexInfo.IncludeNormals) objects[i].RipByNormals();
-            if (vertexInfo.IncludeTangents) objects[i].RipByTangents();
-            if (vertexInfo.IncludeUVs) objects[i].RipByUVs();
-        }
+    // Where an object's geometry goes in the buffers shared by a scene file
+    struct SceneFileEntry {
+        ysGeometryExportFileReader::Object Object;
+
+        int VertexByteOffset;
+
+        // Into the 16 or 32 bit index buffer depending on the object
+        int IndexOffset;
+    };
 
-        objects[i].UniformScale(scale);
+    bool HasWideIndices(const ysGeometryExportFile::ObjectOutputHeader &header) {
+        return (header.Flags & ysGeometryExportFile::MDF_32BIT_INDICES) != 0;
+    }
+
+    // --
+    // Indices stored for the object. Objects with levels of detail store
+    // every level, not just the NumFaces of the full detail mesh.
+    // --
+    bool GetIndexCount(const ysGeometryExportFileReader::Object &object, int *indexCount) {
+        const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+        const int indexSize = ysGeometryExportFile::GetIndexSize(header);
+
+        if ((header.Flags & ysGeometryExportFile::MDF_LODS) == 0) {
+            *indexCount = header.NumFaces * 3;
+            return object.IndexDataSize == indexSize * header.NumFaces * 3;
+        }
 
-        YDS_NESTED_ERROR_CALL(exportFile.WriteObject(&objects[i]));
+        *indexCount = object.IndexDataSize / indexSize;
+        return object.IndexDataSize == indexSize * *indexCount && *indexCount >= header.NumFaces * 3;
     }
 
-    // Clear memory
-    delete[] objects;
+    // --
+    // Reads every object's header through the table of contents and lays
+    // out where each model's vertices and indices will live in the
+    // combined buffers. Models with 16 and 32 bit indices go into separate
+    // index buffers. Returns false if the file is malformed.
+    // --
+    bool LayoutSceneFile(
+        ysGeometryExportFileReader *reader,
+        std::vector<SceneFileEntry> *entries,
+        int *vertexBytes,
+        int *shortIndexCount,
+        int *wideIndexCount)
+    {
+        const int objectCount = reader->GetObjectCount();
+        entries->resize(objectCount);
+
+        int64_t currentVertexByteOffset = 0;
+        int64_t currentIndexOffset[2] = { 0, 0 };
+
+        std::vector<ysGeometryExportFile::Submesh> submeshes;
+
+        for (int i = 0; i < objectCount; ++i) {
+            SceneFileEntry &entry = (*entries)[i];
+            entry.VertexByteOffset = entry.IndexOffset = 0;
+
+            if (reader->ReadObject(i, &entry.Object) != ysError::None) return false;
+
+            const ysGeometryExportFile::ObjectOutputHeader &header = entry.Object.Header;
+            if (static_cast<ysObjectData::ObjectType>(header.ObjectType) != ysObjectData::ObjectType::Geometry) {
+                continue;
+            }
 
-    // TODO: update compilation status
+            int indexCount;
+            if (header.NumVertices <= 0 || header.VertexDataSize <= 0) return false;
+            if (!GetIndexCount(entry.Object, &indexCount)) return false;
 
-    // Close files
-    exportFile.Close();
-    toolFile.Close();
+            if (entry.Object.BoneDataSize != (int)sizeof(int) * header.NumBones) return false;
+            if (!ysGeometryExportFileReader::GetSubmeshes(entry.Object, &submeshes)) return false;
 
-    return YDS_ERROR_RETURN(ysError::None);
-}
+            const int stride = header.VertexDataSize / header.NumVertices;
+            if (stride <= 0) return false;
+
+            // Each model's vertices have to start on a multiple of its own stride
+            if ((currentVertexByteOffset % stride) != 0) {
+                currentVertexByteOffset += (stride - (currentVertexByteOffset % stride));
+            }
+
+            const int wide = HasWideIndices(header) ? 1 : 0;
+
+            entry.VertexByteOffset = (int)currentVertexByteOffset;
+            entry.IndexOffset = (int)currentIndexOffset[wide];
+
+            currentVertexByteOffset += header.VertexDataSize;
+            currentIndexOffset[wide] += indexCount;
+
+            if (currentVertexByteOffset > INT_MAX
+                || currentIndexOffset[0] * sizeof(uint16_t) > INT_MAX
+                || currentIndexOffset[1] * sizeof(uint32_t) > INT_MAX)
+            {
+                return false;
+            }
+        }
+
+        *vertexBytes = (int)currentVertexByteOffset;
+        *shortIndexCount = (int)currentIndexOffset[0];
+        *wideIndexCount = (int)currentIndexOffset[1];
+
+        return true;
+    }
+
+} /* namespace */
 
 ysError dbasic::AssetManager::LoadSceneFile(const char *fname, bool placeInVram) {
+    return LoadSceneFile(fname, placeInVram ? GeometryStorage::Vram : GeometryStorage::Mapped);
+}
+
+ysError dbasic::AssetManager::StreamSceneFile(const char *fname) {
+    if (!m_streamer.IsInitialized()) m_streamer.Initialize();
+    return LoadSceneFile(fname, GeometryStorage::Streamed);
+}
+
+ysError dbasic::AssetManager::LoadSceneFile(const char *fname, GeometryStorage storage) {
     YDS_ERROR_DECLARE("LoadSceneFile");
+    YDS_ALLOCATION_TAG("assets");
+
+    const bool placeInVram = (storage == GeometryStorage::Vram);
 
     char fullPath[512];
     strcpy_s(fullPath, 512, fname);
     strcat_s(fullPath, 512, ".ysce");
 
-    std::fstream file(fullPath, std::ios::in | std::ios::binary);
-
-    CompiledHeader fileHeader;
-    file.read((char *)&fileHeader, sizeof(CompiledHeader));
+    std::unique_ptr<ysGeometryExportFileReader> file(new ysGeometryExportFileReader);
+    if (file->Open(fullPath) != ysError::None) {
+        return YDS_ERROR_RETURN_MSG(ysError::CouldNotOpenFile, fullPath);
+    }
 
-    unsigned short *indicesFile = new unsigned short[1024 * 1024]; // 1 MB
-    char *verticesFile = (char *)malloc(4 * 1024 * 1024); // 4 MB
+    std::vector<SceneFileEntry> entries;
+    int vertexBytes = 0;
+    int shortIndexCount = 0;
+    int wideIndexCount = 0;
+    if (!LayoutSceneFile(file.get(), &entries, &vertexBytes, &shortIndexCount, &wideIndexCount)) {
+        return YDS_ERROR_RETURN_MSG(ysError::CorruptedFile, fullPath);
+    }
 
-    int currentIndexOffset = 0;
-    int currentVertexByteOffset = 0;
+    const int shortIndexBytes = shortIndexCount * (int)sizeof(uint16_t);
+    const int wideIndexBytes = wideIndexCount * (int)sizeof(uint32_t);
 
     int initialIndex = m_sceneObjects.GetNumObjects();
 
-    ysGPUBuffer *indexBuffer = nullptr;
+    ysGPUBuffer *shortIndexBuffer = nullptr;
+    ysGPUBuffer *wideIndexBuffer = nullptr;
     ysGPUBuffer *vertexBuffer = nullptr;
 
+    // Buffers are sized exactly from the layout and filled straight from the mapping.
+    // Each one is owned by the asset manager as soon as it exists so that an
+    // error further down doesn't leak it.
     if (placeInVram) {
-        m_engine->GetDevice()->CreateIndexBuffer(&indexBuffer, 1 * 1024 * 1024, nullptr, false);
-        m_engine->GetDevice()->CreateVertexBuffer(&vertexBuffer, 4 * 1024 * 1024, nullptr, false);
+        ysDevice *device = m_engine->GetDevice();
+        if (shortIndexBytes > 0) {
+            YDS_NESTED_ERROR_CALL(device->CreateIndexBuffer(
+                &shortIndexBuffer, shortIndexBytes, nullptr, false, ysGPUBuffer::IndexFormat::UInt16));
+            m_buffers.push_back(shortIndexBuffer);
+        }
+
+        if (wideIndexBytes > 0) {
+            YDS_NESTED_ERROR_CALL(device->CreateIndexBuffer(
+                &wideIndexBuffer, wideIndexBytes, nullptr, false, ysGPUBuffer::IndexFormat::UInt32));
+            m_buffers.push_back(wideIndexBuffer);
+        }
+
+        if (vertexBytes > 0) {
+            YDS_NESTED_ERROR_CALL(device->CreateVertexBuffer(&vertexBuffer, vertexBytes, nullptr, false));
+            m_buffers.push_back(vertexBuffer);
+        }
     }
 
+    // Mapped models point into the file as soon as they are created and
+    // streamed models read from it on the I/O thread, so it has to outlive
+    // this call even if a later object fails to load
+    if (!placeInVram) m_sceneFiles.push_back(std::move(file));
+
     std::map<int, int> modelIndexMap;
 
-    for (int i = 0; i < fileHeader.ObjectCount; i++) {
-        ysGeometryExportFile::ObjectOutputHeader header;
-        file.read((char *)&header, sizeof(ysGeometryExportFile::ObjectOutputHeader));
+    const int objectCount = (int)entries.size();
+    for (int i = 0; i < objectCount; i++) {
+        const SceneFileEntry &entry = entries[i];
+        const ysGeometryExportFile::ObjectOutputHeader &header = entry.Object.Header;
 
         SceneObjectAsset *newObject = NewSceneObject();
 
@@ -318,50 +449,36 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname, bool placeInVram)
 
             // New model asset
             ModelAsset *newModelAsset = NewModelAsset();
-
-            int vertexDataSize = header.VertexDataSize;
-            int stride = header.VertexDataSize / header.NumVertices;
-
-            if ((currentVertexByteOffset % stride) != 0) {
-                currentVertexByteOffset += (stride - (currentVertexByteOffset % stride));
+            if (storage == GeometryStorage::Streamed) {
+                // Streamed models get buffers of their own once loaded
+                YDS_NESTED_ERROR_CALL(InitializeModelAsset(newModelAsset, entry.Object, nullptr, 0, nullptr, 0, initialIndex));
+                newModelAsset->m_vertexData = nullptr;
+                newModelAsset->m_indexData = nullptr;
+                newModelAsset->m_streamIndex = (int)m_streamedModels.size();
+
+                StreamedModel streamed;
+                streamed.Model = newModelAsset;
+                streamed.Object = entry.Object;
+                streamed.State = StreamState::Evicted;
+                m_streamedModels.push_back(streamed);
             }
-
-            file.read((char *)(verticesFile + currentVertexByteOffset), vertexDataSize);
-            file.read((char *)(indicesFile + currentIndexOffset), sizeof(unsigned short) * header.NumFaces * 3);
-
-            if (header.NumBones > 0) {
-                newModelAsset->m_boneMap.Preallocate(header.NumBones);
-
-                for (int bone = 0; bone < header.NumBones; bone++) {
-                    int &newBone = newModelAsset->m_boneMap.New();
-
-                    file.read((char *)(&newBone), sizeof(int));
-                    newBone += initialIndex;
-                }
+            else {
+                YDS_NESTED_ERROR_CALL(InitializeModelAsset(
+                    newModelAsset,
+                    entry.Object,
+                    vertexBuffer, entry.VertexByteOffset,
+                    HasWideIndices(header) ? wideIndexBuffer : shortIndexBuffer, entry.IndexOffset,
+                    initialIndex));
             }
 
             newObject->m_parent = (header.ParentIndex < 0) ? -1 : header.ParentIndex + initialIndex;
             newObject->m_type = ysObjectData::ObjectType::Geometry;
 
-            newModelAsset->m_vertexSize = stride;
-            newModelAsset->m_UVChannelCount = header.NumUVChannels;
-            newModelAsset->m_vertexCount = header.NumVertices;
-            newModelAsset->m_faceCount = header.NumFaces;
-            newModelAsset->m_baseIndex = currentIndexOffset;
-            newModelAsset->m_baseVertex = currentVertexByteOffset / stride;
-            newModelAsset->m_vertexBuffer = vertexBuffer;
-            newModelAsset->m_indexBuffer = indexBuffer;
-
             strcpy_s(newObject->m_name, 64, header.ObjectName);
-            strcpy_s(newModelAsset->m_name, 64, header.ObjectName);
 
             newObject->m_material = FindMaterial(header.ObjectMaterial);
-            newModelAsset->SetMaterial(FindMaterial(header.ObjectMaterial));
             newObject->m_geometry = newModelAsset;
 
-            currentIndexOffset += header.NumFaces * 3;
-            currentVertexByteOffset += header.VertexDataSize;
-
             // Load Object Transformation
             ysVector translation = ysMath::LoadVector(header.Position);
             ysVector scale = ysMath::LoadVector(header.Scale);
@@ -391,17 +508,170 @@ ysError dbasic::AssetManager::LoadSceneFile(const char *fname, bool placeInVram)
     }
 
     if (placeInVram) {
-        m_engine->GetDevice()->EditBufferData(indexBuffer, (char *)indicesFile);
-        m_engine->GetDevice()->EditBufferData(vertexBuffer, (char *)verticesFile);
+        YDS_METRIC_INCREMENT(m_bytesUploadedMetric, shortIndexBytes + wideIndexBytes + vertexBytes);
+    }
+
+    PublishMetrics();
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError dbasic::AssetManager::LoadModelAsset(const char *fname, const char *objectName, bool placeInVram, ModelAsset **model) {
+    YDS_ERROR_DECLARE("LoadModelAsset");
+    YDS_ALLOCATION_TAG("assets");
+
+    if (model != nullptr) *model = nullptr;
+
+    char fullPath[512];
+    strcpy_s(fullPath, 512, fname);
+    strcat_s(fullPath, 512, ".ysce");
+
+    std::unique_ptr<ysGeometryExportFileReader> file(new ysGeometryExportFileReader);
+    if (file->Open(fullPath) != ysError::None) {
+        return YDS_ERROR_RETURN_MSG(ysError::CouldNotOpenFile, fullPath);
+    }
+
+    const int index = file->FindObject(objectName);
+    if (index < 0) return YDS_ERROR_RETURN_MSG(ysError::InvalidParameter, objectName);
+
+    ysGeometryExportFileReader::Object object;
+    YDS_NESTED_ERROR_CALL(file->ReadObject(index, &object));
+
+    const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+    if (static_cast<ysObjectData::ObjectType>(header.ObjectType) != ysObjectData::ObjectType::Geometry) {
+        return YDS_ERROR_RETURN_MSG(ysError::UnsupportedType, objectName);
+    }
+
+    int indexCount;
+    if (header.NumVertices <= 0 || !GetIndexCount(object, &indexCount)) {
+        return YDS_ERROR_RETURN_MSG(ysError::CorruptedFile, fullPath);
+    }
+
+    ysGPUBuffer *indexBuffer = nullptr;
+    ysGPUBuffer *vertexBuffer = nullptr;
+
+    if (placeInVram) {
+        const ysGPUBuffer::IndexFormat indexFormat = HasWideIndices(header)
+            ? ysGPUBuffer::IndexFormat::UInt32
+            : ysGPUBuffer::IndexFormat::UInt16;
+
+        // Owned as soon as they exist, see LoadSceneFile()
+        ysDevice *device = m_engine->GetDevice();
+        if (object.IndexDataSize > 0) {
+            YDS_NESTED_ERROR_CALL(device->CreateIndexBuffer(&indexBuffer, object.IndexDataSize, nullptr, false, indexFormat));
+            m_buffers.push_back(indexBuffer);
+        }
+
+        YDS_NESTED_ERROR_CALL(device->CreateVertexBuffer(&vertexBuffer, object.VertexDataSize, nullptr, false));
+        m_buffers.push_back(vertexBuffer);
+    }
+
+    // The model points into the file once it is created, see LoadSceneFile()
+    if (!placeInVram) m_sceneFiles.push_back(std::move(file));
+
+    // Bones refer to scene objects, which aren't loaded here
+    ModelAsset *newModelAsset = NewModelAsset();
+    YDS_NESTED_ERROR_CALL(InitializeModelAsset(newModelAsset, object, vertexBuffer, 0, indexBuffer, 0, 0));
+
+    if (placeInVram) {
+        YDS_METRIC_INCREMENT(m_bytesUploadedMetric, object.IndexDataSize + object.VertexDataSize);
     }
 
-    delete[] indicesFile;
-    free(verticesFile);
+    if (model != nullptr) *model = newModelAsset;
 
-    file.close();
+    PublishMetrics();
 
-    m_buffers.push_back(indexBuffer);
-    m_buffers.push_back(vertexBuffer);
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError dbasic::AssetManager::InitializeModelAsset(
+    ModelAsset *model,
+    const ysGeometryExportFileReader::Object &object,
+    ysGPUBuffer *vertexBuffer,
+    int vertexByteOffset,
+    ysGPUBuffer *indexBuffer,
+    int indexOffset,
+    int boneOffset)
+{
+    YDS_ERROR_DECLARE("InitializeModelAsset");
+
+    const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+    const int stride = header.VertexDataSize / header.NumVertices;
+    const int indexSize = ysGeometryExportFile::GetIndexSize(header);
+
+    std::vector<ysGeometryExportFile::Lod> lods;
+    std::vector<ysGeometryExportFile::Submesh> submeshes;
+    if (!ysGeometryExportFileReader::GetLods(object, &lods, &submeshes)) {
+        return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    }
+
+    if (vertexBuffer != nullptr) {
+        ysDevice *device = m_engine->GetDevice();
+        YDS_NESTED_ERROR_CALL(device->EditBufferDataRange(
+            vertexBuffer, const_cast<char *>(object.VertexData), object.VertexDataSize, vertexByteOffset));
+
+        if (indexBuffer != nullptr && object.IndexDataSize > 0) {
+            YDS_NESTED_ERROR_CALL(device->EditBufferDataRange(
+                indexBuffer,
+                const_cast<char *>(object.IndexData),
+                object.IndexDataSize,
+                indexOffset * indexSize));
+        }
+    }
+    else {
+        // Points into the mapping, which stays open until Destroy()
+        model->m_vertexData = object.VertexData;
+        model->m_indexData = object.IndexData;
+    }
+
+    if (header.NumBones > 0) {
+        model->m_boneMap.Preallocate(header.NumBones);
+
+        for (int bone = 0; bone < header.NumBones; bone++) {
+            int &newBone = model->m_boneMap.New();
+
+            memcpy(&newBone, object.BoneData + bone * sizeof(int), sizeof(int));
+            newBone += boneOffset;
+        }
+    }
+
+    model->m_vertexSize = stride;
+    model->m_indexSize = indexSize;
+    model->m_quantized = (header.Flags & ysGeometryExportFile::MDF_QUANTIZED) != 0;
+    if (model->m_quantized) {
+        model->m_quantizationOffset = header.MinExtreme;
+        model->m_quantizationScale = ysVector3(
+            header.MaxExtreme.x - header.MinExtreme.x,
+            header.MaxExtreme.y - header.MinExtreme.y,
+            header.MaxExtreme.z - header.MinExtreme.z);
+    }
+    model->m_UVChannelCount = header.NumUVChannels;
+    model->m_vertexCount = header.NumVertices;
+    model->m_faceCount = header.NumFaces;
+    model->m_baseIndex = indexOffset;
+    model->m_baseVertex = vertexByteOffset / stride;
+    model->m_vertexBuffer = vertexBuffer;
+    model->m_indexBuffer = indexBuffer;
+
+    model->m_submeshes.resize(submeshes.size());
+    for (size_t i = 0; i < submeshes.size(); ++i) {
+        ModelAsset::Submesh &submesh = model->m_submeshes[i];
+        submesh.BaseIndex = model->m_baseIndex + submeshes[i].BaseIndex;
+        submesh.BaseVertex = model->m_baseVertex + submeshes[i].BaseVertex;
+        submesh.FaceCount = submeshes[i].FaceCount;
+    }
+
+    model->m_lods.resize(lods.size());
+    for (size_t i = 0; i < lods.size(); ++i) {
+        ModelAsset::Lod &lod = model->m_lods[i];
+        lod.FirstSubmesh = lods[i].FirstSubmesh;
+        lod.SubmeshCount = lods[i].SubmeshCount;
+        lod.FaceCount = lods[i].FaceCount;
+        lod.Error = lods[i].Error;
+    }
+
+    strcpy_s(model->m_name, 64, header.ObjectName);
+    model->SetMaterial(FindMaterial(header.ObjectMaterial));
 
     return YDS_ERROR_RETURN(ysError::None);
 }
@@ -459,7 +729,7 @@ ysError dbasic::AssetManager::LoadAnimationFileLegacy(const char *fname) {
 }
 
 
-ysError dbasic::AssetManager::LoadAnimationFile(const char *fname) {
+ysError dbasic::AssetManager::LoadAnimationFile(const char *fname, const ysAnimationClip::Settings *compression) {
     YDS_ERROR_DECLARE("LoadAnimationFile");
 
     ysAnimationInterchangeFile animationFile;
@@ -469,6 +739,10 @@ ysError dbasic::AssetManager::LoadAnimationFile(const char *fname) {
     for (int i = 0; i < actionCount; ++i) {
         ysAnimationAction *newAction = m_actions.New();
         animationFile.ReadAction(newAction);
+
+        if (compression != nullptr) {
+            YDS_NESTED_ERROR_CALL(newAction->Compress(*compression));
+        }
     }
 
     animationFile.Close();
@@ -477,14 +751,10 @@ ysError dbasic::AssetManager::LoadAnimationFile(const char *fname) {
 }
 
 ysAnimationAction *dbasic::AssetManager::GetAction(const char *name) {
-    const int actionCount = GetActionCount();
-    for (int i = 0; i < actionCount; ++i) {
-        if (m_actions.Get(i)->GetName() == name) {
-            return m_actions.Get(i);
-        }
-    }
+    const int index = m_actionNames.Lookup(name, m_actions.GetNumObjects(),
+        [this](int i) { return m_actions.Get(i)->GetName().c_str(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_actions.Get(index);
 }
 
 ysError dbasic::AssetManager::LoadTexture(const char *fname, const char *name) {
@@ -497,18 +767,28 @@ ysError dbasic::AssetManager::LoadTexture(const char *fname, const char *name) {
     newTextureAsset->SetName(name);
     newTextureAsset->SetTexture(texture);
 
+    PublishMetrics();
+
     return YDS_ERROR_RETURN(ysError::None);
 }
 
+dbasic::TextureAsset *dbasic::AssetManager::RequestTexture(const char *fname, const char *name) {
+    TextureAsset *newTextureAsset = m_textures.NewGeneric<TextureAsset>();
+    newTextureAsset->SetName(name);
+
+    PendingTexture pending;
+    pending.Asset = newTextureAsset;
+    pending.Path = fname;
+    m_pendingTextures.push_back(pending);
+
+    return newTextureAsset;
+}
+
 dbasic::TextureAsset *dbasic::AssetManager::GetTexture(const char *name) {
-    const int textureCount = GetTextureCount();
-    for (int i = 0; i < textureCount; ++i) {
-        if (m_textures.Get(i)->GetName() == name) {
-            return m_textures.Get(i);
-        }
-    }
+    const int index = m_textureNames.Lookup(name, m_textures.GetNumObjects(),
+        [this](int i) { return m_textures.Get(i)->GetName().c_str(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_textures.Get(index);
 }
 
 ysError dbasic::AssetManager::LoadAudioFile(const char *fname, const char *name) {
@@ -533,14 +813,10 @@ ysError dbasic::AssetManager::LoadAudioFile(const char *fname, const char *name)
 }
 
 dbasic::AudioAsset *dbasic::AssetManager::GetAudioAsset(const char *name) {
-    const int assetCount = m_audioAssets.GetNumObjects();
-    for (int i = 0; i < assetCount; ++i) {
-        if (m_audioAssets.Get(i)->GetName() == name) {
-            return m_audioAssets.Get(i);
-        }
-    }
+    const int index = m_audioNames.Lookup(name, m_audioAssets.GetNumObjects(),
+        [this](int i) { return m_audioAssets.Get(i)->GetName().c_str(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_audioAssets.Get(index);
 }
 
 dbasic::Skeleton *dbasic::AssetManager::BuildSkeleton(ModelAsset *model) {
@@ -705,3 +981,158 @@ ysError dbasic::AssetManager::ResolveNodeHierarchy() {
 
     return YDS_ERROR_RETURN(ysError::None);
 }
+
+namespace {
+
+    // Runs on the I/O thread, copies the geometry out of the mapped scene file
+    bool LoadStreamedGeometry(void *context, int index, std::vector<char> *data) {
+        const ysGeometryExportFileReader::Object *object =
+            reinterpret_cast<const ysGeometryExportFileReader::Object *>(context);
+
+        data->resize((size_t)object->VertexDataSize + object->IndexDataSize);
+        if (object->VertexDataSize > 0) memcpy(data->data(), object->VertexData, object->VertexDataSize);
+        if (object->IndexDataSize > 0) {
+            memcpy(data->data() + object->VertexDataSize, object->IndexData, object->IndexDataSize);
+        }
+
+        return true;
+    }
+
+} /* namespace */
+
+bool dbasic::AssetManager::AcquireModel(ModelAsset *model) {
+    StreamedModel &streamed = m_streamedModels[model->m_streamIndex];
+
+    if (streamed.State == StreamState::Resident) {
+        m_residency.Touch(model->m_streamIndex);
+        return true;
+    }
+    else if (streamed.State == StreamState::Evicted) {
+        streamed.State = StreamState::Loading;
+        m_streamer.Request(model->m_streamIndex, LoadStreamedGeometry, &streamed.Object, 0);
+    }
+
+    return false;
+}
+
+ysError dbasic::AssetManager::UpdateStreaming() {
+    YDS_ERROR_DECLARE("UpdateStreaming");
+    YDS_ALLOCATION_TAG("assets");
+
+    m_residency.NextFrame();
+
+    int64_t uploaded = 0;
+
+    // Textures are decoded by the device from their path, so they're created here
+    size_t texturesCreated = 0;
+    for (; texturesCreated < m_pendingTextures.size() && uploaded < m_uploadBudget; ++texturesCreated) {
+        const PendingTexture &pending = m_pendingTextures[texturesCreated];
+
+        ysTexture *texture = nullptr;
+        m_engine->LoadTexture(&texture, pending.Path.c_str());
+        pending.Asset->SetTexture(texture);
+
+        if (texture != nullptr) uploaded += (int64_t)texture->GetWidth() * texture->GetHeight() * 4;
+    }
+
+    m_pendingTextures.erase(m_pendingTextures.begin(), m_pendingTextures.begin() + texturesCreated);
+
+    std::vector<ysAssetStreamer::Completion> completed;
+    if (uploaded < m_uploadBudget) m_streamer.Collect(&completed, m_uploadBudget - uploaded);
+
+    ysError result = ysError::None;
+    for (ysAssetStreamer::Completion &completion : completed) {
+        StreamedModel &streamed = m_streamedModels[(size_t)completion.Key];
+
+        const ysError uploadResult = completion.Success
+            ? UploadStreamedModel(&streamed, completion.Data)
+            : ysError::CouldNotOpenFile;
+
+        // Failed models aren't requested again
+        if (uploadResult != ysError::None) {
+            streamed.State = StreamState::Failed;
+            result = uploadResult;
+            continue;
+        }
+
+        m_residency.Add(completion.Key, (int64_t)completion.Data.size());
+    }
+
+    std::vector<uint64_t> evicted;
+    m_residency.Evict(&evicted);
+    for (uint64_t key : evicted) {
+        EvictStreamedModel(&m_streamedModels[(size_t)key]);
+    }
+
+    PublishMetrics();
+
+    return YDS_ERROR_RETURN(result);
+}
+
+ysError dbasic::AssetManager::UploadStreamedModel(StreamedModel *streamed, std::vector<char> &data) {
+    YDS_ERROR_DECLARE("UploadStreamedModel");
+
+    const ysGeometryExportFileReader::Object &object = streamed->Object;
+    ModelAsset *model = streamed->Model;
+
+    ysGPUBuffer *vertexBuffer = nullptr;
+    ysGPUBuffer *indexBuffer = nullptr;
+
+    ysDevice *device = m_engine->GetDevice();
+    YDS_NESTED_ERROR_CALL(device->CreateVertexBuffer(&vertexBuffer, object.VertexDataSize, data.data(), false));
+
+    if (object.IndexDataSize > 0) {
+        const ysGPUBuffer::IndexFormat indexFormat = HasWideIndices(object.Header)
+            ? ysGPUBuffer::IndexFormat::UInt32
+            : ysGPUBuffer::IndexFormat::UInt16;
+
+        const ysError indexResult = device->CreateIndexBuffer(
+            &indexBuffer, object.IndexDataSize, data.data() + object.VertexDataSize, false, indexFormat);
+        if (indexResult != ysError::None) {
+            device->DestroyGPUBuffer(vertexBuffer);
+            return YDS_ERROR_RETURN(indexResult);
+        }
+    }
+
+    model->m_vertexBuffer = vertexBuffer;
+    model->m_indexBuffer = indexBuffer;
+    streamed->State = StreamState::Resident;
+
+    YDS_METRIC_INCREMENT(m_bytesUploadedMetric, object.VertexDataSize + object.IndexDataSize);
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void dbasic::AssetManager::EvictStreamedModel(StreamedModel *streamed) {
+    ysDevice *device = m_engine->GetDevice();
+    ModelAsset *model = streamed->Model;
+
+    if (model->m_vertexBuffer != nullptr) device->DestroyGPUBuffer(model->m_vertexBuffer);
+    if (model->m_indexBuffer != nullptr) device->DestroyGPUBuffer(model->m_indexBuffer);
+
+    model->m_vertexBuffer = nullptr;
+    model->m_indexBuffer = nullptr;
+    streamed->State = StreamState::Evicted;
+}
+
+void dbasic::AssetManager::PublishMetrics() {
+    int64_t bufferBytes = 0;
+    for (ysGPUBuffer *buffer : m_buffers) {
+        if (buffer != nullptr) bufferBytes += buffer->GetSize();
+    }
+
+    // Textures are assumed to be 32-bit RGBA
+    int64_t textureBytes = 0;
+    const int textureCount = m_textures.GetNumObjects();
+    for (int i = 0; i < textureCount; ++i) {
+        const ysTexture *texture = m_textures.Get(i)->GetTexture();
+        if (texture != nullptr) textureBytes += (int64_t)texture->GetWidth() * texture->GetHeight() * 4;
+    }
+
+    YDS_METRIC_SET(m_modelCountMetric, m_modelAssets.GetNumObjects());
+    YDS_METRIC_SET(m_textureCountMetric, textureCount);
+    YDS_METRIC_SET(m_bufferBytesMetric, bufferBytes);
+    YDS_METRIC_SET(m_textureBytesMetric, textureBytes);
+    YDS_METRIC_SET(m_residentBytesMetric, m_residency.GetResidentBytes());
+    YDS_METRIC_SET(m_pendingLoadsMetric, GetPendingLoadCount());
+}
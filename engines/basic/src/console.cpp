@@ -3,6 +3,8 @@
 #include "../include/font_map.h"
 #include "../include/delta_engine.h"
 
+#include <stdio.h>
+
 dbasic::Console::Console() {
     m_engine = nullptr;
 
@@ -226,6 +228,20 @@ int dbasic::Console::GetTotalNotWhitespace() const {
     return n;
 }
 
+void dbasic::Console::DrawMetrics(const ysMetrics *metrics) {
+    RealignLocation();
+
+    // Fixed width lines so that values from previous frames are overwritten
+    char line[64];
+
+    const int metricCount = metrics->GetMetricCount();
+    for (int i = 0; i < metricCount; ++i) {
+        snprintf(line, sizeof(line), "%-32.32s %14.2f", metrics->GetName(i), metrics->GetValue(i));
+        DrawGeneralText(line);
+        MoveDownLine();
+    }
+}
+
 // Drawing shapes
 
 void dbasic::Console::DrawHorizontalLine(int length) {
@@ -317,6 +317,7 @@ void dbasic::DefaultShaders::ConfigureImage(
     SetTexScale(texScaleU, texScaleV);
     SetColorReplace(false);
     SetLit(true);
+    ResetQuantization();
 }
 
 void dbasic::DefaultShaders::ConfigureBox(float width, float height) {
@@ -324,6 +325,7 @@ void dbasic::DefaultShaders::ConfigureBox(float width, float height) {
     SetTexOffset(0.0f, 0.0f);
     SetTexScale(1.0f, 1.0f);
     SetColorReplace(true);
+    ResetQuantization();
 }
 
 void dbasic::DefaultShaders::ConfigureAxis(
@@ -346,6 +348,33 @@ void dbasic::DefaultShaders::ConfigureModel(float scale, ModelAsset *model) {
     SetTexOffset(0.0f, 0.0f);
     SetTexScale(1.0f, 1.0f);
     UseMaterial(model->GetMaterial());
+
+    if (model->IsQuantized()) {
+        const ysVector3 &offset = model->GetQuantizationOffset();
+        const ysVector3 &quantizationScale = model->GetQuantizationScale();
+
+        m_shaderObjectVariables.QuantizationOffset = ysVector4(offset.x, offset.y, offset.z, 0.0f);
+        m_shaderObjectVariables.QuantizationScale =
+            ysVector4(quantizationScale.x, quantizationScale.y, quantizationScale.z, 1.0f);
+        m_shaderObjectVariables.OctahedralNormals = 1;
+    }
+    else {
+        ResetQuantization();
+    }
+}
+
+float dbasic::DefaultShaders::GetPixelsPerUnit(const ysVector &position) const {
+    const float distance = sqrtf(ysMath::GetScalar(ysMath::MagnitudeSquared3(ysMath::Sub(position, m_cameraPosition))));
+    if (distance <= m_nearClip) return FLT_MAX;
+
+    // Height of the view frustum at that distance spans the whole screen
+    return m_screenHeight / (2.0f * distance * tan(m_cameraFov / 2.0f));
+}
+
+void dbasic::DefaultShaders::ResetQuantization() {
+    m_shaderObjectVariables.QuantizationOffset = ysVector4(0.0f, 0.0f, 0.0f, 0.0f);
+    m_shaderObjectVariables.QuantizationScale = ysVector4(1.0f, 1.0f, 1.0f, 1.0f);
+    m_shaderObjectVariables.OctahedralNormals = 0;
 }
 
 void dbasic::DefaultShaders::SetDiffuseTexture(ysTexture *texture) {
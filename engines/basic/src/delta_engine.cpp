@@ -11,6 +11,7 @@
 #include <stb/stb_truetype.h>
 
 #include <assert.h>
+#include <stdio.h>
 
 const std::string dbasic::DeltaEngine::FrameBreakdownFull = "Frame Full";
 const std::string dbasic::DeltaEngine::FrameBreakdownRenderScene = "Scene";
@@ -47,9 +48,13 @@ dbasic::DeltaEngine::DeltaEngine() {
     m_inputLayout = nullptr;
     m_consoleInputLayout = nullptr;
     m_saqInputLayout = nullptr;
+    m_quantizedInputLayout = nullptr;
 
     m_initialized = false;
 
+    m_frameBreakdownFullChannel = ysBreakdownTimer::InvalidChannel;
+    m_frameBreakdownRenderSceneChannel = ysBreakdownTimer::InvalidChannel;
+
     m_clearColor[0] = 0.0F;
     m_clearColor[1] = 0.0F;
     m_clearColor[2] = 0.0F;
@@ -62,6 +67,21 @@ dbasic::DeltaEngine::DeltaEngine() {
 
     m_drawQueue = new ysExpandingArray<DrawCall, 256>[MaxLayers];
 
+    ysMetrics *metrics = ysMetrics::Get();
+    m_drawCallsMetric = metrics->RegisterCounter("Render/DrawCalls");
+    m_objectDataBytesMetric = metrics->RegisterCounter("Render/ObjectDataBytes");
+    m_frameTimeMetric = metrics->RegisterGauge("Engine/FrameTime_ms");
+    m_heapAllocationsMetric = metrics->RegisterGauge("Memory/HeapAllocations");
+
+    // Per layer counters are registered the first time a layer is drawn
+    for (int i = 0; i < MaxLayers; ++i) {
+        m_layerDrawCallsMetrics[i] = ysMetrics::InvalidMetric;
+    }
+
+    m_metricsOverlayEnabled = false;
+    m_lodErrorThreshold = 1.0f;
+    m_metricsOverlayLocation = GuiPoint(0, 0);
+
     m_cursorHidden = false;
     m_cursorPositionLocked = false;
 }
@@ -87,6 +107,7 @@ dbasic::DeltaEngine::~DeltaEngine() {
     assert(m_skinnedInputLayout == nullptr);
     assert(m_consoleInputLayout == nullptr);
     assert(m_saqInputLayout == nullptr);
+    assert(m_quantizedInputLayout == nullptr);
     assert(m_mainKeyboard == nullptr);
     assert(m_inputSystem == nullptr);
     assert(m_mainMouse == nullptr);
@@ -144,6 +165,9 @@ ysError dbasic::DeltaEngine::CreateGameWindow(const GameEngineSettings &settings
 
     m_mainRenderTarget->SetDebugName("MAIN_RENDER_TARGET");
 
+    // Per-frame scratch memory
+    m_frameAllocator.Initialize(1 * MB);
+
     // Initialize Geometry
     YDS_NESTED_ERROR_CALL(InitializeGeometry());
 
@@ -164,6 +188,7 @@ ysError dbasic::DeltaEngine::CreateGameWindow(const GameEngineSettings &settings
     m_timingSystem->Initialize();
 
     InitializeBreakdownTimer(settings.LoggingDirectory);
+    ysProfiler::Get()->SetThreadName("Main");
 
     m_initialized = true;
 
@@ -175,11 +200,14 @@ ysError dbasic::DeltaEngine::CreateGameWindow(const GameEngineSettings &settings
 ysError dbasic::DeltaEngine::StartFrame() {
     YDS_ERROR_DECLARE("StartFrame");
 
+    ysProfiler::Get()->BeginFrame();
+
     m_uiRenderer.Reset();
+    m_frameAllocator.StartFrame();
 
     m_breakdownTimer.WriteLastFrameToLogFile();
     m_breakdownTimer.StartFrame();
-    m_breakdownTimer.StartMeasurement(FrameBreakdownFull);
+    m_breakdownTimer.StartMeasurement(m_frameBreakdownFullChannel);
 
     m_windowSystem->ProcessMessages();
     m_timingSystem->Update();
@@ -205,28 +233,54 @@ ysError dbasic::DeltaEngine::StartFrame() {
 
 ysError dbasic::DeltaEngine::EndFrame() {
     YDS_ERROR_DECLARE("EndFrame");
+    YDS_ALLOCATION_TAG("render");
 
     if (IsOpen()) {
+        if (m_metricsOverlayEnabled) {
+            m_console.MoveToLocation(m_metricsOverlayLocation);
+            m_console.DrawMetrics(ysMetrics::Get());
+        }
+
         YDS_NESTED_ERROR_CALL(m_console.UpdateGeometry());
         YDS_NESTED_ERROR_CALL(m_uiRenderer.UpdateDisplay());
 
-        m_breakdownTimer.StartMeasurement(FrameBreakdownRenderScene);
         {
+            YDS_PROFILE_SCOPE(&m_breakdownTimer, m_frameBreakdownRenderSceneChannel);
             YDS_NESTED_ERROR_CALL(ExecuteDrawQueue());
         }
-        m_breakdownTimer.EndMeasurement(FrameBreakdownRenderScene);
 
         ClearDrawQueue();
 
         YDS_NESTED_ERROR_CALL(m_device->Present());
     }
     else {
-        m_breakdownTimer.SkipMeasurement(FrameBreakdownRenderScene);
+        m_breakdownTimer.SkipMeasurement(m_frameBreakdownRenderSceneChannel);
     }
 
-    m_breakdownTimer.EndMeasurement(FrameBreakdownFull);
+    m_breakdownTimer.EndMeasurement(m_frameBreakdownFullChannel);
     m_breakdownTimer.EndFrame();
 
+    ysMetrics *metrics = ysMetrics::Get();
+    metrics->SetGauge(m_frameTimeMetric, m_timingSystem->GetFrameDuration() * 1000.0);
+
+    if (ysAllocationTracker::IsEnabled()) {
+        ysAllocationTracker *tracker = ysAllocationTracker::Get();
+        tracker->EndFrame();
+
+        // Frame allocator blocks are excluded, they never reach the heap
+        const ysAllocationTracker::Statistics total = tracker->GetTotalStatistics();
+        uint64_t frameAllocations = 0;
+        for (int tag = 0; tag < tracker->GetTagCount(); ++tag) {
+            frameAllocations += tracker->GetStatistics(tag, ysAllocationTracker::Source::FrameAllocator).LastFrameAllocations;
+        }
+
+        metrics->SetGauge(m_heapAllocationsMetric, (double)(total.LastFrameAllocations - frameAllocations));
+    }
+
+    metrics->EndFrame();
+
+    ysProfiler::Get()->EndFrame();
+
     return YDS_ERROR_RETURN(ysError::None);
 }
 
@@ -257,6 +311,7 @@ ysError dbasic::DeltaEngine::Destroy() {
     YDS_NESTED_ERROR_CALL(m_device->DestroyInputLayout(m_skinnedInputLayout));
     YDS_NESTED_ERROR_CALL(m_device->DestroyInputLayout(m_consoleInputLayout));
     YDS_NESTED_ERROR_CALL(m_device->DestroyInputLayout(m_saqInputLayout));
+    YDS_NESTED_ERROR_CALL(m_device->DestroyInputLayout(m_quantizedInputLayout));
 
     YDS_NESTED_ERROR_CALL(m_device->DestroyRenderTarget(m_mainRenderTarget));
     YDS_NESTED_ERROR_CALL(m_device->DestroyRenderingContext(m_renderingContext));
@@ -278,6 +333,8 @@ ysError dbasic::DeltaEngine::Destroy() {
 
     ysWindowSystem::DestroyWindowSystem(m_windowSystem);
 
+    m_frameAllocator.Destroy();
+
     return YDS_ERROR_RETURN(ysError::None);
 }
 
@@ -307,9 +364,11 @@ ysError dbasic::DeltaEngine::InitializeConsoleShaders(ShaderSet *shaderSet) {
 }
 
 dbasic::DeltaEngine::DrawCall *dbasic::DeltaEngine::NewDrawCall(int layer, int objectDataSize) {
+    YDS_ALLOCATION_TAG("render");
+
     DrawCall *newCall = &m_drawQueue[layer].New();
     if (newCall != nullptr) {
-        newCall->ObjectData = malloc(objectDataSize);
+        newCall->ObjectData = m_frameAllocator.AllocateBlock(objectDataSize);
         newCall->ObjectDataSize = objectDataSize;
     }
 
@@ -387,6 +446,11 @@ ysError dbasic::DeltaEngine::InitializeShaders(const char *shaderDirectory) {
     m_standardFormat.AddChannel("TEXCOORD", sizeof(float) * 4, ysRenderGeometryChannel::ChannelFormat::R32G32_FLOAT);
     m_standardFormat.AddChannel("NORMAL", sizeof(float) * (4 + 2), ysRenderGeometryChannel::ChannelFormat::R32G32B32A32_FLOAT);
 
+    // Models compiled with ysGeometryExportFile::VertexInfo::Quantize, decoded by the standard shader
+    m_quantizedFormat.AddChannel("POSITION", 0, ysRenderGeometryChannel::ChannelFormat::R16G16B16A16_UNORM);
+    m_quantizedFormat.AddChannel("TEXCOORD", sizeof(uint16_t) * 4, ysRenderGeometryChannel::ChannelFormat::R16G16_FLOAT);
+    m_quantizedFormat.AddChannel("NORMAL", sizeof(uint16_t) * (4 + 2), ysRenderGeometryChannel::ChannelFormat::R16G16_SNORM);
+
     m_consoleVertexFormat.AddChannel("POSITION", 0, ysRenderGeometryChannel::ChannelFormat::R32G32_FLOAT);
     m_consoleVertexFormat.AddChannel("TEXCOORD", sizeof(float) * 2, ysRenderGeometryChannel::ChannelFormat::R32G32_FLOAT);
 
@@ -394,6 +458,7 @@ ysError dbasic::DeltaEngine::InitializeShaders(const char *shaderDirectory) {
     YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_skinnedInputLayout, m_vertexSkinnedShader, &m_skinnedFormat));
     YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_consoleInputLayout, m_consoleVertexShader, &m_consoleVertexFormat));
     YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_saqInputLayout, m_saqVertexShader, &m_standardFormat));
+    YDS_NESTED_ERROR_CALL(m_device->CreateInputLayout(&m_quantizedInputLayout, m_vertexShader, &m_quantizedFormat));
 
     YDS_NESTED_ERROR_CALL(m_device->CreateShaderProgram(&m_shaderProgram));
     YDS_NESTED_ERROR_CALL(m_device->AttachShader(m_shaderProgram, m_vertexShader));
@@ -423,6 +488,9 @@ ysError dbasic::DeltaEngine::InitializeBreakdownTimer(const char *loggingDirecto
     ysBreakdownTimerChannel *full = m_breakdownTimer.CreateChannel(FrameBreakdownFull);
     ysBreakdownTimerChannel *scene = m_breakdownTimer.CreateChannel(FrameBreakdownRenderScene);
 
+    m_frameBreakdownFullChannel = full->GetId();
+    m_frameBreakdownRenderSceneChannel = scene->GetId();
+
     std::string logFile = loggingDirectory;
     logFile += "/frame_breakdown_log.csv";
 
@@ -677,19 +745,31 @@ ysError dbasic::DeltaEngine::DrawAxis(StageEnableFlags flags, int layer) {
     return YDS_ERROR_RETURN(ysError::None);
 }
 
-ysError dbasic::DeltaEngine::DrawModel(StageEnableFlags flags, ModelAsset *model, int layer) {
+ysError dbasic::DeltaEngine::DrawModel(StageEnableFlags flags, ModelAsset *model, int layer, int lod) {
     YDS_ERROR_DECLARE("DrawModel");
 
-    DrawCall *newCall = NewDrawCall(layer, m_shaderSet->GetObjectDataSize());
-    if (newCall != nullptr) {
+    if (lod < 0 || lod >= model->GetLodCount()) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
+    // Streamed models are skipped until their geometry arrives
+    if (!model->Acquire()) return YDS_ERROR_RETURN(ysError::None);
+
+    // Models split to keep 16 bit indices take one call per submesh
+    const ModelAsset::Lod &level = model->GetLod(lod);
+    for (int i = level.FirstSubmesh; i < level.FirstSubmesh + level.SubmeshCount; ++i) {
+        const ModelAsset::Submesh &submesh = model->GetSubmesh(i);
+
+        DrawCall *newCall = NewDrawCall(layer, m_shaderSet->GetObjectDataSize());
+        if (newCall == nullptr) break;
+
         YDS_NESTED_ERROR_CALL(m_shaderSet->CacheObjectData(newCall->ObjectData, m_shaderSet->GetObjectDataSize()));
         newCall->VertexSize = model->GetVertexSize();
         newCall->IndexBuffer = model->GetIndexBuffer();
         newCall->VertexBuffer = model->GetVertexBuffer();
-        newCall->BaseVertex = model->GetBaseVertex();
-        newCall->BaseIndex = model->GetBaseIndex();
-        newCall->FaceCount = model->GetFaceCount();
+        newCall->BaseVertex = submesh.BaseVertex;
+        newCall->BaseIndex = submesh.BaseIndex;
+        newCall->FaceCount = submesh.FaceCount;
         newCall->Flags = flags;
+        newCall->InputLayout = model->IsQuantized() ? m_quantizedInputLayout : nullptr;
     }
 
     return YDS_ERROR_RETURN(ysError::None);
@@ -703,13 +783,17 @@ ysError dbasic::DeltaEngine::DrawRenderSkeleton(
     const int nodeCount = skeleton->GetNodeCount();
     for (int i = 0; i < nodeCount; ++i) {
         RenderNode *node = skeleton->GetNode(i);
-        if (node->GetModelAsset() != nullptr) {
+        ModelAsset *model = node->GetModelAsset();
+        if (model != nullptr) {
+            const float pixelsPerUnit = shaders->GetPixelsPerUnit(node->Transform.GetWorldPosition()) * scale;
+
             shaders->SetObjectTransform(node->Transform.GetWorldTransform());
-            shaders->ConfigureModel(scale, node->GetModelAsset());
+            shaders->ConfigureModel(scale, model);
             DrawModel(
                 flags,
-                node->GetModelAsset(),
-                layer);
+                model,
+                layer,
+                model->SelectLod(pixelsPerUnit, m_lodErrorThreshold));
         }
     }
 
@@ -740,6 +824,7 @@ ysError dbasic::DeltaEngine::DrawGeneric(
 
 ysError dbasic::DeltaEngine::ExecuteDrawQueue() {
     YDS_ERROR_DECLARE("ExecuteDrawQueue");
+    YDS_TRACE_SCOPE("Render");
 
     const int stageCount = m_shaderSet->GetStageCount();
     for (int i = 0; i < stageCount; ++i) {
@@ -756,8 +841,13 @@ ysError dbasic::DeltaEngine::ExecuteShaderStage(int stageIndex) {
     stage->BindScene();
 
     if (stage->GetType() == ShaderStage::Type::FullPass) {
+        int drawCalls = 0;
+        int objectDataBytes = 0;
+
         for (int i = 0; i < MaxLayers; i++) {
             const int objectsAtLayer = m_drawQueue[i].GetNumObjects();;
+            int layerDrawCalls = 0;
+
             for (int j = 0; j < objectsAtLayer; j++) {
                 const DrawCall *call = &m_drawQueue[i][j];
                 if (call == nullptr) continue;
@@ -766,6 +856,12 @@ ysError dbasic::DeltaEngine::ExecuteShaderStage(int stageIndex) {
                 m_shaderSet->ReadObjectData(call->ObjectData, stageIndex, call->ObjectDataSize);
                 stage->BindObject();
 
+                ++layerDrawCalls;
+                objectDataBytes += call->ObjectDataSize;
+
+                m_device->UseInputLayout(
+                    (call->InputLayout != nullptr) ? call->InputLayout : stage->GetInputLayout());
+
                 if (call->IndexBuffer != nullptr) {
                     m_device->SetDepthTestEnabled(stage->GetRenderTarget(), call->DepthTest);
 
@@ -783,7 +879,21 @@ ysError dbasic::DeltaEngine::ExecuteShaderStage(int stageIndex) {
                     m_device->Draw(2, 0, 0);
                 }
             }
+
+            if (layerDrawCalls > 0) {
+                if (m_layerDrawCallsMetrics[i] == ysMetrics::InvalidMetric) {
+                    char name[64];
+                    snprintf(name, sizeof(name), "Render/DrawCalls/Layer%d", i);
+                    m_layerDrawCallsMetrics[i] = ysMetrics::Get()->RegisterCounter(name);
+                }
+
+                YDS_METRIC_INCREMENT(m_layerDrawCallsMetrics[i], layerDrawCalls);
+                drawCalls += layerDrawCalls;
+            }
         }
+
+        YDS_METRIC_INCREMENT(m_drawCallsMetric, drawCalls);
+        YDS_METRIC_INCREMENT(m_objectDataBytesMetric, objectDataBytes);
     }
     else if (stage->GetType() == ShaderStage::Type::PostProcessing) {
         m_device->SetDepthTestEnabled(stage->GetRenderTarget(), false);
@@ -792,19 +902,15 @@ ysError dbasic::DeltaEngine::ExecuteShaderStage(int stageIndex) {
         m_device->UseVertexBuffer(m_mainVertexBuffer, sizeof(Vertex), 0);
 
         m_device->Draw(2, 0, 0);
+
+        YDS_METRIC_INCREMENT(m_drawCallsMetric, 1);
     }
 
     return YDS_ERROR_RETURN(ysError::None);
 }
 
 void dbasic::DeltaEngine::ClearDrawQueue() {
-    for (int i = 0; i < MaxLayers; ++i) {
-        const int n = m_drawQueue[i].GetNumObjects();
-        for (int j = 0; j < n; ++j) {
-            free(m_drawQueue[i][j].ObjectData);
-        }
-    }
-
+    // Object data lives in the frame allocator and is reclaimed at the start of a later frame
     for (int i = 0; i < MaxLayers; ++i) {
         m_drawQueue[i].Clear();
     }
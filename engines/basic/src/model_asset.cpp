@@ -1,5 +1,7 @@
 #include "../include/model_asset.h"
 
+#include "../include/asset_manager.h"
+
 dbasic::ModelAsset::ModelAsset() : ysObject("MODEL_ASSET") {
     m_name[0] = '\0';
     m_material = nullptr;
@@ -7,6 +9,9 @@ dbasic::ModelAsset::ModelAsset() : ysObject("MODEL_ASSET") {
     m_vertexBuffer = nullptr;
     m_indexBuffer = nullptr;
 
+    m_vertexData = nullptr;
+    m_indexData = nullptr;
+
     m_baseVertex = 0;
     m_baseIndex = 0;
 
@@ -15,6 +20,13 @@ dbasic::ModelAsset::ModelAsset() : ysObject("MODEL_ASSET") {
     m_UVChannelCount = 0;
 
     m_vertexSize = 0;
+    m_indexSize = sizeof(unsigned short);
+
+    m_streamIndex = -1;
+
+    m_quantized = false;
+    m_quantizationOffset = ysVector3(0.0f, 0.0f, 0.0f);
+    m_quantizationScale = ysVector3(1.0f, 1.0f, 1.0f);
 
     m_manager = nullptr;
 }
@@ -22,3 +34,19 @@ dbasic::ModelAsset::ModelAsset() : ysObject("MODEL_ASSET") {
 dbasic::ModelAsset::~ModelAsset() {
     /* void */
 }
+
+bool dbasic::ModelAsset::Acquire() {
+    if (m_streamIndex < 0) return true;
+    return m_manager->AcquireModel(this);
+}
+
+int dbasic::ModelAsset::SelectLod(float pixelsPerUnit, float maxError) const {
+    // Errors grow with each level, so stop at the first one that's too coarse
+    int selected = 0;
+    for (int i = 1; i < (int)m_lods.size(); ++i) {
+        if (m_lods[i].Error * pixelsPerUnit > maxError) break;
+        selected = i;
+    }
+
+    return selected;
+}
@@ -48,15 +48,10 @@ void dbasic::RenderSkeleton::BindAction(
 }
 
 dbasic::RenderNode *dbasic::RenderSkeleton::FindNode(const char *boneName) {
-    int nNodes = m_renderNodes.GetNumObjects();
-
-    for (int i = 0; i < nNodes; i++) {
-        if (strcmp(m_renderNodes.Get(i)->GetName(), boneName) == 0) {
-            return m_renderNodes.Get(i);
-        }
-    }
+    const int index = m_nodeNames.Lookup(boneName, m_renderNodes.GetNumObjects(),
+        [this](int i) { return m_renderNodes.Get(i)->GetName(); });
 
-    return nullptr;
+    return (index < 0) ? nullptr : m_renderNodes.Get(index);
 }
 
 void dbasic::RenderSkeleton::Update() {
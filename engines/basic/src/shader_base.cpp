@@ -7,3 +7,7 @@ dbasic::ShaderBase::ShaderBase() {
 dbasic::ShaderBase::~ShaderBase() {
 	/* void */
 }
+
+float dbasic::ShaderBase::GetPixelsPerUnit(const ysVector& position) const {
+	return FLT_MAX;
+}
@@ -20,15 +20,10 @@ dbasic::Bone *dbasic::Skeleton::GetBone(int index) {
 }
 
 dbasic::Bone *dbasic::Skeleton::FindBone(const char *boneName) {
-    int nBones = m_bones.GetNumObjects();
-
-    for (int i = 0; i < nBones; i++) {
-        if (strcmp(m_bones.Get(i)->GetName(), boneName) == 0) {
-            return m_bones.Get(i);
-        }
-    }
+    const int index = m_boneNames.Lookup(boneName, m_bones.GetNumObjects(),
+        [this](int i) { return m_bones.Get(i)->GetName(); });
 
-    return NULL;
+    return (index < 0) ? NULL : m_bones.Get(index);
 }
 
 void dbasic::Skeleton::Update() {
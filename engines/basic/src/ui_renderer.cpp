@@ -13,6 +13,10 @@ dbasic::UiRenderer::UiRenderer() {
     m_mainIndexBuffer = nullptr;
     m_mainVertexBuffer = nullptr;
     m_indexOffset = 0;
+
+    ysMetrics *metrics = ysMetrics::Get();
+    m_bytesUploadedMetric = metrics->RegisterCounter("Ui/BytesUploaded");
+    m_vertexCountMetric = metrics->RegisterCounter("Ui/Vertices");
 }
 
 dbasic::UiRenderer::~UiRenderer() {
@@ -49,6 +53,11 @@ ysError dbasic::UiRenderer::UpdateDisplay() {
         sizeof(unsigned short) * m_indexOffset,
         0);
 
+    YDS_METRIC_INCREMENT(
+        m_bytesUploadedMetric,
+        sizeof(ConsoleVertex) * m_vertexOffset + sizeof(unsigned short) * m_indexOffset);
+    YDS_METRIC_INCREMENT(m_vertexCountMetric, m_vertexOffset);
+
     m_shaders.SetTexture(m_font->GetTexture());
     m_engine->DrawGeneric(
         m_shaders.GetFlags(),
@@ -0,0 +1,206 @@
+#ifndef YDS_ALLOCATION_TRACKER_H
+#define YDS_ALLOCATION_TRACKER_H
+
+#include "yds_base.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// --
+// Attributes heap allocations to subsystems and call sites.
+//
+// ysAllocator, the ysMemoryAllocator implementations and (unless
+// YDS_DISABLE_OPERATOR_NEW_TRACKING is defined) the global operator new
+// report every allocation and free here. Tracking is off by default; while
+// disabled each report costs a single relaxed load.
+//
+// Allocations are charged to the calling thread's current tag, set with
+// YDS_ALLOCATION_TAG("physics") or a ysAllocationTagScope. Statistics are
+// kept per tag and per source. A block carved out of another tracked block
+// (e.g. from a ysDynamicAllocator whose buffer came from operator new)
+// shows up under both sources, so live bytes are best compared within a
+// source. EndFrame() closes the current frame's counts, which makes it
+// easy to spot frames that touch the heap.
+//
+// Call stacks can optionally be captured to build a report of the call
+// sites responsible for the most allocations.
+// --
+class ysAllocationTracker : public ysObject {
+public:
+    typedef int TagId;
+
+    static constexpr int MaxTags = 64;
+    static constexpr int MaxTagNameLength = 32;
+    static constexpr int MaxCallStackDepth = 12;
+    static constexpr TagId UntaggedTag = 0;
+
+    enum class Source {
+        Allocator,
+        MemoryAllocator,
+        FrameAllocator,
+        OperatorNew,
+        Count
+    };
+
+    struct Statistics {
+        uint64_t Allocations;
+        uint64_t Frees;
+        uint64_t BytesAllocated;
+
+        int64_t LiveAllocations;
+        int64_t LiveBytes;
+        int64_t PeakLiveBytes;
+
+        uint64_t FrameAllocations;
+        uint64_t FrameBytes;
+        uint64_t LastFrameAllocations;
+        uint64_t LastFrameBytes;
+    };
+
+    struct CallSite {
+        void *Frames[MaxCallStackDepth];
+        int Depth;
+
+        TagId Tag;
+        Source AllocationSource;
+
+        uint64_t Allocations;
+        uint64_t Bytes;
+        int64_t LiveBytes;
+    };
+
+protected:
+    static std::atomic<ysAllocationTracker *> g_instance;
+    static std::atomic<bool> s_enabled;
+
+public:
+    ysAllocationTracker();
+    ~ysAllocationTracker();
+
+    static ysAllocationTracker *Get();
+
+    // --
+    // Only allocations made while enabled are tracked; frees of blocks
+    // allocated before that are ignored.
+    // --
+    void SetEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Call stack capture is expensive and off by default
+    void SetCaptureCallStacks(bool capture) { m_captureCallStacks = capture; }
+    bool IsCapturingCallStacks() const { return m_captureCallStacks; }
+
+    // --
+    // Returns the id of the tag with the given name, registering it if
+    // needed. Returns UntaggedTag once MaxTags tags exist.
+    // --
+    TagId RegisterTag(const char *name);
+    const char *GetTagName(TagId tag) const;
+    int GetTagCount() const { return m_tagCount.load(std::memory_order_acquire); }
+
+    // Tag charged for allocations made by the calling thread
+    static TagId GetCurrentTag();
+    static TagId SetCurrentTag(TagId tag);
+
+    static void OnAllocate(void *block, size_t size, Source source) {
+        if (!s_enabled.load(std::memory_order_relaxed) || block == nullptr) return;
+        Get()->RecordAllocation(block, size, source);
+    }
+
+    static void OnFree(void *block, Source source) {
+        if (!s_enabled.load(std::memory_order_relaxed) || block == nullptr) return;
+        Get()->RecordFree(block, source);
+    }
+
+    void EndFrame();
+    uint64_t GetFrameCount() const { return m_frameCount; }
+
+    // Totals over every tag and source
+    Statistics GetTotalStatistics() const;
+    Statistics GetTagStatistics(TagId tag) const;
+    Statistics GetStatistics(TagId tag, Source source) const;
+
+    // --
+    // Call sites sorted by bytes allocated, largest first. Empty unless
+    // call stacks were being captured.
+    // --
+    std::vector<CallSite> GetTopCallSites(int count) const;
+
+    // Forget every tracked block and reset all statistics
+    void Reset();
+
+    ysError WriteReport(const char *fname, int topCallSites = 20);
+
+    static const char *GetSourceName(Source source);
+
+protected:
+    struct Record {
+        size_t Size;
+        uint64_t CallSiteHash;
+        TagId Tag;
+    };
+
+    struct SourceState {
+        std::unordered_map<void *, Record> LiveBlocks;
+    };
+
+    void RecordAllocation(void *block, size_t size, Source source);
+    void RecordFree(void *block, Source source);
+
+    static void Accumulate(Statistics *target, const Statistics &s);
+
+protected:
+    mutable std::mutex m_lock;
+
+    bool m_captureCallStacks;
+
+    char m_tagNames[MaxTags][MaxTagNameLength];
+    std::atomic<int> m_tagCount;
+
+    Statistics m_statistics[MaxTags][(int)Source::Count];
+    SourceState m_sources[(int)Source::Count];
+
+    std::unordered_map<uint64_t, CallSite> m_callSites;
+
+    uint64_t m_frameCount;
+};
+
+// --
+// Charges allocations made by the calling thread to a tag for the
+// lifetime of the scope.
+// --
+class ysAllocationTagScope {
+public:
+    ysAllocationTagScope(ysAllocationTracker::TagId tag) {
+        m_previous = ysAllocationTracker::SetCurrentTag(tag);
+    }
+
+    ~ysAllocationTagScope() {
+        ysAllocationTracker::SetCurrentTag(m_previous);
+    }
+
+    ysAllocationTagScope(const ysAllocationTagScope &) = delete;
+    ysAllocationTagScope &operator=(const ysAllocationTagScope &) = delete;
+
+protected:
+    ysAllocationTracker::TagId m_previous;
+};
+
+#define YDS_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define YDS_ALLOCATION_CONCAT(a, b) YDS_ALLOCATION_CONCAT_INNER(a, b)
+
+// Tags can be compiled out entirely by defining YDS_DISABLE_ALLOCATION_TAGS
+#ifndef YDS_DISABLE_ALLOCATION_TAGS
+#define YDS_ALLOCATION_TAG(name) \
+    static const ysAllocationTracker::TagId YDS_ALLOCATION_CONCAT(ysAllocationTagId_, __LINE__) = \
+        ysAllocationTracker::Get()->RegisterTag(name); \
+    ysAllocationTagScope YDS_ALLOCATION_CONCAT(ysAllocationTagScope_, __LINE__)( \
+        YDS_ALLOCATION_CONCAT(ysAllocationTagId_, __LINE__))
+#else
+#define YDS_ALLOCATION_TAG(name) ((void)0)
+#endif /* YDS_DISABLE_ALLOCATION_TAGS */
+
+#endif /* YDS_ALLOCATION_TRACKER_H */
@@ -1,28 +1,57 @@
 #ifndef YDS_ALLOCATOR_H
 #define YDS_ALLOCATOR_H
 
-#include <malloc.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <new>
 
 class ysAllocator {
+public:
+    enum class Event {
+        Allocate,
+        Free
+    };
+
+    // --
+    // Instrumentation callback invoked on every block allocation and free.
+    //
+    //   size: Size of the block, or 0 for frees where the size isn't known
+    //   alignment: Alignment the block was requested with
+    // --
+    typedef void (*AllocationHook)(Event event, void *block, size_t size, int alignment);
+
 public:
     template <int Alignment>
     static void *BlockAllocate(int size) {
-        return ::_aligned_malloc(size, Alignment);
+        return AlignedAllocate((size_t)size, Alignment);
     }
 
-    template <>
-    static void *BlockAllocate<1>(int size) {
-        return ::malloc(size);
-    }
+    // --
+    // Allocate a block with the given alignment. An alignment of 1 falls
+    // back to plain malloc().
+    // --
+    static void *AlignedAllocate(size_t size, int alignment);
 
-    static void BlockFree(void *block, int alignment) {
-        if (alignment != 1) {
-            ::_aligned_free(block);
-        }
-        else {
-            ::free(block);
-        }
-    }
+    // --
+    // Free a block allocated with BlockAllocate() or AlignedAllocate(). The
+    // alignment must match the one the block was allocated with.
+    // --
+    static void BlockFree(void *block, int alignment);
+
+    // --
+    // Allocate a large, page-aligned region directly from the OS. If hugePages
+    // is set the region is backed by large pages when the OS allows it.
+    //
+    // NOTE: Must be released with PageFree() using the same size.
+    // --
+    static void *PageAllocate(size_t size, bool hugePages = false);
+    static void PageFree(void *block, size_t size);
+
+    static size_t GetPageSize();
+    static size_t GetHugePageSize();
+
+    static void SetAllocationHook(AllocationHook hook) { s_allocationHook = hook; }
+    static AllocationHook GetAllocationHook() { return s_allocationHook; }
 
     template <typename T_Create, int Alignment>
     static T_Create *TypeAllocate(int n = 1, bool construct = true) {
@@ -50,6 +79,9 @@ public:
 
         BlockFree(block, alignment);
     }
+
+protected:
+    static AllocationHook s_allocationHook;
 };
 
 #endif /* YDS_ALLOCATOR_H */
@@ -3,6 +3,7 @@
 
 #include "yds_base.h"
 
+#include "yds_animation_clip.h"
 #include "yds_animation_curve.h"
 #include "yds_math.h"
 
@@ -21,11 +22,24 @@ public:
     ysAnimationCurve *GetCurve(const std::string &target, ysAnimationCurve::CurveType type);
     int GetCurveCount() const;
 
+    // Bakes every curve for sampling, see ysAnimationCurve::Bake
+    void Bake();
+
+    // --
+    // Replaces the curves with a compressed clip, see ysAnimationClip.
+    // Bindings have to be created after compressing.
+    // --
+    ysError Compress(const ysAnimationClip::Settings &settings);
+    ysAnimationClip *GetClip() const { return m_clip; }
+
+    // Names of every animated object
+    void GetTargets(std::vector<std::string> *targets) const;
+
     float GetLength() const { return m_length; }
     void SetLength(float length) { m_length = length; }
 
     void SetName(const std::string &name) { m_name = name; }
-    std::string GetName() const { return m_name; }
+    const std::string &GetName() const { return m_name; }
 
     bool IsAnimated(const std::string &objectName) const;
     void Bind(const std::string &objectName, ysAnimationTarget *target);
@@ -36,6 +50,8 @@ protected:
     float m_length;
 
     int m_curveCount;
+
+    ysAnimationClip *m_clip;
 };
 
 #endif /* YDS_ANIMATION_ACTION_H */
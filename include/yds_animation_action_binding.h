@@ -23,6 +23,10 @@ public:
 protected:
     std::vector<ysAnimationTarget *> m_targets;
     ysAnimationAction *m_action;
+
+    // Targets of each bone when the action is compressed
+    std::vector<TransformTarget *> m_clipLocations;
+    std::vector<TransformTarget *> m_clipRotations;
 };
 
 #endif /* YDS_ANIMATION_ACTION_BINDING_H */
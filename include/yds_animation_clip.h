@@ -0,0 +1,94 @@
+#ifndef YDS_ANIMATION_CLIP_H
+#define YDS_ANIMATION_CLIP_H
+
+#include "yds_base.h"
+
+#include "yds_math.h"
+#include "yds_name_index.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct TransformTarget;
+class ysAnimationAction;
+
+// --
+// Compressed form of an action. Every bone's curves are resampled at a
+// fixed rate and each frame stores all bones next to each other, so a
+// pose is sampled by reading two contiguous runs of memory.
+//
+// Locations are quantized to 16 bits over the range each bone covers in
+// the action and rotations are stored as their three smallest components
+// at 16 bits each, with the largest rebuilt from the unit length. A bone
+// takes 16 bytes per frame instead of 28 for seven float curves.
+// --
+class ysAnimationClip : public ysObject {
+public:
+    struct Settings {
+        // Samples per unit of action time. Actions exported from Blender
+        // are timed in frames, so 1 keeps one sample per authored frame.
+        float SampleRate = 1.0f;
+    };
+
+public:
+    ysAnimationClip();
+    ~ysAnimationClip();
+
+    ysError Compress(ysAnimationAction *action, const Settings &settings);
+
+    // --
+    // Decodes the pose at s and accumulates it into the targets of each
+    // bone, interpolating between the two closest frames. Either array
+    // may have null entries for bones that aren't bound.
+    // --
+    void Sample(float s, float amplitude,
+        TransformTarget *const *locations, TransformTarget *const *rotations) const;
+    void SampleRest(float amplitude,
+        TransformTarget *const *locations, TransformTarget *const *rotations) const;
+
+    int FindBone(const std::string &name);
+    int GetBoneCount() const { return (int)m_bones.size(); }
+    const std::string &GetBoneName(int bone) const { return m_bones[bone].Name; }
+
+    int GetFrameCount() const { return m_frameCount; }
+    float GetSampleRate() const { return m_sampleRate; }
+
+    size_t GetMemoryUsage() const;
+
+protected:
+    // Layout matches one 128 bit load, see DecodeLocation/DecodeRotation
+    struct QuantizedTransform {
+        uint16_t Location[3];
+        uint16_t LargestComponent;
+        uint16_t Rotation[3];
+        uint16_t Padding;
+    };
+
+    struct Bone {
+        std::string Name;
+
+        // Lane 3 is zero so decoded locations have w = 0
+        float LocationMin[4];
+        float LocationScale[4];
+
+        // Bit i set if location component i is animated
+        unsigned int LocationMask;
+        bool Rotation;
+    };
+
+    static ysVector DecodeLocation(const Bone &bone, const QuantizedTransform &t);
+    static ysQuaternion DecodeRotation(const QuantizedTransform &t);
+    static void EncodeRotation(const ysQuaternion &q, QuantizedTransform *t);
+
+protected:
+    std::vector<Bone> m_bones;
+    ysNameIndex m_boneNames;
+
+    // m_frameCount frames of GetBoneCount() transforms each
+    std::vector<QuantizedTransform> m_frames;
+    int m_frameCount;
+    float m_sampleRate;
+};
+
+#endif /* YDS_ANIMATION_CLIP_H */
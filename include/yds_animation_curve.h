@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 class ysAnimationTarget;
 
@@ -48,6 +49,15 @@ public:
     ~ysAnimationCurve();
 
     float Sample(float s);
+
+    // --
+    // Same as Sample(s) but starts looking for the segment containing s at
+    // *cursor and stores the segment found there. Forward playback only
+    // ever moves the cursor by a key or two, so keeping one cursor per
+    // binding makes the lookup constant time. Jumping backwards or far
+    // ahead falls back to a binary search.
+    // --
+    float Sample(float s, int *cursor);
     float GetRestValue();
 
     void SetTarget(const std::string &target) { m_target = target; }
@@ -59,13 +69,46 @@ public:
     void AddSamplePoint(const CurveHandle &handle);
     void AddLinearSamplePoint(float s, float t);
     int GetSampleCount() const { return (int)m_samples.size(); }
+    float GetEndTime() const { return m_samples.empty() ? 0.0f : m_samples.rbegin()->first; }
 
     void Attach(ysAnimationTarget *target);
 
+    // --
+    // Compiles the sample points into the flat arrays used for sampling.
+    // Done automatically by the first Sample() after the sample points
+    // change but should be called at load time so playback never pays for
+    // it.
+    // --
+    void Bake();
+    bool IsBaked() const { return m_baked; }
+
     static float Bezier_t(float x, float p0_x, float p1_x, float p2_x, float p3_x);
 
 protected:
+    int FindSegment(float s, int cursor) const;
+    float SampleSegment(int segment, float s) const;
+
+    static float SolveSegment_t(const float *x, float u);
+
+protected:
+    // Authoring form
     std::map<float, CurveHandle> m_samples;
+
+    // Baked form, one entry per key
+    std::vector<float> m_keyTimes;
+    std::vector<float> m_keyValues;
+
+    // Baked form, one entry per segment between two keys. Every segment is
+    // a cubic in t over [0, 1]: x(t) gives the position within the segment
+    // normalized to [0, 1] and y(t) the value. Linear segments have
+    // x(t) = t so they need no solve.
+    //   m_segmentX: a, b, c with x(t) = ((a * t + b) * t + c) * t
+    //   m_segmentY: a, b, c, d with y(t) = ((a * t + b) * t + c) * t + d
+    std::vector<float> m_inverseDurations;
+    std::vector<float> m_segmentX;
+    std::vector<float> m_segmentY;
+    bool m_baked;
+
     std::string m_target;
     CurveType m_curveType;
 };
@@ -109,6 +109,10 @@ protected:
     TransformTarget *m_rotationTarget;
     ysAnimationCurve *m_locationCurves[4];
     ysAnimationCurve *m_rotationCurves[4];
+
+    // Last segment sampled from each curve, see ysAnimationCurve::Sample
+    int m_locationCursors[4];
+    int m_rotationCursors[4];
 };
 
 #endif /* YDS_ANIMATION_TARGET_H */
@@ -0,0 +1,98 @@
+#ifndef YDS_ASSET_STREAMER_H
+#define YDS_ASSET_STREAMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// --
+// Background I/O thread for loading assets.
+//
+// Requests are queued from the main thread and return immediately. The
+// I/O thread runs each request's load function, which reads and decodes
+// the asset into a byte buffer. Finished loads wait until the owner
+// collects them, normally once per frame, so that GPU uploads only ever
+// happen on the main thread and at a known point in the frame.
+// --
+class ysAssetStreamer {
+public:
+    // --
+    // Runs on the I/O thread. Fills data with the loaded asset and
+    // returns false if it couldn't be loaded. Must not touch anything the
+    // main thread may be modifying.
+    // --
+    typedef bool (*LoadFunction)(void *context, int index, std::vector<char> *data);
+
+    struct Completion {
+        uint64_t Key;
+        bool Success;
+        std::vector<char> Data;
+    };
+
+public:
+    ysAssetStreamer();
+    ~ysAssetStreamer();
+
+    ysAssetStreamer(const ysAssetStreamer &) = delete;
+    ysAssetStreamer &operator=(const ysAssetStreamer &) = delete;
+
+    // Start the I/O thread
+    void Initialize();
+
+    // --
+    // Stop and join the I/O thread. The load in progress is finished,
+    // queued and uncollected loads are dropped.
+    // --
+    void Destroy();
+
+    bool IsInitialized() const { return m_thread.joinable(); }
+
+    // --
+    // Queue a load. Key identifies the load to its owner when it's
+    // collected. Loads run in the order they were requested.
+    // --
+    void Request(uint64_t key, LoadFunction function, void *context, int index);
+
+    // --
+    // Move finished loads into completed, oldest first, until maxBytes
+    // worth of data has been collected. At least one load is collected if
+    // any are finished so that a large asset can't stall the queue.
+    // Returns the number of loads collected.
+    // --
+    int Collect(std::vector<Completion> *completed, int64_t maxBytes = INT64_MAX);
+
+    // Block until every requested load has finished (not collected)
+    void WaitIdle();
+
+    // Loads requested but not yet collected
+    int GetPendingCount() const;
+
+protected:
+    struct PendingLoad {
+        uint64_t Key;
+        LoadFunction Function;
+        void *Context;
+        int Index;
+    };
+
+    void IoLoop();
+
+protected:
+    std::thread m_thread;
+    bool m_running;
+
+    // Loads waiting for the I/O thread, and the one it's running
+    std::deque<PendingLoad> m_queue;
+    int m_loading;
+
+    std::deque<Completion> m_completed;
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+};
+
+#endif /* YDS_ASSET_STREAMER_H */
@@ -7,11 +7,16 @@
 #include "yds_dynamic_array.h"
 
 #include <fstream>
+#include <stdint.h>
 #include <string>
 
 class ysBreakdownTimerChannel;
 
 class ysBreakdownTimer : public ysObject {
+public:
+    typedef int ChannelId;
+    static constexpr ChannelId InvalidChannel = -1;
+
 public:
     ysBreakdownTimer();
     ~ysBreakdownTimer();
@@ -25,12 +30,41 @@ public:
     void StartFrame();
     void EndFrame();
 
+    // --
+    // Measurements by channel ID. IDs never change once a channel is
+    // created, so they can be resolved once and cached.
+    // --
+    void StartMeasurement(ChannelId channel);
+    void EndMeasurement(ChannelId channel);
+    void SkipMeasurement(ChannelId channel);
+
+    // NOTE: Looks up the channel on every call; prefer the ChannelId versions
     void StartMeasurement(const std::string &timerChannelName);
     void EndMeasurement(const std::string &timerChannelName);
     void SkipMeasurement(const std::string &timerChannelName);
 
     ysBreakdownTimerChannel *CreateChannel(const std::string &timerChannelName, int bufferSize = 1024);
 
+    ChannelId FindChannelId(const std::string &timerChannelName) const;
+    ChannelId FindChannelId(uint64_t nameHash) const;
+
+    // --
+    // FNV-1a hash of a channel name. Can be evaluated at compile time so
+    // that channels can be looked up without building a string.
+    // --
+    static constexpr uint64_t HashName(const char *name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (; *name != '\0'; ++name) {
+            hash ^= (uint64_t)(unsigned char)*name;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    int GetExecutionOrderLength() const { return m_executionOrder.GetNumObjects(); }
+    ChannelId GetExecutionOrder(int i) const { return m_executionOrder[i]; }
+
     uint64_t GetFrameCount() const { return m_frameCount; }
 
     void OpenLogFile(const std::string &filename);
@@ -41,11 +75,45 @@ protected:
     ysBreakdownTimerChannel *FindChannel(const std::string &timerChannelName);
 
     ysDynamicArray<ysBreakdownTimerChannel, 4> m_channels;
-    ysExpandingArray<std::string, 4> m_executionOrder;
+    ysExpandingArray<ChannelId, 4> m_executionOrder;
 
     std::fstream m_logFile;
 
     uint64_t m_frameCount;
 };
 
+// --
+// Measures the enclosing scope on a breakdown timer channel.
+// --
+class ysBreakdownTimerScope {
+public:
+    ysBreakdownTimerScope(ysBreakdownTimer *timer, ysBreakdownTimer::ChannelId channel)
+        : m_timer(timer), m_channel(channel)
+    {
+        m_timer->StartMeasurement(m_channel);
+    }
+
+    ~ysBreakdownTimerScope() {
+        m_timer->EndMeasurement(m_channel);
+    }
+
+    ysBreakdownTimerScope(const ysBreakdownTimerScope &) = delete;
+    ysBreakdownTimerScope &operator=(const ysBreakdownTimerScope &) = delete;
+
+protected:
+    ysBreakdownTimer *m_timer;
+    ysBreakdownTimer::ChannelId m_channel;
+};
+
+#define YDS_PROFILE_CONCAT_INNER(a, b) a##b
+#define YDS_PROFILE_CONCAT(a, b) YDS_PROFILE_CONCAT_INNER(a, b)
+
+// Profiling scopes can be compiled out entirely by defining YDS_DISABLE_PROFILING
+#ifndef YDS_DISABLE_PROFILING
+#define YDS_PROFILE_SCOPE(timer, channel) \
+    ysBreakdownTimerScope YDS_PROFILE_CONCAT(ysProfileScope_, __LINE__)((timer), (channel))
+#else
+#define YDS_PROFILE_SCOPE(timer, channel) ((void)0)
+#endif /* YDS_DISABLE_PROFILING */
+
 #endif /* YDS_BREAKDOWN_TIMER_H */
@@ -14,8 +14,12 @@ public:
     void Reset();
     void Destroy();
 
-    void SetName(const std::string &name) { m_name = name; }
-    std::string GetName() const { return m_name; }
+    void SetName(const std::string &name);
+    const std::string &GetName() const { return m_name; }
+    uint64_t GetNameHash() const { return m_nameHash; }
+
+    void SetId(int id) { m_id = id; }
+    int GetId() const { return m_id; }
 
     int GetEntryCount() const { return m_entryCount; }
     uint64_t GetFrameCount() const { return m_frameCount; }
@@ -29,10 +33,13 @@ public:
     void StartMeasurement(uint64_t timestamp);
     void EndMeasurement(uint64_t timestamp);
 
-    bool IsMidMeasurement() const { return m_midMeasurement; }
+    bool IsMidMeasurement() const { return m_nestingDepth > 0; }
 
 protected:
     std::string m_name;
+    uint64_t m_nameHash;
+    int m_id;
+
     double *m_sampleBuffer;
     int m_bufferSize;
     int m_currentWriteIndex;
@@ -40,7 +47,8 @@ protected:
 
     uint64_t m_frameCount;
 
-    bool m_midMeasurement;
+    // Nested measurements of the same channel only time the outermost one
+    int m_nestingDepth;
 
 protected:
     uint64_t m_lastMeasurementStart;
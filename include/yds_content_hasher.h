@@ -0,0 +1,58 @@
+#ifndef YDS_CONTENT_HASHER_H
+#define YDS_CONTENT_HASHER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// --
+// 64 bit FNV-1a over the raw bytes of whatever is added, used to key
+// compiled objects by their source data. Values are hashed as they are
+// laid out in memory, so only add types without padding.
+// --
+class ysContentHasher {
+public:
+    ysContentHasher() : m_hash(14695981039346656037ull) { /* void */ }
+
+    void Add(const void *data, size_t size) {
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < size; ++i) {
+            m_hash ^= bytes[i];
+            m_hash *= 1099511628211ull;
+        }
+    }
+
+    template <typename T_Value>
+    void AddValue(const T_Value &value) { Add(&value, sizeof(T_Value)); }
+
+    // The size goes first so that neighbouring arrays can't alias
+    template <typename T_Element>
+    void AddArray(const T_Element *values, size_t count) {
+        AddValue((uint64_t)count);
+        if (count > 0) Add(values, count * sizeof(T_Element));
+    }
+
+    template <typename T_Element>
+    void AddArray(const std::vector<T_Element> &values) {
+        AddArray(values.data(), values.size());
+    }
+
+    void AddString(const char *value) {
+        const size_t length = strlen(value);
+        AddValue((uint64_t)length);
+        Add(value, length);
+    }
+
+    void AddString(const std::string &value) {
+        AddValue((uint64_t)value.size());
+        Add(value.data(), value.size());
+    }
+
+    uint64_t GetHash() const { return m_hash; }
+
+protected:
+    uint64_t m_hash;
+};
+
+#endif /* YDS_CONTENT_HASHER_H */
@@ -21,6 +21,7 @@
 #include "yds_tool_animation_file.h"
 #include "yds_animation_action.h"
 #include "yds_animation_action_binding.h"
+#include "yds_animation_clip.h"
 #include "yds_animation_curve.h"
 #include "yds_animation_mixer.h"
 #include "yds_animation_target.h"
@@ -30,12 +31,21 @@
 #include "yds_timing.h"
 #include "yds_breakdown_timer.h"
 #include "yds_breakdown_timer_channel.h"
+#include "yds_profiler.h"
+#include "yds_metrics.h"
 
 // Math
 #include "yds_math.h"
 
 // Memory management
+#include "yds_allocation_tracker.h"
 #include "yds_expanding_array.h"
+#include "yds_frame_allocator.h"
+#include "yds_memory_mapped_file.h"
+#include "yds_slab_allocator.h"
+
+// Threading
+#include "yds_job_system.h"
 
 // Textures
 #include "yds_texture.h"
@@ -45,6 +55,8 @@
 
 // Utilities
 #include "yds_registry.h"
+#include "yds_name_index.h"
+#include "yds_content_hasher.h"
 
 // Geometry
 #include "yds_interchange_file_0_0.h"
@@ -52,6 +64,12 @@
 #include "yds_tool_geometry_file.h"
 #include "yds_geometry_preprocessing.h"
 #include "yds_geometry_export_file.h"
+#include "yds_geometry_export_file_reader.h"
+#include "yds_mesh_optimizer.h"
+#include "yds_vertex_quantization.h"
+#include "yds_scene_compiler.h"
+#include "yds_asset_streamer.h"
+#include "yds_residency_set.h"
 
 // Object
 #include "yds_transform.h"
@@ -111,7 +111,12 @@ public:
     virtual ysError CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false) = 0;
 
     // Create index buffer
-    virtual ysError CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false) = 0;
+    virtual ysError CreateIndexBuffer(
+        ysGPUBuffer **newBuffer,
+        int size,
+        char *data,
+        bool mirrorToRam = false,
+        ysGPUBuffer::IndexFormat format = ysGPUBuffer::IndexFormat::UInt16) = 0;
 
     // Create constant buffer
     virtual ysError CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false) = 0;
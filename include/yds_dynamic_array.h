@@ -5,6 +5,7 @@
 #include "yds_allocator.h"
 
 #include <memory>
+#include <string.h>
 
 class ysDynamicArrayElement {
 public:
@@ -40,11 +41,16 @@ protected:
 
 template<typename TYPE, int START_SIZE = 0>
 class ysDynamicArray {
+public:
+    static constexpr int MinCondenseSize = 16;
+
 public:
     ysDynamicArray() {
         m_maxSize = START_SIZE;
+        m_minSize = START_SIZE;
         m_nObjects = 0;
         m_array = nullptr;
+        m_allocationCount = 0;
 
         Preallocate(m_maxSize);
     }
@@ -59,6 +65,36 @@ public:
         if (m_array) return;
 
         m_array = new TYPE * [nObjects];
+        m_allocationCount++;
+    }
+
+    // --
+    // Guarantee room for at least nObjects without reallocating. The array
+    // will also never condense below this capacity until ShrinkToFit() is called.
+    // --
+    void Reserve(int nObjects) {
+        if (nObjects > m_minSize) m_minSize = nObjects;
+        if (nObjects > m_maxSize) Resize(nObjects);
+    }
+
+    // --
+    // Release any unused capacity and clear the reserved capacity.
+    // --
+    void ShrinkToFit() {
+        m_minSize = 0;
+        if (m_nObjects < m_maxSize) Resize(m_nObjects);
+    }
+
+    int GetCapacity() const {
+        return m_maxSize;
+    }
+
+    // --
+    // Number of times the pointer table has been (re)allocated. Used to verify
+    // that steady-state workloads don't allocate.
+    // --
+    int GetAllocationCount() const {
+        return m_allocationCount;
     }
 
     TYPE *New() {
@@ -135,8 +171,6 @@ public:
     ysError Delete(int index, bool destroy = true, TYPE *replacement = nullptr, bool preserveOrder = false) {
         if (index >= m_nObjects || index < 0) return ysError::OutOfBounds;
 
-        if (m_nObjects <= m_maxSize / 2) Condense();
-
         ysDynamicArrayElement *target = static_cast<ysDynamicArrayElement *>(m_array[index]);
 
         if (destroy) {
@@ -172,6 +206,12 @@ public:
 
         if (replacement == nullptr) {
             m_nObjects--;
+
+            // Only condense once the array is a quarter full so that workloads
+            // oscillating around a capacity boundary don't reallocate every cycle
+            if (m_maxSize > MinCondenseSize && m_nObjects <= m_maxSize / 4 && m_maxSize / 2 >= m_minSize) {
+                Condense();
+            }
         }
 
         return ysError::None;
@@ -191,9 +231,11 @@ public:
 
     void Clear(bool destroy = true) {
         if (destroy) {
-            int nObjects = m_nObjects;
-            for (int i = nObjects - 1; i >= 0; --i) {
-                Delete(i);
+            // Capacity is kept so that arrays refilled every frame don't reallocate
+            for (int i = m_nObjects - 1; i >= 0; --i) {
+                ysDynamicArrayElement *target = static_cast<ysDynamicArrayElement *>(m_array[i]);
+                ysAllocator::TypeFree<TYPE>(m_array[i], 1, true, target->GetAlignment());
+                m_array[i] = nullptr;
             }
         }
 
@@ -202,31 +244,38 @@ public:
 
 protected:
     void Extend() {
-        TYPE **newArray = new TYPE * [m_maxSize * 2 + 1];
-        memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
-
-        delete[] m_array;
-
-        m_array = newArray;
-        m_maxSize *= 2;
-        m_maxSize++;
+        Resize(m_maxSize * 2 + 1);
     }
 
     void Condense() {
-        TYPE **newArray = new TYPE * [m_maxSize / 2 + 1];
-        memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
+        Resize(m_maxSize / 2);
+    }
+
+    void Resize(int newSize) {
+        if (newSize < m_nObjects) newSize = m_nObjects;
+        if (newSize == m_maxSize) return;
+
+        TYPE **newArray = nullptr;
+        if (newSize > 0) {
+            newArray = new TYPE * [newSize];
+            m_allocationCount++;
+
+            if (m_nObjects > 0) memcpy(newArray, m_array, sizeof(TYPE *) * m_nObjects);
+        }
 
         delete[] m_array;
 
         m_array = newArray;
-        m_maxSize /= 2;
-        m_maxSize++;
+        m_maxSize = newSize;
     }
 
 protected:
     TYPE **m_array;
     int m_maxSize;
+    int m_minSize;
     int m_nObjects;
+
+    int m_allocationCount;
 };
 
 #endif /* YDS_DYNAMIC_ARRAY_H */
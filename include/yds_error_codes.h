@@ -104,6 +104,7 @@ enum class ysError {
     InvalidFileType,
     UnsupportedFileVersion,
     CorruptedFile,
+    CouldNotWriteFile,
 
     UnsupportedType,
 };
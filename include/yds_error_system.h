@@ -4,14 +4,34 @@
 #include "yds_base.h"
 #include "yds_error_codes.h"
 
+#include <atomic>
+#include <mutex>
+
 class ysErrorHandler;
 
+#if defined(__GNUC__) || defined(__clang__)
+#define YDS_ERROR_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define YDS_ERROR_UNLIKELY(x) (x)
+#endif
+
+// --
+// Error reporting and call breadcrumbs.
+//
+// Every engine call pushes its name with YDS_ERROR_DECLARE and pops it again
+// when it returns through one of the YDS_ERROR_RETURN macros. The breadcrumb
+// stack is thread local so engine code can run on any thread, and returning
+// ysError::None never touches the error system instance or its handlers.
+//
+// Defining YDS_DISABLE_ERROR_STACK compiles the breadcrumbs out entirely;
+// GetCall() then always returns "<NO CALL>".
+// --
 class ysErrorSystem : public ysObject {
 protected:
     ysErrorSystem();
     ~ysErrorSystem();
 
-    static ysErrorSystem *g_instance;
+    static std::atomic<ysErrorSystem *> g_instance;
 
 public:
     static ysErrorSystem *GetInstance();
@@ -19,17 +39,56 @@ public:
 
     static const int MAX_STACK_LEVEL = 256;
 
+    // --
+    // Reports an error to all attached handlers. Safe to call from any thread.
+    // --
     ysError RaiseError(ysError error, unsigned int line, ysObject *object, const char *file, const char *msg, bool affectStack = true);
 
-    void StackRaise(const char *callName);
-    void StackDescend();
+    // --
+    // Fast path used by the YDS_ERROR_RETURN macros, the error system is only
+    // created and locked when an error actually occurs.
+    // --
+    static ysError Return(ysError error, unsigned int line, ysObject *object, const char *file, const char *msg, bool affectStack = true) {
+        if (YDS_ERROR_UNLIKELY(error != ysError::None)) {
+            return GetInstance()->RaiseError(error, line, object, file, msg, affectStack);
+        }
+
+        if (affectStack) StackDescend();
+        return error;
+    }
+
+#ifndef YDS_DISABLE_ERROR_STACK
+    static void StackRaise(const char *callName) {
+        CallStack &stack = t_callStack;
+        if (stack.Level < MAX_STACK_LEVEL) stack.Calls[stack.Level] = callName;
+        ++stack.Level;
+    }
+
+    static void StackDescend() { --t_callStack.Level; }
+
+    static const char *GetCall() {
+        const CallStack &stack = t_callStack;
+        if (stack.Level <= 0) return "<NO CALL>";
 
-    const char *GetCall() const { return (m_stackLevel > 0) ? m_callStack[m_stackLevel - 1] : "<NO CALL>"; }
+        return (stack.Level <= MAX_STACK_LEVEL)
+            ? stack.Calls[stack.Level - 1]
+            : stack.Calls[MAX_STACK_LEVEL - 1];
+    }
+
+    static int GetStackLevel() { return t_callStack.Level; }
+#else
+    static void StackRaise(const char *callName) { (void)callName; }
+    static void StackDescend() { /* void */ }
+    static const char *GetCall() { return "<NO CALL>"; }
+    static int GetStackLevel() { return 0; }
+#endif /* YDS_DISABLE_ERROR_STACK */
 
     template<typename T_ErrorHandler>
     ysError AttachErrorHandler(T_ErrorHandler **handler) {
         if (handler == nullptr) return ysError::InvalidParameter;
 
+        std::lock_guard<std::mutex> lock(m_handlerLock);
+
         // Create the new handler
         *handler = m_errorHandlers.NewGeneric<T_ErrorHandler>();
 
@@ -39,39 +98,46 @@ public:
     ysError DetachErrorHandler(ysErrorHandler *handler);
 
 protected:
-    ysDynamicArray<ysErrorHandler, 4> m_errorHandlers;
+#ifndef YDS_DISABLE_ERROR_STACK
+    struct CallStack {
+        int Level;
+        const char *Calls[MAX_STACK_LEVEL];
+    };
+
+    static thread_local CallStack t_callStack;
+#endif /* YDS_DISABLE_ERROR_STACK */
 
-    int m_stackLevel;
-    const char *m_callStack[MAX_STACK_LEVEL];
+    std::mutex m_handlerLock;
+    ysDynamicArray<ysErrorHandler, 4> m_errorHandlers;
 };
 
 #define _YDS_WIDE(_String) L ## _String
 #define YDS_WIDE(_String) _YDS_WIDE(_String)
 
-#define YDS_ERROR_RETURN(error) ysErrorSystem::GetInstance()->RaiseError(error, __LINE__, this, __FILE__, "")
+#define YDS_ERROR_RETURN(error) ysErrorSystem::Return(error, __LINE__, this, __FILE__, "")
 
 #define YDS_ERROR_RETURN_MANUAL()                \
-    ysErrorSystem::GetInstance()->StackDescend()
+    ysErrorSystem::StackDescend()
 
-#define YDS_ERROR_RETURN_STATIC(error) ysErrorSystem::GetInstance()->RaiseError(error, __LINE__, NULL, __FILE__, "")
+#define YDS_ERROR_RETURN_STATIC(error) ysErrorSystem::Return(error, __LINE__, NULL, __FILE__, "")
 
-#define YDS_ERROR_RAISE(error) ysErrorSystem::GetInstance()->RaiseError(error, __LINE__, this, __FILE__, "", false)
+#define YDS_ERROR_RAISE(error) ysErrorSystem::Return(error, __LINE__, this, __FILE__, "", false)
 
-#define YDS_ERROR_RETURN_MSG(error, msg) ysErrorSystem::GetInstance()->RaiseError(error, __LINE__, this, __FILE__, msg)
+#define YDS_ERROR_RETURN_MSG(error, msg) ysErrorSystem::Return(error, __LINE__, this, __FILE__, msg)
 
 #define YDS_NESTED_ERROR_CALL(call)                     \
 {                                                       \
                                                         \
     ysError code = (call);                              \
-    if (code != ysError::None)                  \
+    if (YDS_ERROR_UNLIKELY(code != ysError::None))      \
     {                                                   \
-        ysErrorSystem::GetInstance()->StackDescend();   \
+        ysErrorSystem::StackDescend();                  \
         return code;                                    \
     }                                                   \
                                                         \
 }
 
 #define YDS_ERROR_DECLARE(call) \
-    ysErrorSystem::GetInstance()->StackRaise(call)
+    ysErrorSystem::StackRaise(call)
 
 #endif /* YDS_ERROR_SYSTEM_H */
@@ -5,6 +5,7 @@
 
 #include <stdlib.h>
 #include <new>
+#include <utility>
 
 template<typename TYPE, int START_SIZE = 0, int ALIGNMENT = 1>
 class ysExpandingArray {
@@ -13,12 +14,38 @@ public:
         m_maxSize = START_SIZE;
         m_nObjects = 0;
         m_array = nullptr;
+        m_allocationCount = 0;
 
         Preallocate(m_maxSize);
     }
 
     ysExpandingArray(const ysExpandingArray &ref) {
-        /* void */
+        m_maxSize = 0;
+        m_nObjects = 0;
+        m_array = nullptr;
+        m_allocationCount = 0;
+
+        if (ref.m_maxSize == 0) return;
+
+        m_array = CreateArray(ref.m_maxSize, false);
+        for (int i = 0; i < ref.m_nObjects; i++) {
+            new ((void *)&m_array[i]) TYPE(ref.m_array[i]);
+        }
+
+        m_maxSize = ref.m_maxSize;
+        m_nObjects = ref.m_nObjects;
+    }
+
+    ysExpandingArray(ysExpandingArray &&ref) noexcept {
+        m_maxSize = ref.m_maxSize;
+        m_nObjects = ref.m_nObjects;
+        m_array = ref.m_array;
+        m_allocationCount = ref.m_allocationCount;
+
+        ref.m_maxSize = 0;
+        ref.m_nObjects = 0;
+        ref.m_array = nullptr;
+        ref.m_allocationCount = 0;
     }
 
     ysExpandingArray &operator=(const ysExpandingArray &ref) {
@@ -34,6 +61,24 @@ public:
         return *this;
     }
 
+    ysExpandingArray &operator=(ysExpandingArray &&ref) noexcept {
+        if (this == &ref) return *this;
+
+        Destroy();
+
+        m_maxSize = ref.m_maxSize;
+        m_nObjects = ref.m_nObjects;
+        m_array = ref.m_array;
+        m_allocationCount = ref.m_allocationCount;
+
+        ref.m_maxSize = 0;
+        ref.m_nObjects = 0;
+        ref.m_array = nullptr;
+        ref.m_allocationCount = 0;
+
+        return *this;
+    }
+
     ~ysExpandingArray() {
         Destroy();
     }
@@ -51,6 +96,7 @@ public:
     }
 
     TYPE *CreateArray(int nObjects, bool construct = true) {
+        m_allocationCount++;
         return ysAllocator::TypeAllocate<TYPE, ALIGNMENT>(nObjects, construct);
     }
 
@@ -104,6 +150,26 @@ public:
         m_nObjects = 0;
     }
 
+    // --
+    // Guarantee room for at least nObjects without reallocating. Unlike
+    // Preallocate(), existing contents are preserved.
+    // --
+    void Reserve(int nObjects) {
+        if (nObjects > m_maxSize) Resize(nObjects);
+    }
+
+    int GetCapacity() const {
+        return m_maxSize;
+    }
+
+    // --
+    // Number of times the backing buffer has been (re)allocated. Used to verify
+    // that steady-state workloads don't allocate.
+    // --
+    int GetAllocationCount() const {
+        return m_allocationCount;
+    }
+
     inline TYPE &New() {
         if (m_nObjects >= m_maxSize) Extend();
 
@@ -114,15 +180,16 @@ public:
         New();
 
         for (int i = (m_nObjects - 1); i > index; i--) {
-            m_array[i] = m_array[i - 1];
+            m_array[i] = std::move(m_array[i - 1]);
         }
 
         return m_array[index];
     }
 
     TYPE *GetBuffer() { return m_array; }
+    const TYPE *GetBuffer() const { return m_array; }
 
-    __forceinline TYPE &operator[](int index) {
+    inline TYPE &operator[](int index) {
         return m_array[index];
     }
 
@@ -145,14 +212,14 @@ public:
 
     void Delete(int index, bool maintainOrder = false) {
         if (maintainOrder) {
-            for (int i = index; i < m_nObjects; i++) {
-                m_array[i] = m_array[i + 1];
+            for (int i = index; i < m_nObjects - 1; i++) {
+                m_array[i] = std::move(m_array[i + 1]);
             }
 
             m_array[m_nObjects - 1] = nullptr;
         }
-        else {
-            m_array[index] = m_array[m_nObjects - 1];
+        else if (index != m_nObjects - 1) {
+            m_array[index] = std::move(m_array[m_nObjects - 1]);
         }
 
         m_nObjects--;
@@ -168,21 +235,30 @@ public:
 
 private:
     void Extend() {
-        TYPE *newArray = CreateArray(m_maxSize * 2 + 1);
+        Resize(m_maxSize * 2 + 1);
+    }
+
+    void Resize(int newSize) {
+        // Elements are moved rather than copied so that nested containers
+        // hand over their buffers instead of duplicating them. Only live
+        // elements are constructed, New() constructs the rest in place.
+        TYPE *newArray = CreateArray(newSize, false);
         for (int i = 0; i < m_nObjects; i++) {
-            newArray[i] = m_array[i];
+            new ((void *)&newArray[i]) TYPE(std::move(m_array[i]));
         }
 
+        // Destroys the moved-from originals
         DestroyArray(m_array);
 
         m_array = newArray;
-        m_maxSize *= 2;
-        m_maxSize += 1;
+        m_maxSize = newSize;
     }
 
     int m_maxSize;
     int m_nObjects;
     TYPE *m_array;
+
+    int m_allocationCount;
 };
 
 #endif /* YDS_EXPANDING_ARRAY_H */
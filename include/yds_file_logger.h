@@ -22,6 +22,7 @@ protected:
     virtual void Initialize();
     virtual void Close();
     virtual void Write(const char *data);
+    virtual void Flush();
 
     // File name
     char m_fname[256];
@@ -0,0 +1,117 @@
+#ifndef YDS_FRAME_ALLOCATOR_H
+#define YDS_FRAME_ALLOCATOR_H
+
+#include "yds_memory_base.h"
+
+// --
+// Linear (bump) allocator for memory that only needs to live for a frame.
+//
+// Two arenas are kept and swapped on every StartFrame() call, so a block
+// allocated during frame N stays valid until the start of frame N + 2.
+// Individual frees only run destructors, the memory itself is reclaimed
+// all at once when an arena is reset.
+//
+// If an arena runs out of space, the allocation falls back to the heap and
+// the arena is grown to fit the frame's demand the next time it is reset.
+// A workload with a steady per-frame footprint therefore stops hitting the
+// heap after the first couple of frames.
+//
+// NOTE: An allocator is not thread-safe; each thread should use its own
+// instance, for example the one returned by GetThreadAllocator().
+// --
+class ysFrameAllocator : public ysMemoryAllocator {
+public:
+    static constexpr int Alignment = 16;
+    static constexpr int ArenaCount = 2;
+
+public:
+    ysFrameAllocator();
+    ~ysFrameAllocator();
+
+    // --
+    // Allocate both arenas up front.
+    //
+    //   capacity: Size (bytes) of each arena
+    //
+    // --
+    void Initialize(size_t capacity);
+
+    // --
+    // Swap to the other arena and reset it. Blocks allocated two frames
+    // ago are invalidated.
+    // --
+    void StartFrame();
+
+    virtual void *AllocateBlock(int size, int numObjects = 1);
+    virtual int FreeBlock(void *block);
+    virtual void Destroy();
+
+    // --
+    // Returns the calling thread's frame allocator.
+    // --
+    static ysFrameAllocator *GetThreadAllocator();
+
+public:
+    /* STATISTICS */
+
+    // Number of allocations made since the last StartFrame()
+    int GetAllocationCount() const { return m_allocationCount; }
+
+    // Number of allocations made during the previous frame
+    int GetLastFrameAllocationCount() const { return m_lastFrameAllocationCount; }
+
+    // Number of allocations that didn't fit in the arena and went to the heap
+    int GetOverflowCount() const { return m_overflowCount; }
+
+    // Bytes allocated since the last StartFrame()
+    size_t GetBytesAllocated() const { return m_arenas[m_currentArena].Used; }
+
+    // Largest number of bytes allocated during a single frame
+    size_t GetHighWaterMark() const { return m_highWaterMark; }
+
+    // Capacity (bytes) of the active arena
+    size_t GetCapacity() const { return m_arenas[m_currentArena].Capacity; }
+
+protected:
+    struct OverflowBlock {
+        OverflowBlock *Next;
+    };
+
+    struct BlockHeader {
+        int NumObjects;
+        int Size;
+    };
+
+    struct Arena {
+        char *Data;
+        size_t Capacity;
+        size_t Offset;
+        size_t Used;
+
+        OverflowBlock *Overflow;
+    };
+
+    static constexpr size_t HeaderSize =
+        ((sizeof(BlockHeader) + Alignment - 1) / Alignment) * Alignment;
+    static constexpr size_t OverflowHeaderSize =
+        ((sizeof(OverflowBlock) + Alignment - 1) / Alignment) * Alignment;
+
+    void ResetArena(Arena *arena);
+    void FreeArena(Arena *arena);
+    void ReleaseOverflow(Arena *arena);
+
+    static size_t AlignSize(size_t size) {
+        return (size + Alignment - 1) & ~((size_t)Alignment - 1);
+    }
+
+protected:
+    Arena m_arenas[ArenaCount];
+    int m_currentArena;
+
+    int m_allocationCount;
+    int m_lastFrameAllocationCount;
+    int m_overflowCount;
+    size_t m_highWaterMark;
+};
+
+#endif /* YDS_FRAME_ALLOCATOR_H */
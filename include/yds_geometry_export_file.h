@@ -7,6 +7,8 @@
 #include "yds_interchange_object.h"
 
 #include <fstream>
+#include <stdint.h>
+#include <vector>
 
 class ysGeometryExportFile : public ysObject {
 public:
@@ -17,6 +19,13 @@ public:
     static const unsigned int MDF_TANGENTS = 0x04;
     static const unsigned int MDF_TEXTURE_DATA = 0x08;
     static const unsigned int MDF_ANIMATION_DATA = 0x10;
+    static const unsigned int MDF_32BIT_INDICES = 0x20;
+    static const unsigned int MDF_SUBMESHES = 0x40;
+    static const unsigned int MDF_QUANTIZED = 0x80;
+    static const unsigned int MDF_LODS = 0x100;
+
+    // Vertices addressable by 16 bit indices, 0xFFFF is left free for primitive restart
+    static constexpr int MaxShortIndexVertexCount = 0xFFFF;
 
     struct VertexInfo {
         bool IncludeTangents = false;
@@ -24,6 +33,14 @@ public:
         bool IncludeUVs = true;
 
         int UVChannels = 1;
+
+        // --
+        // Store vertices in 16 bit formats: positions as R16G16B16A16_UNORM
+        // across the object's MinExtreme to MaxExtreme, UVs as R16G16_FLOAT,
+        // normals and tangents octahedral encoded as R16G16_SNORM. Tangent
+        // handedness isn't stored and decodes as +1.
+        // --
+        bool Quantize = false;
     };
 
     struct ObjectOutputHeader {
@@ -56,22 +73,175 @@ public:
         int VertexDataSize;
     };
 
+    // --
+    // Version 1 files are a bare object count written by the caller with
+    // WriteCustomData() followed by one record per object: the header,
+    // then vertex, index and bone data packed back to back.
+    //
+    // Version 2 files start with a SceneFileHeader and end with a table
+    // of contents and a hash table of object names, so any object can be
+    // located without parsing the ones before it. Object headers and
+    // index blobs start on 16 byte boundaries and vertex blobs on 64 byte
+    // boundaries so they can be used directly from a memory mapping.
+    //
+    // Version 2 files may also store a 64 bit content hash per object so
+    // that the compiler can tell which objects need to be rebuilt.
+    //
+    // Indices are 16 bit unless the object has MDF_32BIT_INDICES set.
+    // Meshes split to keep 16 bit indices have MDF_SUBMESHES set and store
+    // a Submesh array as their extra data, which needs version 2.
+    //
+    // Meshes with levels of detail have MDF_LODS and MDF_SUBMESHES set.
+    // Their extra data is a LodTableHeader followed by the Lod and Submesh
+    // arrays, and the index data holds every level back to back. NumFaces
+    // is the face count of the full detail mesh.
+    // --
+    static constexpr uint32_t SceneFileMagic = 0x45435359; // "YSCE"
+    static constexpr int CurrentVersion = 2;
+
+    static constexpr int HeaderAlignment = 16;
+    static constexpr int VertexDataAlignment = 64;
+    static constexpr int IndexDataAlignment = 16;
+
+    struct SceneFileHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t ObjectCount;
+        uint32_t NameTableSize;
+
+        uint64_t TocOffset;
+        uint64_t NameTableOffset;
+        uint64_t FileSize;
+
+        // One uint64_t per object, or 0 if no content hashes were stored
+        uint64_t ContentHashOffset;
+    };
+
+    struct TocEntry {
+        uint64_t HeaderOffset;
+        uint64_t VertexDataOffset;
+        uint64_t IndexDataOffset;
+        uint64_t BoneDataOffset;
+        uint64_t ExtraDataOffset;
+
+        uint32_t VertexDataSize;
+        uint32_t IndexDataSize;
+        uint32_t BoneDataSize;
+        uint32_t ExtraDataSize;
+
+        uint32_t NameHash;
+        uint32_t Reserved;
+    };
+
+    // --
+    // The name table is an open addressed hash table with a power of two
+    // number of slots. Each slot holds an object index plus one, zero marks
+    // an empty slot. Collisions are resolved by linear probing.
+    // --
+    static uint32_t HashName(const char *name);
+
+    // --
+    // Part of a split mesh. Indices of a submesh are relative to its base
+    // vertex so that each one can be drawn with 16 bit indices.
+    // --
+    struct Submesh {
+        int BaseIndex;
+        int FaceCount;
+        int BaseVertex;
+        int VertexCount;
+    };
+
+    // --
+    // A level of detail, drawn as a range of the submesh table. Error is
+    // how far the surface may have moved from the full detail mesh, in
+    // the object's units.
+    // --
+    struct Lod {
+        int FirstSubmesh;
+        int SubmeshCount;
+        int FaceCount;
+        float Error;
+    };
+
+    struct LodTableHeader {
+        int LodCount;
+        int SubmeshCount;
+        int Reserved[2];
+    };
+
+    static int GetIndexSize(const ObjectOutputHeader &header) {
+        return (header.Flags & MDF_32BIT_INDICES) ? (int)sizeof(uint32_t) : (int)sizeof(uint16_t);
+    }
+
+    // --
+    // An object packed into its file layout but not written yet. Packing
+    // doesn't touch the file, so objects can be compiled on any thread and
+    // written in order afterwards.
+    // --
+    struct CompiledObject {
+        ObjectOutputHeader Header;
+
+        std::vector<char> VertexData;
+
+        // Written as 16 bit unless the header has MDF_32BIT_INDICES set
+        std::vector<unsigned int> Indices;
+
+        std::vector<int> Bones;
+        std::vector<float> ExtraData;
+
+        // Empty unless the header has MDF_SUBMESHES set
+        std::vector<Submesh> Submeshes;
+
+        // Empty unless the header has MDF_LODS set
+        std::vector<Lod> Lods;
+
+        // Zero if unknown
+        uint64_t ContentHash = 0;
+    };
+
 public:
     ysGeometryExportFile();
     ~ysGeometryExportFile();
 
-    ysError Open(const char *fname);
-    void Close();
+    ysError Open(const char *fname, int version = CurrentVersion);
+
+    // Writes the table of contents of version 2 files
+    ysError Close();
+
+    int GetVersion() const { return m_version; }
 
     ysError WriteCustomData(void *data, int size);
     ysError WriteObject(ysObjectData *object);
     ysError WriteObject(ysInterchangeObject *object, const VertexInfo *info = nullptr);
+    ysError WriteObject(const CompiledObject &object);
+
+    // Safe to call from several threads at once
+    void CompileObject(ysObjectData *object, CompiledObject *output);
+    void CompileObject(ysInterchangeObject *object, const VertexInfo *info, CompiledObject *output);
 
 protected:
+    ysError WriteRecord(
+        const ObjectOutputHeader &header,
+        const void *vertexData,
+        const void *indexData,
+        uint32_t indexDataSize,
+        const std::vector<int> &bones,
+        const void *extraData,
+        uint32_t extraDataSize,
+        uint64_t contentHash = 0);
+
+    // Returns false if an index doesn't fit in 16 bits
+    static bool PackIndices(const std::vector<unsigned int> &indices, bool wide, std::vector<char> *output);
+
+    void Align(int alignment);
+    uint64_t GetPosition() { return (uint64_t)m_file.tellp(); }
+
     int GetVertexSize(ysInterchangeObject *object, const VertexInfo *info);
 
     void WriteIntToBuffer(int value, char **buffer);
     void WriteFloatToBuffer(float value, char **buffer);
+    void WriteShortToBuffer(uint16_t value, char **buffer);
+    void WriteOctahedralToBuffer(const ysVector3 &v, char **buffer);
 
     int PackVertexData(ysObjectData *object, int maxBonesPerVertex, void **output);
     int PackVertexData(ysInterchangeObject *object, int maxBonesPerVertex, void **output, const VertexInfo *info);
@@ -80,6 +250,10 @@ protected:
 
 protected:
     std::ofstream m_file;
+
+    int m_version;
+    std::vector<TocEntry> m_toc;
+    std::vector<uint64_t> m_contentHashes;
 };
 
 #endif /* YDS_GEOMETRY_EXPORT_FILE_H */
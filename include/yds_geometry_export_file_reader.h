@@ -0,0 +1,99 @@
+#ifndef YDS_GEOMETRY_EXPORT_FILE_READER_H
+#define YDS_GEOMETRY_EXPORT_FILE_READER_H
+
+#include "yds_base.h"
+
+#include "yds_geometry_export_file.h"
+#include "yds_memory_mapped_file.h"
+
+#include <vector>
+
+// --
+// Reads scene files written by ysGeometryExportFile through a memory
+// mapping. Vertex, index and bone data are returned as pointers into the
+// mapping and stay valid until the reader is closed.
+//
+// Version 2 files are accessed through their table of contents, so
+// reading or looking up a single object doesn't touch the rest of the
+// file. Version 1 files are scanned once when opened.
+// --
+class ysGeometryExportFileReader : public ysObject {
+public:
+    struct Object {
+        // Copied out of the file, version 1 files give no alignment guarantees
+        ysGeometryExportFile::ObjectOutputHeader Header;
+
+        const char *VertexData;
+        const char *IndexData;
+        const char *BoneData;
+        const char *ExtraData;
+
+        int VertexDataSize;
+        int IndexDataSize;
+        int BoneDataSize;
+        int ExtraDataSize;
+    };
+
+public:
+    ysGeometryExportFileReader();
+    ~ysGeometryExportFileReader();
+
+    ysError Open(const char *fname);
+
+    // Reads from memory owned by the caller, which must outlive the reader
+    ysError Open(const char *data, size_t size);
+
+    void Close();
+
+    int GetVersion() const { return m_version; }
+    int GetObjectCount() const { return m_objectCount; }
+
+    ysError ReadObject(int index, Object *object);
+
+    // Index of the first object with the given name, or -1
+    int FindObject(const char *name);
+
+    // Content hash recorded by the compiler, or 0 if the file doesn't have one
+    uint64_t GetContentHash(int index) const;
+
+    // --
+    // Submeshes of a geometry object, for every level of detail. Objects
+    // that weren't split give a single submesh covering the whole mesh.
+    // Returns false if the table is malformed.
+    // --
+    static bool GetSubmeshes(const Object &object, std::vector<ysGeometryExportFile::Submesh> *submeshes);
+
+    // --
+    // Levels of detail of a geometry object, finest first, and the
+    // submeshes they refer to. Objects without levels of detail give one
+    // covering all of their submeshes.
+    // --
+    static bool GetLods(
+        const Object &object,
+        std::vector<ysGeometryExportFile::Lod> *lods,
+        std::vector<ysGeometryExportFile::Submesh> *submeshes);
+
+protected:
+    ysError OpenVersion1();
+    ysError OpenVersion2();
+
+    bool ReadObjectVersion2(int index, Object *object) const;
+    bool IsInBounds(uint64_t offset, uint64_t size) const;
+
+protected:
+    ysMemoryMappedFile m_file;
+
+    const char *m_data;
+    size_t m_size;
+
+    int m_version;
+    int m_objectCount;
+
+    // Version 2
+    ysGeometryExportFile::SceneFileHeader m_header;
+
+    // Version 1
+    std::vector<Object> m_objects;
+};
+
+#endif /* YDS_GEOMETRY_EXPORT_FILE_READER_H */
@@ -3,8 +3,27 @@
 
 #include "yds_object_data.h"
 
+#include <vector>
+
 namespace ysGeometryPreprocessing {
 
+    // --
+    // Faces around every vertex, stored as one flat array with an offset
+    // per vertex. Built once per pass from the vertex index sets so that
+    // neighbour queries only look at faces that share a vertex instead of
+    // scanning the whole mesh.
+    // --
+    struct FaceAdjacency {
+        // NumVertices + 1 entries, faces of vertex v are [Offsets[v], Offsets[v + 1])
+        std::vector<int> Offsets;
+        std::vector<int> Faces;
+
+        int GetFaceCount(int vertex) const { return Offsets[vertex + 1] - Offsets[vertex]; }
+        const int *GetFaces(int vertex) const { return Faces.data() + Offsets[vertex]; }
+    };
+
+    void BuildFaceAdjacency(ysObjectData *object, FaceAdjacency *adjacency);
+
     bool ConnectedFaces(ysObjectData *object, int face1, int face2);
     bool SameSmoothingGroup(ysObjectData *object, int face1, int face2);
     bool IncludesVertex(ysObjectData *object, int face, int vertex);
@@ -28,7 +47,14 @@ namespace ysGeometryPreprocessing {
     ysVector *CalculateHardTangents(ysObjectData *object, int mapChannel);
     void CalculateTangents(ysObjectData *object, int mapChannel);
 
-    void SpreadSmoothingGroup(ysObjectData *object, int face, int group, ysVector *tempNormals, int *count);
+    // --
+    // Floods group out from face over neighbours that face the same way.
+    // The adjacency is built by the caller so that spreading many groups
+    // over one mesh only builds it once.
+    // --
+    void SpreadSmoothingGroup(
+        ysObjectData *object, const FaceAdjacency &adjacency,
+        int face, int group, ysVector *tempNormals, int *count);
 
     void SortBoneWeights(ysObjectData *object, bool normalize = true, int maxBoneCount = 3);
 
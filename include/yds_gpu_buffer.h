@@ -16,6 +16,12 @@ public:
         GPU_UNDEFINED_BUFFER
     };
 
+    // Width of the indices in an index buffer
+    enum class IndexFormat {
+        UInt16,
+        UInt32
+    };
+
 public:
     ysGPUBuffer();
     ysGPUBuffer(DeviceAPI API);
@@ -26,8 +32,12 @@ public:
 
     GPU_BUFFER_TYPE GetType() const { return m_bufferType; }
 
+    IndexFormat GetIndexFormat() const { return m_indexFormat; }
+    int GetIndexSize() const { return (m_indexFormat == IndexFormat::UInt32) ? 4 : 2; }
+
 protected:
     GPU_BUFFER_TYPE m_bufferType;
+    IndexFormat m_indexFormat;
 
     char *m_RAMMirror;
     int m_size;
@@ -3,6 +3,7 @@
 
 #include "yds_math.h"
 
+#include <stdint.h>
 #include <vector>
 #include <string>
 
@@ -67,6 +68,12 @@ public:
     void RipByUVs();
 
     void UniformScale(float scale);
+
+    // --
+    // 64 bit hash of everything that affects the compiled object, used to
+    // tell whether an object changed since the last compile.
+    // --
+    uint64_t GetContentHash() const;
 };
 
 #endif /* YDS_INTERCHANGE_OBJECT_H */
@@ -0,0 +1,244 @@
+#ifndef YDS_JOB_SYSTEM_H
+#define YDS_JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+// --
+// Tracks the completion of a group of jobs.
+//
+// The counter is incremented by the number of jobs when they are submitted
+// and decremented as each one finishes, so a value of zero means the whole
+// group is done. Waiting on a counter is how dependencies are expressed.
+// --
+class ysJobCounter {
+    friend class ysJobSystem;
+
+public:
+    ysJobCounter() : m_value(0) { /* void */ }
+    ~ysJobCounter() { /* void */ }
+
+    ysJobCounter(const ysJobCounter &) = delete;
+    ysJobCounter &operator=(const ysJobCounter &) = delete;
+
+    bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+    int GetValue() const { return m_value.load(std::memory_order_acquire); }
+
+protected:
+    std::atomic<int> m_value;
+};
+
+// --
+// Work-stealing job scheduler.
+//
+// Every worker owns a fixed-size Chase-Lev deque: the owner pushes and pops
+// jobs at the bottom while idle workers steal from the top, so the common
+// path never takes a lock. The thread that calls Initialize() becomes
+// worker 0 and runs jobs whenever it waits on a counter. Threads that
+// aren't workers submit through a bounded lock-free MPMC queue.
+//
+// Waits never block on the OS while there is work available. A waiting
+// thread keeps running other jobs (including ones unrelated to the
+// counter) until its counter reaches zero, which avoids the need for
+// fibers. Workers with nothing to do go to sleep and are woken on submit.
+// --
+class ysJobSystem {
+public:
+    typedef void (*JobFunction)(void *data, int index);
+
+    struct Job {
+        JobFunction Function;
+        void *Data;
+        int Index;
+    };
+
+    static constexpr int MaxWorkers = 64;
+    static constexpr int DequeCapacity = 4096;
+    static constexpr int InjectionQueueCapacity = 4096;
+
+public:
+    ysJobSystem();
+    ~ysJobSystem();
+
+    // --
+    // Start the worker threads.
+    //
+    //   workerCount: Total number of workers including the calling thread,
+    //                or 0 to use one per hardware thread
+    // --
+    void Initialize(int workerCount = 0);
+
+    // --
+    // Stop and join all worker threads. Jobs still queued are run first.
+    // --
+    void Destroy();
+
+    // --
+    // Submit a job. If counter is set it's incremented now and decremented
+    // once the job has run.
+    // --
+    void Run(const Job &job, ysJobCounter *counter = nullptr);
+    void Run(const Job *jobs, int count, ysJobCounter *counter = nullptr);
+
+    // --
+    // Run queued jobs on the calling thread until the counter reaches zero.
+    // --
+    void Wait(ysJobCounter *counter);
+
+    // --
+    // Run a single queued job on the calling thread if there is one.
+    // Returns false if no job could be found.
+    // --
+    bool RunPendingJob();
+
+    // --
+    // Call function(begin, end) over sub-ranges of [begin, end) in parallel
+    // and wait for all of them to finish. Ranges are never smaller than
+    // granularity (except for the last one).
+    // --
+    template <typename T_Function>
+    void ParallelFor(int begin, int end, int granularity, const T_Function &function) {
+        const int count = end - begin;
+        if (count <= 0) return;
+
+        RangeData<T_Function> range;
+        range.Function = &function;
+        range.Begin = begin;
+        range.End = end;
+        range.ChunkSize = GetChunkSize(count, granularity);
+
+        const int chunks = (count + range.ChunkSize - 1) / range.ChunkSize;
+        if (chunks == 1) {
+            function(begin, end);
+            return;
+        }
+
+        ysJobCounter counter;
+        RunBatch(&RunRange<T_Function>, &range, chunks, &counter);
+        Wait(&counter);
+    }
+
+    int GetWorkerCount() const { return m_workerCount; }
+
+    // --
+    // Returns the worker index of the calling thread, or -1 if the thread
+    // isn't one of this system's workers.
+    // --
+    int GetCurrentWorkerIndex() const;
+
+public:
+    /* STATISTICS */
+
+    // Number of jobs run since Initialize()
+    uint64_t GetJobsExecuted() const;
+
+    // Number of jobs taken from another worker's deque
+    uint64_t GetJobsStolen() const;
+
+protected:
+    struct JobSlot {
+        std::atomic<JobFunction> Function;
+        std::atomic<void *> Data;
+        std::atomic<int> Index;
+        std::atomic<ysJobCounter *> Counter;
+
+        void Store(const Job &job, ysJobCounter *counter);
+        void Load(Job *job, ysJobCounter **counter) const;
+    };
+
+    // Single producer (the owner), multiple consumer work-stealing deque
+    class WorkDeque {
+    public:
+        WorkDeque();
+
+        bool Push(const Job &job, ysJobCounter *counter);
+        bool Pop(Job *job, ysJobCounter **counter);
+        bool Steal(Job *job, ysJobCounter **counter);
+
+        bool IsEmpty() const;
+
+    protected:
+        alignas(64) std::atomic<int64_t> m_top;
+        alignas(64) std::atomic<int64_t> m_bottom;
+        alignas(64) JobSlot m_slots[DequeCapacity];
+    };
+
+    // Bounded multiple producer, multiple consumer queue
+    class InjectionQueue {
+    public:
+        InjectionQueue();
+
+        bool Push(const Job &job, ysJobCounter *counter);
+        bool Pop(Job *job, ysJobCounter **counter);
+
+    protected:
+        struct Cell {
+            std::atomic<int64_t> Sequence;
+            JobSlot Slot;
+        };
+
+        alignas(64) std::atomic<int64_t> m_enqueuePosition;
+        alignas(64) std::atomic<int64_t> m_dequeuePosition;
+        alignas(64) Cell m_cells[InjectionQueueCapacity];
+    };
+
+    struct alignas(64) Worker {
+        WorkDeque Deque;
+        std::thread Thread;
+
+        std::atomic<uint64_t> JobsExecuted;
+        std::atomic<uint64_t> JobsStolen;
+        unsigned int RandomState;
+    };
+
+    template <typename T_Function>
+    struct RangeData {
+        const T_Function *Function;
+        int Begin;
+        int End;
+        int ChunkSize;
+    };
+
+    template <typename T_Function>
+    static void RunRange(void *data, int index) {
+        RangeData<T_Function> *range = reinterpret_cast<RangeData<T_Function> *>(data);
+
+        const int begin = range->Begin + index * range->ChunkSize;
+        const int end = (range->End - begin < range->ChunkSize)
+            ? range->End
+            : begin + range->ChunkSize;
+
+        (*range->Function)(begin, end);
+    }
+
+    // Submit count jobs that share a function and data, with indices 0..count-1
+    void RunBatch(JobFunction function, void *data, int count, ysJobCounter *counter);
+
+    int GetChunkSize(int count, int granularity) const;
+
+    bool Submit(const Job &job, ysJobCounter *counter);
+    bool FindJob(int workerIndex, Job *job, ysJobCounter **counter);
+    void Execute(int workerIndex, const Job &job, ysJobCounter *counter);
+
+    void WakeWorkers();
+    void WorkerLoop(int workerIndex);
+
+protected:
+    Worker *m_workers;
+    int m_workerCount;
+
+    InjectionQueue *m_injectionQueue;
+
+    std::atomic<bool> m_running;
+
+    // Sleeping workers wait for m_wakeSignal to change
+    std::atomic<uint64_t> m_wakeSignal;
+    std::atomic<int> m_sleepingWorkers;
+    std::mutex m_sleepLock;
+    std::condition_variable m_wakeCondition;
+};
+
+#endif /* YDS_JOB_SYSTEM_H */
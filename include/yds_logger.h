@@ -4,6 +4,15 @@
 #include "yds_dynamic_array.h"
 #include "yds_logger_output.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <time.h>
+
 class ysLoggerMessageLevel
 {
 
@@ -19,9 +28,132 @@ public:
 
 };
 
+// --
+// Deferred formatting logger.
+//
+// Logging a message only copies the format string pointer and the arguments
+// into a single producer ring owned by the calling thread. A background
+// thread started by Start() drains all rings, formats the messages in
+// timestamp order and hands them to the outputs in batches.
+//
+// NOTE: Format strings and file names must outlive the logger (in practice
+// they are string literals). String arguments are copied and truncated to
+// fit in a record.
+// --
 class ysLogger
 {
 
+public:
+
+    // What happens when the calling thread's ring is full
+    enum class OverflowPolicy
+    {
+        Drop,           // Discard the message and count it
+        Block,          // Wait for the background thread to make room
+        Synchronous     // Format and write the message on the calling thread
+    };
+
+    enum class ArgumentType : uint8_t
+    {
+        Int,
+        UnsignedInt,
+        Double,
+        Pointer,
+        String
+    };
+
+    static constexpr int MaxThreads = 64;
+    static constexpr int RingCapacity = 1024;
+    static constexpr int RecordSize = 256;
+    static constexpr int FlushInterval_ms = 10;
+
+    struct RecordHeader
+    {
+        uint64_t Timestamp;
+        const char *Format;
+        const char *File;
+        int Line;
+        int Level;
+        uint16_t PayloadSize;
+        uint8_t ArgumentCount;
+        bool Truncated;
+    };
+
+    struct Record
+    {
+        RecordHeader Header;
+        unsigned char Payload[RecordSize - sizeof(RecordHeader)];
+    };
+
+    // Appends typed arguments to a record's payload
+    class ArgumentWriter
+    {
+
+    public:
+
+        ArgumentWriter(Record *record) : m_record(record) { /* void */ }
+
+        void WriteInt(int64_t value) { WriteScalar(ArgumentType::Int, &value, sizeof(value)); }
+        void WriteUnsignedInt(uint64_t value) { WriteScalar(ArgumentType::UnsignedInt, &value, sizeof(value)); }
+        void WriteDouble(double value) { WriteScalar(ArgumentType::Double, &value, sizeof(value)); }
+        void WritePointer(const void *value) { const uint64_t p = (uint64_t)(uintptr_t)value; WriteScalar(ArgumentType::Pointer, &p, sizeof(p)); }
+
+        void WriteString(const char *value)
+        {
+
+            if (value == nullptr) value = "(null)";
+
+            RecordHeader &header = m_record->Header;
+            const size_t offset = header.PayloadSize;
+            const size_t prefix = 1 + sizeof(uint16_t);
+            if (header.Truncated || offset + prefix > sizeof(m_record->Payload))
+            {
+                header.Truncated = true;
+                return;
+            }
+
+            size_t length = strlen(value);
+            if (length > sizeof(m_record->Payload) - offset - prefix)
+            {
+                length = sizeof(m_record->Payload) - offset - prefix;
+                header.Truncated = true;
+            }
+
+            const uint16_t storedLength = (uint16_t)length;
+            m_record->Payload[offset] = (unsigned char)ArgumentType::String;
+            memcpy(m_record->Payload + offset + 1, &storedLength, sizeof(storedLength));
+            memcpy(m_record->Payload + offset + prefix, value, length);
+
+            header.PayloadSize = (uint16_t)(offset + prefix + length);
+            ++header.ArgumentCount;
+
+        }
+
+    protected:
+
+        void WriteScalar(ArgumentType type, const void *value, size_t size)
+        {
+
+            RecordHeader &header = m_record->Header;
+            const size_t offset = header.PayloadSize;
+            if (header.Truncated || offset + 1 + size > sizeof(m_record->Payload))
+            {
+                header.Truncated = true;
+                return;
+            }
+
+            m_record->Payload[offset] = (unsigned char)type;
+            memcpy(m_record->Payload + offset + 1, value, size);
+
+            header.PayloadSize = (uint16_t)(offset + 1 + size);
+            ++header.ArgumentCount;
+
+        }
+
+        Record *m_record;
+
+    };
+
 protected:
 
     static ysLogger *g_instance;
@@ -47,39 +179,179 @@ public:
 
     }
 
-    void LogMessage(const char *message, const char *fname, int line, int level, ...);
+    // --
+    // printf style formatting, but the message is only formatted once it
+    // reaches the background thread. Arguments must be integers, floating
+    // point numbers, C strings or pointers.
+    // --
+    template<typename ... Args>
+    void LogMessage(const char *message, const char *fname, int line, int level, Args ... args)
+    {
+
+        Record *record = BeginRecord(message, fname, line, level);
+        if (record == nullptr) return;
+
+        ArgumentWriter writer(record);
+        int expand[] = { 0, (EncodeArgument(writer, args), 0)... };
+        (void)expand;
+
+        CommitRecord(record);
+
+    }
 
     void AddMessageLevel(int level, const char *name);
 
     // Get the name corresponding to a level
     const char *GetLevelName(int level) { return m_messageLevels[level].m_name; }
 
+    void SetOverflowPolicy(OverflowPolicy policy) { m_overflowPolicy = policy; }
+    OverflowPolicy GetOverflowPolicy() const { return m_overflowPolicy; }
+
+    // Messages discarded by the Drop policy
+    uint64_t GetDroppedMessageCount() const;
+
     // Start the logging session
     void Start();
 
+    // Write out every message logged so far
+    void Flush();
+
     // End the logging session
     void End();
 
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // --
+    // Formats a record into a null terminated string, exposed for the tests.
+    // --
+    static void FormatRecord(const Record &record, char *buffer, size_t bufferSize);
+
+protected:
+
+    struct ThreadRing
+    {
+        Record Records[RingCapacity];
+
+        // Head is written by the owning thread, tail by the consumer
+        alignas(64) std::atomic<uint64_t> Head;
+        alignas(64) std::atomic<uint64_t> Tail;
+        std::atomic<uint64_t> Dropped;
+    };
+
+    static void EncodeArgument(ArgumentWriter &writer, bool value) { writer.WriteInt(value ? 1 : 0); }
+    static void EncodeArgument(ArgumentWriter &writer, char value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, signed char value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, unsigned char value) { writer.WriteUnsignedInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, short value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, unsigned short value) { writer.WriteUnsignedInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, int value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, unsigned int value) { writer.WriteUnsignedInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, long value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, unsigned long value) { writer.WriteUnsignedInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, long long value) { writer.WriteInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, unsigned long long value) { writer.WriteUnsignedInt(value); }
+    static void EncodeArgument(ArgumentWriter &writer, float value) { writer.WriteDouble(value); }
+    static void EncodeArgument(ArgumentWriter &writer, double value) { writer.WriteDouble(value); }
+    static void EncodeArgument(ArgumentWriter &writer, const char *value) { writer.WriteString(value); }
+    static void EncodeArgument(ArgumentWriter &writer, char *value) { writer.WriteString(value); }
+    static void EncodeArgument(ArgumentWriter &writer, const void *value) { writer.WritePointer(value); }
+    static void EncodeArgument(ArgumentWriter &writer, std::nullptr_t) { writer.WritePointer(nullptr); }
+
+    // Reserves a record in the calling thread's ring, or a scratch record
+    // if the message has to be written synchronously
+    Record *BeginRecord(const char *message, const char *fname, int line, int level);
+    void CommitRecord(Record *record);
+
+    ThreadRing *GetThreadRing();
+
+    void WriteRecord(const Record &record);
+    void ProcessPending();
+    void WorkerThread();
+
 protected:
 
     ysDynamicArray<ysLoggerOutput, 4> m_loggerOutputs;
     ysLoggerMessageLevel m_messageLevels[256];
 
+    OverflowPolicy m_overflowPolicy;
+    int m_generation;
+
+    std::atomic<ThreadRing *> m_threadRings[MaxThreads];
+    std::atomic<int> m_threadCount;
+
+    std::atomic<bool> m_running;
+    bool m_stopping;
+    std::thread m_worker;
+    std::mutex m_workerLock;
+    std::condition_variable m_workerCondition;
+
+    // Held while draining the rings and while writing to the outputs
+    std::mutex m_consumerLock;
+    std::mutex m_outputLock;
+
+    // Wall clock time matching the timestamp clock at Start()
+    time_t m_startTime;
+    uint64_t m_startTimestamp;
+
     void Initialize();
 
 };
 
+#define YDS_LOG_LEVEL_DEBUG     0
+#define YDS_LOG_LEVEL_INFO      10
+#define YDS_LOG_LEVEL_WARNING   20
+#define YDS_LOG_LEVEL_ERROR     30
+#define YDS_LOG_LEVEL_CRITICAL  40
+
+// Messages below this level are compiled out
+#ifndef YDS_LOG_MIN_LEVEL
+#define YDS_LOG_MIN_LEVEL YDS_LOG_LEVEL_DEBUG
+#endif
+
 #define __FILENAME__ (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__)
 
 #ifdef YS_ENABLE_LOGGING
 
-#define ysLogMessage(message, level, ...) \
-    ysLogger::Logger()->LogMessage(message, __FILENAME__, __LINE__, level, __VA_ARGS__);
+#define ysLogMessage(message, level, ...)                                                           \
+    do {                                                                                            \
+        if ((level) >= YDS_LOG_MIN_LEVEL)                                                           \
+            ysLogger::Logger()->LogMessage(message, __FILENAME__, __LINE__, level, ##__VA_ARGS__);  \
+    } while (false);
 
 #else
 
-#define ysLogMessage(message, level) ;
+#define ysLogMessage(message, level, ...) ;
 
 #endif
 
-#endif
\ No newline at end of file
+#if defined(YS_ENABLE_LOGGING) && (YDS_LOG_MIN_LEVEL <= YDS_LOG_LEVEL_DEBUG)
+#define ysLogDebug(message, ...) ysLogMessage(message, YDS_LOG_LEVEL_DEBUG, ##__VA_ARGS__)
+#else
+#define ysLogDebug(message, ...) ;
+#endif
+
+#if defined(YS_ENABLE_LOGGING) && (YDS_LOG_MIN_LEVEL <= YDS_LOG_LEVEL_INFO)
+#define ysLogInfo(message, ...) ysLogMessage(message, YDS_LOG_LEVEL_INFO, ##__VA_ARGS__)
+#else
+#define ysLogInfo(message, ...) ;
+#endif
+
+#if defined(YS_ENABLE_LOGGING) && (YDS_LOG_MIN_LEVEL <= YDS_LOG_LEVEL_WARNING)
+#define ysLogWarning(message, ...) ysLogMessage(message, YDS_LOG_LEVEL_WARNING, ##__VA_ARGS__)
+#else
+#define ysLogWarning(message, ...) ;
+#endif
+
+#if defined(YS_ENABLE_LOGGING) && (YDS_LOG_MIN_LEVEL <= YDS_LOG_LEVEL_ERROR)
+#define ysLogError(message, ...) ysLogMessage(message, YDS_LOG_LEVEL_ERROR, ##__VA_ARGS__)
+#else
+#define ysLogError(message, ...) ;
+#endif
+
+#if defined(YS_ENABLE_LOGGING) && (YDS_LOG_MIN_LEVEL <= YDS_LOG_LEVEL_CRITICAL)
+#define ysLogCritical(message, ...) ysLogMessage(message, YDS_LOG_LEVEL_CRITICAL, ##__VA_ARGS__)
+#else
+#define ysLogCritical(message, ...) ;
+#endif
+
+#endif
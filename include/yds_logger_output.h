@@ -3,6 +3,8 @@
 
 #include "yds_base.h"
 
+#include <time.h>
+
 class ysLogger;
 
 class ysLoggerOutput : public ysObject {
@@ -25,7 +27,7 @@ public:
 public:
     ysLoggerOutput();
     ysLoggerOutput(const char *typeID);
-    ~ysLoggerOutput();
+    virtual ~ysLoggerOutput();
 
     /* Initialize the output */
     virtual void Initialize() = 0;
@@ -40,7 +42,10 @@ public:
     bool GetEnable() const { return m_enabled; }
 
     // Log a message
-    void LogMessage(const char *message, const char *fname, int line, int level);
+    void LogMessage(const char *message, const char *fname, int line, int level, time_t timestamp);
+
+    // Called after each batch of messages is written
+    virtual void Flush() { /* void */ }
 
     // Set format parameters
     void SetFormatParameters(unsigned int formatParameters) { m_formatParameters = formatParameters; }
@@ -118,7 +118,11 @@ struct ysMatrix33 {
     };
 };
 
+#if defined(_MSC_VER)
 #define YS_MATH_CONST extern const __declspec(selectany)
+#else
+#define YS_MATH_CONST inline const
+#endif
 
 namespace ysMath {
 
@@ -0,0 +1,44 @@
+#ifndef YDS_MEMORY_MAPPED_FILE_H
+#define YDS_MEMORY_MAPPED_FILE_H
+
+#include "yds_base.h"
+
+#include <stddef.h>
+
+// --
+// Read-only view of an entire file mapped into the address space. Pages
+// are faulted in by the OS on first access, so nothing is copied until the
+// data is actually touched and callers can hand out pointers into the
+// mapping instead of reading into scratch buffers.
+// --
+class ysMemoryMappedFile : public ysObject {
+public:
+    ysMemoryMappedFile();
+    ~ysMemoryMappedFile();
+
+    ysMemoryMappedFile(const ysMemoryMappedFile &) = delete;
+    ysMemoryMappedFile &operator=(const ysMemoryMappedFile &) = delete;
+
+    ysError Open(const char *fname);
+    void Close();
+
+    bool IsOpen() const { return m_open; }
+
+    // Valid until Close() is called or the object is destroyed
+    const char *GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+protected:
+    const char *m_data;
+    size_t m_size;
+
+    // Empty files can't be mapped but still count as open
+    bool m_open;
+
+#if defined(_WIN32)
+    void *m_fileHandle;
+    void *m_mappingHandle;
+#endif
+};
+
+#endif /* YDS_MEMORY_MAPPED_FILE_H */
@@ -0,0 +1,103 @@
+#ifndef YDS_MESH_OPTIMIZER_H
+#define YDS_MESH_OPTIMIZER_H
+
+#include <stdint.h>
+#include <vector>
+
+// --
+// Index and vertex buffer optimizations for packed triangle lists.
+//
+// Vertices are treated as opaque blobs of stride bytes so that these work
+// on any vertex format. The usual order is WeldVertices() to remove
+// duplicates, OptimizeVertexCache() to reorder triangles for the
+// post-transform cache and finally OptimizeVertexFetch() to lay out the
+// vertices in the order they're first used.
+// --
+namespace ysMeshOptimizer {
+
+    // Cache size used to score triangles, larger than most real caches on purpose
+    constexpr int OptimizerCacheSize = 32;
+
+    // FIFO cache size used when measuring, typical of current hardware
+    constexpr int DefaultAnalysisCacheSize = 16;
+
+    struct VertexCacheStatistics {
+        int VertexCount;
+        int TriangleCount;
+        int CacheMisses;
+
+        // Average cache miss ratio, transformed vertices per triangle (0.5 - 3)
+        float Acmr;
+
+        // Average transform to vertex ratio, transformed vertices per vertex (1 is ideal)
+        float Atvr;
+    };
+
+    // --
+    // Merge vertices that are bitwise identical. The vertex data is
+    // compacted in place (first occurrence wins) and the indices are
+    // rewritten. Returns the new vertex count.
+    // --
+    int WeldVertices(std::vector<char> &vertexData, int stride, std::vector<unsigned int> &indices);
+
+    // --
+    // Reorder triangles for the post-transform vertex cache using Tom
+    // Forsyth's linear-speed algorithm. Vertices aren't touched.
+    // --
+    void OptimizeVertexCache(std::vector<unsigned int> &indices, int vertexCount);
+
+    // --
+    // Reorder vertices by first use so that fetches walk the vertex buffer
+    // forward. Unreferenced vertices are dropped. Returns the new vertex count.
+    // --
+    int OptimizeVertexFetch(std::vector<char> &vertexData, int stride, std::vector<unsigned int> &indices);
+
+    struct Submesh {
+        int BaseIndex;
+        int FaceCount;
+        int BaseVertex;
+        int VertexCount;
+    };
+
+    // --
+    // Split a mesh into submeshes of at most maxVertexCount vertices each.
+    // Triangles are taken in order, so a mesh that was optimized for the
+    // vertex cache first gives compact submeshes. Each submesh's vertices
+    // are made contiguous in first use order, vertices on a boundary are
+    // duplicated and indices are rewritten relative to the submesh's base
+    // vertex. Returns the submeshes.
+    // --
+    std::vector<Submesh> SplitMesh(
+        std::vector<char> &vertexData,
+        int stride,
+        std::vector<unsigned int> &indices,
+        int maxVertexCount);
+
+    // --
+    // Simplify a mesh with quadric error metric edge collapses (Garland and
+    // Heckbert 1997). Vertices are neither moved nor created, the result
+    // indexes the original vertices so that every level of detail can share
+    // one vertex buffer. Positions are three floats per vertex.
+    //
+    // Vertices on open borders and attribute seams (several vertices at
+    // one position) stay in place, everything else may collapse onto a
+    // neighbour. Stops at targetIndexCount or before the surface would
+    // move further than targetError, and writes the distance reached to
+    // resultError if it isn't null.
+    // --
+    std::vector<unsigned int> SimplifyMesh(
+        const std::vector<float> &positions,
+        const std::vector<unsigned int> &indices,
+        int targetIndexCount,
+        float targetError,
+        float *resultError = nullptr);
+
+    // Simulate a FIFO post-transform cache over the index buffer
+    VertexCacheStatistics AnalyzeVertexCache(
+        const std::vector<unsigned int> &indices,
+        int vertexCount,
+        int cacheSize = DefaultAnalysisCacheSize);
+
+} /* namespace ysMeshOptimizer */
+
+#endif /* YDS_MESH_OPTIMIZER_H */
@@ -0,0 +1,169 @@
+#ifndef YDS_METRICS_H
+#define YDS_METRICS_H
+
+#include "yds_base.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+// --
+// Registry of runtime metrics published by engine subsystems.
+//
+// Counters accumulate events (draw calls, contacts, bytes uploaded) and are
+// reported per frame. Each thread increments its own copy of every counter
+// so publishing never contends; EndFrame() sums the copies and turns the
+// running totals into per frame values. Gauges hold a current value (asset
+// memory, object counts) and are simply sampled at EndFrame().
+//
+// Per frame values can be recorded and written out as CSV, and a summary of
+// every metric can be written as JSON.
+// --
+class ysMetrics : public ysObject {
+public:
+    typedef int MetricId;
+    static constexpr MetricId InvalidMetric = -1;
+
+    enum class Type {
+        Counter,
+        Gauge
+    };
+
+    struct Statistics {
+        double Last;
+        double Min;
+        double Max;
+        double Total;
+        uint64_t Frames;
+
+        double GetAverage() const { return (Frames > 0) ? Total / Frames : 0.0; }
+    };
+
+    static constexpr int MaxMetrics = 256;
+    static constexpr int MaxThreads = 64;
+    static constexpr int MaxNameLength = 64;
+    static constexpr size_t DefaultMaxRecordedFrames = 60 * 60 * 10;
+
+protected:
+    static std::atomic<ysMetrics *> g_instance;
+
+    // Slow path of Get(), safe to race from several threads
+    static ysMetrics *CreateInstance();
+
+public:
+    ysMetrics();
+    ~ysMetrics();
+
+    static ysMetrics *Get() {
+        ysMetrics *instance = g_instance.load(std::memory_order_acquire);
+        return (instance != nullptr) ? instance : CreateInstance();
+    }
+
+    // --
+    // Registering a name that already exists returns the existing metric.
+    // Subsystems should register once and keep the ID.
+    // --
+    MetricId RegisterCounter(const char *name) { return Register(name, Type::Counter); }
+    MetricId RegisterGauge(const char *name) { return Register(name, Type::Gauge); }
+    MetricId FindMetric(const char *name) const;
+
+    void Increment(MetricId id, int64_t amount = 1) {
+        if (id < 0) return;
+
+        // Uncontended unless the thread is sharing the overflow counters
+        GetThreadCounters()->Values[id].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void SetGauge(MetricId id, double value) {
+        if (id < 0) return;
+        m_gauges[id].store(value, std::memory_order_relaxed);
+    }
+
+    void AddGauge(MetricId id, double delta);
+
+    // --
+    // Aggregates everything published since the last call.
+    // --
+    void EndFrame();
+
+    int GetMetricCount() const { return m_metricCount.load(std::memory_order_acquire); }
+    const char *GetName(MetricId id) const { return m_metrics[id].Name; }
+    Type GetType(MetricId id) const { return m_metrics[id].MetricType; }
+
+    // Value of the last completed frame
+    double GetValue(MetricId id) const { return m_metrics[id].Stats.Last; }
+    const Statistics &GetStatistics(MetricId id) const { return m_metrics[id].Stats; }
+    uint64_t GetFrameCount() const { return m_frameCount; }
+
+    void ResetStatistics();
+
+    void StartRecording(size_t maxFrames = DefaultMaxRecordedFrames);
+    void StopRecording();
+    bool IsRecording() const { return m_recording; }
+    size_t GetRecordedFrameCount() const;
+
+    ysError WriteCsv(const char *fname);
+    ysError WriteJson(const char *fname);
+
+protected:
+    struct Metric {
+        char Name[MaxNameLength];
+        Type MetricType;
+        Statistics Stats;
+
+        // Sum of all thread counters at the previous EndFrame()
+        int64_t PreviousTotal;
+    };
+
+    struct ThreadCounters {
+        std::atomic<int64_t> Values[MaxMetrics];
+    };
+
+    MetricId Register(const char *name, Type type);
+
+    ThreadCounters *GetThreadCounters() {
+        if (s_threadGeneration == m_generation) return s_threadCounters;
+        return RegisterThread();
+    }
+
+    ThreadCounters *RegisterThread();
+
+    static thread_local int s_threadGeneration;
+    static thread_local ThreadCounters *s_threadCounters;
+
+protected:
+    int m_generation;
+
+    Metric m_metrics[MaxMetrics];
+    std::atomic<int> m_metricCount;
+    std::mutex m_registrationLock;
+
+    std::atomic<double> m_gauges[MaxMetrics];
+
+    std::atomic<ThreadCounters *> m_threadCounters[MaxThreads];
+    std::atomic<int> m_threadCount;
+
+    // Shared by threads past MaxThreads
+    ThreadCounters m_overflowCounters;
+
+    uint64_t m_frameCount;
+
+    bool m_recording;
+    size_t m_maxRecordedFrames;
+
+    // Metric values of each recorded frame, rows grow as metrics are registered
+    std::vector<double> m_recordedValues;
+    std::vector<int> m_recordedRowSizes;
+};
+
+// Metrics can be compiled out entirely by defining YDS_DISABLE_METRICS
+#ifndef YDS_DISABLE_METRICS
+#define YDS_METRIC_INCREMENT(id, amount) ysMetrics::Get()->Increment((id), (int64_t)(amount))
+#define YDS_METRIC_SET(id, value) ysMetrics::Get()->SetGauge((id), (double)(value))
+#else
+#define YDS_METRIC_INCREMENT(id, amount) ((void)0)
+#define YDS_METRIC_SET(id, value) ((void)0)
+#endif /* YDS_DISABLE_METRICS */
+
+#endif /* YDS_METRICS_H */
@@ -0,0 +1,89 @@
+#ifndef YDS_NAME_INDEX_H
+#define YDS_NAME_INDEX_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// --
+// Hash index from names to positions in an array of named objects, kept
+// alongside the array so lookups don't need to compare every name.
+//
+// Objects are indexed lazily: Lookup() first indexes everything added to
+// the array since the last lookup, so a name can be set any time after
+// its object is created up to the first lookup that follows. Objects
+// renamed after being indexed are only found by their new name after
+// Clear().
+//
+// Only the 64 bit FNV-1a hash of each name is stored. Hits are confirmed
+// against the array and fall back to a linear search if the name doesn't
+// match, which takes two names sharing a hash or a renamed object. Like
+// a linear search, the first object with a name wins.
+// --
+class ysNameIndex {
+public:
+    ysNameIndex();
+    ~ysNameIndex();
+
+    static constexpr uint64_t Hash(const char *name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (; *name != '\0'; ++name) {
+            hash ^= (uint64_t)(unsigned char)*name;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    void Clear();
+
+    // --
+    // Index of the object called name, or -1.
+    //
+    //   count:   Number of objects in the array
+    //   getName: Callable taking an index and returning the object's name
+    //            as a const char *
+    // --
+    template <typename T_GetName>
+    int Lookup(const char *name, int count, const T_GetName &getName) {
+        // Objects were removed, indices may have moved
+        if (count < m_indexedCount) Clear();
+
+        for (; m_indexedCount < count; ++m_indexedCount) {
+            Insert(Hash(getName(m_indexedCount)), m_indexedCount);
+        }
+
+        const int candidate = Find(Hash(name));
+        if (candidate < 0) return -1;
+        if (strcmp(getName(candidate), name) == 0) return candidate;
+
+        for (int i = 0; i < count; ++i) {
+            if (strcmp(getName(i), name) == 0) return i;
+        }
+
+        return -1;
+    }
+
+    int GetIndexedCount() const { return m_indexedCount; }
+
+protected:
+    struct Slot {
+        uint64_t Hash;
+        int Value;
+    };
+
+    // Keeps an existing entry for the same hash
+    void Insert(uint64_t hash, int value);
+    int Find(uint64_t hash) const;
+
+    void Grow();
+
+protected:
+    // Open addressing with linear probing, the size is a power of two
+    std::vector<Slot> m_slots;
+    int m_slotsUsed;
+
+    int m_indexedCount;
+};
+
+#endif /* YDS_NAME_INDEX_H */
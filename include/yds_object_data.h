@@ -5,6 +5,8 @@
 
 #include "yds_expanding_array.h"
 
+#include <stdint.h>
+
 class ysObjectData {
 public:
     enum class ObjectType {
@@ -72,6 +74,9 @@ public:
 
     void Clear();
 
+    // Hash of all of the source data, used to find unchanged objects
+    uint64_t GetContentHash() const;
+
     // Header
     char m_name[64];
     char m_materialName[64];
@@ -41,7 +41,12 @@ public:
 
     // GPU Buffers
     virtual ysError CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
-    virtual ysError CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
+    virtual ysError CreateIndexBuffer(
+        ysGPUBuffer **newBuffer,
+        int size,
+        char *data,
+        bool mirrorToRam = false,
+        ysGPUBuffer::IndexFormat format = ysGPUBuffer::IndexFormat::UInt16);
     virtual ysError CreateConstantBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam = false);
     virtual ysError UseVertexBuffer(ysGPUBuffer *buffer, int stride, int offset);
     virtual ysError UseIndexBuffer(ysGPUBuffer *buffer, int offset);
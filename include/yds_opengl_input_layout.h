@@ -12,6 +12,11 @@ struct ysOpenGLLayoutChannel : public ysDynamicArrayElement {
     int m_size = 0;
     int m_offset = 0;
     int m_type = 0;
+
+    // Normalized channels are converted to floats in [0, 1] or [-1, 1],
+    // integer channels are passed to the shader unconverted
+    bool m_normalized = false;
+    bool m_integer = false;
 };
 
 class ysOpenGLInputLayout : public ysInputLayout {
@@ -0,0 +1,181 @@
+#ifndef YDS_PROFILER_H
+#define YDS_PROFILER_H
+
+#include "yds_base.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// --
+// Timeline profiler that records events from any number of threads.
+//
+// Each thread writes begin/end, counter and marker events into its own
+// single producer ring buffer, so recording never takes a lock. Once per
+// frame EndFrame() drains every buffer; while a capture is running the
+// drained events are kept and can be written out as a Chrome trace (JSON)
+// or a Perfetto trace (protobuf) and inspected in chrome://tracing or
+// ui.perfetto.dev.
+//
+// NOTE: Event names must outlive the capture, in practice they should be
+// string literals.
+// --
+class ysProfiler : public ysObject {
+public:
+    enum class EventType : uint8_t {
+        Begin,
+        End,
+        Counter,
+        Marker
+    };
+
+    struct Event {
+        uint64_t Timestamp;
+        const char *Name;
+        double Value;
+        EventType Type;
+    };
+
+    struct CapturedEvent {
+        Event Data;
+        int Thread;
+    };
+
+    static constexpr int MaxThreads = 64;
+    static constexpr int ThreadBufferCapacity = 16 * 1024;
+    static constexpr int MaxThreadNameLength = 32;
+    static constexpr size_t DefaultMaxCaptureEvents = 4 * 1024 * 1024;
+
+protected:
+    static std::atomic<ysProfiler *> g_instance;
+
+    // Slow path of Get(), safe to race from several threads
+    static ysProfiler *CreateInstance();
+
+public:
+    ysProfiler();
+    ~ysProfiler();
+
+    static ysProfiler *Get() {
+        ysProfiler *instance = g_instance.load(std::memory_order_acquire);
+        return (instance != nullptr) ? instance : CreateInstance();
+    }
+
+    // --
+    // Recording is off by default; when disabled every event costs a
+    // single relaxed load.
+    // --
+    void SetEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void BeginEvent(const char *name) { Record(EventType::Begin, name, 0.0); }
+    void EndEvent(const char *name) { Record(EventType::End, name, 0.0); }
+    void Counter(const char *name, double value) { Record(EventType::Counter, name, value); }
+    void Marker(const char *name) { Record(EventType::Marker, name, 0.0); }
+
+    // --
+    // Name the calling thread in exported traces.
+    // --
+    void SetThreadName(const char *name);
+
+    void BeginFrame();
+    void EndFrame();
+
+    // --
+    // Collect the events recorded by all threads. Called by EndFrame().
+    // --
+    void Collect();
+
+    void StartCapture(size_t maxEvents = DefaultMaxCaptureEvents);
+    void StopCapture();
+    void ClearCapture();
+    bool IsCapturing() const { return m_capturing; }
+
+    const std::vector<CapturedEvent> &GetCapturedEvents() const { return m_capture; }
+    int GetThreadCount() const { return m_threadCount.load(std::memory_order_acquire); }
+    std::string GetThreadName(int thread) const;
+    uint64_t GetFrameCount() const { return m_frameCount; }
+
+    // Events lost because a thread buffer was full or because more than
+    // MaxThreads threads were recording at once
+    uint64_t GetDroppedEventCount() const;
+
+    ysError WriteChromeTrace(const char *fname);
+    ysError WritePerfettoTrace(const char *fname);
+
+    // Raw clock ticks, see ysTimingSystem::Now()
+    static uint64_t GetTimestamp();
+
+protected:
+    struct ThreadBuffer {
+        Event Events[ThreadBufferCapacity];
+
+        // Head is written by the owning thread, tail by the collector
+        alignas(64) std::atomic<uint64_t> Head;
+        alignas(64) std::atomic<uint64_t> Tail;
+        std::atomic<uint64_t> Dropped;
+
+        char Name[MaxThreadNameLength];
+        int Index;
+    };
+
+    void Record(EventType type, const char *name, double value) {
+        if (!m_enabled.load(std::memory_order_relaxed)) return;
+        RecordEvent(type, name, value);
+    }
+
+    void RecordEvent(EventType type, const char *name, double value);
+
+    ThreadBuffer *GetThreadBuffer();
+
+protected:
+    std::atomic<bool> m_enabled;
+    int m_generation;
+
+    std::atomic<ThreadBuffer *> m_threadBuffers[MaxThreads];
+    std::atomic<int> m_threadCount;
+    std::atomic<uint64_t> m_rejectedEvents;
+
+    bool m_capturing;
+    size_t m_maxCaptureEvents;
+    std::vector<CapturedEvent> m_capture;
+
+    uint64_t m_frameCount;
+};
+
+// --
+// Records a begin/end event pair around the enclosing scope.
+// --
+class ysProfilerScope {
+public:
+    ysProfilerScope(const char *name) : m_name(name) {
+        ysProfiler::Get()->BeginEvent(m_name);
+    }
+
+    ~ysProfilerScope() {
+        ysProfiler::Get()->EndEvent(m_name);
+    }
+
+    ysProfilerScope(const ysProfilerScope &) = delete;
+    ysProfilerScope &operator=(const ysProfilerScope &) = delete;
+
+protected:
+    const char *m_name;
+};
+
+#define YDS_TRACE_CONCAT_INNER(a, b) a##b
+#define YDS_TRACE_CONCAT(a, b) YDS_TRACE_CONCAT_INNER(a, b)
+
+// Trace events can be compiled out entirely by defining YDS_DISABLE_PROFILING
+#ifndef YDS_DISABLE_PROFILING
+#define YDS_TRACE_SCOPE(name) ysProfilerScope YDS_TRACE_CONCAT(ysTraceScope_, __LINE__)(name)
+#define YDS_TRACE_COUNTER(name, value) ysProfiler::Get()->Counter((name), (double)(value))
+#define YDS_TRACE_MARKER(name) ysProfiler::Get()->Marker(name)
+#else
+#define YDS_TRACE_SCOPE(name) ((void)0)
+#define YDS_TRACE_COUNTER(name, value) ((void)0)
+#define YDS_TRACE_MARKER(name) ((void)0)
+#endif /* YDS_DISABLE_PROFILING */
+
+#endif /* YDS_PROFILER_H */
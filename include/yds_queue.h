@@ -1,6 +1,8 @@
 #ifndef YDS_QUEUE_H
 #define YDS_QUEUE_H
 
+#include "yds_allocator.h"
+
 #include <stdlib.h>
 
 template<typename Type, int InitialSize = 0, int Alignment = 1>
@@ -41,7 +43,7 @@ public:
 
     Type *GetBuffer() { return m_array; }
 
-    __forceinline Type &operator[](int index) {
+    inline Type &operator[](int index) {
         return m_array[(index + m_start) % m_maxSize];
     }
 
@@ -74,7 +76,7 @@ protected:
         Type *ret = NULL;
 
         if (Alignment != 1) {
-            void *memory = _aligned_malloc(sizeof(Type) * size, Alignment);
+            void *memory = ysAllocator::BlockAllocate<Alignment>(sizeof(Type) * size);
             ret = (Type *)memory;
         }
         else ret = new Type[size];
@@ -91,7 +93,7 @@ protected:
                 arr[i].~Type();
             }
 
-            _aligned_free(arr);
+            ysAllocator::BlockFree(arr, Alignment);
         }
     }
 
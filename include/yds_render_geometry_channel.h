@@ -15,6 +15,10 @@ public:
         R32G32B32A32_FLOAT,
         R32G32B32A32_UINT,
         R32G32B32_UINT,
+        R16G16_FLOAT,
+        R16G16_SNORM,
+        R16G16B16A16_FLOAT,
+        R16G16B16A16_UNORM,
         Undefined
     };
 
@@ -40,6 +44,12 @@ public:
             return 4 * sizeof(unsigned int);
         case ChannelFormat::R32G32B32_UINT:
             return 3 * sizeof(unsigned int);
+        case ChannelFormat::R16G16_FLOAT:
+        case ChannelFormat::R16G16_SNORM:
+            return 2 * sizeof(uint16_t);
+        case ChannelFormat::R16G16B16A16_FLOAT:
+        case ChannelFormat::R16G16B16A16_UNORM:
+            return 4 * sizeof(uint16_t);
         case ChannelFormat::Undefined:
         default:
             return 0;
@@ -58,12 +68,24 @@ public:
             return 4;
         case ChannelFormat::R32G32B32_UINT:
             return 3;
+        case ChannelFormat::R16G16_FLOAT:
+        case ChannelFormat::R16G16_SNORM:
+            return 2;
+        case ChannelFormat::R16G16B16A16_FLOAT:
+        case ChannelFormat::R16G16B16A16_UNORM:
+            return 4;
         case ChannelFormat::Undefined:
         default:
             return 0;
         }
     }
 
+    // Integer formats that are read as floats in [0, 1] or [-1, 1]
+    static bool IsFormatNormalized(ChannelFormat format) {
+        return format == ChannelFormat::R16G16_SNORM
+            || format == ChannelFormat::R16G16B16A16_UNORM;
+    }
+
 protected:
     char            m_name[MAX_NAME_LENGTH];
     int                m_offset;
@@ -0,0 +1,73 @@
+#ifndef YDS_RESIDENCY_SET_H
+#define YDS_RESIDENCY_SET_H
+
+#include <list>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+// --
+// Tracks which streamed assets are resident and how much memory they use,
+// in least recently used order.
+//
+// Assets are marked as used with Touch() whenever they're drawn or played,
+// which is constant time. When the resident total goes over the budget the
+// least recently used assets are picked for eviction, except ones used in
+// the current or previous frame, which may still be referenced by work in
+// flight. The budget can therefore be exceeded temporarily if a single
+// frame uses more than it allows.
+// --
+class ysResidencySet {
+public:
+    ysResidencySet();
+    ~ysResidencySet();
+
+    // Zero or less means unlimited
+    void SetBudget(int64_t bytes) { m_budget = bytes; }
+    int64_t GetBudget() const { return m_budget; }
+
+    // Start a new frame, call once per frame before any Touch()
+    void NextFrame() { ++m_frame; }
+    uint64_t GetFrame() const { return m_frame; }
+
+    // --
+    // Add a newly resident asset, as most recently used. Adding a key
+    // that's already resident updates its size.
+    // --
+    void Add(uint64_t key, int64_t bytes);
+    void Remove(uint64_t key);
+
+    // Forget every asset, the budget is kept
+    void Clear();
+
+    // Mark an asset as used this frame, does nothing if it isn't resident
+    void Touch(uint64_t key);
+
+    bool IsResident(uint64_t key) const { return m_entries.count(key) != 0; }
+    int GetResidentCount() const { return (int)m_entries.size(); }
+    int64_t GetResidentBytes() const { return m_residentBytes; }
+
+    // --
+    // Remove least recently used assets until the resident total fits in
+    // the budget, and append their keys to evicted so the owner can free
+    // them. Returns the number of assets evicted.
+    // --
+    int Evict(std::vector<uint64_t> *evicted);
+
+protected:
+    struct Entry {
+        uint64_t Key;
+        int64_t Bytes;
+        uint64_t LastUsedFrame;
+    };
+
+    // Most recently used at the front
+    std::list<Entry> m_order;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_entries;
+
+    int64_t m_budget;
+    int64_t m_residentBytes;
+    uint64_t m_frame;
+};
+
+#endif /* YDS_RESIDENCY_SET_H */
@@ -0,0 +1,175 @@
+#ifndef YDS_SCENE_COMPILER_H
+#define YDS_SCENE_COMPILER_H
+
+#include "yds_base.h"
+
+#include "yds_geometry_export_file.h"
+#include "yds_interchange_object.h"
+
+#include <stdint.h>
+#include <vector>
+
+// --
+// Compiles interchange and tool scenes into scene files.
+//
+// The pipeline runs in stages: objects are read, hashed, looked up in the
+// previous output, processed and then written. Hashing and processing run
+// in parallel on a job system and the results are written in their
+// original order, so the output doesn't depend on the worker count.
+//
+// Geometry can optionally go through a mesh optimization stage: exactly
+// matching vertices are welded, triangles are reordered for the
+// post-transform cache and vertices are laid out in order of first use.
+//
+// Meshes with more vertices than 16 bit indices can address are either
+// split into submeshes or stored with 32 bit indices.
+//
+// Every object is keyed by a hash of its contents and the compile
+// settings. If the existing output file has an object with the same hash
+// its packed data is reused as is, so editing one mesh in a large scene
+// only recompiles that mesh.
+// --
+class ysSceneCompiler : public ysObject {
+public:
+    // Bump when the processing changes so that old outputs aren't reused
+    static constexpr uint32_t PipelineVersion = 4;
+
+    enum class LargeMeshMode {
+        // Split into submeshes that each fit 16 bit indices
+        Split,
+
+        // Keep the mesh whole and store 32 bit indices
+        WideIndices
+    };
+
+    struct Settings {
+        float Scale = 1.0f;
+        ysGeometryExportFile::VertexInfo VertexInfo;
+
+        // Weld vertices and optimize for the vertex cache and vertex fetch
+        bool OptimizeMeshes = true;
+
+        // What to do with meshes that 16 bit indices can't address
+        LargeMeshMode LargeMeshes = LargeMeshMode::Split;
+
+        // --
+        // Levels of detail per mesh including the full detail one, 1
+        // disables simplification. Each level keeps LodReduction of the
+        // previous level's triangles, and no level may move the surface
+        // further than LodMaxError times the diagonal of the object's
+        // bounds. Meshes stop early once they can't be simplified further.
+        // --
+        int LodCount = 1;
+        float LodReduction = 0.5f;
+        float LodMaxError = 0.05f;
+
+        // Reuse unchanged objects from the existing output file
+        bool UseCache = true;
+
+        // Total number of threads including the caller, 0 for one per hardware thread
+        int WorkerCount = 0;
+    };
+
+    // --
+    // Processing of a tool (.ysc) geometry object that depends on its
+    // material, which the compiler doesn't know about.
+    // --
+    struct ToolObjectSettings {
+        bool CalculateTangents = false;
+        bool SeparateByUVs = false;
+    };
+
+    // Times are in seconds
+    struct Statistics {
+        double ReadTime;
+        double HashTime;
+        double CacheTime;
+        double ProcessTime;
+        double WriteTime;
+        double TotalTime;
+
+        int ObjectCount;
+        int CachedObjectCount;
+        int CompiledObjectCount;
+
+        // Compiled objects that were too large for 16 bit indices
+        int SplitObjectCount;
+        int WideIndexObjectCount;
+
+        // Compiled objects with 16 bit vertex formats
+        int QuantizedObjectCount;
+
+        // Compiled objects with more than one level of detail and the
+        // triangles in their reduced levels
+        int LodObjectCount;
+        int64_t LodTriangleCount;
+
+        // Mesh optimization of the compiled objects, ACMR and ATVR are
+        // measured with ysMeshOptimizer::DefaultAnalysisCacheSize
+        int64_t TriangleCount;
+        int64_t VertexCountBefore;
+        int64_t VertexCountAfter;
+        double AcmrBefore;
+        double AcmrAfter;
+        double AtvrBefore;
+        double AtvrAfter;
+    };
+
+public:
+    ysSceneCompiler();
+    ~ysSceneCompiler();
+
+    // Compile an interchange (.dia) file
+    ysError Compile(const char *inputPath, const char *outputPath, const Settings &settings);
+
+    // Compile objects that are already in memory, the objects are modified
+    ysError Compile(std::vector<ysInterchangeObject> &objects, const char *outputPath, const Settings &settings);
+
+    // --
+    // Compile objects read from a tool (.ysc) file, the objects are
+    // modified. They get the tool file preprocessing instead of the
+    // interchange processing, so only Scale, UseCache and WorkerCount
+    // apply.
+    // --
+    ysError Compile(
+        const std::vector<ysObjectData *> &objects,
+        const std::vector<ToolObjectSettings> &objectSettings,
+        const char *outputPath,
+        const Settings &settings);
+
+    const Statistics &GetStatistics() const { return m_statistics; }
+
+protected:
+    ysError CompileObjects(std::vector<ysInterchangeObject> &objects, const char *outputPath, const Settings &settings);
+
+    static uint64_t HashSettings(const Settings &settings);
+    static uint64_t HashSettings(const Settings &settings, const ToolObjectSettings &objectSettings);
+
+    // Takes objects whose content hash matches one in the previous output from there
+    void ReuseCachedObjects(
+        const char *outputPath,
+        const Settings &settings,
+        std::vector<ysGeometryExportFile::CompiledObject> &compiled,
+        std::vector<bool> *cached);
+
+    ysError WriteObjects(const char *outputPath, const std::vector<ysGeometryExportFile::CompiledObject> &compiled);
+
+    struct OptimizationResult {
+        int TriangleCount;
+        int VertexCountBefore;
+        int VertexCountAfter;
+        int CacheMissesBefore;
+        int CacheMissesAfter;
+    };
+
+    static void OptimizeObject(ysGeometryExportFile::CompiledObject *object, OptimizationResult *result);
+    static void SplitObject(ysGeometryExportFile::CompiledObject *object);
+
+    // Returns false if the object was left with a single level of detail
+    static bool GenerateLods(ysGeometryExportFile::CompiledObject *object, const Settings &settings);
+
+protected:
+    Statistics m_statistics;
+};
+
+#endif /* YDS_SCENE_COMPILER_H */
@@ -0,0 +1,168 @@
+#ifndef YDS_SLAB_ALLOCATOR_H
+#define YDS_SLAB_ALLOCATOR_H
+
+#include "yds_memory_base.h"
+
+#include <atomic>
+#include <mutex>
+
+// --
+// General purpose allocator with segregated free lists.
+//
+// Requests are rounded up to one of a fixed set of size classes. Each class
+// carves blocks out of large slabs and keeps freed blocks on a free list, so
+// both allocation and freeing are O(1) and there is no limit on the number
+// of live blocks. Requests larger than the largest size class go straight
+// to the heap.
+//
+// Every thread gets a small cache of free blocks per size class, so the
+// shared free lists (and their lock) are only touched in batches. Up to
+// MaxThreadCaches threads can have a cache at the same time; a cache is
+// handed to a new thread when its owner exits, and threads beyond the
+// limit use the shared free lists directly.
+// --
+class ysSlabAllocator : public ysMemoryAllocator {
+public:
+    static constexpr int Alignment = 16;
+    static constexpr int MaxSizeClasses = 64;
+    static constexpr int MaxSmallSize = 32 * KB;
+    static constexpr int MaxThreadCaches = 16;
+    static constexpr int CacheBatchSize = 32;
+    static constexpr int DefaultSlabSize = 64 * KB;
+
+    struct Statistics {
+        // Bytes reserved from the heap for slabs
+        size_t ReservedBytes;
+
+        // Bytes requested by live allocations
+        size_t RequestedBytes;
+
+        // Bytes of live blocks, including size class rounding and headers
+        size_t AllocatedBytes;
+
+        // Live allocations, including large ones
+        size_t LiveBlocks;
+
+        // Live allocations that bypassed the size classes
+        size_t LargeBlocks;
+        size_t LargeBytes;
+
+        // Fraction of allocated block memory lost to rounding and headers
+        float InternalFragmentation;
+
+        // Fraction of slab memory that isn't currently handed out
+        float ExternalFragmentation;
+    };
+
+public:
+    ysSlabAllocator();
+    ~ysSlabAllocator();
+
+    // --
+    // Set the size of the slabs that size classes allocate from. If hugePages
+    // is set, slabs are allocated directly from the OS and backed by large
+    // pages where available.
+    //
+    // NOTE: Must be called before the first allocation.
+    // --
+    void Initialize(int slabSize = DefaultSlabSize, bool hugePages = false);
+
+    virtual void *AllocateBlock(int size, int numObjects = 1);
+    virtual int FreeBlock(void *block);
+    virtual void Destroy();
+
+    Statistics GetStatistics() const;
+
+    int GetSizeClassCount() const { return m_sizeClassCount; }
+    int GetSizeClassSize(int sizeClass) const { return m_sizeClasses[sizeClass]; }
+
+protected:
+    struct FreeLink {
+        FreeLink *Next;
+    };
+
+    struct BlockHeader {
+        unsigned int Size;
+        int NumObjects;
+        int SizeClass;
+        int Reserved;
+    };
+
+    struct LargeLink {
+        LargeLink *Previous;
+        LargeLink *Next;
+    };
+
+    struct SlabLink {
+        SlabLink *Next;
+        size_t Size;
+        bool PageBacked;
+    };
+
+    struct CentralList {
+        FreeLink *FreeList;
+        int FreeCount;
+
+        char *SlabCursor;
+        char *SlabEnd;
+    };
+
+    struct ThreadCache {
+        FreeLink *FreeLists[MaxSizeClasses];
+        int Counts[MaxSizeClasses];
+    };
+
+    static constexpr int LargeClass = -1;
+    static constexpr size_t HeaderSize = sizeof(BlockHeader);
+    static constexpr size_t LargeHeaderSize =
+        ((sizeof(LargeLink) + Alignment - 1) / Alignment) * Alignment;
+    static constexpr size_t SlabHeaderSize =
+        ((sizeof(SlabLink) + Alignment - 1) / Alignment) * Alignment;
+
+    static_assert(sizeof(BlockHeader) % Alignment == 0, "Block header must preserve alignment");
+
+    void BuildSizeClasses();
+    int GetSizeClass(size_t blockSize) const;
+
+    ThreadCache *GetThreadCache();
+
+    // Move up to count free blocks of a size class into the thread cache
+    void Refill(ThreadCache *cache, int sizeClass, int count);
+
+    // Return count blocks of a size class from the thread cache
+    void Flush(ThreadCache *cache, int sizeClass, int count);
+
+    void *AllocateLarge(int size, int numObjects);
+    void FreeLarge(BlockHeader *header);
+
+    // Cache index of the calling thread, MaxThreadCaches if it has none
+    static int GetThreadSlot();
+
+protected:
+    int m_sizeClasses[MaxSizeClasses];
+    int m_sizeClassCount;
+
+    // Maps a block size (in units of Alignment) to its size class
+    unsigned char m_sizeClassLookup[MaxSmallSize / Alignment + 1];
+
+    int m_slabSize;
+    bool m_hugePages;
+
+    CentralList m_central[MaxSizeClasses];
+    SlabLink *m_slabs;
+    LargeLink *m_largeBlockList;
+
+    ThreadCache m_threadCaches[MaxThreadCaches];
+
+    mutable std::mutex m_lock;
+
+    // Statistics
+    size_t m_reservedBytes;
+    std::atomic<size_t> m_requestedBytes;
+    std::atomic<size_t> m_allocatedBytes;
+    std::atomic<size_t> m_liveBlocks;
+    size_t m_largeBlockCount;
+    size_t m_largeBytes;
+};
+
+#endif /* YDS_SLAB_ALLOCATOR_H */
@@ -1,18 +1,40 @@
 #ifndef YS_TIMING_H
 #define YS_TIMING_H
 
-#include <intrin.h>
+#include <atomic>
 #include <stdint.h>
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#if !defined(YDS_TIMING_DISABLE_TSC)
+#define YDS_TIMING_TSC
+#endif /* YDS_TIMING_DISABLE_TSC */
+#endif
+
+#if defined(YDS_TIMING_TSC)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif /* YDS_TIMING_TSC */
+
+// Time in microseconds
 uint64_t SystemTime();
 
 class ysTimingSystem {
 public:
     enum class Precision {
+        Nanosecond,
         Microsecond,
         Millisecond
     };
 
+    enum class ClockSource {
+        Uncalibrated,
+        Tsc,
+        System
+    };
+
 protected:
     static ysTimingSystem *g_instance;
 
@@ -34,8 +56,11 @@ public:
     double GetFrameDuration();
     uint64_t GetFrameDuration_us();
 
+    // Current time in units of the precision mode
     uint64_t GetTime();
-    unsigned __int64 GetClock();
+
+    // Raw clock ticks, same as Now()
+    uint64_t GetClock();
 
     void SetPrecisionMode(Precision mode);
     Precision GetPrecisionMode() const { return m_precisionMode; }
@@ -44,6 +69,45 @@ public:
 
     float GetFPS() const { return m_fps; }
 
+public:
+    // --
+    // Read the clock in raw ticks. Uses the invariant TSC when the CPU has
+    // one, otherwise the OS monotonic clock. Cheap enough to call from inner
+    // loops; convert differences with TicksToNanoseconds()/TicksToSeconds().
+    //
+    // The clock is calibrated against the OS clock on first use.
+    // --
+    static uint64_t Now() {
+#if defined(YDS_TIMING_TSC)
+        if (s_clockSource.load(std::memory_order_relaxed) == (int)ClockSource::Tsc) {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#endif /* YDS_TIMING_TSC */
+
+        return NowFallback();
+    }
+
+    static uint64_t TicksToNanoseconds(uint64_t ticks);
+    static double TicksToSeconds(uint64_t ticks);
+    static uint64_t GetTicksPerSecond();
+    static ClockSource GetClockSource();
+
+    // Time from the OS monotonic clock in nanoseconds
+    static uint64_t ReadSystemClock();
+
+protected:
+    static uint64_t NowFallback();
+    static void EnsureCalibrated();
+    static void Calibrate();
+
+    // Stored as an int so that the zero initialized value is Uncalibrated
+    static std::atomic<int> s_clockSource;
+    static uint64_t s_ticksPerSecond;
+
+    // Nanoseconds per tick as 32.32 fixed point
+    static uint64_t s_nanosecondsPerTick;
+
 protected:
     Precision m_precisionMode;
     double m_div;
@@ -0,0 +1,40 @@
+#ifndef YDS_VERTEX_QUANTIZATION_H
+#define YDS_VERTEX_QUANTIZATION_H
+
+#include <stdint.h>
+
+// --
+// Encoders for compact vertex formats. Each encoder has a matching
+// decoder that gives the value the GPU will see when reading the encoded
+// data through the corresponding ysRenderGeometryChannel format.
+// --
+namespace ysVertexQuantization {
+
+    // --
+    // IEEE 754 half precision (R16G16_FLOAT etc.), rounded to nearest even.
+    // Values too large for a half become infinity.
+    // --
+    uint16_t FloatToHalf(float value);
+    float HalfToFloat(uint16_t half);
+
+    // --
+    // Value in [min, max] mapped onto the full 16 bit range (R16G16B16A16_UNORM).
+    // Values outside the range are clamped, an empty range encodes to 0.
+    // --
+    uint16_t QuantizeUnorm16(float value, float min, float max);
+    float DequantizeUnorm16(uint16_t quantized, float min, float max);
+
+    // Value in [-1, 1] (R16G16_SNORM), clamped
+    int16_t FloatToSnorm16(float value);
+    float Snorm16ToFloat(int16_t snorm);
+
+    // --
+    // Unit vector folded onto an octahedron and stored as two snorm
+    // values. Zero vectors encode to +Z. The decoded vector is normalized.
+    // --
+    void EncodeOctahedral(float x, float y, float z, int16_t encoded[2]);
+    void DecodeOctahedral(const int16_t encoded[2], float decoded[3]);
+
+} /* namespace ysVertexQuantization */
+
+#endif /* YDS_VERTEX_QUANTIZATION_H */
@@ -9,7 +9,6 @@
 #include "rigid_body_link.h"
 #include "grid_partition_system.h"
 
-#include <Windows.h>
 #include <fstream>
 
 namespace dphysics {
@@ -68,6 +67,7 @@ namespace dphysics {
         void InitializeCollisions();
         void CleanCollisions();
         void ClearCollisions();
+        Collision *NewCollision();
         void GenerateCollisions(RigidBody *body1, RigidBody *body2);
 
         void ResolveCollisions(float dt);
@@ -97,6 +97,9 @@ namespace dphysics {
         ysDynamicArray<Collision, 4> m_dynamicCollisions;
         ysExpandingArray<Collision *, 8192> m_collisionAccumulator;
 
+        // Scratch memory for collisions and other per-update data
+        ysFrameAllocator m_frameAllocator;
+
         std::vector<std::vector<float>> m_dynamicFrictionTable;
         std::vector<std::vector<float>> m_staticFrictionTable;
 
@@ -109,6 +112,11 @@ namespace dphysics {
 
         ysBreakdownTimer *m_breakdownTimer;
 
+        // Runtime metrics
+        ysMetrics::MetricId m_contactsMetric;
+        ysMetrics::MetricId m_pairTestsMetric;
+        ysMetrics::MetricId m_rigidBodiesMetric;
+
         // TEST
         GridPartitionSystem m_gridPartitionSystem;
         std::ofstream m_loggingOutput;
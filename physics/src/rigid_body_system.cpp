@@ -1,7 +1,5 @@
 #include "../include/rigid_body_system.h"
 
-#include <process.h>
-#include <Windows.h>
 #include <ctime>
 #include <assert.h>
 
@@ -17,10 +15,16 @@ dphysics::RigidBodySystem::RigidBodySystem() : ysObject("RigidBodySystem") {
     m_defaultStaticFriction = 0.5f;
 
     m_breakdownTimer = nullptr;
+
+    ysMetrics *metrics = ysMetrics::Get();
+    m_contactsMetric = metrics->RegisterCounter("Physics/Contacts");
+    m_pairTestsMetric = metrics->RegisterCounter("Physics/PairTests");
+    m_rigidBodiesMetric = metrics->RegisterGauge("Physics/RigidBodies");
 }
 
 dphysics::RigidBodySystem::~RigidBodySystem() {
-    /* void */
+    // Collisions live in the frame allocator so they have to be released first
+    ClearCollisions();
 }
 
 void dphysics::RigidBodySystem::InitializeFrictionTable(
@@ -138,11 +142,8 @@ void dphysics::RigidBodySystem::GenerateCollisions(int start, int count) {
     const int REQUEST_THRESHOLD = 0;
 
     const int rigidBodyCount = m_rigidBodyRegistry.GetNumObjects();
-    bool **visited = new bool *[rigidBodyCount];
-    for (int i = 0; i < rigidBodyCount; ++i) {
-        visited[i] = new bool[rigidBodyCount];
-        memset((void *)visited[i], 0, sizeof(bool) * rigidBodyCount);
-    }
+    bool *visited = (bool *)m_frameAllocator.AllocateBlock(sizeof(bool) * rigidBodyCount * rigidBodyCount);
+    memset((void *)visited, 0, sizeof(bool) * rigidBodyCount * rigidBodyCount);
 
     for (auto cell: m_gridPartitionSystem.m_gridCells) {
         GridCell *gridCell = cell.second;
@@ -157,10 +158,11 @@ void dphysics::RigidBodySystem::GenerateCollisions(int start, int count) {
                 for (int j = i + 1; j < cellObjects; j++) {
                     body2 = gridCell->m_objects[j];
 
-                    if (visited[body1->GetIndex()][body2->GetIndex()]) continue;
+                    bool &pairVisited = visited[body1->GetIndex() * rigidBodyCount + body2->GetIndex()];
+                    if (pairVisited) continue;
                     if (body1->GetRoot() == body2->GetRoot()) continue;
 
-                    visited[body1->GetIndex()][body2->GetIndex()] = true;
+                    pairVisited = true;
 
                     GenerateCollisions(body1, body2);
                 }
@@ -169,11 +171,6 @@ void dphysics::RigidBodySystem::GenerateCollisions(int start, int count) {
             gridCell->m_processed = true;
         }
     }
-
-    for (int i = 0; i < rigidBodyCount; ++i) {
-        delete[] visited[i];
-    }
-    delete[] visited;
 }
 
 void dphysics::RigidBodySystem::WriteFrameToReplayFile() {
@@ -299,7 +296,7 @@ void dphysics::RigidBodySystem::GenerateCollisions(RigidBody *body1, RigidBody *
                 }
 
                 for (int i = 0; i < nCollisions; ++i) {
-                    Collision *newCollisionEntry = m_dynamicCollisions.NewGeneric<Collision, 16>();
+                    Collision *newCollisionEntry = NewCollision();
                     m_collisionAccumulator.New() = newCollisionEntry;
 
                     *newCollisionEntry = newCollisions[i];
@@ -367,7 +364,7 @@ void dphysics::RigidBodySystem::GenerateCollisions() {
     for (int i = 0; i < nLinks; i++) {
         int nGenerated = m_rigidBodyLinks.Get(i)->GenerateCollisions(collisions);
         for (int j = 0; j < nGenerated; j++) {
-            Collision *newCollisionEntry = m_dynamicCollisions.NewGeneric<Collision, 16>();
+            Collision *newCollisionEntry = NewCollision();
             m_collisionAccumulator.New() = newCollisionEntry;
             *newCollisionEntry = collisions[j];
 
@@ -401,15 +398,29 @@ void dphysics::RigidBodySystem::CleanCollisions() {
             collision.m_sensor) 
         {
             m_collisionAccumulator.Delete(i, false);
-            m_dynamicCollisions.Delete(collision.GetIndex());
+            m_dynamicCollisions.Delete(collision.GetIndex(), false);
+            collision.~Collision();
             --numContacts;
         }
     }
 }
 
 void dphysics::RigidBodySystem::ClearCollisions() {
+    const int collisionCount = m_dynamicCollisions.GetNumObjects();
+    for (int i = 0; i < collisionCount; ++i) {
+        Collision *collision = m_dynamicCollisions.Get(i);
+        m_frameAllocator.Free(collision);
+    }
+
     m_collisionAccumulator.Clear();
-    m_dynamicCollisions.Clear();
+    m_dynamicCollisions.Clear(false);
+}
+
+dphysics::Collision *dphysics::RigidBodySystem::NewCollision() {
+    Collision *newCollision = m_frameAllocator.Allocate<Collision>();
+    m_dynamicCollisions.Add(newCollision);
+
+    return newCollision;
 }
 
 void dphysics::RigidBodySystem::ResolveCollision(Collision *collision, ysVector *velocityChange, ysVector *rotationDirection, float rotationAmount[2], float penetration) {
@@ -817,11 +828,23 @@ void dphysics::RigidBodySystem::CheckAwake() {
 }
 
 void dphysics::RigidBodySystem::Update(float timestep) {
+    YDS_TRACE_SCOPE("Physics");
+    YDS_ALLOCATION_TAG("physics");
+
+    // Collisions from the previous update stay valid until they are cleared below
+    m_frameAllocator.StartFrame();
+
     //GenerateForces(timestep);
 
     Integrate(timestep);
 
+    const int pairTests = m_loadMeasurement;
     GenerateCollisions();
+
+    YDS_METRIC_INCREMENT(m_contactsMetric, m_collisionAccumulator.GetNumObjects());
+    YDS_METRIC_INCREMENT(m_pairTestsMetric, m_loadMeasurement - pairTests);
+    YDS_METRIC_SET(m_rigidBodiesMetric, m_rigidBodyRegistry.GetNumObjects());
+
     InitializeCollisions();
     ResolveCollisions(timestep);
     AdjustVelocities(timestep);
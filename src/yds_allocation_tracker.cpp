@@ -0,0 +1,451 @@
+#include "../include/yds_allocation_tracker.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define YDS_ALLOCATION_TRACKER_BACKTRACE
+#endif
+
+#if !defined(YDS_DISABLE_OPERATOR_NEW_TRACKING) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// The replacement operator new below is inlined into the new expressions in
+// this file and GCC then pairs its malloc with the delete expressions
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+std::atomic<ysAllocationTracker *> ysAllocationTracker::g_instance(nullptr);
+std::atomic<bool> ysAllocationTracker::s_enabled(false);
+
+constexpr int ysAllocationTracker::MaxTags;
+constexpr int ysAllocationTracker::MaxCallStackDepth;
+
+namespace {
+    std::mutex s_instanceLock;
+
+    thread_local ysAllocationTracker::TagId t_currentTag = ysAllocationTracker::UntaggedTag;
+
+    // Set while the tracker itself is running, so that allocations made by
+    // its own containers aren't reported back into it
+    thread_local bool t_reentrant = false;
+
+    class ReentrancyGuard {
+    public:
+        ReentrancyGuard() { t_reentrant = true; }
+        ~ReentrancyGuard() { t_reentrant = false; }
+    };
+
+    int CaptureCallStack(void **frames, int maxDepth) {
+#if defined(_WIN32)
+        return (int)::RtlCaptureStackBackTrace(0, (DWORD)maxDepth, frames, nullptr);
+#elif defined(YDS_ALLOCATION_TRACKER_BACKTRACE)
+        return ::backtrace(frames, maxDepth);
+#else
+        return 0;
+#endif
+    }
+
+    uint64_t HashCallSite(void *const *frames, int depth, ysAllocationTracker::TagId tag, int source) {
+        // FNV-1a over the frame addresses
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                hash ^= (value >> (i * 8)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (int i = 0; i < depth; ++i) mix((uint64_t)(uintptr_t)frames[i]);
+        mix((uint64_t)tag);
+        mix((uint64_t)source);
+
+        return hash;
+    }
+
+    void WriteStatisticsRow(std::ostream &out, const char *name, const ysAllocationTracker::Statistics &s) {
+        out << std::left << std::setw(24) << name << std::right
+            << std::setw(12) << s.Allocations
+            << std::setw(12) << s.Frees
+            << std::setw(16) << s.BytesAllocated
+            << std::setw(12) << s.LiveAllocations
+            << std::setw(16) << s.LiveBytes
+            << std::setw(16) << s.PeakLiveBytes
+            << std::setw(12) << s.LastFrameAllocations
+            << std::setw(16) << s.LastFrameBytes
+            << "\n";
+    }
+
+    void WriteStatisticsHeader(std::ostream &out, const char *title) {
+        out << std::left << std::setw(24) << title << std::right
+            << std::setw(12) << "Allocs"
+            << std::setw(12) << "Frees"
+            << std::setw(16) << "Bytes"
+            << std::setw(12) << "Live"
+            << std::setw(16) << "LiveBytes"
+            << std::setw(16) << "PeakBytes"
+            << std::setw(12) << "FrameAllocs"
+            << std::setw(16) << "FrameBytes"
+            << "\n";
+    }
+}
+
+ysAllocationTracker::ysAllocationTracker() : ysObject("ysAllocationTracker") {
+    m_captureCallStacks = false;
+
+    memset(m_tagNames, 0, sizeof(m_tagNames));
+    memset(m_statistics, 0, sizeof(m_statistics));
+
+    strncpy(m_tagNames[UntaggedTag], "untagged", MaxTagNameLength - 1);
+    m_tagNames[UntaggedTag][MaxTagNameLength - 1] = '\0';
+    m_tagCount = 1;
+
+    m_frameCount = 0;
+}
+
+ysAllocationTracker::~ysAllocationTracker() {
+    /* void */
+}
+
+ysAllocationTracker *ysAllocationTracker::Get() {
+    ysAllocationTracker *instance = g_instance.load(std::memory_order_acquire);
+    if (instance != nullptr) return instance;
+
+    std::lock_guard<std::mutex> lock(s_instanceLock);
+    instance = g_instance.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+        instance = new ysAllocationTracker;
+        g_instance.store(instance, std::memory_order_release);
+    }
+
+    return instance;
+}
+
+ysAllocationTracker::TagId ysAllocationTracker::RegisterTag(const char *name) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    const int tagCount = m_tagCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < tagCount; ++i) {
+        if (strcmp(m_tagNames[i], name) == 0) return i;
+    }
+
+    if (tagCount >= MaxTags) return UntaggedTag;
+
+    strncpy(m_tagNames[tagCount], name, MaxTagNameLength - 1);
+    m_tagNames[tagCount][MaxTagNameLength - 1] = '\0';
+    m_tagCount.store(tagCount + 1, std::memory_order_release);
+
+    return tagCount;
+}
+
+const char *ysAllocationTracker::GetTagName(TagId tag) const {
+    if (tag < 0 || tag >= GetTagCount()) return nullptr;
+    return m_tagNames[tag];
+}
+
+ysAllocationTracker::TagId ysAllocationTracker::GetCurrentTag() {
+    return t_currentTag;
+}
+
+ysAllocationTracker::TagId ysAllocationTracker::SetCurrentTag(TagId tag) {
+    const TagId previous = t_currentTag;
+    t_currentTag = tag;
+
+    return previous;
+}
+
+void ysAllocationTracker::RecordAllocation(void *block, size_t size, Source source) {
+    if (t_reentrant) return;
+    ReentrancyGuard guard;
+
+    Record record;
+    record.Size = size;
+    record.Tag = t_currentTag;
+    record.CallSiteHash = 0;
+
+    // Capture outside of the lock, unwinding can be slow
+    void *frames[MaxCallStackDepth];
+    int depth = 0;
+    if (m_captureCallStacks) {
+        depth = CaptureCallStack(frames, MaxCallStackDepth);
+        record.CallSiteHash = HashCallSite(frames, depth, record.Tag, (int)source);
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    Statistics &s = m_statistics[record.Tag][(int)source];
+    ++s.Allocations;
+    s.BytesAllocated += size;
+    ++s.FrameAllocations;
+    s.FrameBytes += size;
+
+    if (depth > 0) {
+        auto site = m_callSites.find(record.CallSiteHash);
+        if (site == m_callSites.end()) {
+            CallSite newSite;
+            memcpy(newSite.Frames, frames, sizeof(void *) * depth);
+            newSite.Depth = depth;
+            newSite.Tag = record.Tag;
+            newSite.AllocationSource = source;
+            newSite.Allocations = 0;
+            newSite.Bytes = 0;
+            newSite.LiveBytes = 0;
+
+            site = m_callSites.insert({ record.CallSiteHash, newSite }).first;
+        }
+
+        ++site->second.Allocations;
+        site->second.Bytes += size;
+        site->second.LiveBytes += (int64_t)size;
+    }
+
+    // Frame allocator memory is reclaimed in bulk, there's nothing to free
+    if (source == Source::FrameAllocator) return;
+
+    ++s.LiveAllocations;
+    s.LiveBytes += (int64_t)size;
+    s.PeakLiveBytes = std::max(s.PeakLiveBytes, s.LiveBytes);
+
+    m_sources[(int)source].LiveBlocks[block] = record;
+}
+
+void ysAllocationTracker::RecordFree(void *block, Source source) {
+    if (t_reentrant) return;
+    ReentrancyGuard guard;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    std::unordered_map<void *, Record> &liveBlocks = m_sources[(int)source].LiveBlocks;
+    auto entry = liveBlocks.find(block);
+    if (entry == liveBlocks.end()) return;
+
+    const Record &record = entry->second;
+
+    Statistics &s = m_statistics[record.Tag][(int)source];
+    ++s.Frees;
+    --s.LiveAllocations;
+    s.LiveBytes -= (int64_t)record.Size;
+
+    if (record.CallSiteHash != 0) {
+        auto site = m_callSites.find(record.CallSiteHash);
+        if (site != m_callSites.end()) site->second.LiveBytes -= (int64_t)record.Size;
+    }
+
+    liveBlocks.erase(entry);
+}
+
+void ysAllocationTracker::EndFrame() {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    for (int tag = 0; tag < MaxTags; ++tag) {
+        for (int source = 0; source < (int)Source::Count; ++source) {
+            Statistics &s = m_statistics[tag][source];
+            s.LastFrameAllocations = s.FrameAllocations;
+            s.LastFrameBytes = s.FrameBytes;
+            s.FrameAllocations = 0;
+            s.FrameBytes = 0;
+        }
+    }
+
+    ++m_frameCount;
+}
+
+ysAllocationTracker::Statistics ysAllocationTracker::GetTotalStatistics() const {
+    Statistics total;
+    memset(&total, 0, sizeof(Statistics));
+
+    const int tagCount = GetTagCount();
+    for (int tag = 0; tag < tagCount; ++tag) {
+        Accumulate(&total, GetTagStatistics(tag));
+    }
+
+    return total;
+}
+
+ysAllocationTracker::Statistics ysAllocationTracker::GetTagStatistics(TagId tag) const {
+    Statistics total;
+    memset(&total, 0, sizeof(Statistics));
+
+    for (int source = 0; source < (int)Source::Count; ++source) {
+        Accumulate(&total, GetStatistics(tag, (Source)source));
+    }
+
+    return total;
+}
+
+ysAllocationTracker::Statistics ysAllocationTracker::GetStatistics(TagId tag, Source source) const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_statistics[tag][(int)source];
+}
+
+std::vector<ysAllocationTracker::CallSite> ysAllocationTracker::GetTopCallSites(int count) const {
+    std::vector<CallSite> sites;
+
+    {
+        ReentrancyGuard guard;
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        sites.reserve(m_callSites.size());
+        for (const auto &site : m_callSites) sites.push_back(site.second);
+    }
+
+    std::sort(sites.begin(), sites.end(), [](const CallSite &a, const CallSite &b) {
+        return a.Bytes > b.Bytes;
+    });
+
+    if ((int)sites.size() > count) sites.resize(count);
+    return sites;
+}
+
+void ysAllocationTracker::Reset() {
+    ReentrancyGuard guard;
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    memset(m_statistics, 0, sizeof(m_statistics));
+    for (SourceState &source : m_sources) source.LiveBlocks.clear();
+    m_callSites.clear();
+
+    m_frameCount = 0;
+}
+
+ysError ysAllocationTracker::WriteReport(const char *fname, int topCallSites) {
+    YDS_ERROR_DECLARE("WriteReport");
+
+    std::ofstream file(fname, std::ios::out);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    file << "Allocation report after " << m_frameCount << " frames\n\n";
+
+    WriteStatisticsHeader(file, "Tag");
+    const int tagCount = GetTagCount();
+    for (int tag = 0; tag < tagCount; ++tag) {
+        WriteStatisticsRow(file, m_tagNames[tag], GetTagStatistics(tag));
+    }
+
+    for (int source = 0; source < (int)Source::Count; ++source) {
+        file << "\n";
+        WriteStatisticsHeader(file, GetSourceName((Source)source));
+
+        for (int tag = 0; tag < tagCount; ++tag) {
+            const Statistics s = GetStatistics(tag, (Source)source);
+            if (s.Allocations == 0) continue;
+
+            WriteStatisticsRow(file, m_tagNames[tag], s);
+        }
+    }
+
+    const std::vector<CallSite> sites = GetTopCallSites(topCallSites);
+    if (!sites.empty()) {
+        file << "\nTop " << sites.size() << " call sites by bytes allocated\n";
+
+        ReentrancyGuard guard;
+        for (size_t i = 0; i < sites.size(); ++i) {
+            const CallSite &site = sites[i];
+            file << "\n#" << (i + 1)
+                << " " << m_tagNames[site.Tag]
+                << " " << GetSourceName(site.AllocationSource)
+                << ": " << site.Allocations << " allocations, "
+                << site.Bytes << " bytes, "
+                << site.LiveBytes << " live bytes\n";
+
+#if defined(YDS_ALLOCATION_TRACKER_BACKTRACE)
+            char **symbols = ::backtrace_symbols(site.Frames, site.Depth);
+            for (int f = 0; f < site.Depth; ++f) {
+                file << "    " << ((symbols != nullptr) ? symbols[f] : "?") << "\n";
+            }
+            ::free(symbols);
+#else
+            for (int f = 0; f < site.Depth; ++f) {
+                file << "    0x" << std::hex << (uintptr_t)site.Frames[f] << std::dec << "\n";
+            }
+#endif
+        }
+    }
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+const char *ysAllocationTracker::GetSourceName(Source source) {
+    switch (source) {
+    case Source::Allocator: return "ysAllocator";
+    case Source::MemoryAllocator: return "ysMemoryAllocator";
+    case Source::FrameAllocator: return "ysFrameAllocator";
+    case Source::OperatorNew: return "operator new";
+    default: return "unknown";
+    }
+}
+
+void ysAllocationTracker::Accumulate(Statistics *target, const Statistics &s) {
+    target->Allocations += s.Allocations;
+    target->Frees += s.Frees;
+    target->BytesAllocated += s.BytesAllocated;
+    target->LiveAllocations += s.LiveAllocations;
+    target->LiveBytes += s.LiveBytes;
+    target->PeakLiveBytes += s.PeakLiveBytes;
+    target->FrameAllocations += s.FrameAllocations;
+    target->FrameBytes += s.FrameBytes;
+    target->LastFrameAllocations += s.LastFrameAllocations;
+    target->LastFrameBytes += s.LastFrameBytes;
+}
+
+#ifndef YDS_DISABLE_OPERATOR_NEW_TRACKING
+
+// --
+// Replacements for the global allocation functions. They behave exactly
+// like the standard ones apart from reporting to the tracker.
+// --
+
+void *operator new(size_t size) {
+    void *block = ::malloc((size > 0) ? size : 1);
+    if (block == nullptr) throw std::bad_alloc();
+
+    ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::OperatorNew);
+    return block;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    void *block = ::malloc((size > 0) ? size : 1);
+    ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::OperatorNew);
+
+    return block;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void *block) noexcept {
+    ysAllocationTracker::OnFree(block, ysAllocationTracker::Source::OperatorNew);
+    ::free(block);
+}
+
+void operator delete[](void *block) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void *block, size_t) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void *block, size_t) noexcept {
+    operator delete(block);
+}
+
+void operator delete(void *block, const std::nothrow_t &) noexcept {
+    operator delete(block);
+}
+
+void operator delete[](void *block, const std::nothrow_t &) noexcept {
+    operator delete(block);
+}
+
+#endif /* YDS_DISABLE_OPERATOR_NEW_TRACKING */
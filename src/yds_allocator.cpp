@@ -0,0 +1,149 @@
+#include "../include/yds_allocator.h"
+
+#include "../include/yds_allocation_tracker.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ysAllocator::AllocationHook ysAllocator::s_allocationHook = nullptr;
+
+void *ysAllocator::AlignedAllocate(size_t size, int alignment) {
+    void *block = nullptr;
+
+    if (alignment <= 1) {
+        block = ::malloc(size);
+    }
+    else {
+#if defined(_WIN32)
+        block = ::_aligned_malloc(size, alignment);
+#else
+        // posix_memalign() requires at least pointer alignment
+        const size_t effectiveAlignment =
+            ((size_t)alignment < sizeof(void *)) ? sizeof(void *) : (size_t)alignment;
+        if (::posix_memalign(&block, effectiveAlignment, size) != 0) {
+            block = nullptr;
+        }
+#endif
+    }
+
+    if (s_allocationHook != nullptr && block != nullptr) {
+        s_allocationHook(Event::Allocate, block, size, alignment);
+    }
+
+    ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::Allocator);
+
+    return block;
+}
+
+void ysAllocator::BlockFree(void *block, int alignment) {
+    if (block == nullptr) return;
+
+    if (s_allocationHook != nullptr) {
+        s_allocationHook(Event::Free, block, 0, alignment);
+    }
+
+    ysAllocationTracker::OnFree(block, ysAllocationTracker::Source::Allocator);
+
+    if (alignment <= 1) {
+        ::free(block);
+    }
+    else {
+#if defined(_WIN32)
+        ::_aligned_free(block);
+#else
+        ::free(block);
+#endif
+    }
+}
+
+void *ysAllocator::PageAllocate(size_t size, bool hugePages) {
+    void *block = nullptr;
+
+#if defined(_WIN32)
+    if (hugePages) {
+        const size_t largePageSize = ::GetLargePageMinimum();
+        if (largePageSize > 0) {
+            const size_t roundedSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+
+            // Fails unless the process holds SeLockMemoryPrivilege
+            block = ::VirtualAlloc(
+                nullptr, roundedSize, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+        }
+    }
+
+    if (block == nullptr) {
+        block = ::VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    }
+#else
+#if defined(MAP_HUGETLB)
+    if (hugePages) {
+        const size_t hugePageSize = GetHugePageSize();
+        if (size % hugePageSize == 0) {
+            block = ::mmap(
+                nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (block == MAP_FAILED) block = nullptr;
+        }
+    }
+#endif
+
+    if (block == nullptr) {
+        block = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) block = nullptr;
+
+#if defined(MADV_HUGEPAGE)
+        // Fall back to transparent huge pages if no reserved pages are available
+        if (block != nullptr && hugePages) {
+            ::madvise(block, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+#endif
+
+    if (s_allocationHook != nullptr && block != nullptr) {
+        s_allocationHook(Event::Allocate, block, size, (int)GetPageSize());
+    }
+
+    ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::Allocator);
+
+    return block;
+}
+
+void ysAllocator::PageFree(void *block, size_t size) {
+    if (block == nullptr) return;
+
+    if (s_allocationHook != nullptr) {
+        s_allocationHook(Event::Free, block, size, (int)GetPageSize());
+    }
+
+    ysAllocationTracker::OnFree(block, ysAllocationTracker::Source::Allocator);
+
+#if defined(_WIN32)
+    ::VirtualFree(block, 0, MEM_RELEASE);
+#else
+    ::munmap(block, size);
+#endif
+}
+
+size_t ysAllocator::GetPageSize() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    ::GetSystemInfo(&info);
+    return (size_t)info.dwPageSize;
+#else
+    return (size_t)::sysconf(_SC_PAGESIZE);
+#endif
+}
+
+size_t ysAllocator::GetHugePageSize() {
+#if defined(_WIN32)
+    const size_t largePageSize = ::GetLargePageMinimum();
+    return (largePageSize > 0) ? largePageSize : GetPageSize();
+#else
+    return 2 * 1024 * 1024;
+#endif
+}
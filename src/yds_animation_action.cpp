@@ -5,6 +5,7 @@
 ysAnimationAction::ysAnimationAction() : ysObject("ysAnimationAction") {
     m_curveCount = 0;
     m_length = 0.0f;
+    m_clip = nullptr;
 }
 
 ysAnimationAction::~ysAnimationAction() {
@@ -13,6 +14,8 @@ ysAnimationAction::~ysAnimationAction() {
             delete curve;
         }
     }
+
+    delete m_clip;
 }
 
 ysAnimationCurve *ysAnimationAction::NewCurve(const std::string &target) {
@@ -45,7 +48,57 @@ int ysAnimationAction::GetCurveCount() const {
     return m_curveCount;
 }
 
+void ysAnimationAction::Bake() {
+    for (auto &group : m_curves) {
+        for (ysAnimationCurve *curve : group.second) {
+            curve->Bake();
+        }
+    }
+}
+
+ysError ysAnimationAction::Compress(const ysAnimationClip::Settings &settings) {
+    YDS_ERROR_DECLARE("Compress");
+
+    if (m_clip != nullptr) return YDS_ERROR_RETURN(ysError::InvalidOperation);
+
+    ysAnimationClip *clip = new ysAnimationClip;
+    ysError error = clip->Compress(this, settings);
+    if (error != ysError::None) {
+        delete clip;
+        return YDS_ERROR_RETURN(error);
+    }
+
+    delete m_clip;
+    m_clip = clip;
+
+    for (auto group : m_curves) {
+        for (ysAnimationCurve *curve : group.second) {
+            delete curve;
+        }
+    }
+
+    m_curves.clear();
+    m_curveCount = 0;
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void ysAnimationAction::GetTargets(std::vector<std::string> *targets) const {
+    targets->clear();
+    for (auto &group : m_curves) {
+        if (!group.second.empty()) targets->push_back(group.first);
+    }
+
+    if (m_clip != nullptr) {
+        for (int i = 0; i < m_clip->GetBoneCount(); ++i) {
+            targets->push_back(m_clip->GetBoneName(i));
+        }
+    }
+}
+
 bool ysAnimationAction::IsAnimated(const std::string &objectName) const {
+    if (m_clip != nullptr && m_clip->FindBone(objectName) >= 0) return true;
+
     auto f = m_curves.find(objectName);
     if (f == m_curves.end()) return false;
     else return !(*f).second.empty();
@@ -14,18 +14,38 @@ ysAnimationActionBinding::~ysAnimationActionBinding() {
 }
 
 void ysAnimationActionBinding::Sample(float s, float amplitude) {
+    if (!m_clipLocations.empty()) {
+        m_action->GetClip()->Sample(s, amplitude, m_clipLocations.data(), m_clipRotations.data());
+    }
+
     for (ysAnimationTarget *target : m_targets) {
         target->Sample(s, amplitude);
     }
 }
 
 void ysAnimationActionBinding::SampleRest(float amplitude) {
+    if (!m_clipLocations.empty()) {
+        m_action->GetClip()->SampleRest(amplitude, m_clipLocations.data(), m_clipRotations.data());
+    }
+
     for (ysAnimationTarget *target : m_targets) {
         target->SampleRest(amplitude);
     }
 }
 
 void ysAnimationActionBinding::AddTarget(const std::string &name, TransformTarget *locationTarget, TransformTarget *rotationTarget) {
+    ysAnimationClip *clip = m_action->GetClip();
+    if (clip != nullptr) {
+        const int bone = clip->FindBone(name);
+        if (bone < 0) return;
+
+        m_clipLocations.resize(clip->GetBoneCount(), nullptr);
+        m_clipRotations.resize(clip->GetBoneCount(), nullptr);
+        m_clipLocations[bone] = locationTarget;
+        m_clipRotations[bone] = rotationTarget;
+        return;
+    }
+
     ysAnimationTarget *newTarget = new ysAnimationTarget;
     newTarget->SetLocationTarget(locationTarget);
     newTarget->SetRotationTarget(rotationTarget);
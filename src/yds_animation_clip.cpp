@@ -0,0 +1,290 @@
+#include "../include/yds_animation_clip.h"
+
+#include "../include/yds_animation_action.h"
+#include "../include/yds_animation_curve.h"
+#include "../include/yds_animation_target.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Every component but the largest of a unit quaternion is in this range
+    constexpr float RotationRange = 0.70710678f;
+    constexpr float RotationScale = 2 * RotationRange / 65535.0f;
+
+    uint16_t Quantize(float v, float min, float scale) {
+        if (scale == 0.0f) return 0;
+
+        const float q = std::round((v - min) / scale);
+        return (uint16_t)std::min(std::max(q, 0.0f), 65535.0f);
+    }
+}
+
+ysAnimationClip::ysAnimationClip() : ysObject("ysAnimationClip") {
+    m_frameCount = 0;
+    m_sampleRate = 0.0f;
+}
+
+ysAnimationClip::~ysAnimationClip() {
+    /* void */
+}
+
+ysError ysAnimationClip::Compress(ysAnimationAction *action, const Settings &settings) {
+    YDS_ERROR_DECLARE("Compress");
+
+    if (action == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+    if (settings.SampleRate <= 0.0f) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
+    constexpr ysAnimationCurve::CurveType LocationTypes[] = {
+        ysAnimationCurve::CurveType::LocationX,
+        ysAnimationCurve::CurveType::LocationY,
+        ysAnimationCurve::CurveType::LocationZ
+    };
+
+    constexpr ysAnimationCurve::CurveType RotationTypes[] = {
+        ysAnimationCurve::CurveType::RotationQuatW,
+        ysAnimationCurve::CurveType::RotationQuatX,
+        ysAnimationCurve::CurveType::RotationQuatY,
+        ysAnimationCurve::CurveType::RotationQuatZ
+    };
+
+    std::vector<std::string> targets;
+    action->GetTargets(&targets);
+
+    // Covers the whole action even if some keys are past its length
+    float length = action->GetLength();
+    for (const std::string &target : targets) {
+        for (ysAnimationCurve::CurveType type : LocationTypes) {
+            ysAnimationCurve *curve = action->GetCurve(target, type);
+            if (curve != nullptr) length = std::max(length, curve->GetEndTime());
+        }
+
+        for (ysAnimationCurve::CurveType type : RotationTypes) {
+            ysAnimationCurve *curve = action->GetCurve(target, type);
+            if (curve != nullptr) length = std::max(length, curve->GetEndTime());
+        }
+    }
+
+    const int boneCount = (int)targets.size();
+    const int frameCount = (int)std::ceil(length * settings.SampleRate) + 1;
+
+    m_bones.resize(boneCount);
+    m_boneNames.Clear();
+    m_frames.resize((size_t)frameCount * boneCount);
+    m_frameCount = frameCount;
+    m_sampleRate = settings.SampleRate;
+
+    std::vector<float> locations((size_t)frameCount * 3);
+    for (int b = 0; b < boneCount; ++b) {
+        Bone &bone = m_bones[b];
+        bone.Name = targets[b];
+        bone.LocationMask = 0;
+        bone.LocationMin[3] = bone.LocationScale[3] = 0.0f;
+
+        ysAnimationCurve *locationCurves[3];
+        for (int i = 0; i < 3; ++i) {
+            locationCurves[i] = action->GetCurve(bone.Name, LocationTypes[i]);
+            if (locationCurves[i] != nullptr) bone.LocationMask |= 0x1 << i;
+        }
+
+        ysAnimationCurve *rotationCurves[4];
+        for (int i = 0; i < 4; ++i) {
+            rotationCurves[i] = action->GetCurve(bone.Name, RotationTypes[i]);
+        }
+
+        // Same rule as ysAnimationTarget: rotations need a W curve
+        bone.Rotation = rotationCurves[0] != nullptr;
+
+        // Resample, cursors make this a single pass over each curve
+        int locationCursors[3] = { 0, 0, 0 };
+        int rotationCursors[4] = { 0, 0, 0, 0 };
+        for (int f = 0; f < frameCount; ++f) {
+            const float s = f / m_sampleRate;
+            QuantizedTransform &t = m_frames[(size_t)f * boneCount + b];
+
+            for (int i = 0; i < 3; ++i) {
+                locations[f * 3 + i] = (locationCurves[i] != nullptr)
+                    ? locationCurves[i]->Sample(s, &locationCursors[i])
+                    : 0.0f;
+            }
+
+            float rotation[4] = { 1.0f, 0.0f, 0.0f, 0.0f };
+            if (bone.Rotation) {
+                for (int i = 0; i < 4; ++i) {
+                    if (rotationCurves[i] != nullptr) {
+                        rotation[i] = rotationCurves[i]->Sample(s, &rotationCursors[i]);
+                    }
+                }
+            }
+
+            ysQuaternion q = ysMath::LoadVector(rotation[0], rotation[1], rotation[2], rotation[3]);
+            const float length2 = ysMath::GetScalar(ysMath::Dot(q, q));
+            q = (length2 > 1E-12f)
+                ? ysMath::Normalize(q)
+                : ysMath::Constants::QuatIdentity;
+
+            EncodeRotation(q, &t);
+            t.Padding = 0;
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            float min = 0.0f, max = 0.0f;
+            if (frameCount > 0) min = max = locations[i];
+
+            for (int f = 1; f < frameCount; ++f) {
+                min = std::min(min, locations[f * 3 + i]);
+                max = std::max(max, locations[f * 3 + i]);
+            }
+
+            bone.LocationMin[i] = min;
+            bone.LocationScale[i] = (max - min) / 65535.0f;
+
+            for (int f = 0; f < frameCount; ++f) {
+                m_frames[(size_t)f * boneCount + b].Location[i] =
+                    Quantize(locations[f * 3 + i], min, bone.LocationScale[i]);
+            }
+        }
+    }
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void ysAnimationClip::Sample(
+    float s, float amplitude,
+    TransformTarget *const *locations, TransformTarget *const *rotations) const
+{
+    if (m_frameCount == 0) return;
+
+    const float f = std::min(std::max(s * m_sampleRate, 0.0f), (float)(m_frameCount - 1));
+    const int f0 = std::min((int)f, m_frameCount - 1);
+    const int f1 = std::min(f0 + 1, m_frameCount - 1);
+    const float w = f - f0;
+
+    const int boneCount = GetBoneCount();
+    const QuantizedTransform *frame0 = &m_frames[(size_t)f0 * boneCount];
+    const QuantizedTransform *frame1 = &m_frames[(size_t)f1 * boneCount];
+
+    for (int b = 0; b < boneCount; ++b) {
+        const Bone &bone = m_bones[b];
+
+        TransformTarget *location = locations[b];
+        if (location != nullptr && bone.LocationMask != 0) {
+            const ysVector l = ysMath::Lerp(
+                DecodeLocation(bone, frame0[b]),
+                DecodeLocation(bone, frame1[b]),
+                w);
+
+            float components[4];
+            _mm_storeu_ps(components, ysMath::Mul(l, ysMath::LoadScalar(amplitude)));
+
+            for (int i = 0; i < 3; ++i) {
+                if ((bone.LocationMask & (0x1 << i)) != 0) {
+                    location->Accumulate(components[i], i);
+                }
+            }
+        }
+
+        TransformTarget *rotation = rotations[b];
+        if (rotation != nullptr && bone.Rotation) {
+            const ysQuaternion q0 = DecodeRotation(frame0[b]);
+            ysQuaternion q1 = DecodeRotation(frame1[b]);
+
+            // Shortest path
+            const ysVector negative = _mm_cmplt_ps(ysMath::Dot(q0, q1), _mm_setzero_ps());
+            q1 = _mm_xor_ps(q1, _mm_and_ps(negative, _mm_set1_ps(-0.0f)));
+
+            ysQuaternion q = ysMath::Normalize(ysMath::Lerp(q0, q1, w));
+            rotation->AccumulateQuaternion(q, amplitude);
+        }
+    }
+}
+
+void ysAnimationClip::SampleRest(
+    float amplitude,
+    TransformTarget *const *locations, TransformTarget *const *rotations) const
+{
+    for (int b = 0; b < GetBoneCount(); ++b) {
+        const Bone &bone = m_bones[b];
+
+        if (locations[b] != nullptr) {
+            for (int i = 0; i < 3; ++i) {
+                if ((bone.LocationMask & (0x1 << i)) != 0) {
+                    locations[b]->Accumulate(0.0f, i);
+                }
+            }
+        }
+
+        if (rotations[b] != nullptr && bone.Rotation) {
+            rotations[b]->Accumulate(amplitude, 0);
+            for (int i = 1; i < 4; ++i) rotations[b]->Accumulate(0.0f, i);
+        }
+    }
+}
+
+int ysAnimationClip::FindBone(const std::string &name) {
+    return m_boneNames.Lookup(name.c_str(), GetBoneCount(),
+        [this](int i) { return m_bones[i].Name.c_str(); });
+}
+
+size_t ysAnimationClip::GetMemoryUsage() const {
+    return
+        sizeof(ysAnimationClip)
+        + m_bones.capacity() * sizeof(Bone)
+        + m_frames.capacity() * sizeof(QuantizedTransform);
+}
+
+ysVector ysAnimationClip::DecodeLocation(const Bone &bone, const QuantizedTransform &t) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&t));
+    const __m128i location = _mm_unpacklo_epi16(raw, _mm_setzero_si128());
+
+    // Lane 3 holds the largest component index, cleared by the zero scale
+    return ysMath::Add(
+        ysMath::Mul(_mm_cvtepi32_ps(location), _mm_loadu_ps(bone.LocationScale)),
+        _mm_loadu_ps(bone.LocationMin));
+}
+
+ysQuaternion ysAnimationClip::DecodeRotation(const QuantizedTransform &t) {
+    const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&t));
+    const __m128i rotation = _mm_unpackhi_epi16(raw, _mm_setzero_si128());
+
+    // (a, b, c, 0), the padding lane stays zero
+    const ysVector scale = _mm_set_ps(0.0f, RotationScale, RotationScale, RotationScale);
+    const ysVector offset = _mm_set_ps(0.0f, -RotationRange, -RotationRange, -RotationRange);
+    const ysVector abc = ysMath::Add(ysMath::Mul(_mm_cvtepi32_ps(rotation), scale), offset);
+
+    const ysVector d = _mm_sqrt_ps(
+        _mm_max_ps(ysMath::Sub(ysMath::Constants::One, ysMath::Dot(abc, abc)), _mm_setzero_ps()));
+
+    // (a, b, c, d)
+    const ysVector cd = _mm_shuffle_ps(abc, d, _MM_SHUFFLE(0, 0, 2, 2));
+    const ysVector q = _mm_shuffle_ps(abc, cd, _MM_SHUFFLE(2, 0, 1, 0));
+
+    // Move the largest component back into place
+    switch (t.LargestComponent) {
+    case 0: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 0, 3));
+    case 1: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 1, 3, 0));
+    case 2: return _mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 3, 1, 0));
+    default: return q;
+    }
+}
+
+void ysAnimationClip::EncodeRotation(const ysQuaternion &q, QuantizedTransform *t) {
+    float c[4];
+    _mm_storeu_ps(c, q);
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i) {
+        if (std::abs(c[i]) > std::abs(c[largest])) largest = i;
+    }
+
+    // q and -q are the same rotation, keep the largest component positive
+    const float sign = (c[largest] < 0) ? -1.0f : 1.0f;
+
+    t->LargestComponent = (uint16_t)largest;
+    for (int i = 0, j = 0; i < 4; ++i) {
+        if (i == largest) continue;
+        t->Rotation[j++] = Quantize(c[i] * sign, -RotationRange, RotationScale);
+    }
+}
@@ -2,8 +2,12 @@
 
 #include "../include/yds_animation_target.h"
 
+#include <algorithm>
+#include <cmath>
+
 ysAnimationCurve::ysAnimationCurve() {
     m_curveType = CurveType::Undefined;
+    m_baked = false;
 }
 
 ysAnimationCurve::~ysAnimationCurve() {
@@ -11,49 +15,144 @@ ysAnimationCurve::~ysAnimationCurve() {
 }
 
 float ysAnimationCurve::Sample(float s) {
-    if (m_samples.empty()) {
+    return Sample(s, nullptr);
+}
+
+float ysAnimationCurve::Sample(float s, int *cursor) {
+    if (!m_baked) Bake();
+
+    const int keyCount = (int)m_keyTimes.size();
+    if (keyCount == 0) {
         return 0.0f;
     }
+    else if (s <= m_keyTimes[0]) {
+        return m_keyValues[0];
+    }
+    else if (s >= m_keyTimes[keyCount - 1]) {
+        return m_keyValues[keyCount - 1];
+    }
+
+    const int segment = FindSegment(s, (cursor != nullptr) ? *cursor : -1);
+    if (cursor != nullptr) *cursor = segment;
+
+    return SampleSegment(segment, s);
+}
+
+void ysAnimationCurve::Bake() {
+    const int keyCount = (int)m_samples.size();
+    const int segmentCount = (keyCount > 0) ? keyCount - 1 : 0;
 
-    auto next = m_samples.lower_bound(s);
-    if (next == m_samples.begin()) {
-        return next->second.v;
+    m_keyTimes.resize(keyCount);
+    m_keyValues.resize(keyCount);
+    m_inverseDurations.resize(segmentCount);
+    m_segmentX.resize(segmentCount * 3);
+    m_segmentY.resize(segmentCount * 4);
+
+    int i = 0;
+    for (auto k = m_samples.begin(); k != m_samples.end(); ++k, ++i) {
+        const CurveHandle &handle1 = k->second;
+        m_keyTimes[i] = handle1.s;
+        m_keyValues[i] = handle1.v;
+
+        if (i == segmentCount) break;
+
+        auto next = k; ++next;
+        const CurveHandle &handle2 = next->second;
+
+        const float inverseDuration = 1.0f / (handle2.s - handle1.s);
+        m_inverseDurations[i] = inverseDuration;
+
+        float *x = &m_segmentX[i * 3];
+        float *y = &m_segmentY[i * 4];
+
+        if (handle1.mode == CurveHandle::InterpolationMode::Bezier) {
+            // Power basis of B(t) = (1 - t)^3 * P0 + 3t(1 - t)^2 * P1 + 3t^2(1 - t) * P2 + t^3 * P3
+            // with x normalized so that P0 = 0 and P3 = 1
+            const float x1 = (handle1.r_handle_x - handle1.s) * inverseDuration;
+            const float x2 = (handle2.l_handle_x - handle1.s) * inverseDuration;
+
+            x[0] = 3 * x1 - 3 * x2 + 1;
+            x[1] = -6 * x1 + 3 * x2;
+            x[2] = 3 * x1;
+
+            const float y0 = handle1.v;
+            const float y1 = handle1.r_handle_y;
+            const float y2 = handle2.l_handle_y;
+            const float y3 = handle2.v;
+
+            y[0] = -y0 + 3 * y1 - 3 * y2 + y3;
+            y[1] = 3 * y0 - 6 * y1 + 3 * y2;
+            y[2] = -3 * y0 + 3 * y1;
+            y[3] = y0;
+        }
+        else {
+            x[0] = x[1] = 0.0f;
+            x[2] = 1.0f;
+
+            y[0] = y[1] = 0.0f;
+            y[2] = handle2.v - handle1.v;
+            y[3] = handle1.v;
+        }
     }
 
-    auto prev = next; --prev;
-    if (next == m_samples.end()) {
-        return prev->second.v;
+    m_baked = true;
+}
+
+int ysAnimationCurve::FindSegment(float s, int cursor) const {
+    // Expects m_keyTimes[0] < s < m_keyTimes[last]
+    constexpr int MaxCursorSteps = 4;
+
+    const int segmentCount = (int)m_inverseDurations.size();
+    if (cursor >= 0 && cursor < segmentCount && s >= m_keyTimes[cursor]) {
+        for (int i = 0; i < MaxCursorSteps; ++i, ++cursor) {
+            if (s < m_keyTimes[cursor + 1]) return cursor;
+        }
     }
 
-    CurveHandle &handle1 = prev->second;
-    CurveHandle &handle2 = next->second;
+    auto next = std::upper_bound(m_keyTimes.begin(), m_keyTimes.end(), s);
+    return (int)(next - m_keyTimes.begin()) - 1;
+}
 
-    if (handle1.mode == CurveHandle::InterpolationMode::Linear) {
-        // Linear interpolation
-        float dist = (handle2.s - handle1.s);
-        float sdist = s - handle1.s;
+float ysAnimationCurve::SampleSegment(int segment, float s) const {
+    const float u = (s - m_keyTimes[segment]) * m_inverseDurations[segment];
+    const float t = SolveSegment_t(&m_segmentX[segment * 3], u);
 
-        float w1 = (sdist / dist);
-        float w0 = 1.0f - w1;
+    const float *y = &m_segmentY[segment * 4];
+    return ((y[0] * t + y[1]) * t + y[2]) * t + y[3];
+}
 
-        return handle1.v * w0 + handle2.v * w1;
-    }
-    else if (handle1.mode == CurveHandle::InterpolationMode::Bezier) {
-        // Cubic bezier interpolation
-        float t = Bezier_t(s, 
-            handle1.s, handle1.r_handle_x, handle2.l_handle_x, handle2.s);
-
-        float B_t_y =
-            (1 - t) * (1 - t) * (1 - t) * handle1.v +
-            3 * t * (1 - t) * (1 - t) * handle1.r_handle_y +
-            3 * t * t * (1 - t) * handle2.l_handle_y +
-            t * t * t * handle2.v;
-
-        return B_t_y;
+float ysAnimationCurve::SolveSegment_t(const float *x, float u) {
+    // Newton's method seeded with the linear guess, exact on the first
+    // step for linear segments
+    constexpr float Epsilon = 1E-6f;
+    constexpr int MaxNewtonIterations = 8;
+    constexpr int MaxBisectionIterations = 24;
+
+    float t = u;
+    for (int i = 0; i < MaxNewtonIterations; ++i) {
+        const float d = ((x[0] * t + x[1]) * t + x[2]) * t - u;
+        if (std::abs(d) < Epsilon) return t;
+
+        const float slope = (3 * x[0] * t + 2 * x[1]) * t + x[2];
+        if (std::abs(slope) < Epsilon) break;
+
+        t -= d / slope;
+        if (t < 0.0f || t > 1.0f) break;
     }
-    else {
-        return 0.0f;
+
+    // Flat or badly behaved handles
+    float l = 0.0f;
+    float r = 1.0f;
+    for (int i = 0; i < MaxBisectionIterations; ++i) {
+        t = (l + r) / 2.0f;
+
+        const float d = ((x[0] * t + x[1]) * t + x[2]) * t - u;
+        if (std::abs(d) < Epsilon) return t;
+        else if (d < 0) l = t;
+        else r = t;
     }
+
+    return (l + r) / 2.0f;
 }
 
 float ysAnimationCurve::GetRestValue() {
@@ -75,6 +174,7 @@ float ysAnimationCurve::GetRestValue() {
 
 void ysAnimationCurve::AddSamplePoint( const ysAnimationCurve::CurveHandle &handle) {
     m_samples[handle.s] = handle;
+    m_baked = false;
 }
 
 void ysAnimationCurve::AddLinearSamplePoint(float s, float t) {
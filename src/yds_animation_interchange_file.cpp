@@ -1,5 +1,6 @@
 #include "../include/yds_animation_interchange_file.h"
 
+#include "../include/yds_animation_action.h"
 #include "../include/yds_animation_interchange_file_reader_0_0.h"
 #include "../include/yds_animation_interchange_file_reader_0_1.h"
 
@@ -73,6 +74,7 @@ ysError ysAnimationInterchangeFile::ReadAction(ysAnimationAction *action) {
     YDS_ERROR_DECLARE("ReadAction");
 
     YDS_NESTED_ERROR_CALL(m_reader->ReadAction(m_file, action));
+    action->Bake();
 
     return YDS_ERROR_RETURN(ysError::None);
 }
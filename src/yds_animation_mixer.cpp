@@ -2,6 +2,7 @@
 
 #include "../include/yds_animation_action.h"
 #include "../include/yds_animation_action_binding.h"
+#include "../include/yds_profiler.h"
 
 #include <assert.h>
 #include <algorithm>
@@ -28,6 +29,8 @@ void ysAnimationChannel::Reset() {
 }
 
 void ysAnimationChannel::Sample() {
+    YDS_TRACE_SCOPE("Animation");
+
     HandleQueue();
 
     // Update segment that is fading in first
@@ -6,6 +6,8 @@ ysAnimationTarget::ysAnimationTarget() {
     for (int i = 0; i < 4; ++i) {
         m_locationCurves[i] = nullptr;
         m_rotationCurves[i] = nullptr;
+        m_locationCursors[i] = 0;
+        m_rotationCursors[i] = 0;
     }
 
     m_rotationTarget = nullptr;
@@ -20,14 +22,14 @@ void ysAnimationTarget::Sample(float s, float amplitude) {
     for (int i = 0; i < 4; ++i) {
         if (m_locationCurves[i] != nullptr) {
             m_locationTarget->Accumulate(
-                m_locationCurves[i]->Sample(s) * amplitude, i);
+                m_locationCurves[i]->Sample(s, &m_locationCursors[i]) * amplitude, i);
         }
     }
 
     if (m_rotationCurves[0] != nullptr) {
         float rotation[4];
         for (int i = 0; i < 4; ++i) {
-            rotation[i] = m_rotationCurves[i]->Sample(s);
+            rotation[i] = m_rotationCurves[i]->Sample(s, &m_rotationCursors[i]);
         }
 
         ysQuaternion q = ysMath::LoadVector(rotation[0], rotation[1], rotation[2], rotation[3]);
@@ -51,8 +53,10 @@ void ysAnimationTarget::SampleRest(float amplitude) {
 
 void ysAnimationTarget::SetLocationCurve(ysAnimationCurve *curve, int index) {
     m_locationCurves[index] = curve;
+    m_locationCursors[index] = 0;
 }
 
 void ysAnimationTarget::SetRotationCurve(ysAnimationCurve *curve, int index) {
     m_rotationCurves[index] = curve;
+    m_rotationCursors[index] = 0;
 }
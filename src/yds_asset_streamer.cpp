@@ -0,0 +1,105 @@
+#include "../include/yds_asset_streamer.h"
+
+ysAssetStreamer::ysAssetStreamer() {
+    m_running = false;
+    m_loading = 0;
+}
+
+ysAssetStreamer::~ysAssetStreamer() {
+    Destroy();
+}
+
+void ysAssetStreamer::Initialize() {
+    if (IsInitialized()) return;
+
+    m_running = true;
+    m_thread = std::thread(&ysAssetStreamer::IoLoop, this);
+}
+
+void ysAssetStreamer::Destroy() {
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_running = false;
+    }
+
+    m_wake.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+
+    m_queue.clear();
+    m_completed.clear();
+    m_loading = 0;
+}
+
+void ysAssetStreamer::Request(uint64_t key, LoadFunction function, void *context, int index) {
+    PendingLoad load;
+    load.Key = key;
+    load.Function = function;
+    load.Context = context;
+    load.Index = index;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_queue.push_back(load);
+    }
+
+    m_wake.notify_one();
+}
+
+int ysAssetStreamer::Collect(std::vector<Completion> *completed, int64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    int count = 0;
+    int64_t bytes = 0;
+    while (!m_completed.empty()) {
+        const int64_t size = (int64_t)m_completed.front().Data.size();
+        if (count > 0 && bytes + size > maxBytes) break;
+
+        completed->push_back(std::move(m_completed.front()));
+        m_completed.pop_front();
+
+        bytes += size;
+        ++count;
+    }
+
+    return count;
+}
+
+void ysAssetStreamer::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_idle.wait(lock, [this] { return !m_running || (m_queue.empty() && m_loading == 0); });
+}
+
+int ysAssetStreamer::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return (int)m_queue.size() + m_loading + (int)m_completed.size();
+}
+
+void ysAssetStreamer::IoLoop() {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true) {
+        m_wake.wait(lock, [this] { return !m_running || !m_queue.empty(); });
+        if (!m_running) break;
+
+        const PendingLoad load = m_queue.front();
+        m_queue.pop_front();
+        m_loading = 1;
+
+        // The lock is only held while touching the queues, never during I/O
+        lock.unlock();
+
+        Completion completion;
+        completion.Key = load.Key;
+        completion.Success = load.Function(load.Context, load.Index, &completion.Data);
+        if (!completion.Success) completion.Data.clear();
+
+        lock.lock();
+
+        m_completed.push_back(std::move(completion));
+        m_loading = 0;
+
+        if (m_queue.empty()) m_idle.notify_all();
+    }
+
+    m_idle.notify_all();
+}
@@ -5,6 +5,8 @@
 
 #include <assert.h>
 
+constexpr ysBreakdownTimer::ChannelId ysBreakdownTimer::InvalidChannel;
+
 ysBreakdownTimer::ysBreakdownTimer() {
     m_frameCount = 0;
 }
@@ -38,42 +40,77 @@ void ysBreakdownTimer::EndFrame() {
     ++m_frameCount;
 }
 
-void ysBreakdownTimer::StartMeasurement(const std::string &timerChannelName) {
-    ysBreakdownTimerChannel *channel = FindChannel(timerChannelName);
-    assert(channel != nullptr);
+void ysBreakdownTimer::StartMeasurement(ChannelId channelId) {
+    assert(channelId >= 0 && channelId < GetChannelCount());
+    ysBreakdownTimerChannel *channel = m_channels.Get(channelId);
 
-    m_executionOrder.New() = timerChannelName;
+    m_executionOrder.New() = channelId;
 
-    uint64_t timestamp = ysTimingSystem::Get()->GetTime();
+    uint64_t timestamp = ysTimingSystem::Now();
 
     channel->StartMeasurement(timestamp);
 
-    uint64_t frameCount = channel->GetFrameCount();
-    assert(frameCount == m_frameCount);
+    assert(channel->GetFrameCount() == m_frameCount);
 }
 
-void ysBreakdownTimer::EndMeasurement(const std::string &timerChannelName) {
-    ysBreakdownTimerChannel *channel = FindChannel(timerChannelName);
-    assert(channel != nullptr);
+void ysBreakdownTimer::EndMeasurement(ChannelId channelId) {
+    uint64_t timestamp = ysTimingSystem::Now();
+
+    m_channels.Get(channelId)->EndMeasurement(timestamp);
+}
+
+void ysBreakdownTimer::SkipMeasurement(ChannelId channelId) {
+    StartMeasurement(channelId);
+    EndMeasurement(channelId);
+}
 
-    uint64_t timestamp = ysTimingSystem::Get()->GetTime();
+void ysBreakdownTimer::StartMeasurement(const std::string &timerChannelName) {
+    const ChannelId channel = FindChannelId(timerChannelName);
+    assert(channel != InvalidChannel);
 
-    channel->EndMeasurement(timestamp);
+    StartMeasurement(channel);
+}
+
+void ysBreakdownTimer::EndMeasurement(const std::string &timerChannelName) {
+    const ChannelId channel = FindChannelId(timerChannelName);
+    assert(channel != InvalidChannel);
+
+    EndMeasurement(channel);
 }
 
 void ysBreakdownTimer::SkipMeasurement(const std::string &timerChannelName) {
-    StartMeasurement(timerChannelName);
-    EndMeasurement(timerChannelName);
+    const ChannelId channel = FindChannelId(timerChannelName);
+    assert(channel != InvalidChannel);
+
+    SkipMeasurement(channel);
 }
 
 ysBreakdownTimerChannel *ysBreakdownTimer::CreateChannel(const std::string &timerChannelName, int bufferSize) {
+    assert(FindChannelId(timerChannelName) == InvalidChannel);
+
     ysBreakdownTimerChannel *newChannel = m_channels.New();
     newChannel->SetName(timerChannelName);
+    newChannel->SetId(m_channels.GetNumObjects() - 1);
     newChannel->Initialize(bufferSize);
 
     return newChannel;
 }
 
+ysBreakdownTimer::ChannelId ysBreakdownTimer::FindChannelId(const std::string &timerChannelName) const {
+    return FindChannelId(HashName(timerChannelName.c_str()));
+}
+
+ysBreakdownTimer::ChannelId ysBreakdownTimer::FindChannelId(uint64_t nameHash) const {
+    const int n = GetChannelCount();
+    for (int i = 0; i < n; ++i) {
+        if (m_channels.Get(i)->GetNameHash() == nameHash) {
+            return i;
+        }
+    }
+
+    return InvalidChannel;
+}
+
 void ysBreakdownTimer::OpenLogFile(const std::string &filename) {
     m_logFile.open(filename.c_str(), std::ios::out);
 
@@ -110,12 +147,8 @@ void ysBreakdownTimer::CloseLogFile() {
 }
 
 ysBreakdownTimerChannel *ysBreakdownTimer::FindChannel(const std::string &s) {
-    const int n = GetChannelCount();
-    for (int i = 0; i < n; ++i) {
-        if (m_channels.Get(i)->GetName() == s) {
-            return m_channels.Get(i);
-        }
-    }
-
-    return nullptr;
+    const ChannelId channel = FindChannelId(s);
+    return (channel != InvalidChannel)
+        ? m_channels.Get(channel)
+        : nullptr;
 }
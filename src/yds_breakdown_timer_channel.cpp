@@ -1,23 +1,32 @@
 #include "../include/yds_breakdown_timer_channel.h"
 
+#include "../include/yds_breakdown_timer.h"
 #include "../include/yds_timing.h"
 
 #include <assert.h>
 
 ysBreakdownTimerChannel::ysBreakdownTimerChannel() {
     m_name = "";
+    m_nameHash = ysBreakdownTimer::HashName("");
+    m_id = ysBreakdownTimer::InvalidChannel;
     m_sampleBuffer = nullptr;
     m_currentWriteIndex = 0;
     m_bufferSize = 0;
     m_entryCount = 0;
-    m_midMeasurement = false;
+    m_nestingDepth = 0;
     m_frameCount = 0;
+    m_lastMeasurementStart = 0;
 }
 
 ysBreakdownTimerChannel::~ysBreakdownTimerChannel() {
     if (m_sampleBuffer != nullptr) Destroy();
 }
 
+void ysBreakdownTimerChannel::SetName(const std::string &name) {
+    m_name = name;
+    m_nameHash = ysBreakdownTimer::HashName(name.c_str());
+}
+
 void ysBreakdownTimerChannel::Initialize(int bufferSize) {
     m_bufferSize = bufferSize;
     m_sampleBuffer = new double[m_bufferSize];
@@ -57,17 +66,15 @@ double ysBreakdownTimerChannel::GetLastSample() const {
 }
 
 void ysBreakdownTimerChannel::StartMeasurement(uint64_t timestamp) {
-    assert(!m_midMeasurement);
+    if (m_nestingDepth++ > 0) return;
 
     m_lastMeasurementStart = timestamp;
-    m_midMeasurement = true;
 }
 
 void ysBreakdownTimerChannel::EndMeasurement(uint64_t timestamp) {
-    assert(m_midMeasurement);
+    assert(m_nestingDepth > 0);
+    if (--m_nestingDepth > 0) return;
 
-    double s = ysTimingSystem::Get()->ConvertToSeconds(timestamp - m_lastMeasurementStart);
+    double s = ysTimingSystem::TicksToSeconds(timestamp - m_lastMeasurementStart);
     RecordSample(s);
-
-    m_midMeasurement = false;
 }
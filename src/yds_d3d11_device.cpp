@@ -635,7 +635,13 @@ ysError ysD3D11Device::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, cha
     return YDS_ERROR_RETURN(ysError::None);
 }
 
-ysError ysD3D11Device::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam) {
+ysError ysD3D11Device::CreateIndexBuffer(
+    ysGPUBuffer **newBuffer,
+    int size,
+    char *data,
+    bool mirrorToRam,
+    ysGPUBuffer::IndexFormat format)
+{
     YDS_ERROR_DECLARE("CreateIndexBuffer");
 
     if (newBuffer == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
@@ -669,6 +675,7 @@ ysError ysD3D11Device::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char
     newD3D11Buffer->m_size = size;
     newD3D11Buffer->m_mirrorToRAM = mirrorToRam;
     newD3D11Buffer->m_bufferType = ysGPUBuffer::GPU_INDEX_BUFFER;
+    newD3D11Buffer->m_indexFormat = format;
     newD3D11Buffer->m_buffer = buffer;
 
     if (mirrorToRam) {
@@ -769,7 +776,10 @@ ysError ysD3D11Device::UseIndexBuffer(ysGPUBuffer *buffer, int offset) {
         ysD3D11GPUBuffer *d3d11Buffer = static_cast<ysD3D11GPUBuffer *>(buffer);
 
         if (d3d11Buffer->m_bufferType == ysGPUBuffer::GPU_INDEX_BUFFER && buffer != m_activeIndexBuffer) {
-            GetImmediateContext()->IASetIndexBuffer(d3d11Buffer->m_buffer, DXGI_FORMAT_R16_UINT, uoffset);
+            const DXGI_FORMAT format = (buffer->GetIndexFormat() == ysGPUBuffer::IndexFormat::UInt32)
+                ? DXGI_FORMAT_R32_UINT
+                : DXGI_FORMAT_R16_UINT;
+            GetImmediateContext()->IASetIndexBuffer(d3d11Buffer->m_buffer, format, uoffset);
         }
     }
     else {
@@ -1358,6 +1368,14 @@ DXGI_FORMAT ysD3D11Device::ConvertInputLayoutFormat(ysRenderGeometryChannel::Cha
         return DXGI_FORMAT_R32G32B32A32_UINT;
     case ysRenderGeometryChannel::ChannelFormat::R32G32B32_UINT:
         return DXGI_FORMAT_R32G32B32_UINT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16_FLOAT:
+        return DXGI_FORMAT_R16G16_FLOAT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16_SNORM:
+        return DXGI_FORMAT_R16G16_SNORM;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16B16A16_FLOAT:
+        return DXGI_FORMAT_R16G16B16A16_FLOAT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16B16A16_UNORM:
+        return DXGI_FORMAT_R16G16B16A16_UNORM;
     case ysRenderGeometryChannel::ChannelFormat::Undefined:
     default:
         return DXGI_FORMAT_UNKNOWN;
@@ -1,5 +1,7 @@
 #include "../include/yds_dynamic_allocator.h"
 
+#include "../include/yds_allocation_tracker.h"
+
 ysDynamicAllocator::ysDynamicAllocator() : ysMemoryAllocator("DYN_ALLOCATOR") {
     m_blockPool = NULL;
     m_blocks = NULL;
@@ -77,10 +79,14 @@ void *ysDynamicAllocator::AllocateBlock(int size, int numObjects) {
         *metadataPointer = usedBlock;
     }
 
+    ysAllocationTracker::OnAllocate(allocatedData, size, ysAllocationTracker::Source::MemoryAllocator);
+
     return allocatedData;
 }
 
 int ysDynamicAllocator::FreeBlock(void *block) {
+    ysAllocationTracker::OnFree(block, ysAllocationTracker::Source::MemoryAllocator);
+
     BlockLink **metadataPointer = (BlockLink **)( (char *)block - sizeof(BlockLink *) );
     BlockLink *metadata = *metadataPointer;
 
@@ -1,24 +1,21 @@
-// TEMP
-#include <Windows.h>
-#include <WinBase.h>
-
 #include "../include/yds_error_system.h"
 
 #include "../include/yds_error_handler.h"
 
 #include <assert.h>
 
-ysErrorSystem *ysErrorSystem::g_instance = nullptr;
+std::atomic<ysErrorSystem *> ysErrorSystem::g_instance(nullptr);
 
-ysErrorSystem::ysErrorSystem() {
-    if (g_instance != nullptr) {
-        YDS_ERROR_RAISE(ysError::MultipleErrorSystems);
-    }
+#ifndef YDS_DISABLE_ERROR_STACK
+thread_local ysErrorSystem::CallStack ysErrorSystem::t_callStack = { 0, { nullptr } };
+#endif /* YDS_DISABLE_ERROR_STACK */
 
-    g_instance = this;
+namespace {
+    std::mutex s_instanceLock;
+}
 
-    memset((void *)m_callStack, 0, sizeof(m_callStack));
-    m_stackLevel = 0;
+ysErrorSystem::ysErrorSystem() {
+    /* void */
 }
 
 ysErrorSystem::~ysErrorSystem() {
@@ -26,16 +23,29 @@ ysErrorSystem::~ysErrorSystem() {
 }
 
 ysErrorSystem *ysErrorSystem::GetInstance() {
-    if (g_instance == nullptr) g_instance = new ysErrorSystem;
-    return g_instance;
+    ysErrorSystem *instance = g_instance.load(std::memory_order_acquire);
+    if (instance != nullptr) return instance;
+
+    std::lock_guard<std::mutex> lock(s_instanceLock);
+    instance = g_instance.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+        instance = new ysErrorSystem;
+        g_instance.store(instance, std::memory_order_release);
+    }
+
+    return instance;
 }
 
 void ysErrorSystem::Destroy() {
-    delete [] g_instance;
+    std::lock_guard<std::mutex> lock(s_instanceLock);
+    delete g_instance.exchange(nullptr, std::memory_order_acq_rel);
 }
 
 ysError ysErrorSystem::RaiseError(ysError error, unsigned int line, ysObject *object, const char *file, const char *msg, bool affectStack) {
+    (void)msg;
+
     if (error != ysError::None) {
+        std::lock_guard<std::mutex> lock(m_handlerLock);
         for (int i = 0; i < m_errorHandlers.GetNumObjects(); i++) {
             m_errorHandlers.Get(i)->OnError(error, line, object, file);
         }
@@ -45,18 +55,20 @@ ysError ysErrorSystem::RaiseError(ysError error, unsigned int line, ysObject *ob
         StackDescend();
     }
 
-    assert(m_stackLevel >= 0);
+    assert(GetStackLevel() >= 0);
 
     return error;
 }
 
-void ysErrorSystem::StackRaise(const char *callName) {
-    assert(m_stackLevel >= 0);
+ysError ysErrorSystem::DetachErrorHandler(ysErrorHandler *handler) {
+    if (handler == nullptr) return ysError::InvalidParameter;
 
-    m_callStack[m_stackLevel] = callName;
-    m_stackLevel++;
-}
+    std::lock_guard<std::mutex> lock(m_handlerLock);
+    for (int i = 0; i < m_errorHandlers.GetNumObjects(); i++) {
+        if (m_errorHandlers.Get(i) == handler) {
+            return m_errorHandlers.Delete(i);
+        }
+    }
 
-void ysErrorSystem::StackDescend() {
-    --m_stackLevel;
+    return ysError::InvalidParameter;
 }
@@ -23,3 +23,7 @@ void ysFileLogger::Close() {
 void ysFileLogger::Write(const char *data) {
     m_stream.write(data, strlen(data));
 }
+
+void ysFileLogger::Flush() {
+    m_stream.flush();
+}
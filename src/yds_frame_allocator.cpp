@@ -0,0 +1,138 @@
+#include "../include/yds_frame_allocator.h"
+
+#include "../include/yds_allocation_tracker.h"
+#include "../include/yds_allocator.h"
+
+ysFrameAllocator::ysFrameAllocator() : ysMemoryAllocator("FRAME_ALLOCATOR") {
+    for (int i = 0; i < ArenaCount; ++i) {
+        m_arenas[i].Data = nullptr;
+        m_arenas[i].Capacity = 0;
+        m_arenas[i].Offset = 0;
+        m_arenas[i].Used = 0;
+        m_arenas[i].Overflow = nullptr;
+    }
+
+    m_currentArena = 0;
+
+    m_allocationCount = 0;
+    m_lastFrameAllocationCount = 0;
+    m_overflowCount = 0;
+    m_highWaterMark = 0;
+}
+
+ysFrameAllocator::~ysFrameAllocator() {
+    Destroy();
+}
+
+void ysFrameAllocator::Initialize(size_t capacity) {
+    Destroy();
+
+    capacity = AlignSize(capacity);
+    for (int i = 0; i < ArenaCount; ++i) {
+        m_arenas[i].Data = (char *)ysAllocator::BlockAllocate<Alignment>((int)capacity);
+        m_arenas[i].Capacity = capacity;
+    }
+}
+
+void ysFrameAllocator::StartFrame() {
+    const size_t used = m_arenas[m_currentArena].Used;
+    if (used > m_highWaterMark) m_highWaterMark = used;
+
+    m_lastFrameAllocationCount = m_allocationCount;
+    m_allocationCount = 0;
+
+    m_currentArena = (m_currentArena + 1) % ArenaCount;
+    ResetArena(&m_arenas[m_currentArena]);
+}
+
+void *ysFrameAllocator::AllocateBlock(int size, int numObjects) {
+    Arena &arena = m_arenas[m_currentArena];
+
+    const size_t totalSize = HeaderSize + AlignSize((size_t)size);
+    arena.Used += totalSize;
+    ++m_allocationCount;
+
+    char *block;
+    if (arena.Offset + totalSize <= arena.Capacity) {
+        block = arena.Data + arena.Offset;
+        arena.Offset += totalSize;
+    }
+    else {
+        // Out of space, fall back to the heap until the arena is resized
+        char *overflow = (char *)ysAllocator::BlockAllocate<Alignment>((int)(OverflowHeaderSize + totalSize));
+        if (overflow == nullptr) return nullptr;
+
+        OverflowBlock *link = reinterpret_cast<OverflowBlock *>(overflow);
+        link->Next = arena.Overflow;
+        arena.Overflow = link;
+
+        block = overflow + OverflowHeaderSize;
+        ++m_overflowCount;
+    }
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(block);
+    header->NumObjects = numObjects;
+    header->Size = size;
+
+    ysAllocationTracker::OnAllocate(block + HeaderSize, size, ysAllocationTracker::Source::FrameAllocator);
+
+    return block + HeaderSize;
+}
+
+int ysFrameAllocator::FreeBlock(void *block) {
+    if (block == nullptr) return 0;
+
+    // Memory is only reclaimed when the arena is reset
+    const BlockHeader *header = reinterpret_cast<const BlockHeader *>((char *)block - HeaderSize);
+    return header->NumObjects;
+}
+
+void ysFrameAllocator::Destroy() {
+    for (int i = 0; i < ArenaCount; ++i) {
+        FreeArena(&m_arenas[i]);
+    }
+}
+
+ysFrameAllocator *ysFrameAllocator::GetThreadAllocator() {
+    static thread_local ysFrameAllocator allocator;
+    return &allocator;
+}
+
+void ysFrameAllocator::ResetArena(Arena *arena) {
+    ReleaseOverflow(arena);
+
+    // Grow the arena so that the last frame's demand fits without overflowing
+    if (arena->Used > arena->Capacity) {
+        size_t newCapacity = (arena->Capacity > 0) ? arena->Capacity : (size_t)(64 * KB);
+        while (newCapacity < arena->Used) newCapacity *= 2;
+
+        if (arena->Data != nullptr) ysAllocator::BlockFree(arena->Data, Alignment);
+        arena->Data = (char *)ysAllocator::BlockAllocate<Alignment>((int)newCapacity);
+        arena->Capacity = (arena->Data != nullptr) ? newCapacity : 0;
+    }
+
+    arena->Offset = 0;
+    arena->Used = 0;
+}
+
+void ysFrameAllocator::FreeArena(Arena *arena) {
+    ReleaseOverflow(arena);
+
+    if (arena->Data != nullptr) ysAllocator::BlockFree(arena->Data, Alignment);
+
+    arena->Data = nullptr;
+    arena->Capacity = 0;
+    arena->Offset = 0;
+    arena->Used = 0;
+}
+
+void ysFrameAllocator::ReleaseOverflow(Arena *arena) {
+    OverflowBlock *overflow = arena->Overflow;
+    while (overflow != nullptr) {
+        OverflowBlock *next = overflow->Next;
+        ysAllocator::BlockFree(overflow, Alignment);
+        overflow = next;
+    }
+
+    arena->Overflow = nullptr;
+}
@@ -1,27 +1,138 @@
 #include "../include/yds_geometry_export_file.h"
 
+#include "../include/yds_vertex_quantization.h"
+
 #include <math.h>
 
+constexpr uint32_t ysGeometryExportFile::SceneFileMagic;
+constexpr int ysGeometryExportFile::CurrentVersion;
+constexpr int ysGeometryExportFile::HeaderAlignment;
+constexpr int ysGeometryExportFile::VertexDataAlignment;
+constexpr int ysGeometryExportFile::IndexDataAlignment;
+constexpr int ysGeometryExportFile::MaxShortIndexVertexCount;
+
 ysGeometryExportFile::ysGeometryExportFile() : ysObject("ysGeometryExportFile") {
-    /* void */
+    m_version = CurrentVersion;
 }
 
 ysGeometryExportFile::~ysGeometryExportFile() {
-    /* void */
+    // Version 2 files are only valid once Close() writes the header
+    if (m_file.is_open()) Close();
 }
 
-ysError ysGeometryExportFile::Open(const char *fname) {
+ysError ysGeometryExportFile::Open(const char *fname, int version) {
     YDS_ERROR_DECLARE("Open");
 
+    if (version != 1 && version != 2) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
     m_file.open(fname, std::ios::binary);
 
     if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
 
+    m_version = version;
+    m_toc.clear();
+    m_contentHashes.clear();
+
+    if (m_version >= 2) {
+        // Filled in by Close() once the table of contents is known
+        SceneFileHeader header;
+        memset(&header, 0, sizeof(SceneFileHeader));
+        m_file.write((char *)&header, sizeof(SceneFileHeader));
+    }
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysGeometryExportFile::Close() {
+    YDS_ERROR_DECLARE("Close");
+
+    if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::None);
+
+    if (m_version >= 2) {
+        const uint32_t objectCount = (uint32_t)m_toc.size();
+
+        Align(VertexDataAlignment);
+        const uint64_t tocOffset = GetPosition();
+        if (objectCount > 0) {
+            m_file.write((char *)m_toc.data(), sizeof(TocEntry) * objectCount);
+        }
+
+        // Keep the load factor at or below one half
+        uint32_t tableSize = 0;
+        if (objectCount > 0) {
+            tableSize = 1;
+            while (tableSize < 2 * objectCount) tableSize *= 2;
+        }
+
+        std::vector<uint32_t> table(tableSize, 0);
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            uint32_t slot = m_toc[i].NameHash & (tableSize - 1);
+            while (table[slot] != 0) slot = (slot + 1) & (tableSize - 1);
+
+            table[slot] = i + 1;
+        }
+
+        Align(HeaderAlignment);
+        const uint64_t nameTableOffset = GetPosition();
+        if (tableSize > 0) {
+            m_file.write((char *)table.data(), sizeof(uint32_t) * tableSize);
+        }
+
+        // Only stored if at least one object has a hash
+        uint64_t contentHashOffset = 0;
+        for (uint64_t hash : m_contentHashes) {
+            if (hash == 0) continue;
+
+            Align(HeaderAlignment);
+            contentHashOffset = GetPosition();
+            m_file.write((char *)m_contentHashes.data(), sizeof(uint64_t) * objectCount);
+            break;
+        }
+
+        SceneFileHeader header;
+        memset(&header, 0, sizeof(SceneFileHeader));
+        header.Magic = SceneFileMagic;
+        header.Version = (uint32_t)m_version;
+        header.ObjectCount = objectCount;
+        header.NameTableSize = tableSize;
+        header.TocOffset = tocOffset;
+        header.NameTableOffset = nameTableOffset;
+        header.FileSize = GetPosition();
+        header.ContentHashOffset = contentHashOffset;
+
+        m_file.seekp(0, std::ios::beg);
+        m_file.write((char *)&header, sizeof(SceneFileHeader));
+    }
+
+    const bool failed = m_file.fail();
+    m_file.close();
+    m_toc.clear();
+    m_contentHashes.clear();
+
+    if (failed) return YDS_ERROR_RETURN(ysError::CouldNotWriteFile);
+
     return YDS_ERROR_RETURN(ysError::None);
 }
 
-void ysGeometryExportFile::Close() {
-    if (m_file.is_open()) m_file.close();
+uint32_t ysGeometryExportFile::HashName(const char *name) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const char *c = name; *c != '\0'; ++c) {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void ysGeometryExportFile::Align(int alignment) {
+    static const char Padding[VertexDataAlignment] = { 0 };
+
+    const uint64_t position = GetPosition();
+    const uint64_t remainder = position % alignment;
+    if (remainder != 0) {
+        m_file.write(Padding, (std::streamsize)(alignment - remainder));
+    }
 }
 
 void ysGeometryExportFile::FillOutputHeader(ysObjectData* object, ObjectOutputHeader* header) {
@@ -54,6 +165,7 @@ void ysGeometryExportFile::FillOutputHeader(ysObjectData* object, ObjectOutputHe
     if (object->m_normals.IsActive())                header->Flags |= MDF_NORMALS;
     if (object->m_tangents.IsActive())                header->Flags |= MDF_TANGENTS;
     if (object->m_objectStatistics.NumUVChannels)    header->Flags |= MDF_TEXTURE_DATA;
+    if (header->NumVertices > MaxShortIndexVertexCount) header->Flags |= MDF_32BIT_INDICES;
 
     float minx = FLT_MAX, miny = FLT_MAX, minz = FLT_MAX, maxx = -FLT_MAX, maxy = -FLT_MAX, maxz = -FLT_MAX;
     if (object->m_objectInformation.ObjectType == ysObjectData::ObjectType::Geometry) {
@@ -102,6 +214,8 @@ void ysGeometryExportFile::FillOutputHeader(const ysInterchangeObject *object, c
     if (info->IncludeNormals)                    header->Flags |= MDF_NORMALS;
     if (info->IncludeTangents)                    header->Flags |= MDF_TANGENTS;
     if (header->NumUVChannels > 0)                header->Flags |= MDF_TEXTURE_DATA;
+    if (header->NumVertices > MaxShortIndexVertexCount) header->Flags |= MDF_32BIT_INDICES;
+    if (info->Quantize)                            header->Flags |= MDF_QUANTIZED;
 
     float minx = FLT_MAX, miny = FLT_MAX, minz = FLT_MAX, maxx = -FLT_MAX, maxy = -FLT_MAX, maxz = -FLT_MAX;
     if (object->Type == ysInterchangeObject::ObjectType::Geometry) {
@@ -125,6 +239,15 @@ int ysGeometryExportFile::GetVertexSize(ysInterchangeObject *object, const Verte
     const bool includeNormals = info->IncludeNormals;
     const bool includeTangents = info->IncludeTangents;
 
+    if (info->Quantize) {
+        int vertexSize = 4 * sizeof(uint16_t);
+        vertexSize += numUVChannels * (2 * sizeof(uint16_t));
+        if (includeNormals) vertexSize += sizeof(int16_t) * 2;
+        if (includeTangents) vertexSize += sizeof(int16_t) * 2;
+
+        return vertexSize;
+    }
+
     int vertexSize = 4 * sizeof(float);
     /* TODO: bone weights */
     vertexSize += numUVChannels * (2 * sizeof(float));
@@ -144,6 +267,19 @@ void ysGeometryExportFile::WriteFloatToBuffer(float value, char **location) {
     (*location) += sizeof(float);
 }
 
+void ysGeometryExportFile::WriteShortToBuffer(uint16_t value, char **location) {
+    memcpy(*location, &value, sizeof(uint16_t));
+    (*location) += sizeof(uint16_t);
+}
+
+void ysGeometryExportFile::WriteOctahedralToBuffer(const ysVector3 &v, char **location) {
+    int16_t encoded[2];
+    ysVertexQuantization::EncodeOctahedral(v.x, v.y, v.z, encoded);
+
+    WriteShortToBuffer((uint16_t)encoded[0], location);
+    WriteShortToBuffer((uint16_t)encoded[1], location);
+}
+
 int ysGeometryExportFile::PackVertexData(ysObjectData *object, int maxBonesPerVertex, void **output) {
     int packedSize = 0;
 
@@ -317,17 +453,42 @@ int ysGeometryExportFile::PackVertexData(ysInterchangeObject *object, int maxBon
     char *data = (char *)malloc(packedSize);
     char *location = data;
 
+    // Quantized positions are relative to the same extremes FillOutputHeader() writes
+    ysVector3 minExtreme(FLT_MAX, FLT_MAX, FLT_MAX);
+    ysVector3 maxExtreme(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int vert = 0; info->Quantize && vert < numVertices; vert++) {
+        const ysVector3 &vertex = object->Vertices[vert];
+        minExtreme = ysVector3(fminf(minExtreme.x, vertex.x), fminf(minExtreme.y, vertex.y), fminf(minExtreme.z, vertex.z));
+        maxExtreme = ysVector3(fmaxf(maxExtreme.x, vertex.x), fmaxf(maxExtreme.y, vertex.y), fmaxf(maxExtreme.z, vertex.z));
+    }
+
     for (int vert = 0; vert < numVertices; vert++) {
         ysVector3 &vertex = object->Vertices[vert];
 
-        WriteFloatToBuffer(vertex.x, &location);
-        WriteFloatToBuffer(vertex.y, &location);
-        WriteFloatToBuffer(vertex.z, &location);
-        WriteFloatToBuffer(1.0f, &location);
+        if (info->Quantize) {
+            WriteShortToBuffer(ysVertexQuantization::QuantizeUnorm16(vertex.x, minExtreme.x, maxExtreme.x), &location);
+            WriteShortToBuffer(ysVertexQuantization::QuantizeUnorm16(vertex.y, minExtreme.y, maxExtreme.y), &location);
+            WriteShortToBuffer(ysVertexQuantization::QuantizeUnorm16(vertex.z, minExtreme.z, maxExtreme.z), &location);
+            WriteShortToBuffer(0xFFFF, &location);
+        }
+        else {
+            WriteFloatToBuffer(vertex.x, &location);
+            WriteFloatToBuffer(vertex.y, &location);
+            WriteFloatToBuffer(vertex.z, &location);
+            WriteFloatToBuffer(1.0f, &location);
+        }
 
         if (numRequiredUVChannels > 0) {
             for (int channel = 0; channel < numRequiredUVChannels; ++channel) {
-                if (channel >= numUVChannels) {
+                if (info->Quantize) {
+                    const ysVector2 uv = (channel >= numUVChannels)
+                        ? ysVector2(0.0f, 0.0f)
+                        : object->UVChannels[channel].Coordinates[UVCoordinates[channel][vert]];
+
+                    WriteShortToBuffer(ysVertexQuantization::FloatToHalf(uv.x), &location);
+                    WriteShortToBuffer(ysVertexQuantization::FloatToHalf(uv.y), &location);
+                }
+                else if (channel >= numUVChannels) {
                     WriteFloatToBuffer(0.0f, &location);
                     WriteFloatToBuffer(0.0f, &location);
                 }
@@ -346,10 +507,15 @@ int ysGeometryExportFile::PackVertexData(ysInterchangeObject *object, int maxBon
                 ? object->Normals[normals[vert]]
                 : ysVector3(0.0f, 0.0f, 0.0f);
 
-            WriteFloatToBuffer(normal.x, &location);
-            WriteFloatToBuffer(normal.y, &location);
-            WriteFloatToBuffer(normal.z, &location);
-            WriteFloatToBuffer(0.0f, &location);
+            if (info->Quantize) {
+                WriteOctahedralToBuffer(normal, &location);
+            }
+            else {
+                WriteFloatToBuffer(normal.x, &location);
+                WriteFloatToBuffer(normal.y, &location);
+                WriteFloatToBuffer(normal.z, &location);
+                WriteFloatToBuffer(0.0f, &location);
+            }
         }
 
         /* TODO: bones */
@@ -358,12 +524,17 @@ int ysGeometryExportFile::PackVertexData(ysInterchangeObject *object, int maxBon
                 ? object->Tangents[tangents[vert]]
                 : ysVector3(0.0f, 0.0f, 0.0f);
 
-            WriteFloatToBuffer(tangent.x, &location);
-            WriteFloatToBuffer(tangent.y, &location);
-            WriteFloatToBuffer(tangent.z, &location);
+            if (info->Quantize) {
+                WriteOctahedralToBuffer(tangent, &location);
+            }
+            else {
+                WriteFloatToBuffer(tangent.x, &location);
+                WriteFloatToBuffer(tangent.y, &location);
+                WriteFloatToBuffer(tangent.z, &location);
 
-            /* TODO: space handedness goes here */
-            WriteFloatToBuffer(1.0f, &location);
+                /* TODO: space handedness goes here */
+                WriteFloatToBuffer(1.0f, &location);
+            }
         }
     }
 
@@ -399,78 +570,149 @@ ysError ysGeometryExportFile::WriteObject(ysObjectData *object) {
     if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::NoFile);
     if (object == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
 
-    ObjectOutputHeader header;
-    FillOutputHeader(object, &header);
+    CompiledObject compiled;
+    CompileObject(object, &compiled);
 
-    void *vertexData = nullptr;
-    int vertexDataSize = 0;
+    YDS_NESTED_ERROR_CALL(WriteObject(compiled));
 
-    if (object->m_objectInformation.ObjectType == ysObjectData::ObjectType::Geometry) {
-        vertexDataSize = PackVertexData(object, 4 /* TEMP */, &vertexData);
-        header.VertexDataSize = vertexDataSize;
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysGeometryExportFile::WriteObject(ysInterchangeObject *object, const VertexInfo *info) {
+    YDS_ERROR_DECLARE("WriteObject");
+
+    if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::NoFile);
+    if (object == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
+    CompiledObject compiled;
+    CompileObject(object, info, &compiled);
+
+    return YDS_ERROR_RETURN(WriteObject(compiled));
+}
+
+ysError ysGeometryExportFile::WriteObject(const CompiledObject &object) {
+    YDS_ERROR_DECLARE("WriteObject");
+
+    if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::NoFile);
+    if (object.Header.VertexDataSize != (int)object.VertexData.size()) {
+        return YDS_ERROR_RETURN(ysError::InvalidParameter);
+    }
+
+    const bool split = (object.Header.Flags & MDF_SUBMESHES) != 0;
+    const bool lods = (object.Header.Flags & MDF_LODS) != 0;
+    if (split != !object.Submeshes.empty()) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+    if (lods != !object.Lods.empty() || (lods && !split)) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
+    std::vector<char> indexData;
+    if (!PackIndices(object.Indices, (object.Header.Flags & MDF_32BIT_INDICES) != 0, &indexData)) {
+        return YDS_ERROR_RETURN(ysError::InvalidParameter);
     }
 
-    m_file.write((char *)&header, sizeof(ObjectOutputHeader));
+    std::vector<char> lodTable;
+    if (lods) {
+        LodTableHeader tableHeader;
+        memset(&tableHeader, 0, sizeof(LodTableHeader));
+        tableHeader.LodCount = (int)object.Lods.size();
+        tableHeader.SubmeshCount = (int)object.Submeshes.size();
+
+        const char *header = reinterpret_cast<const char *>(&tableHeader);
+        const char *lodData = reinterpret_cast<const char *>(object.Lods.data());
+        const char *submeshData = reinterpret_cast<const char *>(object.Submeshes.data());
+
+        lodTable.insert(lodTable.end(), header, header + sizeof(LodTableHeader));
+        lodTable.insert(lodTable.end(), lodData, lodData + object.Lods.size() * sizeof(Lod));
+        lodTable.insert(lodTable.end(), submeshData, submeshData + object.Submeshes.size() * sizeof(Submesh));
+    }
+
+    const void *extraData = lods
+        ? (const void *)lodTable.data()
+        : (split ? (const void *)object.Submeshes.data() : (const void *)object.ExtraData.data());
+    const size_t extraDataSize = lods
+        ? lodTable.size()
+        : (split ? object.Submeshes.size() * sizeof(Submesh) : object.ExtraData.size() * sizeof(float));
+
+    const ysError result = WriteRecord(
+        object.Header,
+        object.VertexData.data(),
+        indexData.data(),
+        (uint32_t)indexData.size(),
+        object.Bones,
+        extraData,
+        (uint32_t)extraDataSize,
+        object.ContentHash);
+
+    return YDS_ERROR_RETURN(result);
+}
+
+void ysGeometryExportFile::CompileObject(ysObjectData *object, CompiledObject *output) {
+    FillOutputHeader(object, &output->Header);
+
+    output->VertexData.clear();
+    output->Indices.clear();
+    output->Bones.clear();
+    output->ExtraData.clear();
+    output->Submeshes.clear();
+    output->Lods.clear();
 
     // Geometry Data
     if (object->m_objectInformation.ObjectType == ysObjectData::ObjectType::Geometry) {
-        m_file.write((char *)vertexData, vertexDataSize);
+        void *vertexData = nullptr;
+        const int vertexDataSize = PackVertexData(object, 4 /* TEMP */, &vertexData);
 
-        for (int i  =0; i < object->m_objectStatistics.NumFaces; ++i) {
+        output->VertexData.assign((char *)vertexData, (char *)vertexData + vertexDataSize);
+        output->Header.VertexDataSize = vertexDataSize;
+        free(vertexData);
+
+        output->Indices.reserve(object->m_objectStatistics.NumFaces * 3);
+        for (int i = 0; i < object->m_objectStatistics.NumFaces; ++i) {
             for (int facevert = 0; facevert < 3; facevert++) {
-                unsigned short reduced = object->m_vertexIndexSet[i].indices[facevert];
-                m_file.write((char *)&reduced, sizeof(unsigned short));
+                output->Indices.push_back((unsigned int)object->m_vertexIndexSet[i].indices[facevert]);
             }
         }
 
         // Bone Map
         for (int i = 0; i < object->m_boneIndices.GetNumObjects(); ++i) {
-            int *add = &object->m_boneIndices[i];
-            m_file.write((char *)add, sizeof(int));
+            output->Bones.push_back(object->m_boneIndices[i]);
         }
     }
 
     // Primitive Data
     if (object->m_objectInformation.ObjectType == ysObjectData::ObjectType::Plane) {
-        m_file.write((char *)&object->m_length, sizeof(float));
-        m_file.write((char *)&object->m_width, sizeof(float));
+        output->ExtraData.push_back(object->m_length);
+        output->ExtraData.push_back(object->m_width);
     }
-
-    return YDS_ERROR_RETURN(ysError::None);
 }
 
-ysError ysGeometryExportFile::WriteObject(ysInterchangeObject *object, const VertexInfo *info) {
-    YDS_ERROR_DECLARE("WriteObject");
-
-    if (!m_file.is_open()) return YDS_ERROR_RETURN(ysError::NoFile);
-    if (object == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
-
+void ysGeometryExportFile::CompileObject(ysInterchangeObject *object, const VertexInfo *info, CompiledObject *output) {
     VertexInfo defaultInfo;
     if (info == nullptr) {
         info = &defaultInfo;
     }
 
-    ObjectOutputHeader header;
-    FillOutputHeader(object, info, &header);
+    FillOutputHeader(object, info, &output->Header);
 
-    void *vertexData = nullptr;
-    int vertexDataSize = 0;
+    output->VertexData.clear();
+    output->Indices.clear();
+    output->Bones.clear();
+    output->ExtraData.clear();
+    output->Submeshes.clear();
+    output->Lods.clear();
 
     if (object->Type == ysInterchangeObject::ObjectType::Geometry) {
-        vertexDataSize = PackVertexData(object, 4 /* TEMP */, &vertexData, info);
-        header.VertexDataSize = vertexDataSize;
-    }
+        void *vertexData = nullptr;
+        const int vertexDataSize = PackVertexData(object, 4 /* TEMP */, &vertexData, info);
 
-    m_file.write((char *)&header, sizeof(ObjectOutputHeader));
+        output->VertexData.assign((char *)vertexData, (char *)vertexData + vertexDataSize);
+        output->Header.VertexDataSize = vertexDataSize;
+        free(vertexData);
+    }
 
     // Geometry Data
     if (object->Type == ysInterchangeObject::ObjectType::Geometry) {
-        m_file.write((char *)vertexData, vertexDataSize);
-
+        output->Indices.reserve(object->VertexIndices.size() * 3);
         for (size_t i = 0; i < object->VertexIndices.size(); ++i) {
             for (int facevert = 0; facevert < 3; ++facevert) {
-                unsigned short reduced = object->VertexIndices[i].indices[facevert];
-                m_file.write((char *)&reduced, sizeof(unsigned short));
+                output->Indices.push_back((unsigned int)object->VertexIndices[i].indices[facevert]);
             }
         }
 
@@ -479,9 +721,96 @@ ysError ysGeometryExportFile::WriteObject(ysInterchangeObject *object, const Ver
 
     // Primitive Data
     if (object->Type == ysInterchangeObject::ObjectType::Plane) {
-        m_file.write((char *)&object->Length, sizeof(float));
-        m_file.write((char *)&object->Width, sizeof(float));
+        output->ExtraData.push_back(object->Length);
+        output->ExtraData.push_back(object->Width);
+    }
+}
+
+bool ysGeometryExportFile::PackIndices(const std::vector<unsigned int> &indices, bool wide, std::vector<char> *output) {
+    if (wide) {
+        output->resize(indices.size() * sizeof(uint32_t));
+        if (!indices.empty()) memcpy(output->data(), indices.data(), output->size());
+
+        return true;
+    }
+
+    output->resize(indices.size() * sizeof(uint16_t));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] > (unsigned int)MaxShortIndexVertexCount) return false;
+
+        const uint16_t index = (uint16_t)indices[i];
+        memcpy(output->data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
     }
 
+    return true;
+}
+
+ysError ysGeometryExportFile::WriteRecord(
+    const ObjectOutputHeader &header,
+    const void *vertexData,
+    const void *indexData,
+    uint32_t indexDataSize,
+    const std::vector<int> &bones,
+    const void *extraData,
+    uint32_t extraDataSize,
+    uint64_t contentHash)
+{
+    YDS_ERROR_DECLARE("WriteRecord");
+
+    const uint32_t vertexDataSize = (uint32_t)header.VertexDataSize;
+    const uint32_t boneDataSize = (uint32_t)(bones.size() * sizeof(int));
+
+    if (m_version < 2) {
+        // Version 1 readers find the extra data by object type
+        if ((header.Flags & MDF_SUBMESHES) != 0) return YDS_ERROR_RETURN(ysError::UnsupportedFileVersion);
+
+        m_file.write((const char *)&header, sizeof(ObjectOutputHeader));
+        if (vertexDataSize > 0) m_file.write((const char *)vertexData, vertexDataSize);
+        if (indexDataSize > 0) m_file.write((const char *)indexData, indexDataSize);
+        if (boneDataSize > 0) m_file.write((const char *)bones.data(), boneDataSize);
+        if (extraDataSize > 0) m_file.write((const char *)extraData, extraDataSize);
+
+        return YDS_ERROR_RETURN(ysError::None);
+    }
+
+    TocEntry entry;
+    memset(&entry, 0, sizeof(TocEntry));
+    entry.NameHash = HashName(header.ObjectName);
+
+    Align(HeaderAlignment);
+    entry.HeaderOffset = GetPosition();
+    m_file.write((const char *)&header, sizeof(ObjectOutputHeader));
+
+    if (vertexDataSize > 0) {
+        Align(VertexDataAlignment);
+        entry.VertexDataOffset = GetPosition();
+        entry.VertexDataSize = vertexDataSize;
+        m_file.write((const char *)vertexData, vertexDataSize);
+    }
+
+    if (indexDataSize > 0) {
+        Align(IndexDataAlignment);
+        entry.IndexDataOffset = GetPosition();
+        entry.IndexDataSize = indexDataSize;
+        m_file.write((const char *)indexData, indexDataSize);
+    }
+
+    if (boneDataSize > 0) {
+        Align(HeaderAlignment);
+        entry.BoneDataOffset = GetPosition();
+        entry.BoneDataSize = boneDataSize;
+        m_file.write((const char *)bones.data(), boneDataSize);
+    }
+
+    if (extraDataSize > 0) {
+        Align(HeaderAlignment);
+        entry.ExtraDataOffset = GetPosition();
+        entry.ExtraDataSize = extraDataSize;
+        m_file.write((const char *)extraData, extraDataSize);
+    }
+
+    m_toc.push_back(entry);
+    m_contentHashes.push_back(contentHash);
+
     return YDS_ERROR_RETURN(ysError::None);
 }
@@ -0,0 +1,358 @@
+#include "../include/yds_geometry_export_file_reader.h"
+
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+
+ysGeometryExportFileReader::ysGeometryExportFileReader() : ysObject("ysGeometryExportFileReader") {
+    m_data = nullptr;
+    m_size = 0;
+
+    m_version = 0;
+    m_objectCount = 0;
+
+    memset(&m_header, 0, sizeof(ysGeometryExportFile::SceneFileHeader));
+}
+
+ysGeometryExportFileReader::~ysGeometryExportFileReader() {
+    /* void */
+}
+
+ysError ysGeometryExportFileReader::Open(const char *fname) {
+    YDS_ERROR_DECLARE("Open");
+
+    Close();
+
+    YDS_NESTED_ERROR_CALL(m_file.Open(fname));
+
+    const ysError result = Open(m_file.GetData(), m_file.GetSize());
+    if (result != ysError::None) m_file.Close();
+
+    return YDS_ERROR_RETURN(result);
+}
+
+ysError ysGeometryExportFileReader::Open(const char *data, size_t size) {
+    YDS_ERROR_DECLARE("Open");
+
+    m_data = data;
+    m_size = size;
+    m_version = 0;
+    m_objectCount = 0;
+    m_objects.clear();
+
+    uint32_t magic = 0;
+    if (m_size < sizeof(uint32_t)) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    memcpy(&magic, m_data, sizeof(uint32_t));
+
+    // Version 1 files start with a plain object count instead of a magic number
+    const ysError result = (magic == ysGeometryExportFile::SceneFileMagic)
+        ? OpenVersion2()
+        : OpenVersion1();
+
+    if (result != ysError::None) {
+        m_data = nullptr;
+        m_size = 0;
+        m_version = 0;
+        m_objectCount = 0;
+        m_objects.clear();
+    }
+
+    return YDS_ERROR_RETURN(result);
+}
+
+void ysGeometryExportFileReader::Close() {
+    m_file.Close();
+
+    m_data = nullptr;
+    m_size = 0;
+
+    m_version = 0;
+    m_objectCount = 0;
+    m_objects.clear();
+}
+
+ysError ysGeometryExportFileReader::ReadObject(int index, Object *object) {
+    YDS_ERROR_DECLARE("ReadObject");
+
+    if (index < 0 || index >= m_objectCount) return YDS_ERROR_RETURN(ysError::OutOfBounds);
+
+    if (m_version == 1) {
+        *object = m_objects[index];
+    }
+    else if (!ReadObjectVersion2(index, object)) {
+        return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    }
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+int ysGeometryExportFileReader::FindObject(const char *name) {
+    if (m_version == 1) {
+        for (int i = 0; i < m_objectCount; ++i) {
+            if (strncmp(m_objects[i].Header.ObjectName, name, 64) == 0) return i;
+        }
+
+        return -1;
+    }
+
+    const uint32_t tableSize = m_header.NameTableSize;
+    if (tableSize == 0) return -1;
+
+    const uint32_t hash = ysGeometryExportFile::HashName(name);
+    const char *table = m_data + m_header.NameTableOffset;
+
+    uint32_t slot = hash & (tableSize - 1);
+    for (uint32_t probe = 0; probe < tableSize; ++probe) {
+        uint32_t entry;
+        memcpy(&entry, table + slot * sizeof(uint32_t), sizeof(uint32_t));
+        if (entry == 0) return -1;
+
+        const int index = (int)entry - 1;
+        if (index < m_objectCount) {
+            ysGeometryExportFile::TocEntry toc;
+            memcpy(&toc, m_data + m_header.TocOffset + index * sizeof(ysGeometryExportFile::TocEntry), sizeof(toc));
+
+            if (toc.NameHash == hash) {
+                const char *objectName =
+                    m_data + toc.HeaderOffset + offsetof(ysGeometryExportFile::ObjectOutputHeader, ObjectName);
+                if (strncmp(objectName, name, 64) == 0) return index;
+            }
+        }
+
+        slot = (slot + 1) & (tableSize - 1);
+    }
+
+    return -1;
+}
+
+uint64_t ysGeometryExportFileReader::GetContentHash(int index) const {
+    if (m_version != 2 || m_header.ContentHashOffset == 0) return 0;
+    if (index < 0 || index >= m_objectCount) return 0;
+
+    uint64_t hash;
+    memcpy(&hash, m_data + m_header.ContentHashOffset + index * sizeof(uint64_t), sizeof(uint64_t));
+
+    return hash;
+}
+
+ysError ysGeometryExportFileReader::OpenVersion1() {
+    YDS_ERROR_DECLARE("OpenVersion1");
+
+    int objectCount = 0;
+    memcpy(&objectCount, m_data, sizeof(int));
+    if (objectCount < 0) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+
+    size_t offset = sizeof(int);
+    auto consume = [this, &offset](size_t bytes, const char **location) {
+        if (bytes > m_size - offset) return false;
+
+        *location = m_data + offset;
+        offset += bytes;
+        return true;
+    };
+
+    m_objects.resize(objectCount);
+    for (int i = 0; i < objectCount; ++i) {
+        Object &object = m_objects[i];
+        object = {};
+
+        const char *header = nullptr;
+        if (!consume(sizeof(ysGeometryExportFile::ObjectOutputHeader), &header)) {
+            return YDS_ERROR_RETURN(ysError::CorruptedFile);
+        }
+
+        memcpy(&object.Header, header, sizeof(ysGeometryExportFile::ObjectOutputHeader));
+
+        const ysObjectData::ObjectType type = static_cast<ysObjectData::ObjectType>(object.Header.ObjectType);
+        if (type == ysObjectData::ObjectType::Geometry) {
+            if (object.Header.VertexDataSize < 0 || object.Header.NumFaces < 0 || object.Header.NumBones < 0) {
+                return YDS_ERROR_RETURN(ysError::CorruptedFile);
+            }
+
+            // The submesh table can't be located without a table of contents
+            if ((object.Header.Flags & ysGeometryExportFile::MDF_SUBMESHES) != 0) {
+                return YDS_ERROR_RETURN(ysError::CorruptedFile);
+            }
+
+            object.VertexDataSize = object.Header.VertexDataSize;
+            object.IndexDataSize = ysGeometryExportFile::GetIndexSize(object.Header) * object.Header.NumFaces * 3;
+            object.BoneDataSize = (int)sizeof(int) * object.Header.NumBones;
+
+            if (!consume(object.VertexDataSize, &object.VertexData)
+                || !consume(object.IndexDataSize, &object.IndexData)
+                || !consume(object.BoneDataSize, &object.BoneData))
+            {
+                return YDS_ERROR_RETURN(ysError::CorruptedFile);
+            }
+        }
+        else if (type == ysObjectData::ObjectType::Plane) {
+            // Length and width
+            object.ExtraDataSize = 2 * sizeof(float);
+            if (!consume(object.ExtraDataSize, &object.ExtraData)) {
+                return YDS_ERROR_RETURN(ysError::CorruptedFile);
+            }
+        }
+    }
+
+    m_version = 1;
+    m_objectCount = objectCount;
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysGeometryExportFileReader::OpenVersion2() {
+    YDS_ERROR_DECLARE("OpenVersion2");
+
+    if (m_size < sizeof(ysGeometryExportFile::SceneFileHeader)) {
+        return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    }
+
+    memcpy(&m_header, m_data, sizeof(ysGeometryExportFile::SceneFileHeader));
+
+    if (m_header.Version != 2) return YDS_ERROR_RETURN(ysError::UnsupportedFileVersion);
+    if (m_header.FileSize > m_size) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    if (m_header.ObjectCount > (uint32_t)INT_MAX) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+
+    const uint32_t tableSize = m_header.NameTableSize;
+    if ((tableSize & (tableSize - 1)) != 0) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+
+    const uint64_t tocSize = (uint64_t)m_header.ObjectCount * sizeof(ysGeometryExportFile::TocEntry);
+    if (!IsInBounds(m_header.TocOffset, tocSize)) return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    if (!IsInBounds(m_header.NameTableOffset, (uint64_t)tableSize * sizeof(uint32_t))) {
+        return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    }
+
+    if (m_header.ContentHashOffset != 0
+        && !IsInBounds(m_header.ContentHashOffset, (uint64_t)m_header.ObjectCount * sizeof(uint64_t)))
+    {
+        return YDS_ERROR_RETURN(ysError::CorruptedFile);
+    }
+
+    // Headers are checked up front so that FindObject() can read names in place
+    for (uint32_t i = 0; i < m_header.ObjectCount; ++i) {
+        ysGeometryExportFile::TocEntry toc;
+        memcpy(&toc, m_data + m_header.TocOffset + i * sizeof(ysGeometryExportFile::TocEntry), sizeof(toc));
+
+        if (!IsInBounds(toc.HeaderOffset, sizeof(ysGeometryExportFile::ObjectOutputHeader))) {
+            return YDS_ERROR_RETURN(ysError::CorruptedFile);
+        }
+    }
+
+    m_version = 2;
+    m_objectCount = (int)m_header.ObjectCount;
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+bool ysGeometryExportFileReader::ReadObjectVersion2(int index, Object *object) const {
+    ysGeometryExportFile::TocEntry toc;
+    memcpy(&toc, m_data + m_header.TocOffset + index * sizeof(ysGeometryExportFile::TocEntry), sizeof(toc));
+
+    if (!IsInBounds(toc.VertexDataOffset, toc.VertexDataSize)) return false;
+    if (!IsInBounds(toc.IndexDataOffset, toc.IndexDataSize)) return false;
+    if (!IsInBounds(toc.BoneDataOffset, toc.BoneDataSize)) return false;
+    if (!IsInBounds(toc.ExtraDataOffset, toc.ExtraDataSize)) return false;
+
+    memcpy(&object->Header, m_data + toc.HeaderOffset, sizeof(ysGeometryExportFile::ObjectOutputHeader));
+    if (object->Header.VertexDataSize != (int)toc.VertexDataSize) return false;
+
+    object->VertexData = (toc.VertexDataSize > 0) ? m_data + toc.VertexDataOffset : nullptr;
+    object->IndexData = (toc.IndexDataSize > 0) ? m_data + toc.IndexDataOffset : nullptr;
+    object->BoneData = (toc.BoneDataSize > 0) ? m_data + toc.BoneDataOffset : nullptr;
+    object->ExtraData = (toc.ExtraDataSize > 0) ? m_data + toc.ExtraDataOffset : nullptr;
+
+    object->VertexDataSize = (int)toc.VertexDataSize;
+    object->IndexDataSize = (int)toc.IndexDataSize;
+    object->BoneDataSize = (int)toc.BoneDataSize;
+    object->ExtraDataSize = (int)toc.ExtraDataSize;
+
+    return true;
+}
+
+bool ysGeometryExportFileReader::GetSubmeshes(
+    const Object &object,
+    std::vector<ysGeometryExportFile::Submesh> *submeshes)
+{
+    std::vector<ysGeometryExportFile::Lod> lods;
+    return GetLods(object, &lods, submeshes);
+}
+
+bool ysGeometryExportFileReader::GetLods(
+    const Object &object,
+    std::vector<ysGeometryExportFile::Lod> *lods,
+    std::vector<ysGeometryExportFile::Submesh> *submeshes)
+{
+    const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+    lods->clear();
+    submeshes->clear();
+
+    if ((header.Flags & ysGeometryExportFile::MDF_SUBMESHES) == 0) {
+        ysGeometryExportFile::Submesh whole;
+        whole.BaseIndex = 0;
+        whole.FaceCount = header.NumFaces;
+        whole.BaseVertex = 0;
+        whole.VertexCount = header.NumVertices;
+        submeshes->push_back(whole);
+    }
+    else if ((header.Flags & ysGeometryExportFile::MDF_LODS) == 0) {
+        const int count = object.ExtraDataSize / (int)sizeof(ysGeometryExportFile::Submesh);
+        if (count <= 0 || object.ExtraDataSize != count * (int)sizeof(ysGeometryExportFile::Submesh)) return false;
+
+        submeshes->resize(count);
+        memcpy(submeshes->data(), object.ExtraData, object.ExtraDataSize);
+    }
+    else {
+        ysGeometryExportFile::LodTableHeader table;
+        if (object.ExtraDataSize < (int)sizeof(table)) return false;
+        memcpy(&table, object.ExtraData, sizeof(table));
+
+        if (table.LodCount <= 0 || table.SubmeshCount <= 0) return false;
+
+        const int64_t expectedSize = (int64_t)sizeof(table)
+            + (int64_t)table.LodCount * sizeof(ysGeometryExportFile::Lod)
+            + (int64_t)table.SubmeshCount * sizeof(ysGeometryExportFile::Submesh);
+        if (object.ExtraDataSize != expectedSize) return false;
+
+        const char *data = object.ExtraData + sizeof(table);
+        lods->resize(table.LodCount);
+        memcpy(lods->data(), data, table.LodCount * sizeof(ysGeometryExportFile::Lod));
+
+        data += table.LodCount * sizeof(ysGeometryExportFile::Lod);
+        submeshes->resize(table.SubmeshCount);
+        memcpy(submeshes->data(), data, table.SubmeshCount * sizeof(ysGeometryExportFile::Submesh));
+
+        for (const ysGeometryExportFile::Lod &lod : *lods) {
+            if (lod.FirstSubmesh < 0 || lod.SubmeshCount <= 0) return false;
+            if ((int64_t)lod.FirstSubmesh + lod.SubmeshCount > table.SubmeshCount) return false;
+        }
+    }
+
+    // Objects without levels of detail have one covering every submesh
+    if (lods->empty()) {
+        ysGeometryExportFile::Lod full;
+        full.FirstSubmesh = 0;
+        full.SubmeshCount = (int)submeshes->size();
+        full.FaceCount = header.NumFaces;
+        full.Error = 0.0f;
+        lods->push_back(full);
+    }
+
+    // Every level of detail's indices are stored, not just the first
+    const int indexSize = ysGeometryExportFile::GetIndexSize(header);
+    const int64_t indexCount = ((header.Flags & ysGeometryExportFile::MDF_LODS) != 0)
+        ? object.IndexDataSize / indexSize
+        : (int64_t)header.NumFaces * 3;
+
+    for (const ysGeometryExportFile::Submesh &submesh : *submeshes) {
+        if (submesh.BaseIndex < 0 || submesh.FaceCount < 0) return false;
+        if (submesh.BaseVertex < 0 || submesh.VertexCount < 0) return false;
+        if (submesh.BaseIndex + (int64_t)submesh.FaceCount * 3 > indexCount) return false;
+        if ((int64_t)submesh.BaseVertex + submesh.VertexCount > header.NumVertices) return false;
+    }
+
+    return true;
+}
+
+bool ysGeometryExportFileReader::IsInBounds(uint64_t offset, uint64_t size) const {
+    return offset <= m_size && size <= m_size - offset;
+}
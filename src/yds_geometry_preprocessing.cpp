@@ -1,10 +1,153 @@
 #include "../include/yds_geometry_preprocessing.h"
 
+#include "../include/yds_allocator.h"
+
 #include <limits>
 #include <stdlib.h>
 #include <memory>
 #include <assert.h>
 #include <float.h>
+#include <limits.h>
+#include <utility>
+
+namespace {
+
+    const float NormalThreshold = 1.0F - 10e-5F;
+
+    // Disjoint set forest with union by size and path halving
+    class DisjointSet {
+    public:
+        void Reset(int count) {
+            m_parent.resize(count);
+            m_size.assign(count, 1);
+
+            for (int i = 0; i < count; ++i) m_parent[i] = i;
+        }
+
+        int Find(int x) {
+            while (m_parent[x] != x) {
+                m_parent[x] = m_parent[m_parent[x]];
+                x = m_parent[x];
+            }
+
+            return x;
+        }
+
+        void Union(int a, int b) {
+            a = Find(a);
+            b = Find(b);
+            if (a == b) return;
+
+            if (m_size[a] < m_size[b]) std::swap(a, b);
+            m_parent[b] = a;
+            m_size[a] += m_size[b];
+        }
+
+    protected:
+        std::vector<int> m_parent;
+        std::vector<int> m_size;
+    };
+
+    void ReplaceVertex(ysObjectData *object, int face, int vertex, int replacement) {
+        for (int facevert = 0; facevert < 3; ++facevert) {
+            if (object->m_vertexIndexSet[face].indices[facevert] == vertex) {
+                object->m_vertexIndexSet[face].indices[facevert] = replacement;
+            }
+        }
+    }
+
+    // --
+    // Gives every group of faces around a vertex its own copy of the vertex.
+    // Faces are grouped with a union-find over the pairs that sameGroup()
+    // accepts, so the cost is quadratic in the vertex valence only. The
+    // group of the first face keeps the original vertex.
+    // --
+    template <typename T_SameGroup>
+    void SplitVertices(ysObjectData *object, const T_SameGroup &sameGroup) {
+        ysGeometryPreprocessing::FaceAdjacency adjacency;
+        ysGeometryPreprocessing::BuildFaceAdjacency(object, &adjacency);
+
+        DisjointSet groups;
+        std::vector<int> copies;
+
+        // Copies are appended, the adjacency only covers the original vertices
+        const int vertexCount = object->m_objectStatistics.NumVertices;
+        for (int vert = 0; vert < vertexCount; ++vert) {
+            const int faceCount = adjacency.GetFaceCount(vert);
+            if (faceCount < 2) continue;
+
+            const int *faces = adjacency.GetFaces(vert);
+
+            groups.Reset(faceCount);
+            for (int i = 0; i < faceCount; ++i) {
+                for (int j = i + 1; j < faceCount; ++j) {
+                    if (groups.Find(i) == groups.Find(j)) continue;
+                    if (sameGroup(faces[i], faces[j], vert)) groups.Union(i, j);
+                }
+            }
+
+            const int original = groups.Find(0);
+            copies.assign(faceCount, -1);
+
+            for (int i = 1; i < faceCount; ++i) {
+                const int group = groups.Find(i);
+                if (group == original) continue;
+
+                if (copies[group] == -1) {
+                    copies[group] = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
+                }
+
+                ReplaceVertex(object, faces[i], vert, copies[group]);
+            }
+        }
+
+        object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
+    }
+
+    bool ContinuousTangents(const ysVector &t1, const ysVector &t2) {
+        if (ysMath::GetX(ysMath::Dot(t1, t2)) < 0) return false;
+        return (ysMath::GetW(t1) > 0) == (ysMath::GetW(t2) > 0);
+    }
+
+} /* namespace */
+
+void ysGeometryPreprocessing::BuildFaceAdjacency(ysObjectData *object, FaceAdjacency *adjacency) {
+    const int vertexCount = object->m_objectStatistics.NumVertices;
+    const int faceCount = object->m_objectStatistics.NumFaces;
+
+    adjacency->Offsets.assign(vertexCount + 1, 0);
+
+    // Degenerate faces are only listed once per vertex
+    auto isRepeated = [object](int face, int facevert) {
+        const ysObjectData::IndexSet &indices = object->m_vertexIndexSet[face];
+        for (int i = 0; i < facevert; ++i) {
+            if (indices.indices[i] == indices.indices[facevert]) return true;
+        }
+
+        return false;
+    };
+
+    for (int face = 0; face < faceCount; ++face) {
+        for (int facevert = 0; facevert < 3; ++facevert) {
+            if (isRepeated(face, facevert)) continue;
+            ++adjacency->Offsets[object->m_vertexIndexSet[face].indices[facevert] + 1];
+        }
+    }
+
+    for (int vert = 0; vert < vertexCount; ++vert) {
+        adjacency->Offsets[vert + 1] += adjacency->Offsets[vert];
+    }
+
+    adjacency->Faces.resize(adjacency->Offsets[vertexCount]);
+
+    std::vector<int> next(adjacency->Offsets.begin(), adjacency->Offsets.end() - 1);
+    for (int face = 0; face < faceCount; ++face) {
+        for (int facevert = 0; facevert < 3; ++facevert) {
+            if (isRepeated(face, facevert)) continue;
+            adjacency->Faces[next[object->m_vertexIndexSet[face].indices[facevert]]++] = face;
+        }
+    }
+}
 
 bool ysGeometryPreprocessing::ConnectedFaces(ysObjectData *object, int face1, int face2) {
     for (int i = 0; i < 3; i++) {
@@ -69,17 +212,22 @@ int ysGeometryPreprocessing::CreateVertexCopy(ysObjectData *object, int vertex)
 }
 
 void ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(ysObjectData *object) {
+    FaceAdjacency adjacency;
+    BuildFaceAdjacency(object, &adjacency);
+
     unsigned int groups;
 
     for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
         if (!object->m_smoothingGroups[face]) {
             groups = UINT_MAX; // ie all groups available
 
-            for (int neighbour = 0; neighbour < object->m_objectStatistics.NumFaces; neighbour++) {
-                if (face == neighbour) continue;
+            for (int facevert = 0; facevert < 3; facevert++) {
+                const int vert = object->m_vertexIndexSet[face].indices[facevert];
+                const int *neighbours = adjacency.GetFaces(vert);
 
-                if (ConnectedFaces(object, face, neighbour)) {
-                    groups = groups & (~object->m_smoothingGroups[neighbour]);
+                for (int i = 0; i < adjacency.GetFaceCount(vert); i++) {
+                    if (neighbours[i] == face) continue;
+                    groups = groups & (~object->m_smoothingGroups[neighbours[i]]);
                 }
             }
 
@@ -97,190 +245,109 @@ void ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(ysObjectData *objec
 void ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(ysObjectData *object) {
     ysVector *tempNormals = CalculateHardNormals(object);
 
-    object->m_extendedSmoothingGroups.Allocate(object->m_objectStatistics.NumFaces);
+    const int faceCount = object->m_objectStatistics.NumFaces;
 
-    // Temporary extended smoothing group designation
-    for (int i = 0; i < object->m_objectStatistics.NumFaces; i++) {
-        object->m_extendedSmoothingGroups[i] = object->m_objectStatistics.NumFaces + i;
-    }
+    FaceAdjacency adjacency;
+    BuildFaceAdjacency(object, &adjacency);
 
-    const float NormalThreshold = 1.0F - 10e-5F;
-    int CurrentGroup = 0;
-    int count = 0;
+    // Connected faces that face the same way end up in the same group even
+    // if their smoothing groups differ
+    DisjointSet groups;
+    groups.Reset(faceCount);
 
-    for (int f1 = 0; f1 < object->m_objectStatistics.NumFaces; f1++) {
-        if (object->m_extendedSmoothingGroups[f1] < 0) {
-            for (int f2 = 0; f2 < object->m_objectStatistics.NumFaces; f2++) {
-                if (ysGeometryPreprocessing::SameSmoothingGroup(object, f1, f2)) {
-                    continue;
-                }
+    for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
+        const int *faces = adjacency.GetFaces(vert);
+        const int count = adjacency.GetFaceCount(vert);
+
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                const int f1 = faces[i];
+                const int f2 = faces[j];
+
+                if (object->m_smoothingGroups[f1] & object->m_smoothingGroups[f2]) continue;
+                if (groups.Find(f1) == groups.Find(f2)) continue;
 
                 ysVector dot = ysMath::Dot(tempNormals[f1], tempNormals[f2]);
                 float similarity = ysMath::GetScalar(dot);
 
                 if (similarity > NormalThreshold) {
-                    object->m_extendedSmoothingGroups[f2] = CurrentGroup;
-                    object->m_extendedSmoothingGroups[f1] = CurrentGroup;
+                    groups.Union(f1, f2);
                 }
             }
         }
-
-        CurrentGroup++;
     }
 
-    object->m_numExtendedSmoothingGroups = CurrentGroup;
-}
-
-void ysGeometryPreprocessing::SpreadSmoothingGroup(ysObjectData *object, int face, int group, ysVector *tempNormals, int *count) {
-    const float NormalThreshold = 1.0F - 10e-5F;
-
-    (*count)++;
-    if (face >= object->m_objectStatistics.NumFaces || face < 0) {
-        int breakHere = 0;
-    }
-    object->m_extendedSmoothingGroups[face] = group;
+    object->m_extendedSmoothingGroups.Allocate(faceCount);
 
-    for (int cmpFace = 0; cmpFace < object->m_objectStatistics.NumFaces; cmpFace++) {
-        if (cmpFace == face) continue;
-
-        // Check to make sure the faces are in different smoothing groups
-        if (object->m_smoothingGroups[face] & object->m_smoothingGroups[cmpFace]) continue;
-
-        if (!ConnectedFaces(object, face, cmpFace)) continue;
-        if (object->m_extendedSmoothingGroups[face] == object->m_extendedSmoothingGroups[cmpFace]) continue;
+    // Groups are numbered in order of their first face
+    std::vector<int> groupIndex(faceCount, -1);
+    int CurrentGroup = 0;
 
-        ysVector dot = ysMath::Dot(tempNormals[face], tempNormals[cmpFace]);
-        float similarity = ysMath::GetScalar(dot);
+    for (int face = 0; face < faceCount; face++) {
+        const int root = groups.Find(face);
+        if (groupIndex[root] == -1) groupIndex[root] = CurrentGroup++;
 
-        if (similarity > NormalThreshold) {
-            SpreadSmoothingGroup(object, cmpFace, group, tempNormals, count);
-        }
+        object->m_extendedSmoothingGroups[face] = groupIndex[root];
     }
+
+    object->m_numExtendedSmoothingGroups = CurrentGroup;
 }
 
-void ysGeometryPreprocessing::SeparateBySmoothingGroups(ysObjectData *object) {
-    int faceIndex = 0;
-    int vertex = 0;
+void ysGeometryPreprocessing::SpreadSmoothingGroup(
+    ysObjectData *object, const FaceAdjacency &adjacency,
+    int face, int group, ysVector *tempNormals, int *count)
+{
+    // Iterative so that large flat regions can't overflow the stack
+    std::vector<int> pending(1, face);
+    object->m_extendedSmoothingGroups[face] = group;
+    (*count)++;
 
-    ysExpandingArray<ysExpandingArray<int, 4>> sharingCache;
-    sharingCache.Allocate(object->m_objectStatistics.NumVertices);
+    while (!pending.empty()) {
+        const int current = pending.back();
+        pending.pop_back();
 
-    // Cache vertex connections
-    for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
-        for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
-            int vert = object->m_vertexIndexSet[face].indices[vertIndex];
-            sharingCache[vert].New() = face;
-        }
-    }
+        for (int facevert = 0; facevert < 3; facevert++) {
+            const int vert = object->m_vertexIndexSet[current].indices[facevert];
+            const int *neighbours = adjacency.GetFaces(vert);
 
-    ysExpandingArray<ysExpandingArray<int, 4>, 16> groups;
-    for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
-        groups.Destroy();
-        groups.Preallocate(16);
-
-        for (int face = 0; face < sharingCache[vert].GetNumObjects(); face++) {
-            // Find which group this face belongs to
-            int faceGroup = -1;
-            for (int l = 0; l < groups.GetNumObjects(); l++) {
-                for (int i = 0; i < groups[l].GetNumObjects(); i++) {
-                    if (SameSmoothingGroup(object, sharingCache[vert][face], groups[l][i])) {
-                        faceGroup = l;
-                        break;
-                    }
-                }
+            for (int i = 0; i < adjacency.GetFaceCount(vert); i++) {
+                const int cmpFace = neighbours[i];
+                if (cmpFace == current) continue;
 
-                if (faceGroup != -1) {
-                    break;
-                }
-            }
-
-            if (faceGroup == -1) groups.New().New() = sharingCache[vert][face];
-            else groups[faceGroup].New() = sharingCache[vert][face];
-        }
+                // Check to make sure the faces are in different smoothing groups
+                if (object->m_smoothingGroups[current] & object->m_smoothingGroups[cmpFace]) continue;
+                if (object->m_extendedSmoothingGroups[cmpFace] == group) continue;
 
-        for (int l = 1; l < groups.GetNumObjects(); l++) {
-            // Create a copy of the vertex
-            int newVertex = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
+                ysVector dot = ysMath::Dot(tempNormals[current], tempNormals[cmpFace]);
+                float similarity = ysMath::GetScalar(dot);
 
-            // Adjust indicies for faces
-            for (int face = 0; face < groups[l].GetNumObjects(); face++) {
-                for (int facevert = 0; facevert < 3; facevert++) {
-                    if (object->m_vertexIndexSet[groups[l][face]].indices[facevert] == vert) {
-                        assert(groups[l][face] < object->m_objectStatistics.NumFaces);
-                        assert(groups[l][face] >= 0);
+                if (similarity > NormalThreshold) {
+                    object->m_extendedSmoothingGroups[cmpFace] = group;
+                    (*count)++;
 
-                        object->m_vertexIndexSet[groups[l][face]].indices[facevert] = newVertex;
-                    }
+                    pending.push_back(cmpFace);
                 }
             }
         }
     }
+}
 
-    object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
+void ysGeometryPreprocessing::SeparateBySmoothingGroups(ysObjectData *object) {
+    SplitVertices(object, [object](int face1, int face2, int) {
+        return SameSmoothingGroup(object, face1, face2);
+    });
 }
 
 void ysGeometryPreprocessing::SeparateByUVGroups(ysObjectData *object, int mapChannel) {
-    int faceIndex = 0;
-    int vertex = 0;
-
-    ysExpandingArray<ysExpandingArray<int, 4>> sharingCache;
-    sharingCache.Allocate(object->m_objectStatistics.NumVertices);
-
-    // Cache vertex connections
-    for (int face = 0; face < object->m_objectStatistics.NumFaces; face++) {
-        for (int vertIndex = 0; vertIndex < 3; vertIndex++) {
-            int vert = object->m_vertexIndexSet[face].indices[vertIndex];
-            sharingCache[vert].New() = face;
-        }
-    }
-
-    ysExpandingArray<ysExpandingArray<int, 4>, 16> leaders;
-
-    for (int vert = 0; vert < object->m_objectStatistics.NumVertices; vert++) {
-        leaders.Destroy();
-        leaders.Preallocate(16);
-
-        for (int face = 0; face < sharingCache[vert].GetNumObjects(); face++) {
-            int follows = -1;
-            for (int l = 0; l < leaders.GetNumObjects(); l++) {
-                int f1 = sharingCache[vert][face];
-                int f2 = leaders[l][0];
-
-                if (SameUVGroup(object, f1, f2, vert, mapChannel)) {
-                    break;
-                    follows = l;
-                }
-            }
-
-            if (follows == -1) leaders.New().New() = sharingCache[vert][face];
-            else leaders[follows].New() = sharingCache[vert][face];
-        }
-
-        for (int l = 1; l < leaders.GetNumObjects(); l++) {
-            // Create a copy of the vertex
-            int newVertex = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
-
-            // Adjust indicies for faces
-            for (int face = 0; face < leaders[l].GetNumObjects(); face++) {
-                for (int facevert = 0; facevert < 3; facevert++) {
-                    if (object->m_vertexIndexSet[leaders[l][face]].indices[facevert] == vert) {
-                        assert(leaders[l][face] < object->m_objectStatistics.NumFaces);
-                        assert(leaders[l][face] >= 0);
-
-                        object->m_vertexIndexSet[leaders[l][face]].indices[facevert] = newVertex;
-                    }
-                }
-            }
-        }
-    }
-
-    object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
+    SplitVertices(object, [object, mapChannel](int face1, int face2, int vert) {
+        return SameUVGroup(object, face1, face2, vert, mapChannel);
+    });
 }
 
 ysVector *ysGeometryPreprocessing::CalculateHardNormals(ysObjectData *object) {
     if (object->m_hardNormalCache) return object->m_hardNormalCache;
 
-    object->m_hardNormalCache = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumFaces, 16);
+    object->m_hardNormalCache = (ysVector *)ysAllocator::BlockAllocate<16>(sizeof(__m128) * object->m_objectStatistics.NumFaces);
     ysVector *tempNormals = object->m_hardNormalCache;
 
     ysVector vert1, vert2, vert3;
@@ -309,7 +376,7 @@ ysVector *ysGeometryPreprocessing::CalculateHardNormals(ysObjectData *object) {
 void ysGeometryPreprocessing::CalculateNormals(ysObjectData *object) {
     object->m_normals.Allocate(object->m_objectStatistics.NumVertices);
     ysVector *tempNormals = CalculateHardNormals(object);
-    ysVector *accum = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumVertices, 16);
+    ysVector *accum = (ysVector *)ysAllocator::BlockAllocate<16>(sizeof(__m128) * object->m_objectStatistics.NumVertices);
 
     // Clear accum
     for (int i = 0; i < object->m_objectStatistics.NumVertices; i++) {
@@ -329,11 +396,11 @@ void ysGeometryPreprocessing::CalculateNormals(ysObjectData *object) {
         object->m_normals[i] = ysMath::GetVector3(normalSum);
     }
 
-    _aligned_free(accum);
+    ysAllocator::BlockFree(accum, 16);
 }
 
 ysVector *ysGeometryPreprocessing::CalculateHardTangents(ysObjectData *object, int mapChannel) {
-    ysVector *tempTangents = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumFaces, 16);
+    ysVector *tempTangents = (ysVector *)ysAllocator::BlockAllocate<16>(sizeof(__m128) * object->m_objectStatistics.NumFaces);
     ysVector *hardNormals = CalculateHardNormals(object);
 
     ysVector vert1, vert2, vert3;
@@ -398,41 +465,13 @@ void ysGeometryPreprocessing::CalculateTangents(ysObjectData *object, int mapCha
     ysVector *tempTangents = CalculateHardTangents(object, mapChannel);
 
     // Separate Faces With Discontinuous Tangents
-    ysExpandingArray<int, 4> m_discontinuousFaces;
-
-    for (int f1 = 0; f1 < object->m_objectStatistics.NumFaces; f1++) {
-        m_discontinuousFaces.Clear();
-
-        for (int f2 = 0; f2 < object->m_objectStatistics.NumFaces; f2++) {
-            if (ysGeometryPreprocessing::ConnectedFaces(object, f1, f2)) {
-                if (ysMath::GetX(ysMath::Dot(tempTangents[f1], tempTangents[f2])) < 0 ||
-                    ((ysMath::GetW(tempTangents[f1]) > 0) != (ysMath::GetW(tempTangents[f2]) > 0))) {
-                    m_discontinuousFaces.New() = f2;
-                }
-            }
-        }
-
-        for (int facevert = 0; facevert < 3; facevert++) {
-            int vert = object->m_vertexIndexSet[f1].indices[facevert];
-            int copy = -1;
-
-            // Separate faces
-            for (int f2 = 0; f2 < m_discontinuousFaces.GetNumObjects(); f2++) {
-                if (ysGeometryPreprocessing::IncludesVertex(object, f2, vert)) {
-                    if (copy == -1) copy = ysGeometryPreprocessing::CreateVertexCopy(object, vert);
-                    SwapVertex(object, f2, vert, copy);
-                }
-            }
-        }
-    }
-
-    // FROM HERE
-
-    object->m_objectStatistics.NumVertices = object->m_vertices.GetNumObjects();
+    SplitVertices(object, [tempTangents](int face1, int face2, int) {
+        return ContinuousTangents(tempTangents[face1], tempTangents[face2]);
+    });
 
     // Find smoothed tangents
     object->m_tangents.Allocate(object->m_vertices.GetNumObjects());
-    ysVector *accum = (ysVector *)_aligned_malloc(sizeof(__m128) * object->m_objectStatistics.NumVertices, 16);
+    ysVector *accum = (ysVector *)ysAllocator::BlockAllocate<16>(sizeof(__m128) * object->m_objectStatistics.NumVertices);
 
     // Clear accum
     for (int i = 0; i < object->m_objectStatistics.NumVertices; i++) {
@@ -458,8 +497,8 @@ void ysGeometryPreprocessing::CalculateTangents(ysObjectData *object, int mapCha
         object->m_tangents[i].w = ysMath::GetW(accum[i]);
     }
 
-    _aligned_free(accum);
-    _aligned_free(tempTangents);
+    ysAllocator::BlockFree(accum, 16);
+    ysAllocator::BlockFree(tempTangents, 16);
 }
 
 void ysGeometryPreprocessing::SortBoneWeights(ysObjectData *object, bool normalize, int maxBoneCount) {
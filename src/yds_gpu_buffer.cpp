@@ -2,6 +2,7 @@
 
 ysGPUBuffer::ysGPUBuffer() : ysContextObject("GPU_BUFFER", DeviceAPI::Unknown) {
     m_bufferType = GPU_UNDEFINED_BUFFER;
+    m_indexFormat = IndexFormat::UInt16;
 
     m_RAMMirror = nullptr;
     m_size = 0;
@@ -12,6 +13,7 @@ ysGPUBuffer::ysGPUBuffer() : ysContextObject("GPU_BUFFER", DeviceAPI::Unknown) {
 
 ysGPUBuffer::ysGPUBuffer(DeviceAPI API) : ysContextObject("GPU_BUFFER", API) {
     m_bufferType = GPU_UNDEFINED_BUFFER;
+    m_indexFormat = IndexFormat::UInt16;
 
     m_RAMMirror = nullptr;
     m_size = 0;
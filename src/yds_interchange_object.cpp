@@ -1,5 +1,7 @@
 #include "../include/yds_interchange_object.h"
 
+#include "../include/yds_content_hasher.h"
+
 #include <map>
 #include <vector>
 
@@ -97,3 +99,36 @@ void ysInterchangeObject::UniformScale(float scale) {
     Position.y *= scale;
     Position.z *= scale;
 }
+
+uint64_t ysInterchangeObject::GetContentHash() const {
+    ysContentHasher hasher;
+
+    hasher.AddString(Name);
+    hasher.AddString(MaterialName);
+    hasher.AddValue((int)Type);
+    hasher.AddValue(ModelIndex);
+    hasher.AddValue(ParentIndex);
+    hasher.AddValue(InstanceIndex);
+
+    hasher.AddValue(Length);
+    hasher.AddValue(Width);
+
+    hasher.AddValue(Position);
+    hasher.AddValue(OrientationEuler);
+    hasher.AddValue(Orientation);
+    hasher.AddValue(Scale);
+
+    hasher.AddArray(Vertices);
+    hasher.AddValue((uint64_t)UVChannels.size());
+    for (const UVChannel &channel : UVChannels) hasher.AddArray(channel.Coordinates);
+    hasher.AddArray(Normals);
+    hasher.AddArray(Tangents);
+
+    hasher.AddArray(VertexIndices);
+    hasher.AddArray(NormalIndices);
+    hasher.AddValue((uint64_t)UVIndices.size());
+    for (const std::vector<IndexSet> &channel : UVIndices) hasher.AddArray(channel);
+    hasher.AddArray(TangentIndices);
+
+    return hasher.GetHash();
+}
@@ -0,0 +1,407 @@
+#include "../include/yds_job_system.h"
+
+#include "../include/yds_allocator.h"
+
+namespace {
+    // Identifies the job system (if any) the calling thread works for
+    thread_local ysJobSystem *s_currentSystem = nullptr;
+    thread_local int s_currentWorker = -1;
+
+    // Victim selection state for threads that aren't workers
+    thread_local unsigned int s_externalRandomState = 0x9e3779b9;
+
+    constexpr int SpinCount = 64;
+
+    unsigned int NextRandom(unsigned int *state) {
+        unsigned int x = *state;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        *state = x;
+
+        return x;
+    }
+}
+
+void ysJobSystem::JobSlot::Store(const Job &job, ysJobCounter *counter) {
+    Function.store(job.Function, std::memory_order_relaxed);
+    Data.store(job.Data, std::memory_order_relaxed);
+    Index.store(job.Index, std::memory_order_relaxed);
+    Counter.store(counter, std::memory_order_relaxed);
+}
+
+void ysJobSystem::JobSlot::Load(Job *job, ysJobCounter **counter) const {
+    job->Function = Function.load(std::memory_order_relaxed);
+    job->Data = Data.load(std::memory_order_relaxed);
+    job->Index = Index.load(std::memory_order_relaxed);
+    *counter = Counter.load(std::memory_order_relaxed);
+}
+
+ysJobSystem::WorkDeque::WorkDeque() : m_top(0), m_bottom(0) {
+    /* void */
+}
+
+bool ysJobSystem::WorkDeque::Push(const Job &job, ysJobCounter *counter) {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_acquire);
+    if (b - t >= DequeCapacity) return false;
+
+    m_slots[b & (DequeCapacity - 1)].Store(job, counter);
+    m_bottom.store(b + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool ysJobSystem::WorkDeque::Pop(Job *job, ysJobCounter **counter) {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(b, std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    m_slots[b & (DequeCapacity - 1)].Load(job, counter);
+    if (t < b) return true;
+
+    // Last job in the deque, race any thieves for it
+    const bool taken = m_top.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+
+    return taken;
+}
+
+bool ysJobSystem::WorkDeque::Steal(Job *job, ysJobCounter **counter) {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+    if (t >= b) return false;
+
+    m_slots[t & (DequeCapacity - 1)].Load(job, counter);
+    return m_top.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+bool ysJobSystem::WorkDeque::IsEmpty() const {
+    return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+}
+
+ysJobSystem::InjectionQueue::InjectionQueue() : m_enqueuePosition(0), m_dequeuePosition(0) {
+    for (int i = 0; i < InjectionQueueCapacity; ++i) {
+        m_cells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ysJobSystem::InjectionQueue::Push(const Job &job, ysJobCounter *counter) {
+    Cell *cell;
+    int64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[position & (InjectionQueueCapacity - 1)];
+        const int64_t sequence = cell->Sequence.load(std::memory_order_acquire);
+        const int64_t diff = sequence - position;
+
+        if (diff == 0) {
+            if (m_enqueuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) return false;
+        else position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+
+    cell->Slot.Store(job, counter);
+    cell->Sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool ysJobSystem::InjectionQueue::Pop(Job *job, ysJobCounter **counter) {
+    Cell *cell;
+    int64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &m_cells[position & (InjectionQueueCapacity - 1)];
+        const int64_t sequence = cell->Sequence.load(std::memory_order_acquire);
+        const int64_t diff = sequence - (position + 1);
+
+        if (diff == 0) {
+            if (m_dequeuePosition.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) return false;
+        else position = m_dequeuePosition.load(std::memory_order_relaxed);
+    }
+
+    cell->Slot.Load(job, counter);
+    cell->Sequence.store(position + InjectionQueueCapacity, std::memory_order_release);
+
+    return true;
+}
+
+ysJobSystem::ysJobSystem() {
+    m_workers = nullptr;
+    m_workerCount = 0;
+    m_injectionQueue = nullptr;
+
+    m_running = false;
+    m_wakeSignal = 0;
+    m_sleepingWorkers = 0;
+}
+
+ysJobSystem::~ysJobSystem() {
+    Destroy();
+}
+
+void ysJobSystem::Initialize(int workerCount) {
+    Destroy();
+
+    if (workerCount <= 0) workerCount = (int)std::thread::hardware_concurrency();
+    if (workerCount <= 0) workerCount = 1;
+    if (workerCount > MaxWorkers) workerCount = MaxWorkers;
+
+    m_workerCount = workerCount;
+    m_workers = ysAllocator::TypeAllocate<Worker, alignof(Worker)>(workerCount);
+    m_injectionQueue = ysAllocator::TypeAllocate<InjectionQueue, alignof(InjectionQueue)>(1);
+
+    for (int i = 0; i < workerCount; ++i) {
+        m_workers[i].JobsExecuted = 0;
+        m_workers[i].JobsStolen = 0;
+        m_workers[i].RandomState = 0x9e3779b9u * (i + 1);
+    }
+
+    // The calling thread is worker 0
+    s_currentSystem = this;
+    s_currentWorker = 0;
+
+    m_running = true;
+    for (int i = 1; i < workerCount; ++i) {
+        m_workers[i].Thread = std::thread(&ysJobSystem::WorkerLoop, this, i);
+    }
+}
+
+void ysJobSystem::Destroy() {
+    if (m_workers == nullptr) return;
+
+    while (RunPendingJob()) {
+        /* void */
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepLock);
+        m_running = false;
+        m_wakeSignal.fetch_add(1);
+    }
+    m_wakeCondition.notify_all();
+
+    for (int i = 1; i < m_workerCount; ++i) {
+        if (m_workers[i].Thread.joinable()) m_workers[i].Thread.join();
+    }
+
+    // Jobs submitted by jobs that were running during shutdown
+    while (RunPendingJob()) {
+        /* void */
+    }
+
+    if (s_currentSystem == this) {
+        s_currentSystem = nullptr;
+        s_currentWorker = -1;
+    }
+
+    ysAllocator::TypeFree(m_workers, m_workerCount, true, alignof(Worker));
+    ysAllocator::TypeFree(m_injectionQueue, 1, true, alignof(InjectionQueue));
+
+    m_workers = nullptr;
+    m_injectionQueue = nullptr;
+    m_workerCount = 0;
+}
+
+void ysJobSystem::Run(const Job &job, ysJobCounter *counter) {
+    Run(&job, 1, counter);
+}
+
+void ysJobSystem::Run(const Job *jobs, int count, ysJobCounter *counter) {
+    if (count <= 0) return;
+    if (counter != nullptr) counter->m_value.fetch_add(count, std::memory_order_relaxed);
+
+    for (int i = 0; i < count; ++i) {
+        if (!Submit(jobs[i], counter)) {
+            // Queues are full, run the job here instead
+            Execute(GetCurrentWorkerIndex(), jobs[i], counter);
+        }
+    }
+
+    WakeWorkers();
+}
+
+void ysJobSystem::RunBatch(JobFunction function, void *data, int count, ysJobCounter *counter) {
+    if (counter != nullptr) counter->m_value.fetch_add(count, std::memory_order_relaxed);
+
+    Job job;
+    job.Function = function;
+    job.Data = data;
+
+    for (int i = 0; i < count; ++i) {
+        job.Index = i;
+        if (!Submit(job, counter)) {
+            Execute(GetCurrentWorkerIndex(), job, counter);
+        }
+    }
+
+    WakeWorkers();
+}
+
+void ysJobSystem::Wait(ysJobCounter *counter) {
+    if (counter == nullptr) return;
+
+    while (!counter->IsDone()) {
+        if (!RunPendingJob()) std::this_thread::yield();
+    }
+}
+
+bool ysJobSystem::RunPendingJob() {
+    if (m_workers == nullptr) return false;
+
+    const int workerIndex = GetCurrentWorkerIndex();
+
+    Job job;
+    ysJobCounter *counter;
+    if (!FindJob(workerIndex, &job, &counter)) return false;
+
+    Execute(workerIndex, job, counter);
+    return true;
+}
+
+int ysJobSystem::GetCurrentWorkerIndex() const {
+    return (s_currentSystem == this) ? s_currentWorker : -1;
+}
+
+uint64_t ysJobSystem::GetJobsExecuted() const {
+    uint64_t total = 0;
+    for (int i = 0; i < m_workerCount; ++i) {
+        total += m_workers[i].JobsExecuted.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+uint64_t ysJobSystem::GetJobsStolen() const {
+    uint64_t total = 0;
+    for (int i = 0; i < m_workerCount; ++i) {
+        total += m_workers[i].JobsStolen.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+int ysJobSystem::GetChunkSize(int count, int granularity) const {
+    // A few chunks per worker leaves room to balance uneven work by stealing
+    const int targetChunks = (m_workerCount > 0) ? m_workerCount * 4 : 1;
+
+    int chunkSize = (count + targetChunks - 1) / targetChunks;
+    if (chunkSize < granularity) chunkSize = granularity;
+    if (chunkSize < 1) chunkSize = 1;
+
+    return chunkSize;
+}
+
+bool ysJobSystem::Submit(const Job &job, ysJobCounter *counter) {
+    if (m_workers == nullptr) return false;
+
+    const int workerIndex = GetCurrentWorkerIndex();
+    if (workerIndex >= 0) return m_workers[workerIndex].Deque.Push(job, counter);
+    else return m_injectionQueue->Push(job, counter);
+}
+
+bool ysJobSystem::FindJob(int workerIndex, Job *job, ysJobCounter **counter) {
+    if (workerIndex >= 0 && m_workers[workerIndex].Deque.Pop(job, counter)) return true;
+    if (m_injectionQueue->Pop(job, counter)) return true;
+
+    unsigned int *randomState = (workerIndex >= 0)
+        ? &m_workers[workerIndex].RandomState
+        : &s_externalRandomState;
+
+    const int start = (int)(NextRandom(randomState) % m_workerCount);
+    for (int i = 0; i < m_workerCount; ++i) {
+        const int victim = (start + i) % m_workerCount;
+        if (victim == workerIndex) continue;
+
+        if (m_workers[victim].Deque.Steal(job, counter)) {
+            if (workerIndex >= 0) {
+                m_workers[workerIndex].JobsStolen.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ysJobSystem::Execute(int workerIndex, const Job &job, ysJobCounter *counter) {
+    job.Function(job.Data, job.Index);
+
+    if (workerIndex >= 0) {
+        m_workers[workerIndex].JobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (counter != nullptr) counter->m_value.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ysJobSystem::WakeWorkers() {
+    m_wakeSignal.fetch_add(1, std::memory_order_seq_cst);
+
+    if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepLock);
+        }
+
+        m_wakeCondition.notify_all();
+    }
+}
+
+void ysJobSystem::WorkerLoop(int workerIndex) {
+    s_currentSystem = this;
+    s_currentWorker = workerIndex;
+
+    int idleCount = 0;
+    while (m_running.load(std::memory_order_acquire)) {
+        const uint64_t signal = m_wakeSignal.load(std::memory_order_seq_cst);
+
+        Job job;
+        ysJobCounter *counter;
+        if (FindJob(workerIndex, &job, &counter)) {
+            Execute(workerIndex, job, counter);
+            idleCount = 0;
+            continue;
+        }
+
+        if (++idleCount < SpinCount) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing was submitted since the signal was sampled, go to sleep
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        m_wakeCondition.wait(lock, [this, signal] {
+            return m_wakeSignal.load(std::memory_order_seq_cst) != signal
+                || !m_running.load(std::memory_order_acquire);
+        });
+        m_sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+
+        idleCount = 0;
+    }
+
+    s_currentSystem = nullptr;
+    s_currentWorker = -1;
+}
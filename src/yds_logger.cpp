@@ -1,30 +1,141 @@
 #include "../include/yds_logger.h"
 
-#include <stdarg.h>
+#include "../include/yds_allocator.h"
+#include "../include/yds_timing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <vector>
 
 ysLogger *ysLogger::g_instance = NULL;
 
-ysLogger::ysLogger() {
-    /* void */
+constexpr int ysLogger::MaxThreads;
+constexpr int ysLogger::RingCapacity;
+constexpr int ysLogger::RecordSize;
+constexpr int ysLogger::FlushInterval_ms;
+
+namespace {
+    std::atomic<int> s_nextGeneration(1);
+
+    // Ring of the calling thread, tagged with the logger it belongs to
+    thread_local int s_threadGeneration = 0;
+    thread_local void *s_threadRing = nullptr;
+
+    // Used for messages that bypass the ring
+    thread_local ysLogger::Record s_scratchRecord;
+
+    class ArgumentReader {
+    public:
+        struct Argument {
+            ysLogger::ArgumentType Type;
+            union {
+                int64_t Int;
+                uint64_t UnsignedInt;
+                double Double;
+            };
+            const char *String;
+            size_t Length;
+        };
+
+        ArgumentReader(const ysLogger::Record &record) : m_record(record) {
+            m_offset = 0;
+            m_remaining = record.Header.ArgumentCount;
+        }
+
+        bool Next(Argument *argument) {
+            if (m_remaining == 0) return false;
+            --m_remaining;
+
+            const unsigned char *data = m_record.Payload + m_offset;
+            argument->Type = (ysLogger::ArgumentType)data[0];
+            argument->String = nullptr;
+            argument->Length = 0;
+
+            if (argument->Type == ysLogger::ArgumentType::String) {
+                uint16_t length;
+                memcpy(&length, data + 1, sizeof(length));
+
+                argument->String = reinterpret_cast<const char *>(data + 1 + sizeof(length));
+                argument->Length = length;
+                m_offset += 1 + sizeof(length) + length;
+            }
+            else {
+                memcpy(&argument->UnsignedInt, data + 1, sizeof(uint64_t));
+                m_offset += 1 + sizeof(uint64_t);
+            }
+
+            return true;
+        }
+
+    protected:
+        const ysLogger::Record &m_record;
+        size_t m_offset;
+        int m_remaining;
+    };
+
+    int64_t ToInt(const ArgumentReader::Argument &argument) {
+        switch (argument.Type) {
+        case ysLogger::ArgumentType::Double: return (int64_t)argument.Double;
+        case ysLogger::ArgumentType::String: return 0;
+        default: return argument.Int;
+        }
+    }
+
+    double ToDouble(const ArgumentReader::Argument &argument) {
+        switch (argument.Type) {
+        case ysLogger::ArgumentType::Double: return argument.Double;
+        case ysLogger::ArgumentType::Int: return (double)argument.Int;
+        case ysLogger::ArgumentType::UnsignedInt: return (double)argument.UnsignedInt;
+        default: return 0.0;
+        }
+    }
+
+    bool IsConversion(char c) {
+        return c != '\0' && strchr("diouxXeEfFgGaAcspn", c) != nullptr;
+    }
+
+    bool IsLengthModifier(char c) {
+        return c != '\0' && strchr("hlLqjzt", c) != nullptr;
+    }
 }
 
-ysLogger::~ysLogger() {
-    /* void */
+ysLogger::ysLogger() {
+    m_overflowPolicy = OverflowPolicy::Drop;
+    m_generation = s_nextGeneration.fetch_add(1);
+
+    for (int i = 0; i < MaxThreads; ++i) {
+        m_threadRings[i] = nullptr;
+    }
+
+    m_threadCount = 0;
+
+    m_running = false;
+    m_stopping = false;
+
+    m_startTime = time(0);
+    m_startTimestamp = ysTimingSystem::Now();
 }
 
-void ysLogger::LogMessage(const char *message, const char *fname, int line, int level, ...) {
-    char buffer[1024];
+ysLogger::~ysLogger() {
+    if (IsRunning()) End();
 
-    va_list argptr;
-    va_start(argptr, level);
-    vsnprintf(buffer, 1024, message, argptr);
-    va_end(argptr);
+    for (int i = 0; i < MaxThreads; ++i) {
+        ThreadRing *ring = m_threadRings[i].load();
+        if (ring != nullptr) ysAllocator::TypeFree(ring, 1, true, alignof(ThreadRing));
+    }
+}
 
-    int nTargets = m_loggerOutputs.GetNumObjects();
+uint64_t ysLogger::GetDroppedMessageCount() const {
+    uint64_t dropped = 0;
 
-    for (int i = 0; i < nTargets; i++) {
-        m_loggerOutputs.Get(i)->LogMessage(buffer, fname, line, level);
+    const int threadCount = m_threadCount.load(std::memory_order_acquire);
+    for (int i = 0; i < threadCount && i < MaxThreads; ++i) {
+        ThreadRing *ring = m_threadRings[i].load(std::memory_order_acquire);
+        if (ring != nullptr) dropped += ring->Dropped.load(std::memory_order_relaxed);
     }
+
+    return dropped;
 }
 
 void ysLogger::AddMessageLevel(int level, const char *name) {
@@ -35,11 +146,11 @@ void ysLogger::AddMessageLevel(int level, const char *name) {
 
 void ysLogger::Initialize() {
     // Add default levels
-    AddMessageLevel(0,    "DEBUG");
-    AddMessageLevel(10, "INFO");
-    AddMessageLevel(20, "WARNING");
-    AddMessageLevel(30, "ERROR");
-    AddMessageLevel(40, "CRITICAL");
+    AddMessageLevel(YDS_LOG_LEVEL_DEBUG,    "DEBUG");
+    AddMessageLevel(YDS_LOG_LEVEL_INFO,     "INFO");
+    AddMessageLevel(YDS_LOG_LEVEL_WARNING,  "WARNING");
+    AddMessageLevel(YDS_LOG_LEVEL_ERROR,    "ERROR");
+    AddMessageLevel(YDS_LOG_LEVEL_CRITICAL, "CRITICAL");
 }
 
 void ysLogger::Start() {
@@ -48,9 +159,35 @@ void ysLogger::Start() {
     for (int i = 0; i < nTargets; i++) {
         m_loggerOutputs.Get(i)->Initialize();
     }
+
+    m_startTime = time(0);
+    m_startTimestamp = ysTimingSystem::Now();
+
+    m_stopping = false;
+    m_running.store(true, std::memory_order_release);
+    m_worker = std::thread(&ysLogger::WorkerThread, this);
+}
+
+void ysLogger::Flush() {
+    ProcessPending();
 }
 
 void ysLogger::End() {
+    if (m_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_workerLock);
+            m_stopping = true;
+        }
+
+        m_workerCondition.notify_one();
+        m_worker.join();
+    }
+
+    m_running.store(false, std::memory_order_release);
+
+    // Anything logged while the worker was shutting down
+    ProcessPending();
+
     int nTargets = m_loggerOutputs.GetNumObjects();
 
     for (int i = 0; i < nTargets; i++) {
@@ -58,8 +195,306 @@ void ysLogger::End() {
     }
 }
 
+ysLogger::Record *ysLogger::BeginRecord(const char *message, const char *fname, int line, int level) {
+    Record *record = &s_scratchRecord;
+
+    ThreadRing *ring = IsRunning() ? GetThreadRing() : nullptr;
+    if (ring != nullptr) {
+        const uint64_t head = ring->Head.load(std::memory_order_relaxed);
+        uint64_t tail = ring->Tail.load(std::memory_order_acquire);
+
+        if (head - tail >= (uint64_t)RingCapacity) {
+            if (m_overflowPolicy == OverflowPolicy::Drop) {
+                ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else if (m_overflowPolicy == OverflowPolicy::Block) {
+                m_workerCondition.notify_one();
+                while (head - tail >= (uint64_t)RingCapacity && IsRunning()) {
+                    std::this_thread::yield();
+                    tail = ring->Tail.load(std::memory_order_acquire);
+                }
+            }
+            else {
+                // Older messages from this thread are still queued, write them
+                // out first so the synchronous write doesn't jump ahead of them
+                ProcessPending();
+                ring = nullptr;
+            }
+        }
+
+        if (ring != nullptr && head - tail < (uint64_t)RingCapacity) {
+            record = &ring->Records[head % RingCapacity];
+        }
+    }
+
+    RecordHeader &header = record->Header;
+    header.Timestamp = ysTimingSystem::Now();
+    header.Format = message;
+    header.File = fname;
+    header.Line = line;
+    header.Level = level;
+    header.PayloadSize = 0;
+    header.ArgumentCount = 0;
+    header.Truncated = false;
+
+    return record;
+}
+
+void ysLogger::CommitRecord(Record *record) {
+    if (record == &s_scratchRecord) {
+        std::lock_guard<std::mutex> lock(m_outputLock);
+        WriteRecord(*record);
+        return;
+    }
+
+    ThreadRing *ring = reinterpret_cast<ThreadRing *>(s_threadRing);
+    const uint64_t head = ring->Head.load(std::memory_order_relaxed) + 1;
+    ring->Head.store(head, std::memory_order_release);
+
+    // Wake the worker early rather than letting the ring fill up
+    if ((head - ring->Tail.load(std::memory_order_relaxed)) == RingCapacity / 2) {
+        m_workerCondition.notify_one();
+    }
+}
+
+ysLogger::ThreadRing *ysLogger::GetThreadRing() {
+    if (s_threadGeneration == m_generation) {
+        return reinterpret_cast<ThreadRing *>(s_threadRing);
+    }
+
+    const int index = m_threadCount.fetch_add(1);
+
+    ThreadRing *ring = nullptr;
+    if (index < MaxThreads) {
+        ring = ysAllocator::TypeAllocate<ThreadRing, alignof(ThreadRing)>(1);
+        ring->Head = 0;
+        ring->Tail = 0;
+        ring->Dropped = 0;
+
+        m_threadRings[index].store(ring, std::memory_order_release);
+    }
+    else {
+        m_threadCount.fetch_sub(1);
+    }
+
+    // Threads past the limit fall back to synchronous writes
+    s_threadGeneration = m_generation;
+    s_threadRing = ring;
+
+    return ring;
+}
+
+void ysLogger::WriteRecord(const Record &record) {
+    char buffer[1024];
+    FormatRecord(record, buffer, sizeof(buffer));
+
+    const uint64_t timestamp = record.Header.Timestamp;
+    const time_t t = (timestamp > m_startTimestamp)
+        ? m_startTime + (time_t)ysTimingSystem::TicksToSeconds(timestamp - m_startTimestamp)
+        : m_startTime;
+
+    int nTargets = m_loggerOutputs.GetNumObjects();
+
+    for (int i = 0; i < nTargets; i++) {
+        ysLoggerOutput *output = m_loggerOutputs.Get(i);
+        if (output->GetEnable()) {
+            output->LogMessage(buffer, record.Header.File, record.Header.Line, record.Header.Level, t);
+        }
+    }
+}
+
+void ysLogger::ProcessPending() {
+    std::lock_guard<std::mutex> consumerLock(m_consumerLock);
+
+    struct Range {
+        ThreadRing *Ring;
+        uint64_t Head;
+    };
+
+    Range ranges[MaxThreads];
+    std::vector<const Record *> batch;
+
+    const int threadCount = (std::min)(m_threadCount.load(std::memory_order_acquire), MaxThreads);
+    for (int i = 0; i < threadCount; ++i) {
+        ThreadRing *ring = m_threadRings[i].load(std::memory_order_acquire);
+        ranges[i].Ring = ring;
+        ranges[i].Head = 0;
+        if (ring == nullptr) continue;
+
+        const uint64_t head = ring->Head.load(std::memory_order_acquire);
+        const uint64_t tail = ring->Tail.load(std::memory_order_relaxed);
+        for (uint64_t j = tail; j < head; ++j) {
+            batch.push_back(&ring->Records[j % RingCapacity]);
+        }
+
+        ranges[i].Head = head;
+    }
+
+    if (!batch.empty()) {
+        // Messages from one thread are already in order, this interleaves threads
+        std::stable_sort(batch.begin(), batch.end(), [](const Record *a, const Record *b) {
+            return a->Header.Timestamp < b->Header.Timestamp;
+        });
+
+        std::lock_guard<std::mutex> outputLock(m_outputLock);
+        for (const Record *record : batch) {
+            WriteRecord(*record);
+        }
+
+        int nTargets = m_loggerOutputs.GetNumObjects();
+        for (int i = 0; i < nTargets; i++) {
+            m_loggerOutputs.Get(i)->Flush();
+        }
+    }
+
+    for (int i = 0; i < threadCount; ++i) {
+        if (ranges[i].Ring != nullptr) {
+            ranges[i].Ring->Tail.store(ranges[i].Head, std::memory_order_release);
+        }
+    }
+}
+
+void ysLogger::WorkerThread() {
+    while (true) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_workerLock);
+            m_workerCondition.wait_for(lock, std::chrono::milliseconds(FlushInterval_ms), [this]() { return m_stopping; });
+            stopping = m_stopping;
+        }
+
+        ProcessPending();
+
+        if (stopping) break;
+    }
+}
+
+void ysLogger::FormatRecord(const Record &record, char *buffer, size_t bufferSize) {
+    if (bufferSize == 0) return;
+
+    ArgumentReader reader(record);
+    ArgumentReader::Argument argument;
+
+    char spec[48];
+    char text[RecordSize];
+
+    size_t length = 0;
+    const size_t capacity = bufferSize - 1;
+
+    const char *p = (record.Header.Format != nullptr) ? record.Header.Format : "";
+    while (*p != '\0' && length < capacity) {
+        if (*p != '%') {
+            buffer[length++] = *p++;
+            continue;
+        }
+        else if (p[1] == '%') {
+            buffer[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Rebuild the conversion with a length modifier matching the stored argument
+        int specLength = 0;
+        spec[specLength++] = *p++;
+
+        while (*p != '\0' && strchr("-+ #0", *p) != nullptr && specLength < 8) spec[specLength++] = *p++;
+
+        for (int field = 0; field < 2; ++field) {
+            if (field == 1) {
+                if (*p != '.') break;
+                spec[specLength++] = *p++;
+            }
+
+            if (*p == '*') {
+                ++p;
+                const int value = reader.Next(&argument) ? (int)ToInt(argument) : 0;
+                specLength += snprintf(spec + specLength, sizeof(spec) - specLength, "%d", value);
+            }
+            else {
+                while (*p >= '0' && *p <= '9' && specLength < 20) spec[specLength++] = *p++;
+            }
+        }
+
+        while (IsLengthModifier(*p)) ++p;
+
+        const char conversion = *p;
+        if (!IsConversion(conversion)) {
+            // Malformed specification, skip it
+            continue;
+        }
+
+        ++p;
+
+        const size_t remaining = bufferSize - length;
+        int written = 0;
+
+        if (!reader.Next(&argument)) {
+            written = snprintf(buffer + length, remaining, "<?>");
+        }
+        else {
+            switch (conversion) {
+            case 'd':
+            case 'i':
+                strcpy(spec + specLength, "lld");
+                written = snprintf(buffer + length, remaining, spec, (long long)ToInt(argument));
+                break;
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                spec[specLength++] = 'l';
+                spec[specLength++] = 'l';
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                written = snprintf(buffer + length, remaining, spec, (unsigned long long)ToInt(argument));
+                break;
+            case 'c':
+                strcpy(spec + specLength, "c");
+                written = snprintf(buffer + length, remaining, spec, (int)ToInt(argument));
+                break;
+            case 'p':
+                strcpy(spec + specLength, "p");
+                written = snprintf(buffer + length, remaining, spec, (void *)(uintptr_t)argument.UnsignedInt);
+                break;
+            case 's':
+                if (argument.Type == ArgumentType::String) {
+                    memcpy(text, argument.String, argument.Length);
+                    text[argument.Length] = '\0';
+                }
+                else {
+                    strcpy(text, "<?>");
+                }
+
+                strcpy(spec + specLength, "s");
+                written = snprintf(buffer + length, remaining, spec, text);
+                break;
+            case 'n':
+                break;
+            default:
+                spec[specLength++] = conversion;
+                spec[specLength] = '\0';
+                written = snprintf(buffer + length, remaining, spec, ToDouble(argument));
+                break;
+            }
+        }
+
+        if (written > 0) {
+            length += (std::min)((size_t)written, remaining - 1);
+        }
+    }
+
+    if (record.Header.Truncated && length + 3 < capacity) {
+        memcpy(buffer + length, "...", 3);
+        length += 3;
+    }
+
+    buffer[length] = '\0';
+}
+
 ysLoggerMessageLevel::ysLoggerMessageLevel() {
-    ysLoggerMessageLevel::ysLoggerMessageLevel("", -1);
+    m_name[0] = '\0';
+    m_level = -1;
     m_valid = false;
 }
 
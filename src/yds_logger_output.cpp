@@ -1,9 +1,8 @@
 #include "../include/yds_logger_output.h"
 #include "../include/yds_logger.h"
 
-#include <time.h>
-
 ysLoggerOutput::ysLoggerOutput() : ysObject("ysLoggerOutput") {
+    m_enabled = true;
     m_level = -1;
     m_parentLogger = NULL;
     m_formatParameters = LOG_DEFAULT;
@@ -12,6 +11,7 @@ ysLoggerOutput::ysLoggerOutput() : ysObject("ysLoggerOutput") {
 }
 
 ysLoggerOutput::ysLoggerOutput(const char *typeID) : ysObject(typeID) {
+    m_enabled = true;
     m_level = -1;
     m_parentLogger = NULL;
     m_formatParameters = LOG_DEFAULT;
@@ -27,14 +27,13 @@ void ysLoggerOutput::SetLogger(ysLogger *logger) {
     m_parentLogger = logger;
 }
 
-void ysLoggerOutput::LogMessage(const char *message, const char *fname, int line, int level) {
+void ysLoggerOutput::LogMessage(const char *message, const char *fname, int line, int level, time_t timestamp) {
     char buffer[256];
 
     ClearBuffer();
 
-    time_t now = time(0);
     struct tm tstruct;
-    localtime_s(&tstruct, &now);
+    localtime_s(&tstruct, &timestamp);
 
     if ((m_formatParameters & LOG_DATE) > 0) {
         strftime(buffer, 256, "%Y-%m-%d", &tstruct);
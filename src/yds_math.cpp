@@ -3,6 +3,14 @@
 #include <math.h>
 #include <cmath>
 
+namespace {
+    // Portable replacement for the MSVC-only m128_f32 accessor
+    template <int Lane>
+    inline float ExtractLane(const ysVector &v) {
+        return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane)));
+    }
+}
+
 ysVector ysMath::UniformRandom4(float range) {
     float r = (rand() % RAND_MAX) / ((float)(RAND_MAX - 1));
     return LoadScalar(range * r);
@@ -75,65 +83,65 @@ ysQuaternion ysMath::LoadQuaternion(float angle, const ysVector &axis) {
 
 ysVector4 ysMath::GetVector4(const ysVector &v) {
     ysVector4 r;
-    r.x = v.m128_f32[0];
-    r.y = v.m128_f32[1];
-    r.z = v.m128_f32[2];
-    r.w = v.m128_f32[3];
+    r.x = ExtractLane<0>(v);
+    r.y = ExtractLane<1>(v);
+    r.z = ExtractLane<2>(v);
+    r.w = ExtractLane<3>(v);
 
     return r;
 }
 
 ysVector3 ysMath::GetVector3(const ysVector &v) {
     ysVector3 r;
-    r.x = v.m128_f32[0];
-    r.y = v.m128_f32[1];
-    r.z = v.m128_f32[2];
+    r.x = ExtractLane<0>(v);
+    r.y = ExtractLane<1>(v);
+    r.z = ExtractLane<2>(v);
 
     return r;
 }
 
 ysVector2 ysMath::GetVector2(const ysVector &v) {
     ysVector2 r;
-    r.x = v.m128_f32[0];
-    r.y = v.m128_f32[1];
+    r.x = ExtractLane<0>(v);
+    r.y = ExtractLane<1>(v);
 
     return r;
 }
 
 float ysMath::GetScalar(const ysVector &v) {
-    return v.m128_f32[0];
+    return ExtractLane<0>(v);
 }
 
 float ysMath::GetX(const ysVector &v) {
-    return v.m128_f32[0];
+    return ExtractLane<0>(v);
 }
 
 float ysMath::GetY(const ysVector &v) {
-    return v.m128_f32[1];
+    return ExtractLane<1>(v);
 }
 
 float ysMath::GetZ(const ysVector &v) {
-    return v.m128_f32[2];
+    return ExtractLane<2>(v);
 }
 
 float ysMath::GetW(const ysVector &v) {
-    return v.m128_f32[3];
+    return ExtractLane<3>(v);
 }
 
 float ysMath::GetQuatX(const ysQuaternion &v) {
-    return v.m128_f32[1];
+    return ExtractLane<1>(v);
 }
 
 float ysMath::GetQuatY(const ysQuaternion &v) {
-    return v.m128_f32[2];
+    return ExtractLane<2>(v);
 }
 
 float ysMath::GetQuatZ(const ysQuaternion &v) {
-    return v.m128_f32[3];
+    return ExtractLane<3>(v);
 }
 
 float ysMath::GetQuatW(const ysQuaternion &v) {
-    return v.m128_f32[0];
+    return ExtractLane<0>(v);
 }
 
 ysGeneric ysMath::Add(const ysGeneric &v1, const ysGeneric &v2) {
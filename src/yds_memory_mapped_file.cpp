@@ -0,0 +1,110 @@
+#include "../include/yds_memory_mapped_file.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ysMemoryMappedFile::ysMemoryMappedFile() : ysObject("ysMemoryMappedFile") {
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+
+#if defined(_WIN32)
+    m_fileHandle = INVALID_HANDLE_VALUE;
+    m_mappingHandle = nullptr;
+#endif
+}
+
+ysMemoryMappedFile::~ysMemoryMappedFile() {
+    Close();
+}
+
+ysError ysMemoryMappedFile::Open(const char *fname) {
+    YDS_ERROR_DECLARE("Open");
+
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = ::CreateFileA(
+        fname, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+    }
+
+    m_fileHandle = file;
+    m_size = (size_t)size.QuadPart;
+    m_open = true;
+
+    if (m_size == 0) return YDS_ERROR_RETURN(ysError::None);
+
+    m_mappingHandle = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle == nullptr) {
+        Close();
+        return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+    }
+
+    m_data = (const char *)::MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == nullptr) {
+        Close();
+        return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+    }
+#else
+    const int file = ::open(fname, O_RDONLY);
+    if (file < 0) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    struct stat info;
+    if (::fstat(file, &info) != 0) {
+        ::close(file);
+        return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+    }
+
+    m_size = (size_t)info.st_size;
+    m_open = true;
+
+    if (m_size > 0) {
+        void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED) {
+            ::close(file);
+            Close();
+            return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+        }
+
+#if defined(MADV_SEQUENTIAL)
+        ::madvise(data, m_size, MADV_SEQUENTIAL);
+#endif
+
+        m_data = (const char *)data;
+    }
+
+    // The mapping keeps its own reference to the file
+    ::close(file);
+#endif
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void ysMemoryMappedFile::Close() {
+#if defined(_WIN32)
+    if (m_data != nullptr) ::UnmapViewOfFile(m_data);
+    if (m_mappingHandle != nullptr) ::CloseHandle(m_mappingHandle);
+    if (m_fileHandle != INVALID_HANDLE_VALUE) ::CloseHandle(m_fileHandle);
+
+    m_mappingHandle = nullptr;
+    m_fileHandle = INVALID_HANDLE_VALUE;
+#else
+    if (m_data != nullptr) ::munmap((void *)m_data, m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
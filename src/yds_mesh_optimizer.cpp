@@ -0,0 +1,635 @@
+#include "../include/yds_mesh_optimizer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+#include <unordered_map>
+
+namespace {
+
+    uint64_t HashBytes(const char *data, int size) {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (int i = 0; i < size; ++i) {
+            hash ^= (uint8_t)data[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // --
+    // Vertex scoring from "Linear-Speed Vertex Cache Optimisation"
+    // (Forsyth 2006). Vertices near the front of the cache score higher,
+    // as do vertices with few triangles left so that stragglers get
+    // cleaned up instead of leaving isolated triangles behind.
+    // --
+    const float CacheDecayPower = 1.5f;
+    const float LastTriangleScore = 0.75f;
+    const float ValenceBoostScale = 2.0f;
+    const float ValenceBoostPower = 0.5f;
+
+    float VertexScore(int cachePosition, int remainingValence) {
+        if (remainingValence == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // The last triangle's vertices get a fixed score so that
+                // strips don't simply keep going in one direction
+                score = LastTriangleScore;
+            }
+            else {
+                const float scaler = 1.0f / (ysMeshOptimizer::OptimizerCacheSize - 3);
+                score = powf(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+            }
+        }
+
+        score += ValenceBoostScale * powf((float)remainingValence, -ValenceBoostPower);
+
+        return score;
+    }
+
+    // Number of distinct vertices in a triangle, written to vertices
+    int GetDistinctVertices(const unsigned int *triangle, unsigned int *vertices) {
+        int count = 0;
+        for (int i = 0; i < 3; ++i) {
+            bool repeated = false;
+            for (int j = 0; j < count; ++j) {
+                if (vertices[j] == triangle[i]) repeated = true;
+            }
+
+            if (!repeated) vertices[count++] = triangle[i];
+        }
+
+        return count;
+    }
+
+    // --
+    // Sum of squared distances to a set of planes, stored as the symmetric
+    // matrix A, vector b and scalar c so that the error at p is
+    // p.A.p + 2 b.p + c
+    // --
+    struct Quadric {
+        double A00, A01, A02, A11, A12, A22;
+        double B0, B1, B2;
+        double C;
+    };
+
+    void AddPlane(Quadric *q, double nx, double ny, double nz, double d) {
+        q->A00 += nx * nx; q->A01 += nx * ny; q->A02 += nx * nz;
+        q->A11 += ny * ny; q->A12 += ny * nz;
+        q->A22 += nz * nz;
+        q->B0 += nx * d; q->B1 += ny * d; q->B2 += nz * d;
+        q->C += d * d;
+    }
+
+    void AddQuadric(Quadric *q, const Quadric &other) {
+        q->A00 += other.A00; q->A01 += other.A01; q->A02 += other.A02;
+        q->A11 += other.A11; q->A12 += other.A12;
+        q->A22 += other.A22;
+        q->B0 += other.B0; q->B1 += other.B1; q->B2 += other.B2;
+        q->C += other.C;
+    }
+
+    double QuadricError(const Quadric &q, const float *p) {
+        const double x = p[0], y = p[1], z = p[2];
+        const double ax = q.A00 * x + q.A01 * y + q.A02 * z;
+        const double ay = q.A01 * x + q.A11 * y + q.A12 * z;
+        const double az = q.A02 * x + q.A12 * y + q.A22 * z;
+
+        // Rounding can take it slightly below zero
+        const double error = x * ax + y * ay + z * az + 2 * (q.B0 * x + q.B1 * y + q.B2 * z) + q.C;
+        return (error > 0) ? error : 0;
+    }
+
+    void TriangleNormal(const float *a, const float *b, const float *c, double *n) {
+        const double e0[] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const double e1[] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+        n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+        n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+        n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+    }
+
+    uint64_t EdgeKey(unsigned int a, unsigned int b) {
+        return (a < b)
+            ? ((uint64_t)a << 32) | b
+            : ((uint64_t)b << 32) | a;
+    }
+
+    struct Collapse {
+        unsigned int From;
+        unsigned int To;
+        double Cost;
+    };
+
+} /* namespace */
+
+int ysMeshOptimizer::WeldVertices(std::vector<char> &vertexData, int stride, std::vector<unsigned int> &indices) {
+    if (stride <= 0) return 0;
+
+    const int vertexCount = (int)(vertexData.size() / stride);
+
+    size_t tableSize = 1;
+    while (tableSize < 2 * (size_t)vertexCount) tableSize *= 2;
+
+    // Open addressed table of unique vertices, -1 marks an empty slot
+    std::vector<int> table(tableSize, -1);
+    std::vector<unsigned int> remap(vertexCount);
+
+    int uniqueCount = 0;
+    for (int i = 0; i < vertexCount; ++i) {
+        const char *vertex = vertexData.data() + (size_t)i * stride;
+
+        size_t slot = HashBytes(vertex, stride) & (tableSize - 1);
+        for (;;) {
+            const int entry = table[slot];
+            if (entry == -1) {
+                // Unique vertices are compacted as they're found, the slot
+                // being written to has already been visited
+                if (uniqueCount != i) {
+                    memcpy(vertexData.data() + (size_t)uniqueCount * stride, vertex, stride);
+                }
+
+                table[slot] = uniqueCount;
+                remap[i] = uniqueCount++;
+                break;
+            }
+
+            if (memcmp(vertexData.data() + (size_t)entry * stride, vertex, stride) == 0) {
+                remap[i] = entry;
+                break;
+            }
+
+            slot = (slot + 1) & (tableSize - 1);
+        }
+    }
+
+    for (unsigned int &index : indices) index = remap[index];
+    vertexData.resize((size_t)uniqueCount * stride);
+
+    return uniqueCount;
+}
+
+void ysMeshOptimizer::OptimizeVertexCache(std::vector<unsigned int> &indices, int vertexCount) {
+    const int triangleCount = (int)(indices.size() / 3);
+    if (triangleCount == 0) return;
+
+    // Triangles using each vertex. Each vertex's list is kept partitioned
+    // so that the first remainingValence entries are the triangles that
+    // haven't been emitted yet.
+    std::vector<int> offsets(vertexCount + 1, 0);
+    std::vector<int> remainingValence(vertexCount, 0);
+
+    unsigned int vertices[3];
+    for (int t = 0; t < triangleCount; ++t) {
+        const int count = GetDistinctVertices(&indices[t * 3], vertices);
+        for (int i = 0; i < count; ++i) ++remainingValence[vertices[i]];
+    }
+
+    for (int v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + remainingValence[v];
+
+    std::vector<int> vertexTriangles(offsets[vertexCount]);
+    {
+        std::vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (int t = 0; t < triangleCount; ++t) {
+            const int count = GetDistinctVertices(&indices[t * 3], vertices);
+            for (int i = 0; i < count; ++i) vertexTriangles[next[vertices[i]]++] = t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) vertexScore[v] = VertexScore(-1, remainingValence[v]);
+
+    std::vector<float> triangleScore(triangleCount, 0.0f);
+    std::vector<bool> emitted(triangleCount, false);
+
+    int bestTriangle = 0;
+    for (int t = 0; t < triangleCount; ++t) {
+        const int count = GetDistinctVertices(&indices[t * 3], vertices);
+        for (int i = 0; i < count; ++i) triangleScore[t] += vertexScore[vertices[i]];
+
+        if (triangleScore[t] > triangleScore[bestTriangle]) bestTriangle = t;
+    }
+
+    // Holds the triangle's vertices ahead of the previous cache contents
+    int cache[OptimizerCacheSize + 3];
+    int cacheCount = 0;
+
+    std::vector<unsigned int> output(triangleCount * 3);
+    int nextUnemitted = 0;
+
+    for (int emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle == -1) {
+            // Nothing in the cache has triangles left, start somewhere new
+            while (emitted[nextUnemitted]) ++nextUnemitted;
+            bestTriangle = nextUnemitted;
+        }
+
+        const int t = bestTriangle;
+        const unsigned int *triangle = &indices[t * 3];
+
+        output[emittedCount * 3 + 0] = triangle[0];
+        output[emittedCount * 3 + 1] = triangle[1];
+        output[emittedCount * 3 + 2] = triangle[2];
+        emitted[t] = true;
+
+        const int count = GetDistinctVertices(triangle, vertices);
+
+        // Remove the triangle from its vertices' lists of remaining triangles
+        for (int i = 0; i < count; ++i) {
+            const int v = vertices[i];
+            int *triangles = &vertexTriangles[offsets[v]];
+            const int last = --remainingValence[v];
+
+            for (int j = 0; j <= last; ++j) {
+                if (triangles[j] == t) {
+                    triangles[j] = triangles[last];
+                    triangles[last] = t;
+                    break;
+                }
+            }
+        }
+
+        // Move the triangle's vertices to the front of the cache
+        int newCache[OptimizerCacheSize + 3];
+        int newCacheCount = 0;
+
+        for (int i = 0; i < count; ++i) newCache[newCacheCount++] = vertices[i];
+        for (int i = 0; i < cacheCount; ++i) {
+            const int v = cache[i];
+            if (v == (int)vertices[0] || (count > 1 && v == (int)vertices[1]) || (count > 2 && v == (int)vertices[2])) {
+                continue;
+            }
+
+            newCache[newCacheCount++] = v;
+        }
+
+        // Rescore everything whose position changed, including the evicted
+        // vertices, and look for the best triangle among the cached ones
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+
+        for (int i = 0; i < newCacheCount; ++i) {
+            const int v = newCache[i];
+            const int position = (i < OptimizerCacheSize) ? i : -1;
+            cachePosition[v] = position;
+
+            const float score = VertexScore(position, remainingValence[v]);
+            const float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+
+            const int *triangles = &vertexTriangles[offsets[v]];
+            for (int j = 0; j < remainingValence[v]; ++j) {
+                triangleScore[triangles[j]] += delta;
+            }
+        }
+
+        cacheCount = (newCacheCount < OptimizerCacheSize) ? newCacheCount : OptimizerCacheSize;
+        for (int i = 0; i < cacheCount; ++i) {
+            const int v = newCache[i];
+            cache[i] = v;
+
+            const int *triangles = &vertexTriangles[offsets[v]];
+            for (int j = 0; j < remainingValence[v]; ++j) {
+                if (triangleScore[triangles[j]] > bestScore) {
+                    bestScore = triangleScore[triangles[j]];
+                    bestTriangle = triangles[j];
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+int ysMeshOptimizer::OptimizeVertexFetch(std::vector<char> &vertexData, int stride, std::vector<unsigned int> &indices) {
+    if (stride <= 0) return 0;
+
+    const int vertexCount = (int)(vertexData.size() / stride);
+
+    std::vector<int> remap(vertexCount, -1);
+    std::vector<char> output(vertexData.size());
+
+    int nextVertex = 0;
+    for (unsigned int &index : indices) {
+        if (remap[index] == -1) {
+            memcpy(output.data() + (size_t)nextVertex * stride, vertexData.data() + (size_t)index * stride, stride);
+            remap[index] = nextVertex++;
+        }
+
+        index = (unsigned int)remap[index];
+    }
+
+    output.resize((size_t)nextVertex * stride);
+    vertexData.swap(output);
+
+    return nextVertex;
+}
+
+std::vector<ysMeshOptimizer::Submesh> ysMeshOptimizer::SplitMesh(
+    std::vector<char> &vertexData,
+    int stride,
+    std::vector<unsigned int> &indices,
+    int maxVertexCount)
+{
+    std::vector<Submesh> submeshes;
+    if (stride <= 0 || maxVertexCount < 3) return submeshes;
+
+    const int vertexCount = (int)(vertexData.size() / stride);
+    const int triangleCount = (int)(indices.size() / 3);
+
+    // Position of each vertex in the current submesh, valid if its tag
+    // matches the submesh index
+    std::vector<unsigned int> localIndex(vertexCount, 0);
+    std::vector<int> tag(vertexCount, -1);
+
+    std::vector<char> output;
+    output.reserve(vertexData.size());
+
+    Submesh current = { 0, 0, 0, 0 };
+
+    unsigned int vertices[3];
+    for (int t = 0; t < triangleCount; ++t) {
+        const int count = GetDistinctVertices(&indices[t * 3], vertices);
+        const int submeshIndex = (int)submeshes.size();
+
+        int newVertices = 0;
+        for (int i = 0; i < count; ++i) {
+            if (tag[vertices[i]] != submeshIndex) ++newVertices;
+        }
+
+        if (current.VertexCount + newVertices > maxVertexCount) {
+            submeshes.push_back(current);
+
+            current.BaseIndex = t * 3;
+            current.FaceCount = 0;
+            current.BaseVertex += current.VertexCount;
+            current.VertexCount = 0;
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            const unsigned int v = indices[t * 3 + i];
+            if (tag[v] != (int)submeshes.size()) {
+                tag[v] = (int)submeshes.size();
+                localIndex[v] = current.VertexCount++;
+
+                output.insert(
+                    output.end(),
+                    vertexData.begin() + (size_t)v * stride,
+                    vertexData.begin() + (size_t)(v + 1) * stride);
+            }
+
+            indices[t * 3 + i] = localIndex[v];
+        }
+
+        ++current.FaceCount;
+    }
+
+    if (current.FaceCount > 0) submeshes.push_back(current);
+
+    vertexData.swap(output);
+
+    return submeshes;
+}
+
+std::vector<unsigned int> ysMeshOptimizer::SimplifyMesh(
+    const std::vector<float> &positions,
+    const std::vector<unsigned int> &indices,
+    int targetIndexCount,
+    float targetError,
+    float *resultError)
+{
+    const int vertexCount = (int)(positions.size() / 3);
+    std::vector<unsigned int> result = indices;
+
+    double maxCost = 0;
+    const double costLimit = (double)targetError * targetError;
+
+    // Vertices sharing a position are treated as one, they differ only by attributes
+    std::vector<unsigned int> remap(vertexCount);
+    {
+        std::vector<unsigned int> order(vertexCount);
+        for (int i = 0; i < vertexCount; ++i) order[i] = (unsigned int)i;
+
+        std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+            return memcmp(&positions[a * 3], &positions[b * 3], 3 * sizeof(float)) < 0;
+        });
+
+        for (int i = 0; i < vertexCount; ++i) {
+            const unsigned int v = order[i];
+            remap[v] = (i > 0 && memcmp(&positions[order[i - 1] * 3], &positions[v * 3], 3 * sizeof(float)) == 0)
+                ? remap[order[i - 1]]
+                : v;
+        }
+    }
+
+    std::vector<bool> locked(vertexCount, false);
+    for (int i = 0; i < vertexCount; ++i) {
+        if (remap[i] != (unsigned int)i) {
+            locked[i] = locked[remap[i]] = true;
+        }
+    }
+
+    // Edges with a single triangle are on an open border
+    {
+        std::unordered_map<uint64_t, int> edgeUses;
+        edgeUses.reserve(result.size());
+
+        for (size_t t = 0; t < result.size(); t += 3) {
+            for (int e = 0; e < 3; ++e) {
+                const unsigned int a = remap[result[t + e]], b = remap[result[t + (e + 1) % 3]];
+                if (a != b) ++edgeUses[EdgeKey(a, b)];
+            }
+        }
+
+        for (const auto &edge : edgeUses) {
+            if (edge.second == 1) {
+                locked[(unsigned int)(edge.first >> 32)] = true;
+                locked[(unsigned int)(edge.first & 0xFFFFFFFF)] = true;
+            }
+        }
+    }
+
+    for (int i = 0; i < vertexCount; ++i) {
+        if (locked[remap[i]]) locked[i] = true;
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    memset(quadrics.data(), 0, sizeof(Quadric) * vertexCount);
+
+    for (size_t t = 0; t < result.size(); t += 3) {
+        const float *p0 = &positions[result[t + 0] * 3];
+        const float *p1 = &positions[result[t + 1] * 3];
+        const float *p2 = &positions[result[t + 2] * 3];
+
+        double n[3];
+        TriangleNormal(p0, p1, p2, n);
+
+        const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0) continue;
+
+        n[0] /= length; n[1] /= length; n[2] /= length;
+        const double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+        for (int i = 0; i < 3; ++i) {
+            AddPlane(&quadrics[remap[result[t + i]]], n[0], n[1], n[2], d);
+        }
+    }
+
+    std::vector<std::vector<int>> vertexTriangles(vertexCount);
+    std::vector<Collapse> collapses;
+    std::vector<unsigned int> collapseTarget(vertexCount);
+    std::vector<bool> touched(vertexCount);
+
+    // --
+    // Each pass collapses the cheapest edges first. A vertex and its
+    // neighbours can only be involved in one collapse per pass, so the
+    // costs and flip checks are never computed against stale geometry.
+    // --
+    while ((int)result.size() > targetIndexCount) {
+        const int triangleCount = (int)(result.size() / 3);
+
+        for (std::vector<int> &triangles : vertexTriangles) triangles.clear();
+        for (int t = 0; t < triangleCount; ++t) {
+            for (int i = 0; i < 3; ++i) {
+                vertexTriangles[result[t * 3 + i]].push_back(t);
+            }
+        }
+
+        collapses.clear();
+        for (int t = 0; t < triangleCount; ++t) {
+            for (int e = 0; e < 3; ++e) {
+                const unsigned int a = result[t * 3 + e], b = result[t * 3 + (e + 1) % 3];
+                if (remap[a] == remap[b]) continue;
+
+                if (!locked[a]) collapses.push_back({ a, b, QuadricError(quadrics[remap[a]], &positions[b * 3]) });
+                if (!locked[b]) collapses.push_back({ b, a, QuadricError(quadrics[remap[b]], &positions[a * 3]) });
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(),
+            [](const Collapse &a, const Collapse &b) { return a.Cost < b.Cost; });
+
+        for (int i = 0; i < vertexCount; ++i) collapseTarget[i] = (unsigned int)i;
+        std::fill(touched.begin(), touched.end(), false);
+
+        // Each collapse removes about two triangles
+        const int collapseBudget = (triangleCount - targetIndexCount / 3) / 2 + 1;
+        int collapseCount = 0;
+
+        for (const Collapse &collapse : collapses) {
+            if (collapseCount >= collapseBudget || collapse.Cost > costLimit) break;
+
+            const unsigned int from = collapse.From, to = collapse.To;
+            if (touched[remap[from]] || touched[remap[to]]) continue;
+
+            // Reject collapses that would flip or badly squash a triangle
+            bool flips = false;
+            for (int t : vertexTriangles[from]) {
+                const unsigned int *triangle = &result[t * 3];
+
+                int corner = 0;
+                bool containsTarget = false;
+                for (int i = 0; i < 3; ++i) {
+                    if (triangle[i] == from) corner = i;
+                    if (remap[triangle[i]] == remap[to]) containsTarget = true;
+                }
+
+                // Becomes degenerate and is removed
+                if (containsTarget) continue;
+
+                const float *p[3] = {
+                    &positions[triangle[0] * 3], &positions[triangle[1] * 3], &positions[triangle[2] * 3] };
+
+                double before[3], after[3];
+                TriangleNormal(p[0], p[1], p[2], before);
+                p[corner] = &positions[to * 3];
+                TriangleNormal(p[0], p[1], p[2], after);
+
+                const double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+                const double beforeLength2 = before[0] * before[0] + before[1] * before[1] + before[2] * before[2];
+                const double afterLength2 = after[0] * after[0] + after[1] * after[1] + after[2] * after[2];
+
+                // Already degenerate triangles can't flip
+                if (beforeLength2 == 0) continue;
+
+                if (afterLength2 <= 1e-12 * beforeLength2 || dot < 0.25 * sqrt(beforeLength2 * afterLength2)) {
+                    flips = true;
+                    break;
+                }
+            }
+
+            if (flips) continue;
+
+            collapseTarget[from] = to;
+            AddQuadric(&quadrics[remap[to]], quadrics[remap[from]]);
+            if (collapse.Cost > maxCost) maxCost = collapse.Cost;
+
+            for (int t : vertexTriangles[from]) {
+                for (int i = 0; i < 3; ++i) {
+                    touched[remap[result[t * 3 + i]]] = true;
+                }
+            }
+
+            ++collapseCount;
+        }
+
+        if (collapseCount == 0) break;
+
+        size_t write = 0;
+        for (size_t t = 0; t < result.size(); t += 3) {
+            const unsigned int a = collapseTarget[result[t + 0]];
+            const unsigned int b = collapseTarget[result[t + 1]];
+            const unsigned int c = collapseTarget[result[t + 2]];
+
+            if (remap[a] == remap[b] || remap[b] == remap[c] || remap[a] == remap[c]) continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+
+        result.resize(write);
+    }
+
+    if (resultError != nullptr) *resultError = (float)sqrt(maxCost);
+
+    return result;
+}
+
+ysMeshOptimizer::VertexCacheStatistics ysMeshOptimizer::AnalyzeVertexCache(
+    const std::vector<unsigned int> &indices,
+    int vertexCount,
+    int cacheSize)
+{
+    VertexCacheStatistics statistics;
+    memset(&statistics, 0, sizeof(VertexCacheStatistics));
+    statistics.TriangleCount = (int)(indices.size() / 3);
+
+    // A vertex is in the FIFO if fewer than cacheSize vertices were
+    // transformed since it was
+    std::vector<unsigned int> timestamps(vertexCount, 0);
+    unsigned int time = (unsigned int)cacheSize + 1;
+
+    for (unsigned int index : indices) {
+        if (timestamps[index] == 0) ++statistics.VertexCount;
+
+        if (time - timestamps[index] > (unsigned int)cacheSize) {
+            timestamps[index] = time++;
+            ++statistics.CacheMisses;
+        }
+    }
+
+    if (statistics.TriangleCount > 0) {
+        statistics.Acmr = (float)statistics.CacheMisses / statistics.TriangleCount;
+    }
+
+    if (statistics.VertexCount > 0) {
+        statistics.Atvr = (float)statistics.CacheMisses / statistics.VertexCount;
+    }
+
+    return statistics;
+}
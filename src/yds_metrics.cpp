@@ -0,0 +1,277 @@
+#include "../include/yds_metrics.h"
+
+#include <fstream>
+#include <string.h>
+
+std::atomic<ysMetrics *> ysMetrics::g_instance(nullptr);
+
+namespace {
+    std::mutex s_instanceLock;
+}
+
+constexpr ysMetrics::MetricId ysMetrics::InvalidMetric;
+constexpr int ysMetrics::MaxMetrics;
+constexpr int ysMetrics::MaxThreads;
+
+thread_local int ysMetrics::s_threadGeneration = 0;
+thread_local ysMetrics::ThreadCounters *ysMetrics::s_threadCounters = nullptr;
+
+namespace {
+    std::atomic<int> s_nextGeneration(1);
+
+    void WriteCsvField(std::ostream &out, const char *s) {
+        out << '"';
+        for (; *s != '\0'; ++s) {
+            if (*s == '"') out << "\"\"";
+            else out << *s;
+        }
+        out << '"';
+    }
+
+    void WriteJsonString(std::ostream &out, const char *s) {
+        out << '"';
+        for (; *s != '\0'; ++s) {
+            if (*s == '"' || *s == '\\') out << '\\' << *s;
+            else if ((unsigned char)*s < 0x20) out << ' ';
+            else out << *s;
+        }
+        out << '"';
+    }
+}
+
+ysMetrics::ysMetrics() : ysObject("ysMetrics") {
+    m_generation = s_nextGeneration.fetch_add(1);
+
+    m_metricCount = 0;
+    for (int i = 0; i < MaxMetrics; ++i) {
+        m_gauges[i] = 0.0;
+        m_overflowCounters.Values[i] = 0;
+    }
+
+    for (int i = 0; i < MaxThreads; ++i) {
+        m_threadCounters[i] = nullptr;
+    }
+
+    m_threadCount = 0;
+    m_frameCount = 0;
+
+    m_recording = false;
+    m_maxRecordedFrames = DefaultMaxRecordedFrames;
+}
+
+ysMetrics::~ysMetrics() {
+    for (int i = 0; i < MaxThreads; ++i) {
+        delete m_threadCounters[i].load();
+    }
+}
+
+ysMetrics *ysMetrics::CreateInstance() {
+    std::lock_guard<std::mutex> lock(s_instanceLock);
+
+    ysMetrics *instance = g_instance.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+        instance = new ysMetrics;
+        g_instance.store(instance, std::memory_order_release);
+    }
+
+    return instance;
+}
+
+ysMetrics::MetricId ysMetrics::Register(const char *name, Type type) {
+    std::lock_guard<std::mutex> lock(m_registrationLock);
+
+    const MetricId existing = FindMetric(name);
+    if (existing != InvalidMetric) return existing;
+
+    const int count = m_metricCount.load(std::memory_order_relaxed);
+    if (count >= MaxMetrics) return InvalidMetric;
+
+    Metric &metric = m_metrics[count];
+    strncpy(metric.Name, name, MaxNameLength - 1);
+    metric.Name[MaxNameLength - 1] = '\0';
+    metric.MetricType = type;
+    metric.Stats = { 0.0, 0.0, 0.0, 0.0, 0 };
+    metric.PreviousTotal = 0;
+
+    m_gauges[count].store(0.0, std::memory_order_relaxed);
+
+    m_metricCount.store(count + 1, std::memory_order_release);
+
+    return count;
+}
+
+ysMetrics::MetricId ysMetrics::FindMetric(const char *name) const {
+    const int count = GetMetricCount();
+    for (int i = 0; i < count; ++i) {
+        if (strncmp(m_metrics[i].Name, name, MaxNameLength - 1) == 0) return i;
+    }
+
+    return InvalidMetric;
+}
+
+void ysMetrics::AddGauge(MetricId id, double delta) {
+    if (id < 0) return;
+
+    double current = m_gauges[id].load(std::memory_order_relaxed);
+    while (!m_gauges[id].compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+        /* void */
+    }
+}
+
+void ysMetrics::EndFrame() {
+    const int metricCount = GetMetricCount();
+    const int threadCount = m_threadCount.load(std::memory_order_acquire);
+
+    const bool record = m_recording && m_recordedRowSizes.size() < m_maxRecordedFrames;
+    if (record) m_recordedRowSizes.push_back(metricCount);
+
+    for (int i = 0; i < metricCount; ++i) {
+        Metric &metric = m_metrics[i];
+
+        double value;
+        if (metric.MetricType == Type::Counter) {
+            // Thread counters only ever grow, the frame value is the change in their sum
+            int64_t total = m_overflowCounters.Values[i].load(std::memory_order_relaxed);
+            for (int j = 0; j < threadCount && j < MaxThreads; ++j) {
+                ThreadCounters *counters = m_threadCounters[j].load(std::memory_order_acquire);
+                if (counters != nullptr) total += counters->Values[i].load(std::memory_order_relaxed);
+            }
+
+            value = (double)(total - metric.PreviousTotal);
+            metric.PreviousTotal = total;
+        }
+        else {
+            value = m_gauges[i].load(std::memory_order_relaxed);
+        }
+
+        Statistics &stats = metric.Stats;
+        if (stats.Frames == 0) {
+            stats.Min = stats.Max = value;
+        }
+        else {
+            if (value < stats.Min) stats.Min = value;
+            if (value > stats.Max) stats.Max = value;
+        }
+
+        stats.Last = value;
+        stats.Total += value;
+        ++stats.Frames;
+
+        if (record) m_recordedValues.push_back(value);
+    }
+
+    ++m_frameCount;
+}
+
+void ysMetrics::ResetStatistics() {
+    const int metricCount = GetMetricCount();
+    for (int i = 0; i < metricCount; ++i) {
+        m_metrics[i].Stats = { 0.0, 0.0, 0.0, 0.0, 0 };
+    }
+}
+
+void ysMetrics::StartRecording(size_t maxFrames) {
+    m_recordedValues.clear();
+    m_recordedRowSizes.clear();
+
+    m_maxRecordedFrames = maxFrames;
+    m_recording = true;
+}
+
+void ysMetrics::StopRecording() {
+    m_recording = false;
+}
+
+size_t ysMetrics::GetRecordedFrameCount() const {
+    return m_recordedRowSizes.size();
+}
+
+ysError ysMetrics::WriteCsv(const char *fname) {
+    YDS_ERROR_DECLARE("WriteCsv");
+
+    std::ofstream file(fname, std::ios::out);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    const int metricCount = GetMetricCount();
+
+    file << "Frame";
+    for (int i = 0; i < metricCount; ++i) {
+        file << ',';
+        WriteCsvField(file, m_metrics[i].Name);
+    }
+    file << '\n';
+
+    size_t offset = 0;
+    for (size_t frame = 0; frame < m_recordedRowSizes.size(); ++frame) {
+        const int rowSize = m_recordedRowSizes[frame];
+
+        file << frame;
+        for (int i = 0; i < metricCount; ++i) {
+            file << ',';
+
+            // Metrics registered after this frame was recorded are left empty
+            if (i < rowSize) file << m_recordedValues[offset + i];
+        }
+        file << '\n';
+
+        offset += rowSize;
+    }
+
+    file.close();
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysMetrics::WriteJson(const char *fname) {
+    YDS_ERROR_DECLARE("WriteJson");
+
+    std::ofstream file(fname, std::ios::out);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    file << "{\"frames\":" << m_frameCount << ",\"metrics\":[\n";
+
+    const int metricCount = GetMetricCount();
+    for (int i = 0; i < metricCount; ++i) {
+        const Metric &metric = m_metrics[i];
+        const Statistics &stats = metric.Stats;
+
+        if (i > 0) file << ",\n";
+
+        file << "{\"name\":";
+        WriteJsonString(file, metric.Name);
+        file << ",\"type\":\"" << ((metric.MetricType == Type::Counter) ? "counter" : "gauge") << "\""
+            << ",\"last\":" << stats.Last
+            << ",\"min\":" << stats.Min
+            << ",\"max\":" << stats.Max
+            << ",\"average\":" << stats.GetAverage()
+            << ",\"total\":" << stats.Total
+            << "}";
+    }
+
+    file << "\n]}\n";
+    file.close();
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysMetrics::ThreadCounters *ysMetrics::RegisterThread() {
+    const int index = m_threadCount.fetch_add(1);
+
+    ThreadCounters *counters = &m_overflowCounters;
+    if (index < MaxThreads) {
+        counters = new ThreadCounters;
+        for (int i = 0; i < MaxMetrics; ++i) {
+            counters->Values[i].store(0, std::memory_order_relaxed);
+        }
+
+        m_threadCounters[index].store(counters, std::memory_order_release);
+    }
+    else {
+        m_threadCount.fetch_sub(1);
+    }
+
+    s_threadGeneration = m_generation;
+    s_threadCounters = counters;
+
+    return counters;
+}
@@ -0,0 +1,59 @@
+#include "../include/yds_name_index.h"
+
+ysNameIndex::ysNameIndex() {
+    m_slotsUsed = 0;
+    m_indexedCount = 0;
+}
+
+ysNameIndex::~ysNameIndex() {
+    /* void */
+}
+
+void ysNameIndex::Clear() {
+    m_slots.clear();
+    m_slotsUsed = 0;
+    m_indexedCount = 0;
+}
+
+void ysNameIndex::Insert(uint64_t hash, int value) {
+    // Kept at most half full so probe sequences stay short
+    if ((m_slotsUsed + 1) * 2 > (int)m_slots.size()) Grow();
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask) {
+        Slot &s = m_slots[slot];
+        if (s.Value < 0) {
+            s.Hash = hash;
+            s.Value = value;
+            ++m_slotsUsed;
+            return;
+        }
+        else if (s.Hash == hash) {
+            return;
+        }
+    }
+}
+
+int ysNameIndex::Find(uint64_t hash) const {
+    if (m_slots.empty()) return -1;
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t slot = (size_t)hash & mask;; slot = (slot + 1) & mask) {
+        const Slot &s = m_slots[slot];
+        if (s.Value < 0) return -1;
+        else if (s.Hash == hash) return s.Value;
+    }
+}
+
+void ysNameIndex::Grow() {
+    std::vector<Slot> old;
+    old.swap(m_slots);
+
+    const Slot empty = { 0, -1 };
+    m_slots.assign(old.empty() ? 16 : old.size() * 2, empty);
+    m_slotsUsed = 0;
+
+    for (const Slot &s : old) {
+        if (s.Value >= 0) Insert(s.Hash, s.Value);
+    }
+}
@@ -1,7 +1,19 @@
 #include "../include/yds_object_data.h"
 
+#include "../include/yds_content_hasher.h"
+
 #include <stdlib.h>
 
+namespace {
+
+    template <typename T_Element>
+    void AddArray(ysContentHasher *hasher, const ysExpandingArray<T_Element> &values) {
+        hasher->AddValue(values.IsActive());
+        hasher->AddArray(values.GetBuffer(), (size_t)values.GetNumObjects());
+    }
+
+} /* namespace */
+
 ysObjectData::ysObjectData() {
     Clear();
 }
@@ -19,6 +31,7 @@ void ysObjectData::Clear() {
     m_objectInformation.ParentInstance = -1;
     m_objectInformation.ObjectType = ObjectType::Undefined;
     m_objectInformation.UsesBones = 0;
+    m_objectInformation.SkeletonIndex = -1;
 
     m_objectStatistics.NumUVChannels = 0;
     m_objectStatistics.NumVertices = 0;
@@ -43,5 +56,70 @@ void ysObjectData::Clear() {
 
     m_flipNormals = false;
 
+    m_width = 0.0f;
+    m_height = 0.0f;
+    m_length = 0.0f;
+
     m_hardNormalCache = nullptr;
 }
+
+uint64_t ysObjectData::GetContentHash() const {
+    ysContentHasher hasher;
+
+    hasher.AddString(m_name);
+    hasher.AddString(m_materialName);
+
+    hasher.AddValue(m_objectInformation.ModelIndex);
+    hasher.AddValue(m_objectInformation.ParentIndex);
+    hasher.AddValue(m_objectInformation.ParentInstance);
+    hasher.AddValue((int)m_objectInformation.ObjectType);
+    hasher.AddValue(m_objectInformation.UsesBones);
+    hasher.AddValue(m_objectInformation.SkeletonIndex);
+
+    hasher.AddValue(m_objectTransformation.Position);
+    hasher.AddValue(m_objectTransformation.OrientationEuler);
+    hasher.AddValue(m_objectTransformation.Orientation);
+    hasher.AddValue(m_objectTransformation.Scale);
+
+    hasher.AddValue(m_objectStatistics.NumUVChannels);
+    hasher.AddValue(m_objectStatistics.NumVertices);
+    hasher.AddValue(m_objectStatistics.NumFaces);
+
+    AddArray(&hasher, m_vertices);
+    AddArray(&hasher, m_materialList);
+
+    hasher.AddValue(m_boneWeights.IsActive());
+    hasher.AddValue((uint64_t)m_boneWeights.GetNumObjects());
+    for (int i = 0; i < m_boneWeights.GetNumObjects(); ++i) {
+        AddArray(&hasher, m_boneWeights.GetBuffer()[i].m_boneIndices);
+        AddArray(&hasher, m_boneWeights.GetBuffer()[i].m_boneWeights);
+    }
+
+    hasher.AddValue(m_channels.IsActive());
+    hasher.AddValue((uint64_t)m_channels.GetNumObjects());
+    for (int i = 0; i < m_channels.GetNumObjects(); ++i) {
+        AddArray(&hasher, m_channels.GetBuffer()[i].m_coordinates);
+    }
+
+    AddArray(&hasher, m_vertexIndexSet);
+    AddArray(&hasher, m_smoothingGroups);
+    AddArray(&hasher, m_extendedSmoothingGroups);
+    hasher.AddValue(m_numExtendedSmoothingGroups);
+
+    hasher.AddValue(m_UVIndexSets.IsActive());
+    hasher.AddValue((uint64_t)m_UVIndexSets.GetNumObjects());
+    for (int i = 0; i < m_UVIndexSets.GetNumObjects(); ++i) {
+        AddArray(&hasher, m_UVIndexSets.GetBuffer()[i].UVIndexSets);
+    }
+
+    AddArray(&hasher, m_boneIndices);
+    AddArray(&hasher, m_normals);
+    AddArray(&hasher, m_tangents);
+
+    hasher.AddValue(m_flipNormals);
+    hasher.AddValue(m_width);
+    hasher.AddValue(m_height);
+    hasher.AddValue(m_length);
+
+    return hasher.GetHash();
+}
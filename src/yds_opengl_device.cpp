@@ -415,7 +415,13 @@ ysError ysOpenGLDevice::CreateVertexBuffer(ysGPUBuffer **newBuffer, int size, ch
     return YDS_ERROR_RETURN(ysError::None);
 }
 
-ysError ysOpenGLDevice::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, char *data, bool mirrorToRam) {
+ysError ysOpenGLDevice::CreateIndexBuffer(
+    ysGPUBuffer **newBuffer,
+    int size,
+    char *data,
+    bool mirrorToRam,
+    ysGPUBuffer::IndexFormat format)
+{
     YDS_ERROR_DECLARE("CreateIndexBuffer");
 
     if (newBuffer == nullptr) return YDS_ERROR_RETURN(ysError::InvalidParameter);
@@ -426,6 +432,7 @@ ysError ysOpenGLDevice::CreateIndexBuffer(ysGPUBuffer **newBuffer, int size, cha
     newOpenGLBuffer->m_size = size;
     newOpenGLBuffer->m_mirrorToRAM = mirrorToRam;
     newOpenGLBuffer->m_bufferType = ysGPUBuffer::GPU_INDEX_BUFFER;
+    newOpenGLBuffer->m_indexFormat = format;
 
     m_realContext->glGenBuffers(1, &newOpenGLBuffer->m_bufferHandle);
     m_realContext->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, newOpenGLBuffer->m_bufferHandle);
@@ -817,6 +824,8 @@ ysError ysOpenGLDevice::CreateInputLayout(ysInputLayout **newInputLayout, ysShad
         ysOpenGLLayoutChannel *newChannel = newLayout->m_channels.New();
         newChannel->m_length = channel->GetLength();
         newChannel->m_type = GetFormatGLType(channel->GetFormat());
+        newChannel->m_normalized = ysRenderGeometryChannel::IsFormatNormalized(channel->GetFormat());
+        newChannel->m_integer = (newChannel->m_type == GL_UNSIGNED_INT);
         newChannel->m_size = channel->GetSize();
         newChannel->m_offset = channel->GetOffset();
 
@@ -843,7 +852,8 @@ ysError ysOpenGLDevice::UseInputLayout(ysInputLayout *layout) {
 
     for (int i = 0; i < nChannels; i++) {
         ysOpenGLLayoutChannel *channel = openglLayout->m_channels.Get(i);
-        m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
+        m_realContext->glVertexAttribPointer(
+            i, channel->m_length, channel->m_type, channel->m_normalized ? GL_TRUE : GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
         m_realContext->glEnableVertexAttribArray(i);
     }
 
@@ -1054,8 +1064,9 @@ void ysOpenGLDevice::ResubmitInputLayout() {
     for (int i = 0; i < nChannels; i++) {
         ysOpenGLLayoutChannel *channel = openglLayout->m_channels.Get(i);
 
-        if (channel->m_type == GL_FLOAT) {
-            m_realContext->glVertexAttribPointer(i, channel->m_length, channel->m_type, GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
+        if (!channel->m_integer) {
+            m_realContext->glVertexAttribPointer(
+                i, channel->m_length, channel->m_type, channel->m_normalized ? GL_TRUE : GL_FALSE, openglLayout->m_size, (void *)channel->m_offset);
         }
         else {
             m_realContext->glVertexAttribIPointer(i, channel->m_length, channel->m_type, openglLayout->m_size, (void *)channel->m_offset);
@@ -1096,6 +1107,13 @@ int ysOpenGLDevice::GetFormatGLType(ysRenderGeometryChannel::ChannelFormat forma
         return GL_UNSIGNED_INT;
     case ysRenderGeometryChannel::ChannelFormat::R32G32B32_UINT:
         return GL_UNSIGNED_INT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16_FLOAT:
+    case ysRenderGeometryChannel::ChannelFormat::R16G16B16A16_FLOAT:
+        return GL_HALF_FLOAT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16_SNORM:
+        return GL_SHORT;
+    case ysRenderGeometryChannel::ChannelFormat::R16G16B16A16_UNORM:
+        return GL_UNSIGNED_SHORT;
     default:
         // No real option here
         return GL_4_BYTES;
@@ -1105,7 +1123,12 @@ int ysOpenGLDevice::GetFormatGLType(ysRenderGeometryChannel::ChannelFormat forma
 // TEMP
 void ysOpenGLDevice::Draw(int numFaces, int indexOffset, int vertexOffset) {
     if (m_activeVertexBuffer != nullptr) {
-        m_realContext->glDrawElementsBaseVertex(GL_TRIANGLES, numFaces * 3, GL_UNSIGNED_SHORT, (void *)(indexOffset * 2), vertexOffset);
+        const bool wideIndices = m_activeIndexBuffer != nullptr
+            && m_activeIndexBuffer->GetIndexFormat() == ysGPUBuffer::IndexFormat::UInt32;
+        const GLenum type = wideIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        const intptr_t offset = (intptr_t)indexOffset * (wideIndices ? 4 : 2);
+
+        m_realContext->glDrawElementsBaseVertex(GL_TRIANGLES, numFaces * 3, type, (void *)offset, vertexOffset);
     }
 }
 
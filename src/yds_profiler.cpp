@@ -0,0 +1,533 @@
+#include "../include/yds_profiler.h"
+
+#include "../include/yds_allocator.h"
+#include "../include/yds_timing.h"
+
+#include <fstream>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+
+std::atomic<ysProfiler *> ysProfiler::g_instance(nullptr);
+
+constexpr int ysProfiler::MaxThreads;
+constexpr int ysProfiler::ThreadBufferCapacity;
+constexpr int ysProfiler::MaxThreadNameLength;
+constexpr size_t ysProfiler::DefaultMaxCaptureEvents;
+
+namespace {
+    std::mutex s_instanceLock;
+
+    std::atomic<int> s_nextGeneration(1);
+
+    // Thread buffer of the calling thread, tagged with the profiler it belongs to
+    thread_local int s_threadGeneration = 0;
+    thread_local void *s_threadBuffer = nullptr;
+
+    // Buffer slots are handed back when a thread exits, so the limit applies to
+    // threads recording at the same time rather than to every thread ever seen
+    std::mutex s_threadSlotLock;
+    bool s_threadSlotUsed[ysProfiler::MaxThreads] = {};
+
+    struct ThreadSlot {
+        int Slot = -1;
+
+        ~ThreadSlot() {
+            if (Slot < 0 || Slot >= ysProfiler::MaxThreads) return;
+
+            std::lock_guard<std::mutex> lock(s_threadSlotLock);
+            s_threadSlotUsed[Slot] = false;
+        }
+    };
+
+    int AcquireThreadSlot() {
+        std::lock_guard<std::mutex> lock(s_threadSlotLock);
+
+        for (int i = 0; i < ysProfiler::MaxThreads; ++i) {
+            if (!s_threadSlotUsed[i]) {
+                s_threadSlotUsed[i] = true;
+                return i;
+            }
+        }
+
+        return ysProfiler::MaxThreads;
+    }
+
+    int GetThreadSlot() {
+        static thread_local ThreadSlot slot;
+        if (slot.Slot == -1) slot.Slot = AcquireThreadSlot();
+
+        return slot.Slot;
+    }
+
+    constexpr int ProcessId = 1;
+    constexpr uint64_t ProcessTrackUuid = 1;
+    constexpr uint64_t ThreadTrackUuidBase = 0x100;
+    constexpr uint64_t CounterTrackUuidBase = 0x10000;
+    constexpr uint32_t PacketSequenceId = 1;
+
+    void WriteJsonString(std::ostream &out, const char *s) {
+        out << '"';
+        for (; *s != '\0'; ++s) {
+            if (*s == '"' || *s == '\\') out << '\\' << *s;
+            else if ((unsigned char)*s < 0x20) out << ' ';
+            else out << *s;
+        }
+        out << '"';
+    }
+
+    // Minimal protobuf encoder for the subset of the Perfetto trace format used here
+    class ProtoWriter {
+    public:
+        enum WireType {
+            Varint = 0,
+            Fixed64 = 1,
+            LengthDelimited = 2
+        };
+
+        void WriteVarint(uint64_t value) {
+            while (value >= 0x80) {
+                m_buffer.push_back((char)((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+
+            m_buffer.push_back((char)value);
+        }
+
+        void WriteTag(int field, WireType type) {
+            WriteVarint(((uint64_t)field << 3) | type);
+        }
+
+        void WriteUint(int field, uint64_t value) {
+            WriteTag(field, Varint);
+            WriteVarint(value);
+        }
+
+        void WriteDouble(int field, double value) {
+            uint64_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+
+            WriteTag(field, Fixed64);
+            for (int i = 0; i < 8; ++i) m_buffer.push_back((char)((bits >> (8 * i)) & 0xFF));
+        }
+
+        void WriteString(int field, const char *s) {
+            WriteBytes(field, s, strlen(s));
+        }
+
+        void WriteMessage(int field, const ProtoWriter &message) {
+            WriteBytes(field, message.m_buffer.data(), message.m_buffer.size());
+        }
+
+        const std::string &GetBuffer() const { return m_buffer; }
+
+    protected:
+        void WriteBytes(int field, const char *data, size_t size) {
+            WriteTag(field, LengthDelimited);
+            WriteVarint(size);
+            m_buffer.append(data, size);
+        }
+
+        std::string m_buffer;
+    };
+
+    // Field numbers from perfetto/trace/trace_packet.proto and friends
+    namespace perfetto {
+        constexpr int Trace_Packet = 1;
+
+        constexpr int TracePacket_Timestamp = 8;
+        constexpr int TracePacket_TrustedPacketSequenceId = 10;
+        constexpr int TracePacket_TrackEvent = 11;
+        constexpr int TracePacket_TrackDescriptor = 60;
+
+        constexpr int TrackDescriptor_Uuid = 1;
+        constexpr int TrackDescriptor_Name = 2;
+        constexpr int TrackDescriptor_Process = 3;
+        constexpr int TrackDescriptor_Thread = 4;
+        constexpr int TrackDescriptor_ParentUuid = 5;
+        constexpr int TrackDescriptor_Counter = 8;
+
+        constexpr int ProcessDescriptor_Pid = 1;
+        constexpr int ProcessDescriptor_ProcessName = 6;
+
+        constexpr int ThreadDescriptor_Pid = 1;
+        constexpr int ThreadDescriptor_Tid = 2;
+        constexpr int ThreadDescriptor_ThreadName = 5;
+
+        constexpr int TrackEvent_Type = 9;
+        constexpr int TrackEvent_TrackUuid = 11;
+        constexpr int TrackEvent_Name = 23;
+        constexpr int TrackEvent_DoubleCounterValue = 44;
+
+        constexpr int TypeSliceBegin = 1;
+        constexpr int TypeSliceEnd = 2;
+        constexpr int TypeInstant = 3;
+        constexpr int TypeCounter = 4;
+    }
+
+    void WritePacket(std::ostream &out, ProtoWriter &packet) {
+        packet.WriteUint(perfetto::TracePacket_TrustedPacketSequenceId, PacketSequenceId);
+
+        ProtoWriter trace;
+        trace.WriteMessage(perfetto::Trace_Packet, packet);
+
+        const std::string &buffer = trace.GetBuffer();
+        out.write(buffer.data(), buffer.size());
+    }
+}
+
+ysProfiler::ysProfiler() : ysObject("ysProfiler") {
+    m_enabled = false;
+    m_generation = s_nextGeneration.fetch_add(1);
+
+    for (int i = 0; i < MaxThreads; ++i) {
+        m_threadBuffers[i] = nullptr;
+    }
+
+    m_threadCount = 0;
+    m_rejectedEvents = 0;
+
+    m_capturing = false;
+    m_maxCaptureEvents = DefaultMaxCaptureEvents;
+
+    m_frameCount = 0;
+}
+
+ysProfiler::~ysProfiler() {
+    for (int i = 0; i < MaxThreads; ++i) {
+        ThreadBuffer *buffer = m_threadBuffers[i].load();
+        if (buffer != nullptr) ysAllocator::TypeFree(buffer, 1, true, alignof(ThreadBuffer));
+    }
+}
+
+ysProfiler *ysProfiler::CreateInstance() {
+    std::lock_guard<std::mutex> lock(s_instanceLock);
+
+    ysProfiler *instance = g_instance.load(std::memory_order_relaxed);
+    if (instance == nullptr) {
+        instance = new ysProfiler;
+        g_instance.store(instance, std::memory_order_release);
+    }
+
+    return instance;
+}
+
+void ysProfiler::SetThreadName(const char *name) {
+    ThreadBuffer *buffer = GetThreadBuffer();
+    if (buffer == nullptr) return;
+
+    strncpy(buffer->Name, name, MaxThreadNameLength - 1);
+    buffer->Name[MaxThreadNameLength - 1] = '\0';
+}
+
+void ysProfiler::BeginFrame() {
+    BeginEvent("Frame");
+}
+
+void ysProfiler::EndFrame() {
+    EndEvent("Frame");
+    Collect();
+
+    ++m_frameCount;
+}
+
+void ysProfiler::Collect() {
+    const int threadCount = GetThreadCount();
+    for (int i = 0; i < threadCount && i < MaxThreads; ++i) {
+        ThreadBuffer *buffer = m_threadBuffers[i].load(std::memory_order_acquire);
+        if (buffer == nullptr) continue;
+
+        const uint64_t head = buffer->Head.load(std::memory_order_acquire);
+        const uint64_t tail = buffer->Tail.load(std::memory_order_relaxed);
+
+        if (m_capturing) {
+            for (uint64_t j = tail; j < head; ++j) {
+                if (m_capture.size() >= m_maxCaptureEvents) {
+                    m_capturing = false;
+                    break;
+                }
+
+                CapturedEvent event;
+                event.Data = buffer->Events[j % ThreadBufferCapacity];
+                event.Thread = buffer->Index;
+                m_capture.push_back(event);
+            }
+        }
+
+        buffer->Tail.store(head, std::memory_order_release);
+    }
+}
+
+void ysProfiler::StartCapture(size_t maxEvents) {
+    // Discard anything recorded before the capture started
+    m_capturing = false;
+    Collect();
+
+    m_maxCaptureEvents = maxEvents;
+    m_capturing = true;
+}
+
+void ysProfiler::StopCapture() {
+    Collect();
+    m_capturing = false;
+}
+
+void ysProfiler::ClearCapture() {
+    m_capture.clear();
+}
+
+std::string ysProfiler::GetThreadName(int thread) const {
+    ThreadBuffer *buffer = m_threadBuffers[thread].load(std::memory_order_acquire);
+    if (buffer == nullptr) return "";
+    else if (buffer->Name[0] != '\0') return buffer->Name;
+    else return "Thread " + std::to_string(thread);
+}
+
+uint64_t ysProfiler::GetDroppedEventCount() const {
+    uint64_t dropped = m_rejectedEvents.load(std::memory_order_relaxed);
+
+    const int threadCount = GetThreadCount();
+    for (int i = 0; i < threadCount && i < MaxThreads; ++i) {
+        ThreadBuffer *buffer = m_threadBuffers[i].load(std::memory_order_acquire);
+        if (buffer != nullptr) dropped += buffer->Dropped.load(std::memory_order_relaxed);
+    }
+
+    return dropped;
+}
+
+ysError ysProfiler::WriteChromeTrace(const char *fname) {
+    YDS_ERROR_DECLARE("WriteChromeTrace");
+
+    std::ofstream file(fname, std::ios::out);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    uint64_t start = m_capture.empty() ? 0 : m_capture.front().Data.Timestamp;
+    for (const CapturedEvent &event : m_capture) {
+        if (event.Data.Timestamp < start) start = event.Data.Timestamp;
+    }
+
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    const int threadCount = GetThreadCount();
+    for (int i = 0; i < threadCount && i < MaxThreads; ++i) {
+        if (!first) file << ",\n";
+        first = false;
+
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << ProcessId << ",\"tid\":" << i
+            << ",\"args\":{\"name\":";
+        WriteJsonString(file, GetThreadName(i).c_str());
+        file << "}}";
+    }
+
+    char timestamp[32];
+    for (const CapturedEvent &event : m_capture) {
+        if (!first) file << ",\n";
+        first = false;
+
+        // Chrome traces are in microseconds
+        const uint64_t t = (event.Data.Timestamp > start)
+            ? ysTimingSystem::TicksToNanoseconds(event.Data.Timestamp - start)
+            : 0;
+        snprintf(timestamp, sizeof(timestamp), "%llu.%03llu",
+            (unsigned long long)(t / 1000), (unsigned long long)(t % 1000));
+
+        file << "{\"name\":";
+        WriteJsonString(file, event.Data.Name);
+        file << ",\"pid\":" << ProcessId << ",\"tid\":" << event.Thread << ",\"ts\":" << timestamp;
+
+        switch (event.Data.Type) {
+        case EventType::Begin:
+            file << ",\"ph\":\"B\"}";
+            break;
+        case EventType::End:
+            file << ",\"ph\":\"E\"}";
+            break;
+        case EventType::Counter:
+            file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.Data.Value << "}}";
+            break;
+        case EventType::Marker:
+            file << ",\"ph\":\"i\",\"s\":\"t\"}";
+            break;
+        }
+    }
+
+    file << "\n]}\n";
+    file.close();
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysProfiler::WritePerfettoTrace(const char *fname) {
+    YDS_ERROR_DECLARE("WritePerfettoTrace");
+
+    std::ofstream file(fname, std::ios::out | std::ios::binary);
+    if (!file.is_open()) return YDS_ERROR_RETURN(ysError::CouldNotOpenFile);
+
+    // Process track
+    {
+        ProtoWriter process;
+        process.WriteUint(perfetto::ProcessDescriptor_Pid, ProcessId);
+        process.WriteString(perfetto::ProcessDescriptor_ProcessName, "delta");
+
+        ProtoWriter track;
+        track.WriteUint(perfetto::TrackDescriptor_Uuid, ProcessTrackUuid);
+        track.WriteMessage(perfetto::TrackDescriptor_Process, process);
+
+        ProtoWriter packet;
+        packet.WriteMessage(perfetto::TracePacket_TrackDescriptor, track);
+        WritePacket(file, packet);
+    }
+
+    // One track per thread
+    const int threadCount = GetThreadCount();
+    for (int i = 0; i < threadCount && i < MaxThreads; ++i) {
+        ProtoWriter thread;
+        thread.WriteUint(perfetto::ThreadDescriptor_Pid, ProcessId);
+        thread.WriteUint(perfetto::ThreadDescriptor_Tid, (uint64_t)i + 1);
+        thread.WriteString(perfetto::ThreadDescriptor_ThreadName, GetThreadName(i).c_str());
+
+        ProtoWriter track;
+        track.WriteUint(perfetto::TrackDescriptor_Uuid, ThreadTrackUuidBase + i);
+        track.WriteUint(perfetto::TrackDescriptor_ParentUuid, ProcessTrackUuid);
+        track.WriteMessage(perfetto::TrackDescriptor_Thread, thread);
+
+        ProtoWriter packet;
+        packet.WriteMessage(perfetto::TracePacket_TrackDescriptor, track);
+        WritePacket(file, packet);
+    }
+
+    // One track per counter name
+    std::vector<const char *> counters;
+    for (const CapturedEvent &event : m_capture) {
+        if (event.Data.Type != EventType::Counter) continue;
+
+        bool found = false;
+        for (const char *name : counters) {
+            if (name == event.Data.Name || strcmp(name, event.Data.Name) == 0) {
+                found = true;
+                break;
+            }
+        }
+
+        if (found) continue;
+
+        ProtoWriter track;
+        track.WriteUint(perfetto::TrackDescriptor_Uuid, CounterTrackUuidBase + counters.size());
+        track.WriteUint(perfetto::TrackDescriptor_ParentUuid, ProcessTrackUuid);
+        track.WriteString(perfetto::TrackDescriptor_Name, event.Data.Name);
+        track.WriteMessage(perfetto::TrackDescriptor_Counter, ProtoWriter());
+
+        ProtoWriter packet;
+        packet.WriteMessage(perfetto::TracePacket_TrackDescriptor, track);
+        WritePacket(file, packet);
+
+        counters.push_back(event.Data.Name);
+    }
+
+    for (const CapturedEvent &event : m_capture) {
+        ProtoWriter trackEvent;
+        uint64_t trackUuid = ThreadTrackUuidBase + event.Thread;
+
+        switch (event.Data.Type) {
+        case EventType::Begin:
+            trackEvent.WriteUint(perfetto::TrackEvent_Type, perfetto::TypeSliceBegin);
+            trackEvent.WriteString(perfetto::TrackEvent_Name, event.Data.Name);
+            break;
+        case EventType::End:
+            trackEvent.WriteUint(perfetto::TrackEvent_Type, perfetto::TypeSliceEnd);
+            break;
+        case EventType::Marker:
+            trackEvent.WriteUint(perfetto::TrackEvent_Type, perfetto::TypeInstant);
+            trackEvent.WriteString(perfetto::TrackEvent_Name, event.Data.Name);
+            break;
+        case EventType::Counter:
+            for (size_t i = 0; i < counters.size(); ++i) {
+                if (counters[i] == event.Data.Name || strcmp(counters[i], event.Data.Name) == 0) {
+                    trackUuid = CounterTrackUuidBase + i;
+                    break;
+                }
+            }
+
+            trackEvent.WriteUint(perfetto::TrackEvent_Type, perfetto::TypeCounter);
+            trackEvent.WriteDouble(perfetto::TrackEvent_DoubleCounterValue, event.Data.Value);
+            break;
+        }
+
+        trackEvent.WriteUint(perfetto::TrackEvent_TrackUuid, trackUuid);
+
+        ProtoWriter packet;
+        packet.WriteUint(perfetto::TracePacket_Timestamp, ysTimingSystem::TicksToNanoseconds(event.Data.Timestamp));
+        packet.WriteMessage(perfetto::TracePacket_TrackEvent, trackEvent);
+        WritePacket(file, packet);
+    }
+
+    file.close();
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+uint64_t ysProfiler::GetTimestamp() {
+    return ysTimingSystem::Now();
+}
+
+void ysProfiler::RecordEvent(EventType type, const char *name, double value) {
+    ThreadBuffer *buffer = GetThreadBuffer();
+    if (buffer == nullptr) {
+        m_rejectedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint64_t head = buffer->Head.load(std::memory_order_relaxed);
+    const uint64_t tail = buffer->Tail.load(std::memory_order_acquire);
+    if (head - tail >= (uint64_t)ThreadBufferCapacity) {
+        buffer->Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event &event = buffer->Events[head % ThreadBufferCapacity];
+    event.Timestamp = GetTimestamp();
+    event.Name = name;
+    event.Value = value;
+    event.Type = type;
+
+    buffer->Head.store(head + 1, std::memory_order_release);
+}
+
+ysProfiler::ThreadBuffer *ysProfiler::GetThreadBuffer() {
+    if (s_threadGeneration == m_generation) {
+        return reinterpret_cast<ThreadBuffer *>(s_threadBuffer);
+    }
+
+    const int index = GetThreadSlot();
+
+    ThreadBuffer *buffer = nullptr;
+    if (index < MaxThreads) {
+        buffer = m_threadBuffers[index].load(std::memory_order_acquire);
+        if (buffer == nullptr) {
+            buffer = ysAllocator::TypeAllocate<ThreadBuffer, alignof(ThreadBuffer)>(1);
+            buffer->Head = 0;
+            buffer->Tail = 0;
+            buffer->Dropped = 0;
+            buffer->Index = index;
+
+            m_threadBuffers[index].store(buffer, std::memory_order_release);
+        }
+
+        // A recycled buffer still holds the previous thread's name. Its
+        // pending events are collected as usual, the slot has a single
+        // producer at any time.
+        buffer->Name[0] = '\0';
+
+        int threadCount = m_threadCount.load(std::memory_order_relaxed);
+        while (threadCount <= index && !m_threadCount.compare_exchange_weak(threadCount, index + 1)) {
+            /* void */
+        }
+    }
+
+    // Threads past the limit are remembered too so they don't retry on every event
+    s_threadGeneration = m_generation;
+    s_threadBuffer = buffer;
+
+    return buffer;
+}
@@ -0,0 +1,68 @@
+#include "../include/yds_residency_set.h"
+
+ysResidencySet::ysResidencySet() {
+    m_budget = 0;
+    m_residentBytes = 0;
+    m_frame = 0;
+}
+
+ysResidencySet::~ysResidencySet() {
+    /* void */
+}
+
+void ysResidencySet::Add(uint64_t key, int64_t bytes) {
+    Remove(key);
+
+    Entry entry;
+    entry.Key = key;
+    entry.Bytes = bytes;
+    entry.LastUsedFrame = m_frame;
+
+    m_order.push_front(entry);
+    m_entries[key] = m_order.begin();
+    m_residentBytes += bytes;
+}
+
+void ysResidencySet::Remove(uint64_t key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+
+    m_residentBytes -= it->second->Bytes;
+    m_order.erase(it->second);
+    m_entries.erase(it);
+}
+
+void ysResidencySet::Clear() {
+    m_order.clear();
+    m_entries.clear();
+    m_residentBytes = 0;
+}
+
+void ysResidencySet::Touch(uint64_t key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) return;
+
+    it->second->LastUsedFrame = m_frame;
+    m_order.splice(m_order.begin(), m_order, it->second);
+}
+
+int ysResidencySet::Evict(std::vector<uint64_t> *evicted) {
+    if (m_budget <= 0) return 0;
+
+    int count = 0;
+    while (m_residentBytes > m_budget && !m_order.empty()) {
+        const Entry &entry = m_order.back();
+
+        // Everything in front of it was used at least as recently
+        if (entry.LastUsedFrame + 1 >= m_frame) break;
+
+        evicted->push_back(entry.Key);
+        m_residentBytes -= entry.Bytes;
+        m_entries.erase(entry.Key);
+        m_order.pop_back();
+
+        ++count;
+    }
+
+    return count;
+}
@@ -0,0 +1,656 @@
+#include "../include/yds_scene_compiler.h"
+
+#include "../include/yds_geometry_export_file_reader.h"
+#include "../include/yds_geometry_preprocessing.h"
+#include "../include/yds_interchange_file_0_1.h"
+#include "../include/yds_job_system.h"
+#include "../include/yds_logger.h"
+#include "../include/yds_mesh_optimizer.h"
+#include "../include/yds_profiler.h"
+#include "../include/yds_timing.h"
+#include "../include/yds_vertex_quantization.h"
+
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unordered_map>
+
+constexpr uint32_t ysSceneCompiler::PipelineVersion;
+
+namespace {
+
+    uint64_t CombineHashes(uint64_t a, uint64_t b) {
+        return a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+    }
+
+    double SecondsSince(uint64_t start) {
+        return ysTimingSystem::TicksToSeconds(ysTimingSystem::Now() - start);
+    }
+
+    void CopyCachedObject(
+        const ysGeometryExportFileReader::Object &cached,
+        ysGeometryExportFile::CompiledObject *output)
+    {
+        output->Header = cached.Header;
+
+        output->VertexData.assign(cached.VertexData, cached.VertexData + cached.VertexDataSize);
+
+        const int indexSize = ysGeometryExportFile::GetIndexSize(cached.Header);
+        output->Indices.resize(cached.IndexDataSize / indexSize);
+        for (size_t i = 0; i < output->Indices.size(); ++i) {
+            if (indexSize == sizeof(uint32_t)) {
+                memcpy(&output->Indices[i], cached.IndexData + i * sizeof(uint32_t), sizeof(uint32_t));
+            }
+            else {
+                uint16_t index;
+                memcpy(&index, cached.IndexData + i * sizeof(uint16_t), sizeof(uint16_t));
+                output->Indices[i] = index;
+            }
+        }
+
+        output->Bones.resize(cached.BoneDataSize / sizeof(int));
+        if (cached.BoneDataSize > 0) memcpy(output->Bones.data(), cached.BoneData, cached.BoneDataSize);
+
+        if ((cached.Header.Flags & ysGeometryExportFile::MDF_LODS) != 0) {
+            ysGeometryExportFileReader::GetLods(cached, &output->Lods, &output->Submeshes);
+        }
+        else if ((cached.Header.Flags & ysGeometryExportFile::MDF_SUBMESHES) != 0) {
+            ysGeometryExportFileReader::GetSubmeshes(cached, &output->Submeshes);
+        }
+        else {
+            output->ExtraData.resize(cached.ExtraDataSize / sizeof(float));
+            if (cached.ExtraDataSize > 0) memcpy(output->ExtraData.data(), cached.ExtraData, cached.ExtraDataSize);
+        }
+    }
+
+    void ProcessToolObject(
+        ysObjectData *object,
+        const ysSceneCompiler::ToolObjectSettings &objectSettings,
+        float scale)
+    {
+        if (object->m_objectInformation.ObjectType == ysObjectData::ObjectType::Geometry) {
+            ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(object);
+            ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(object);
+            ysGeometryPreprocessing::SeparateBySmoothingGroups(object);
+            ysGeometryPreprocessing::CalculateNormals(object);
+
+            if (objectSettings.CalculateTangents) {
+                ysGeometryPreprocessing::CalculateTangents(object, 0);
+            }
+
+            if (objectSettings.SeparateByUVs) {
+                for (int i = 0; i < object->m_objectStatistics.NumUVChannels; ++i) {
+                    ysGeometryPreprocessing::SeparateByUVGroups(object, i);
+                }
+            }
+
+            ysGeometryPreprocessing::SortBoneWeights(object);
+        }
+
+        ysGeometryPreprocessing::CalculateNormals(object);
+        ysGeometryPreprocessing::UniformScale(object, scale);
+    }
+
+    // Positions of a compiled object's vertices, three floats each
+    void GetPositions(const ysGeometryExportFile::CompiledObject &object, std::vector<float> *positions) {
+        const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+        const int stride = header.VertexDataSize / header.NumVertices;
+        const bool quantized = (header.Flags & ysGeometryExportFile::MDF_QUANTIZED) != 0;
+
+        const float minExtreme[] = { header.MinExtreme.x, header.MinExtreme.y, header.MinExtreme.z };
+        const float maxExtreme[] = { header.MaxExtreme.x, header.MaxExtreme.y, header.MaxExtreme.z };
+
+        positions->resize((size_t)header.NumVertices * 3);
+        for (int v = 0; v < header.NumVertices; ++v) {
+            const char *vertex = object.VertexData.data() + (size_t)v * stride;
+            float *position = &(*positions)[(size_t)v * 3];
+
+            if (quantized) {
+                uint16_t encoded[3];
+                memcpy(encoded, vertex, sizeof(encoded));
+
+                for (int i = 0; i < 3; ++i) {
+                    position[i] = ysVertexQuantization::DequantizeUnorm16(encoded[i], minExtreme[i], maxExtreme[i]);
+                }
+            }
+            else {
+                memcpy(position, vertex, 3 * sizeof(float));
+            }
+        }
+    }
+
+} /* namespace */
+
+ysSceneCompiler::ysSceneCompiler() : ysObject("ysSceneCompiler") {
+    memset(&m_statistics, 0, sizeof(Statistics));
+}
+
+ysSceneCompiler::~ysSceneCompiler() {
+    /* void */
+}
+
+ysError ysSceneCompiler::Compile(const char *inputPath, const char *outputPath, const Settings &settings) {
+    YDS_ERROR_DECLARE("Compile");
+    YDS_TRACE_SCOPE("ysSceneCompiler::Compile");
+
+    memset(&m_statistics, 0, sizeof(Statistics));
+    const uint64_t start = ysTimingSystem::Now();
+
+    ysInterchangeFile0_1 inputFile;
+    YDS_NESTED_ERROR_CALL(inputFile.Open(inputPath));
+
+    std::vector<ysInterchangeObject> objects(inputFile.GetObjectCount());
+    for (ysInterchangeObject &object : objects) {
+        YDS_NESTED_ERROR_CALL(inputFile.ReadObject(&object));
+    }
+
+    inputFile.Close();
+    m_statistics.ReadTime = SecondsSince(start);
+
+    YDS_NESTED_ERROR_CALL(CompileObjects(objects, outputPath, settings));
+    m_statistics.TotalTime = SecondsSince(start);
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysSceneCompiler::Compile(std::vector<ysInterchangeObject> &objects, const char *outputPath, const Settings &settings) {
+    YDS_ERROR_DECLARE("Compile");
+    YDS_TRACE_SCOPE("ysSceneCompiler::Compile");
+
+    memset(&m_statistics, 0, sizeof(Statistics));
+    const uint64_t start = ysTimingSystem::Now();
+
+    YDS_NESTED_ERROR_CALL(CompileObjects(objects, outputPath, settings));
+    m_statistics.TotalTime = SecondsSince(start);
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysSceneCompiler::Compile(
+    const std::vector<ysObjectData *> &objects,
+    const std::vector<ToolObjectSettings> &objectSettings,
+    const char *outputPath,
+    const Settings &settings)
+{
+    YDS_ERROR_DECLARE("Compile");
+    YDS_TRACE_SCOPE("ysSceneCompiler::Compile");
+
+    if (objectSettings.size() != objects.size()) return YDS_ERROR_RETURN(ysError::InvalidParameter);
+
+    memset(&m_statistics, 0, sizeof(Statistics));
+    const uint64_t start = ysTimingSystem::Now();
+
+    const int objectCount = (int)objects.size();
+    m_statistics.ObjectCount = objectCount;
+
+    std::vector<ysGeometryExportFile::CompiledObject> compiled(objectCount);
+    std::vector<bool> cached(objectCount, false);
+
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(settings.WorkerCount);
+
+    // Hash
+    {
+        YDS_TRACE_SCOPE("ysSceneCompiler::Hash");
+        const uint64_t hashStart = ysTimingSystem::Now();
+
+        jobSystem.ParallelFor(0, objectCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                // Zero means "no hash" in the scene file
+                const uint64_t hash = CombineHashes(
+                    HashSettings(settings, objectSettings[i]), objects[i]->GetContentHash());
+                compiled[i].ContentHash = (hash != 0) ? hash : 1;
+            }
+        });
+
+        m_statistics.HashTime = SecondsSince(hashStart);
+    }
+
+    ReuseCachedObjects(outputPath, settings, compiled, &cached);
+
+    // Process
+    {
+        YDS_TRACE_SCOPE("ysSceneCompiler::Process");
+        const uint64_t processStart = ysTimingSystem::Now();
+
+        ysGeometryExportFile exportFile;
+        jobSystem.ParallelFor(0, objectCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (cached[i]) continue;
+
+                ProcessToolObject(objects[i], objectSettings[i], settings.Scale);
+
+                const uint64_t hash = compiled[i].ContentHash;
+                exportFile.CompileObject(objects[i], &compiled[i]);
+                compiled[i].ContentHash = hash;
+            }
+        });
+
+        m_statistics.ProcessTime = SecondsSince(processStart);
+    }
+
+    jobSystem.Destroy();
+
+    YDS_NESTED_ERROR_CALL(WriteObjects(outputPath, compiled));
+    m_statistics.TotalTime = SecondsSince(start);
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+ysError ysSceneCompiler::CompileObjects(std::vector<ysInterchangeObject> &objects, const char *outputPath, const Settings &settings) {
+    YDS_ERROR_DECLARE("CompileObjects");
+
+    const int objectCount = (int)objects.size();
+    m_statistics.ObjectCount = objectCount;
+
+    std::vector<ysGeometryExportFile::CompiledObject> compiled(objectCount);
+    std::vector<bool> cached(objectCount, false);
+
+    std::vector<OptimizationResult> optimization(objectCount);
+    memset(optimization.data(), 0, sizeof(OptimizationResult) * objectCount);
+
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(settings.WorkerCount);
+
+    // Hash
+    {
+        YDS_TRACE_SCOPE("ysSceneCompiler::Hash");
+        const uint64_t start = ysTimingSystem::Now();
+
+        const uint64_t settingsHash = HashSettings(settings);
+        jobSystem.ParallelFor(0, objectCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                // Zero means "no hash" in the scene file
+                const uint64_t hash = CombineHashes(settingsHash, objects[i].GetContentHash());
+                compiled[i].ContentHash = (hash != 0) ? hash : 1;
+            }
+        });
+
+        m_statistics.HashTime = SecondsSince(start);
+    }
+
+    ReuseCachedObjects(outputPath, settings, compiled, &cached);
+
+    ysGeometryExportFile exportFile;
+
+    // Process
+    {
+        YDS_TRACE_SCOPE("ysSceneCompiler::Process");
+        const uint64_t start = ysTimingSystem::Now();
+
+        jobSystem.ParallelFor(0, objectCount, 1, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (cached[i]) continue;
+
+                ysInterchangeObject &object = objects[i];
+                if (object.Type == ysInterchangeObject::ObjectType::Geometry) {
+                    if (settings.VertexInfo.IncludeNormals) object.RipByNormals();
+                    if (settings.VertexInfo.IncludeTangents) object.RipByTangents();
+                    if (settings.VertexInfo.IncludeUVs) object.RipByUVs();
+                }
+
+                object.UniformScale(settings.Scale);
+
+                const uint64_t hash = compiled[i].ContentHash;
+                exportFile.CompileObject(&object, &settings.VertexInfo, &compiled[i]);
+                compiled[i].ContentHash = hash;
+
+                if (object.Type != ysInterchangeObject::ObjectType::Geometry) continue;
+
+                if (settings.OptimizeMeshes) {
+                    OptimizeObject(&compiled[i], &optimization[i]);
+                }
+
+                // Levels of detail handle large meshes themselves
+                if (GenerateLods(&compiled[i], settings)) continue;
+
+                // Welding may have brought the mesh back under the limit
+                ysGeometryExportFile::ObjectOutputHeader &header = compiled[i].Header;
+                if (header.NumVertices <= ysGeometryExportFile::MaxShortIndexVertexCount) {
+                    header.Flags &= ~ysGeometryExportFile::MDF_32BIT_INDICES;
+                }
+                else if (settings.LargeMeshes == LargeMeshMode::Split) {
+                    SplitObject(&compiled[i]);
+                }
+                else {
+                    header.Flags |= ysGeometryExportFile::MDF_32BIT_INDICES;
+                }
+            }
+        });
+
+        m_statistics.ProcessTime = SecondsSince(start);
+    }
+
+    for (int i = 0; i < objectCount; ++i) {
+        if (cached[i]) continue;
+
+        const unsigned int flags = compiled[i].Header.Flags;
+
+        // Levels of detail have a submesh each unless they were split
+        if (compiled[i].Submeshes.size() > compiled[i].Lods.size()) ++m_statistics.SplitObjectCount;
+        if ((flags & ysGeometryExportFile::MDF_32BIT_INDICES) != 0) ++m_statistics.WideIndexObjectCount;
+        if ((flags & ysGeometryExportFile::MDF_QUANTIZED) != 0) ++m_statistics.QuantizedObjectCount;
+
+        if ((flags & ysGeometryExportFile::MDF_LODS) != 0) {
+            ++m_statistics.LodObjectCount;
+            for (size_t lod = 1; lod < compiled[i].Lods.size(); ++lod) {
+                m_statistics.LodTriangleCount += compiled[i].Lods[lod].FaceCount;
+            }
+        }
+    }
+
+    int64_t cacheMissesBefore = 0, cacheMissesAfter = 0;
+    for (const OptimizationResult &result : optimization) {
+        m_statistics.TriangleCount += result.TriangleCount;
+        m_statistics.VertexCountBefore += result.VertexCountBefore;
+        m_statistics.VertexCountAfter += result.VertexCountAfter;
+        cacheMissesBefore += result.CacheMissesBefore;
+        cacheMissesAfter += result.CacheMissesAfter;
+    }
+
+    if (m_statistics.TriangleCount > 0) {
+        m_statistics.AcmrBefore = (double)cacheMissesBefore / m_statistics.TriangleCount;
+        m_statistics.AcmrAfter = (double)cacheMissesAfter / m_statistics.TriangleCount;
+        m_statistics.AtvrBefore = (double)cacheMissesBefore / m_statistics.VertexCountBefore;
+        m_statistics.AtvrAfter = (double)cacheMissesAfter / m_statistics.VertexCountAfter;
+    }
+
+    // The numbers are always available through GetStatistics(), logging them
+    // is optional and the logger may not have been created
+    if (ysLogger::Logger() != nullptr) {
+        if (m_statistics.TriangleCount > 0) {
+            ysLogInfo(
+                "Mesh optimization: %d triangles, %d -> %d vertices, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+                (int)m_statistics.TriangleCount,
+                (int)m_statistics.VertexCountBefore,
+                (int)m_statistics.VertexCountAfter,
+                m_statistics.AcmrBefore,
+                m_statistics.AcmrAfter,
+                m_statistics.AtvrBefore,
+                m_statistics.AtvrAfter);
+        }
+
+        if (m_statistics.LodObjectCount > 0) {
+            ysLogInfo(
+                "Levels of detail: %d objects, %d triangles in reduced levels",
+                m_statistics.LodObjectCount,
+                (int)m_statistics.LodTriangleCount);
+        }
+    }
+
+    jobSystem.Destroy();
+
+    YDS_NESTED_ERROR_CALL(WriteObjects(outputPath, compiled));
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void ysSceneCompiler::ReuseCachedObjects(
+    const char *outputPath,
+    const Settings &settings,
+    std::vector<ysGeometryExportFile::CompiledObject> &compiled,
+    std::vector<bool> *cached)
+{
+    const int objectCount = (int)compiled.size();
+
+    // The old file has to be closed again before it can be overwritten
+    struct stat buffer;
+    if (settings.UseCache && stat(outputPath, &buffer) == 0) {
+        YDS_TRACE_SCOPE("ysSceneCompiler::Cache");
+        const uint64_t start = ysTimingSystem::Now();
+
+        ysGeometryExportFileReader previous;
+        if (previous.Open(outputPath) == ysError::None) {
+            std::unordered_map<uint64_t, int> previousObjects;
+            for (int i = 0; i < previous.GetObjectCount(); ++i) {
+                const uint64_t hash = previous.GetContentHash(i);
+                if (hash != 0) previousObjects.emplace(hash, i);
+            }
+
+            for (int i = 0; i < objectCount; ++i) {
+                auto match = previousObjects.find(compiled[i].ContentHash);
+                if (match == previousObjects.end()) continue;
+
+                ysGeometryExportFileReader::Object object;
+                if (previous.ReadObject(match->second, &object) != ysError::None) continue;
+
+                CopyCachedObject(object, &compiled[i]);
+                (*cached)[i] = true;
+            }
+
+            previous.Close();
+        }
+
+        m_statistics.CacheTime = SecondsSince(start);
+    }
+
+    for (int i = 0; i < objectCount; ++i) {
+        if ((*cached)[i]) ++m_statistics.CachedObjectCount;
+    }
+
+    m_statistics.CompiledObjectCount = objectCount - m_statistics.CachedObjectCount;
+}
+
+ysError ysSceneCompiler::WriteObjects(
+    const char *outputPath,
+    const std::vector<ysGeometryExportFile::CompiledObject> &compiled)
+{
+    YDS_ERROR_DECLARE("WriteObjects");
+    YDS_TRACE_SCOPE("ysSceneCompiler::Write");
+
+    const uint64_t start = ysTimingSystem::Now();
+
+    ysGeometryExportFile exportFile;
+    YDS_NESTED_ERROR_CALL(exportFile.Open(outputPath));
+    for (const ysGeometryExportFile::CompiledObject &object : compiled) {
+        YDS_NESTED_ERROR_CALL(exportFile.WriteObject(object));
+    }
+
+    YDS_NESTED_ERROR_CALL(exportFile.Close());
+
+    m_statistics.WriteTime = SecondsSince(start);
+
+    return YDS_ERROR_RETURN(ysError::None);
+}
+
+void ysSceneCompiler::OptimizeObject(ysGeometryExportFile::CompiledObject *object, OptimizationResult *result) {
+    ysGeometryExportFile::ObjectOutputHeader &header = object->Header;
+    if (header.NumVertices <= 0 || object->Indices.empty()) return;
+
+    const int stride = header.VertexDataSize / header.NumVertices;
+    std::vector<unsigned int> &indices = object->Indices;
+
+    const ysMeshOptimizer::VertexCacheStatistics before =
+        ysMeshOptimizer::AnalyzeVertexCache(indices, header.NumVertices);
+
+    int vertexCount = ysMeshOptimizer::WeldVertices(object->VertexData, stride, indices);
+    ysMeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+    vertexCount = ysMeshOptimizer::OptimizeVertexFetch(object->VertexData, stride, indices);
+
+    const ysMeshOptimizer::VertexCacheStatistics after =
+        ysMeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+
+    header.NumVertices = vertexCount;
+    header.VertexDataSize = (int)object->VertexData.size();
+
+    result->TriangleCount = before.TriangleCount;
+    result->VertexCountBefore = before.VertexCount;
+    result->VertexCountAfter = vertexCount;
+    result->CacheMissesBefore = before.CacheMisses;
+    result->CacheMissesAfter = after.CacheMisses;
+}
+
+void ysSceneCompiler::SplitObject(ysGeometryExportFile::CompiledObject *object) {
+    ysGeometryExportFile::ObjectOutputHeader &header = object->Header;
+    const int stride = header.VertexDataSize / header.NumVertices;
+
+    const std::vector<ysMeshOptimizer::Submesh> submeshes = ysMeshOptimizer::SplitMesh(
+        object->VertexData, stride, object->Indices, ysGeometryExportFile::MaxShortIndexVertexCount);
+
+    object->Submeshes.resize(submeshes.size());
+    for (size_t i = 0; i < submeshes.size(); ++i) {
+        ysGeometryExportFile::Submesh &submesh = object->Submeshes[i];
+        submesh.BaseIndex = submeshes[i].BaseIndex;
+        submesh.FaceCount = submeshes[i].FaceCount;
+        submesh.BaseVertex = submeshes[i].BaseVertex;
+        submesh.VertexCount = submeshes[i].VertexCount;
+    }
+
+    header.NumVertices = (int)(object->VertexData.size() / stride);
+    header.VertexDataSize = (int)object->VertexData.size();
+    header.Flags &= ~ysGeometryExportFile::MDF_32BIT_INDICES;
+    header.Flags |= ysGeometryExportFile::MDF_SUBMESHES;
+}
+
+bool ysSceneCompiler::GenerateLods(ysGeometryExportFile::CompiledObject *object, const Settings &settings) {
+    ysGeometryExportFile::ObjectOutputHeader &header = object->Header;
+    if (settings.LodCount <= 1 || header.NumVertices <= 0 || object->Indices.empty()) return false;
+
+    const int stride = header.VertexDataSize / header.NumVertices;
+
+    std::vector<float> positions;
+    GetPositions(*object, &positions);
+
+    const float dx = header.MaxExtreme.x - header.MinExtreme.x;
+    const float dy = header.MaxExtreme.y - header.MinExtreme.y;
+    const float dz = header.MaxExtreme.z - header.MinExtreme.z;
+    const float maxError = settings.LodMaxError * sqrtf(dx * dx + dy * dy + dz * dz);
+
+    // Every level is simplified from the full mesh so that its error is measured against it
+    std::vector<std::vector<unsigned int>> levels(1, object->Indices);
+    std::vector<float> errors(1, 0.0f);
+    for (int level = 1; level < settings.LodCount; ++level) {
+        const size_t previousSize = levels.back().size();
+        const int target = (int)(previousSize / 3 * settings.LodReduction) * 3;
+
+        float error = 0.0f;
+        std::vector<unsigned int> simplified =
+            ysMeshOptimizer::SimplifyMesh(positions, object->Indices, target, maxError, &error);
+
+        // Not worth another level
+        if (simplified.empty() || simplified.size() * 10 > previousSize * 9) break;
+
+        ysMeshOptimizer::OptimizeVertexCache(simplified, header.NumVertices);
+
+        levels.push_back(std::move(simplified));
+        errors.push_back(error);
+    }
+
+    if (levels.size() == 1) return false;
+
+    // --
+    // Levels share the vertex buffer unless the mesh has to be split, then
+    // each level gets its own compacted and split copy of the vertices it
+    // uses so that all of them can be drawn with 16 bit indices.
+    // --
+    const bool split = header.NumVertices > ysGeometryExportFile::MaxShortIndexVertexCount
+        && settings.LargeMeshes == LargeMeshMode::Split;
+
+    std::vector<char> splitVertexData;
+
+    object->Indices.clear();
+    object->Submeshes.clear();
+    object->Lods.clear();
+
+    for (size_t level = 0; level < levels.size(); ++level) {
+        std::vector<unsigned int> &indices = levels[level];
+
+        ysGeometryExportFile::Lod lod;
+        lod.FirstSubmesh = (int)object->Submeshes.size();
+        lod.FaceCount = (int)(indices.size() / 3);
+        lod.Error = errors[level];
+
+        if (!split) {
+            ysGeometryExportFile::Submesh submesh;
+            submesh.BaseIndex = (int)object->Indices.size();
+            submesh.FaceCount = lod.FaceCount;
+            submesh.BaseVertex = 0;
+            submesh.VertexCount = header.NumVertices;
+            object->Submeshes.push_back(submesh);
+        }
+        else {
+            std::vector<char> levelVertexData = object->VertexData;
+            const int vertexCount = ysMeshOptimizer::OptimizeVertexFetch(levelVertexData, stride, indices);
+
+            std::vector<ysMeshOptimizer::Submesh> parts;
+            if (vertexCount > ysGeometryExportFile::MaxShortIndexVertexCount) {
+                parts = ysMeshOptimizer::SplitMesh(
+                    levelVertexData, stride, indices, ysGeometryExportFile::MaxShortIndexVertexCount);
+            }
+            else {
+                parts.push_back({ 0, lod.FaceCount, 0, vertexCount });
+            }
+
+            const int baseVertex = (int)(splitVertexData.size() / stride);
+            for (const ysMeshOptimizer::Submesh &part : parts) {
+                ysGeometryExportFile::Submesh submesh;
+                submesh.BaseIndex = (int)object->Indices.size() + part.BaseIndex;
+                submesh.FaceCount = part.FaceCount;
+                submesh.BaseVertex = baseVertex + part.BaseVertex;
+                submesh.VertexCount = part.VertexCount;
+                object->Submeshes.push_back(submesh);
+            }
+
+            splitVertexData.insert(splitVertexData.end(), levelVertexData.begin(), levelVertexData.end());
+        }
+
+        lod.SubmeshCount = (int)object->Submeshes.size() - lod.FirstSubmesh;
+        object->Lods.push_back(lod);
+        object->Indices.insert(object->Indices.end(), indices.begin(), indices.end());
+    }
+
+    if (split) {
+        object->VertexData.swap(splitVertexData);
+        header.NumVertices = (int)(object->VertexData.size() / stride);
+        header.VertexDataSize = (int)object->VertexData.size();
+        header.Flags &= ~ysGeometryExportFile::MDF_32BIT_INDICES;
+    }
+    else if (header.NumVertices > ysGeometryExportFile::MaxShortIndexVertexCount) {
+        header.Flags |= ysGeometryExportFile::MDF_32BIT_INDICES;
+    }
+    else {
+        header.Flags &= ~ysGeometryExportFile::MDF_32BIT_INDICES;
+    }
+
+    header.NumFaces = object->Lods[0].FaceCount;
+    header.Flags |= ysGeometryExportFile::MDF_LODS | ysGeometryExportFile::MDF_SUBMESHES;
+
+    return true;
+}
+
+uint64_t ysSceneCompiler::HashSettings(const Settings &settings) {
+    uint32_t scale;
+    memcpy(&scale, &settings.Scale, sizeof(float));
+
+    uint64_t hash = PipelineVersion;
+    hash = CombineHashes(hash, scale);
+    hash = CombineHashes(hash, settings.VertexInfo.IncludeTangents ? 1 : 0);
+    hash = CombineHashes(hash, settings.VertexInfo.IncludeNormals ? 1 : 0);
+    hash = CombineHashes(hash, settings.VertexInfo.IncludeUVs ? 1 : 0);
+    hash = CombineHashes(hash, (uint64_t)settings.VertexInfo.UVChannels);
+    hash = CombineHashes(hash, settings.VertexInfo.Quantize ? 1 : 0);
+
+    uint32_t lodReduction, lodMaxError;
+    memcpy(&lodReduction, &settings.LodReduction, sizeof(float));
+    memcpy(&lodMaxError, &settings.LodMaxError, sizeof(float));
+
+    hash = CombineHashes(hash, (uint64_t)settings.LodCount);
+    hash = CombineHashes(hash, lodReduction);
+    hash = CombineHashes(hash, lodMaxError);
+    hash = CombineHashes(hash, settings.OptimizeMeshes ? 1 : 0);
+    hash = CombineHashes(hash, (uint64_t)settings.LargeMeshes);
+
+    return hash;
+}
+
+uint64_t ysSceneCompiler::HashSettings(const Settings &settings, const ToolObjectSettings &objectSettings) {
+    uint32_t scale;
+    memcpy(&scale, &settings.Scale, sizeof(float));
+
+    uint64_t hash = PipelineVersion;
+    hash = CombineHashes(hash, scale);
+    hash = CombineHashes(hash, objectSettings.CalculateTangents ? 1 : 0);
+    hash = CombineHashes(hash, objectSettings.SeparateByUVs ? 1 : 0);
+
+    return hash;
+}
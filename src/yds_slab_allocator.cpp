@@ -0,0 +1,368 @@
+#include "../include/yds_slab_allocator.h"
+
+#include "../include/yds_allocation_tracker.h"
+#include "../include/yds_allocator.h"
+
+#include <string.h>
+
+namespace {
+    // Slots are shared by every allocator. A thread keeps its slot until it
+    // exits and the next thread to start takes it over, along with whatever
+    // blocks are still in that slot's caches.
+    std::mutex s_threadSlotLock;
+    bool s_threadSlotUsed[ysSlabAllocator::MaxThreadCaches] = {};
+
+    struct ThreadSlot {
+        int Slot = -1;
+
+        ~ThreadSlot() {
+            if (Slot < 0 || Slot >= ysSlabAllocator::MaxThreadCaches) return;
+
+            std::lock_guard<std::mutex> lock(s_threadSlotLock);
+            s_threadSlotUsed[Slot] = false;
+        }
+    };
+
+    int AcquireThreadSlot() {
+        std::lock_guard<std::mutex> lock(s_threadSlotLock);
+
+        for (int i = 0; i < ysSlabAllocator::MaxThreadCaches; ++i) {
+            if (!s_threadSlotUsed[i]) {
+                s_threadSlotUsed[i] = true;
+                return i;
+            }
+        }
+
+        return ysSlabAllocator::MaxThreadCaches;
+    }
+}
+
+ysSlabAllocator::ysSlabAllocator() : ysMemoryAllocator("SLAB_ALLOCATOR") {
+    m_slabSize = DefaultSlabSize;
+    m_hugePages = false;
+    m_slabs = nullptr;
+    m_largeBlockList = nullptr;
+
+    m_reservedBytes = 0;
+    m_requestedBytes = 0;
+    m_allocatedBytes = 0;
+    m_liveBlocks = 0;
+    m_largeBlockCount = 0;
+    m_largeBytes = 0;
+
+    memset(m_central, 0, sizeof(m_central));
+    memset(m_threadCaches, 0, sizeof(m_threadCaches));
+
+    BuildSizeClasses();
+}
+
+ysSlabAllocator::~ysSlabAllocator() {
+    Destroy();
+}
+
+void ysSlabAllocator::Initialize(int slabSize, bool hugePages) {
+    m_slabSize = (slabSize > 0) ? slabSize : DefaultSlabSize;
+    m_hugePages = hugePages;
+}
+
+void *ysSlabAllocator::AllocateBlock(int size, int numObjects) {
+    const size_t blockSize = HeaderSize + ((size_t)size + Alignment - 1) / Alignment * Alignment;
+    if (blockSize > (size_t)MaxSmallSize) {
+        void *block = AllocateLarge(size, numObjects);
+        ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::MemoryAllocator);
+
+        return block;
+    }
+
+    const int sizeClass = GetSizeClass(blockSize);
+
+    FreeLink *link = nullptr;
+    ThreadCache *cache = GetThreadCache();
+    if (cache != nullptr) {
+        if (cache->FreeLists[sizeClass] == nullptr) Refill(cache, sizeClass, CacheBatchSize);
+
+        link = cache->FreeLists[sizeClass];
+        if (link != nullptr) {
+            cache->FreeLists[sizeClass] = link->Next;
+            --cache->Counts[sizeClass];
+        }
+    }
+    else {
+        // Threads without a cache of their own go straight to the shared lists
+        ThreadCache local;
+        local.FreeLists[sizeClass] = nullptr;
+        local.Counts[sizeClass] = 0;
+
+        Refill(&local, sizeClass, 1);
+        link = local.FreeLists[sizeClass];
+    }
+
+    if (link == nullptr) return nullptr;
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(link);
+    header->Size = (unsigned int)size;
+    header->NumObjects = numObjects;
+    header->SizeClass = sizeClass;
+    header->Reserved = 0;
+
+    m_requestedBytes.fetch_add(size, std::memory_order_relaxed);
+    m_allocatedBytes.fetch_add(m_sizeClasses[sizeClass], std::memory_order_relaxed);
+    m_liveBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    void *block = reinterpret_cast<char *>(header) + HeaderSize;
+    ysAllocationTracker::OnAllocate(block, size, ysAllocationTracker::Source::MemoryAllocator);
+
+    return block;
+}
+
+int ysSlabAllocator::FreeBlock(void *block) {
+    if (block == nullptr) return 0;
+
+    ysAllocationTracker::OnFree(block, ysAllocationTracker::Source::MemoryAllocator);
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(reinterpret_cast<char *>(block) - HeaderSize);
+    const int numObjects = header->NumObjects;
+    const int sizeClass = header->SizeClass;
+
+    if (sizeClass == LargeClass) {
+        FreeLarge(header);
+        return numObjects;
+    }
+
+    m_requestedBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+    m_allocatedBytes.fetch_sub(m_sizeClasses[sizeClass], std::memory_order_relaxed);
+    m_liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+    FreeLink *link = reinterpret_cast<FreeLink *>(header);
+
+    ThreadCache *cache = GetThreadCache();
+    if (cache != nullptr) {
+        link->Next = cache->FreeLists[sizeClass];
+        cache->FreeLists[sizeClass] = link;
+
+        if (++cache->Counts[sizeClass] > 2 * CacheBatchSize) Flush(cache, sizeClass, CacheBatchSize);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        CentralList &central = m_central[sizeClass];
+        link->Next = central.FreeList;
+        central.FreeList = link;
+        ++central.FreeCount;
+    }
+
+    return numObjects;
+}
+
+void ysSlabAllocator::Destroy() {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    SlabLink *slab = m_slabs;
+    while (slab != nullptr) {
+        SlabLink *next = slab->Next;
+        if (slab->PageBacked) ysAllocator::PageFree(slab, slab->Size);
+        else ysAllocator::BlockFree(slab, Alignment);
+        slab = next;
+    }
+
+    LargeLink *large = m_largeBlockList;
+    while (large != nullptr) {
+        LargeLink *next = large->Next;
+        ysAllocator::BlockFree(large, Alignment);
+        large = next;
+    }
+
+    m_slabs = nullptr;
+    m_largeBlockList = nullptr;
+
+    memset(m_central, 0, sizeof(m_central));
+    memset(m_threadCaches, 0, sizeof(m_threadCaches));
+
+    m_reservedBytes = 0;
+    m_requestedBytes = 0;
+    m_allocatedBytes = 0;
+    m_liveBlocks = 0;
+    m_largeBlockCount = 0;
+    m_largeBytes = 0;
+}
+
+ysSlabAllocator::Statistics ysSlabAllocator::GetStatistics() const {
+    Statistics stats;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        stats.ReservedBytes = m_reservedBytes;
+        stats.LargeBlocks = m_largeBlockCount;
+        stats.LargeBytes = m_largeBytes;
+    }
+
+    stats.RequestedBytes = m_requestedBytes.load(std::memory_order_relaxed);
+    stats.AllocatedBytes = m_allocatedBytes.load(std::memory_order_relaxed);
+    stats.LiveBlocks = m_liveBlocks.load(std::memory_order_relaxed);
+
+    const size_t smallAllocated = (stats.AllocatedBytes > stats.LargeBytes)
+        ? stats.AllocatedBytes - stats.LargeBytes
+        : 0;
+
+    stats.InternalFragmentation = (stats.AllocatedBytes > 0)
+        ? 1.0f - (float)stats.RequestedBytes / stats.AllocatedBytes
+        : 0.0f;
+    stats.ExternalFragmentation = (stats.ReservedBytes > 0)
+        ? 1.0f - (float)smallAllocated / stats.ReservedBytes
+        : 0.0f;
+
+    return stats;
+}
+
+void ysSlabAllocator::BuildSizeClasses() {
+    // Every 16 bytes up to 256, then four classes per power of two
+    int count = 0;
+    for (int size = 2 * Alignment; size <= 256; size += Alignment) {
+        m_sizeClasses[count++] = size;
+    }
+
+    for (int base = 256; base < MaxSmallSize; base *= 2) {
+        const int step = base / 4;
+        for (int i = 1; i <= 4; ++i) {
+            m_sizeClasses[count++] = base + i * step;
+        }
+    }
+
+    m_sizeClassCount = count;
+
+    int sizeClass = 0;
+    for (int units = 0; units <= MaxSmallSize / Alignment; ++units) {
+        while (m_sizeClasses[sizeClass] < units * Alignment) ++sizeClass;
+        m_sizeClassLookup[units] = (unsigned char)sizeClass;
+    }
+}
+
+int ysSlabAllocator::GetSizeClass(size_t blockSize) const {
+    return m_sizeClassLookup[blockSize / Alignment];
+}
+
+ysSlabAllocator::ThreadCache *ysSlabAllocator::GetThreadCache() {
+    const int slot = GetThreadSlot();
+    return (slot < MaxThreadCaches) ? &m_threadCaches[slot] : nullptr;
+}
+
+void ysSlabAllocator::Refill(ThreadCache *cache, int sizeClass, int count) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    CentralList &central = m_central[sizeClass];
+    const int blockSize = m_sizeClasses[sizeClass];
+
+    for (int i = 0; i < count; ++i) {
+        FreeLink *link = central.FreeList;
+        if (link != nullptr) {
+            central.FreeList = link->Next;
+            --central.FreeCount;
+        }
+        else {
+            if (central.SlabCursor == nullptr || central.SlabCursor + blockSize > central.SlabEnd) {
+                // Make sure large size classes still get several blocks per slab
+                size_t slabSize = (size_t)m_slabSize;
+                if (slabSize < (size_t)blockSize * 8) slabSize = (size_t)blockSize * 8;
+
+                const size_t totalSize = SlabHeaderSize + slabSize;
+                char *data = (m_hugePages)
+                    ? (char *)ysAllocator::PageAllocate(totalSize, true)
+                    : (char *)ysAllocator::BlockAllocate<Alignment>((int)totalSize);
+                if (data == nullptr) break;
+
+                SlabLink *slab = reinterpret_cast<SlabLink *>(data);
+                slab->Size = totalSize;
+                slab->PageBacked = m_hugePages;
+                slab->Next = m_slabs;
+                m_slabs = slab;
+                m_reservedBytes += slabSize;
+
+                central.SlabCursor = data + SlabHeaderSize;
+                central.SlabEnd = central.SlabCursor + slabSize;
+            }
+
+            link = reinterpret_cast<FreeLink *>(central.SlabCursor);
+            central.SlabCursor += blockSize;
+        }
+
+        link->Next = cache->FreeLists[sizeClass];
+        cache->FreeLists[sizeClass] = link;
+        ++cache->Counts[sizeClass];
+    }
+}
+
+void ysSlabAllocator::Flush(ThreadCache *cache, int sizeClass, int count) {
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    CentralList &central = m_central[sizeClass];
+    for (int i = 0; i < count && cache->FreeLists[sizeClass] != nullptr; ++i) {
+        FreeLink *link = cache->FreeLists[sizeClass];
+        cache->FreeLists[sizeClass] = link->Next;
+        --cache->Counts[sizeClass];
+
+        link->Next = central.FreeList;
+        central.FreeList = link;
+        ++central.FreeCount;
+    }
+}
+
+void *ysSlabAllocator::AllocateLarge(int size, int numObjects) {
+    const size_t totalSize = LargeHeaderSize + HeaderSize + (size_t)size;
+
+    char *data = (char *)ysAllocator::BlockAllocate<Alignment>((int)totalSize);
+    if (data == nullptr) return nullptr;
+
+    LargeLink *link = reinterpret_cast<LargeLink *>(data);
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(data + LargeHeaderSize);
+    header->Size = (unsigned int)size;
+    header->NumObjects = numObjects;
+    header->SizeClass = LargeClass;
+    header->Reserved = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        link->Previous = nullptr;
+        link->Next = m_largeBlockList;
+        if (m_largeBlockList != nullptr) m_largeBlockList->Previous = link;
+        m_largeBlockList = link;
+
+        ++m_largeBlockCount;
+        m_largeBytes += totalSize;
+    }
+
+    m_requestedBytes.fetch_add(size, std::memory_order_relaxed);
+    m_allocatedBytes.fetch_add(totalSize, std::memory_order_relaxed);
+    m_liveBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    return reinterpret_cast<char *>(header) + HeaderSize;
+}
+
+void ysSlabAllocator::FreeLarge(BlockHeader *header) {
+    const size_t totalSize = LargeHeaderSize + HeaderSize + (size_t)header->Size;
+    LargeLink *link = reinterpret_cast<LargeLink *>(reinterpret_cast<char *>(header) - LargeHeaderSize);
+
+    m_requestedBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+    m_allocatedBytes.fetch_sub(totalSize, std::memory_order_relaxed);
+    m_liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (link->Previous != nullptr) link->Previous->Next = link->Next;
+        else m_largeBlockList = link->Next;
+        if (link->Next != nullptr) link->Next->Previous = link->Previous;
+
+        --m_largeBlockCount;
+        m_largeBytes -= totalSize;
+    }
+
+    ysAllocator::BlockFree(link, Alignment);
+}
+
+int ysSlabAllocator::GetThreadSlot() {
+    static thread_local ThreadSlot slot;
+    if (slot.Slot == -1) slot.Slot = AcquireThreadSlot();
+
+    return slot.Slot;
+}
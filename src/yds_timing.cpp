@@ -1,29 +1,74 @@
 #include "../include/yds_timing.h"
 
-#include <windows.h>
-#include <mmsystem.h>
+#include <mutex>
 
-static bool qpcFlag;
-static LARGE_INTEGER qpcFrequency;
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#else
+#include <chrono>
+#endif
 
 ysTimingSystem *ysTimingSystem::g_instance = nullptr;
 
-uint64_t SystemTime() {
-    if (qpcFlag) {
-        LARGE_INTEGER currentTime;
-        QueryPerformanceCounter(&currentTime);
+std::atomic<int> ysTimingSystem::s_clockSource(0);
+uint64_t ysTimingSystem::s_ticksPerSecond = 0;
+uint64_t ysTimingSystem::s_nanosecondsPerTick = 0;
+
+namespace {
+    constexpr uint64_t NanosecondsPerSecond = 1000000000ull;
+
+    // Long enough for a ~1 ppm estimate of the TSC frequency
+    constexpr uint64_t CalibrationTime = 10000000ull;
+
+    std::once_flag s_calibrationFlag;
+
+#if defined(_WIN32)
+    uint64_t GetQpcFrequency() {
+        static const uint64_t frequency = []() {
+            LARGE_INTEGER f;
+            QueryPerformanceFrequency(&f);
+            return (uint64_t)f.QuadPart;
+        }();
 
-        currentTime.QuadPart *= 1000000;
-        currentTime.QuadPart /= qpcFrequency.QuadPart;
+        return frequency;
+    }
+#endif /* _WIN32 */
+
+#if defined(YDS_TIMING_TSC)
+    bool HasInvariantTsc() {
+        unsigned int regs[4] = { 0, 0, 0, 0 };
+
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0x80000000);
+        if ((unsigned int)info[0] < 0x80000007u) return false;
+
+        __cpuid(info, 0x80000007);
+        regs[3] = (unsigned int)info[3];
+#else
+        unsigned int maxLeaf;
+        __asm__ __volatile__("cpuid" : "=a"(maxLeaf), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(0x80000000u));
+        if (maxLeaf < 0x80000007u) return false;
 
-        return (uint64_t)(currentTime.QuadPart);
+        __asm__ __volatile__("cpuid" : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3]) : "a"(0x80000007u));
+#endif
+
+        // EDX bit 8: TSC runs at a constant rate in all power states
+        return (regs[3] & (1u << 8)) != 0;
     }
-    else {
-        // Convert output to microseconds
-        return (uint64_t)(timeGetTime() * 1000);
+#endif /* YDS_TIMING_TSC */
+
+    uint64_t ToFixedPoint(double nanosecondsPerTick) {
+        return (uint64_t)(nanosecondsPerTick * 4294967296.0 + 0.5);
     }
 }
 
+uint64_t SystemTime() {
+    return ysTimingSystem::TicksToNanoseconds(ysTimingSystem::Now()) / 1000;
+}
+
 ysTimingSystem::ysTimingSystem() {
     SetPrecisionMode(Precision::Microsecond);
     Initialize();
@@ -34,15 +79,18 @@ ysTimingSystem::~ysTimingSystem() {
 }
 
 uint64_t ysTimingSystem::GetTime() {
-    return SystemTime();
-}
+    const uint64_t ns = TicksToNanoseconds(Now());
 
-inline unsigned __int64 SystemClock() {
-    return __rdtsc();
+    switch (m_precisionMode) {
+    case Precision::Nanosecond: return ns;
+    case Precision::Microsecond: return ns / 1000;
+    case Precision::Millisecond: return ns / 1000000;
+    default: return ns;
+    }
 }
 
-unsigned __int64 ysTimingSystem::GetClock() {
-    return (unsigned long long) SystemClock();
+uint64_t ysTimingSystem::GetClock() {
+    return Now();
 }
 
 void ysTimingSystem::SetPrecisionMode(Precision mode) {
@@ -54,6 +102,9 @@ void ysTimingSystem::SetPrecisionMode(Precision mode) {
     else if (mode == Precision::Microsecond) {
         m_div = 1000000.0;
     }
+    else if (mode == Precision::Nanosecond) {
+        m_div = 1000000000.0;
+    }
 }
 
 double ysTimingSystem::ConvertToSeconds(uint64_t t_u) {
@@ -87,7 +138,7 @@ void ysTimingSystem::Update() {
 }
 
 void ysTimingSystem::Initialize() {
-    qpcFlag = (QueryPerformanceFrequency(&qpcFrequency) > 0);
+    EnsureCalibrated();
 
     m_frameNumber = 0;
 
@@ -110,3 +161,108 @@ double ysTimingSystem::GetFrameDuration() {
 uint64_t ysTimingSystem::GetFrameDuration_us() {
     return m_lastFrameDuration;
 }
+
+uint64_t ysTimingSystem::TicksToNanoseconds(uint64_t ticks) {
+    EnsureCalibrated();
+
+    // 32.32 fixed point multiply split in two to avoid overflow
+    const uint64_t high = ticks >> 32;
+    const uint64_t low = ticks & 0xFFFFFFFFull;
+
+    return high * s_nanosecondsPerTick + ((low * s_nanosecondsPerTick) >> 32);
+}
+
+double ysTimingSystem::TicksToSeconds(uint64_t ticks) {
+    EnsureCalibrated();
+
+    return (double)ticks / s_ticksPerSecond;
+}
+
+uint64_t ysTimingSystem::GetTicksPerSecond() {
+    EnsureCalibrated();
+
+    return s_ticksPerSecond;
+}
+
+ysTimingSystem::ClockSource ysTimingSystem::GetClockSource() {
+    EnsureCalibrated();
+
+    return (ClockSource)s_clockSource.load(std::memory_order_acquire);
+}
+
+uint64_t ysTimingSystem::ReadSystemClock() {
+#if defined(_WIN32)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    const uint64_t frequency = GetQpcFrequency();
+    const uint64_t ticks = (uint64_t)counter.QuadPart;
+
+    return (ticks / frequency) * NanosecondsPerSecond
+        + ((ticks % frequency) * NanosecondsPerSecond) / frequency;
+#elif defined(__linux__)
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &t);
+
+    return (uint64_t)t.tv_sec * NanosecondsPerSecond + (uint64_t)t.tv_nsec;
+#elif defined(__APPLE__)
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (uint64_t)t.tv_sec * NanosecondsPerSecond + (uint64_t)t.tv_nsec;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void ysTimingSystem::EnsureCalibrated() {
+    if (s_clockSource.load(std::memory_order_acquire) != (int)ClockSource::Uncalibrated) return;
+
+    std::call_once(s_calibrationFlag, &ysTimingSystem::Calibrate);
+}
+
+uint64_t ysTimingSystem::NowFallback() {
+    EnsureCalibrated();
+
+#if defined(YDS_TIMING_TSC)
+    if (s_clockSource.load(std::memory_order_relaxed) == (int)ClockSource::Tsc) {
+        unsigned int aux;
+        return __rdtscp(&aux);
+    }
+#endif /* YDS_TIMING_TSC */
+
+    return ReadSystemClock();
+}
+
+void ysTimingSystem::Calibrate() {
+    ClockSource source = ClockSource::System;
+    s_ticksPerSecond = NanosecondsPerSecond;
+    s_nanosecondsPerTick = ToFixedPoint(1.0);
+
+#if defined(YDS_TIMING_TSC)
+    if (HasInvariantTsc()) {
+        unsigned int aux;
+
+        const uint64_t t0 = ReadSystemClock();
+        const uint64_t c0 = __rdtscp(&aux);
+
+        uint64_t t1, c1;
+        do {
+            t1 = ReadSystemClock();
+            c1 = __rdtscp(&aux);
+        } while (t1 - t0 < CalibrationTime);
+
+        if (c1 > c0) {
+            const double elapsed = (double)(t1 - t0);
+            const double ticks = (double)(c1 - c0);
+
+            s_ticksPerSecond = (uint64_t)(ticks * NanosecondsPerSecond / elapsed + 0.5);
+            s_nanosecondsPerTick = ToFixedPoint(elapsed / ticks);
+            source = ClockSource::Tsc;
+        }
+    }
+#endif /* YDS_TIMING_TSC */
+
+    s_clockSource.store((int)source, std::memory_order_release);
+}
@@ -0,0 +1,142 @@
+#include "../include/yds_vertex_quantization.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+    float SignNotZero(float value) {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+
+    float Clamp(float value, float min, float max) {
+        return (value < min) ? min : ((value > max) ? max : value);
+    }
+
+} /* namespace */
+
+uint16_t ysVertexQuantization::FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    const uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN, NaN keeps a mantissa bit so it doesn't become infinity
+    if (exponent == 0xFF) return (uint16_t)(sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0));
+
+    const int halfExponent = (int)exponent - 127 + 15;
+    if (halfExponent >= 0x1F) return (uint16_t)(sign | 0x7C00);
+
+    if (halfExponent <= 0) {
+        // Too small even for a subnormal half
+        if (halfExponent < -10) return (uint16_t)sign;
+
+        mantissa |= 0x800000;
+
+        const int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+
+        // Rounding up may carry into the smallest normal, which is still correct
+        if (remainder > halfway || (remainder == halfway && (half & 1) != 0)) ++half;
+
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = ((uint32_t)halfExponent << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFF;
+
+    // Carries into the exponent round up to the next power of two or to infinity
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1) != 0)) ++half;
+
+    return (uint16_t)(sign | half);
+}
+
+float ysVertexQuantization::HalfToFloat(uint16_t half) {
+    const uint32_t sign = ((uint32_t)half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1F;
+    const uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else if (exponent == 0) {
+        // Zero and subnormals, mantissa * 2^-24
+        const float value = (float)mantissa * (1.0f / 16777216.0f);
+        return (sign != 0) ? -value : value;
+    }
+    else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+uint16_t ysVertexQuantization::QuantizeUnorm16(float value, float min, float max) {
+    const float range = max - min;
+    if (!(range > 0.0f)) return 0;
+
+    const float t = Clamp((value - min) / range, 0.0f, 1.0f);
+    return (uint16_t)(t * 65535.0f + 0.5f);
+}
+
+float ysVertexQuantization::DequantizeUnorm16(uint16_t quantized, float min, float max) {
+    return min + (quantized / 65535.0f) * (max - min);
+}
+
+int16_t ysVertexQuantization::FloatToSnorm16(float value) {
+    const float scaled = Clamp(value, -1.0f, 1.0f) * 32767.0f;
+    return (int16_t)((scaled >= 0.0f) ? scaled + 0.5f : scaled - 0.5f);
+}
+
+float ysVertexQuantization::Snorm16ToFloat(int16_t snorm) {
+    // -32768 and -32767 both map to -1
+    return Clamp(snorm / 32767.0f, -1.0f, 1.0f);
+}
+
+void ysVertexQuantization::EncodeOctahedral(float x, float y, float z, int16_t encoded[2]) {
+    const float l1 = fabsf(x) + fabsf(y) + fabsf(z);
+    if (l1 == 0.0f) {
+        encoded[0] = encoded[1] = 0;
+        return;
+    }
+
+    float u = x / l1;
+    float v = y / l1;
+
+    // Lower hemisphere is folded over the diagonals
+    if (z < 0.0f) {
+        const float foldedU = (1.0f - fabsf(v)) * SignNotZero(u);
+        const float foldedV = (1.0f - fabsf(u)) * SignNotZero(v);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    encoded[0] = FloatToSnorm16(u);
+    encoded[1] = FloatToSnorm16(v);
+}
+
+void ysVertexQuantization::DecodeOctahedral(const int16_t encoded[2], float decoded[3]) {
+    float x = Snorm16ToFloat(encoded[0]);
+    float y = Snorm16ToFloat(encoded[1]);
+    const float z = 1.0f - fabsf(x) - fabsf(y);
+
+    if (z < 0.0f) {
+        const float unfoldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+        const float unfoldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = unfoldedX;
+        y = unfoldedY;
+    }
+
+    const float length = sqrtf(x * x + y * y + z * z);
+    decoded[0] = x / length;
+    decoded[1] = y / length;
+    decoded[2] = z / length;
+}
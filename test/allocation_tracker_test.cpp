@@ -0,0 +1,196 @@
+#include <pch.h>
+
+#include "../include/yds_allocation_tracker.h"
+#include "../include/yds_allocator.h"
+#include "../include/yds_frame_allocator.h"
+#include "../include/yds_slab_allocator.h"
+
+#include <memory>
+#include <thread>
+
+namespace {
+    typedef ysAllocationTracker::Source Source;
+
+    // Lets allocations escape so the compiler can't elide a new/delete pair
+    void *volatile s_escaped = nullptr;
+
+    // Every test starts from a clean, enabled tracker and leaves it disabled
+    class AllocationTrackerTest : public testing::Test {
+    protected:
+        virtual void SetUp() {
+            m_tracker = ysAllocationTracker::Get();
+            m_tracker->SetEnabled(false);
+            m_tracker->SetCaptureCallStacks(false);
+            m_tracker->Reset();
+            m_tracker->SetEnabled(true);
+        }
+
+        virtual void TearDown() {
+            m_tracker->SetEnabled(false);
+            m_tracker->SetCaptureCallStacks(false);
+            m_tracker->Reset();
+        }
+
+        ysAllocationTracker *m_tracker;
+    };
+
+    void *AllocateTagged(ysAllocationTracker::TagId tag, int size) {
+        ysAllocationTagScope scope(tag);
+        return ysAllocator::BlockAllocate<16>(size);
+    }
+}
+
+TEST_F(AllocationTrackerTest, TagsAndLiveBytes) {
+    const ysAllocationTracker::TagId physics = m_tracker->RegisterTag("test_physics");
+    const ysAllocationTracker::TagId assets = m_tracker->RegisterTag("test_assets");
+    EXPECT_NE(physics, assets);
+    EXPECT_EQ(m_tracker->RegisterTag("test_physics"), physics);
+    EXPECT_STREQ(m_tracker->GetTagName(assets), "test_assets");
+
+    void *a = AllocateTagged(physics, 100);
+    void *b = AllocateTagged(physics, 28);
+    void *c = AllocateTagged(assets, 1000);
+
+    ysAllocationTracker::Statistics s = m_tracker->GetStatistics(physics, Source::Allocator);
+    EXPECT_EQ(s.Allocations, 2);
+    EXPECT_EQ(s.BytesAllocated, 128);
+    EXPECT_EQ(s.LiveAllocations, 2);
+    EXPECT_EQ(s.LiveBytes, 128);
+
+    // Frees are charged to the tag of the allocation, not the current tag
+    ysAllocator::BlockFree(a, 16);
+    ysAllocator::BlockFree(c, 16);
+
+    s = m_tracker->GetStatistics(physics, Source::Allocator);
+    EXPECT_EQ(s.Frees, 1);
+    EXPECT_EQ(s.LiveBytes, 28);
+    EXPECT_EQ(s.PeakLiveBytes, 128);
+
+    s = m_tracker->GetStatistics(assets, Source::Allocator);
+    EXPECT_EQ(s.LiveAllocations, 0);
+    EXPECT_EQ(s.PeakLiveBytes, 1000);
+
+    ysAllocator::BlockFree(b, 16);
+    EXPECT_EQ(m_tracker->GetStatistics(physics, Source::Allocator).LiveBytes, 0);
+}
+
+TEST_F(AllocationTrackerTest, MemoryAllocators) {
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_allocators");
+    ysAllocationTagScope scope(tag);
+
+    ysSlabAllocator slab;
+    void *small = slab.AllocateBlock(64);
+    void *large = slab.AllocateBlock(1024 * 1024);
+
+    ysAllocationTracker::Statistics s = m_tracker->GetStatistics(tag, Source::MemoryAllocator);
+    EXPECT_EQ(s.LiveAllocations, 2);
+    EXPECT_EQ(s.LiveBytes, 64 + 1024 * 1024);
+
+    slab.FreeBlock(small);
+    slab.FreeBlock(large);
+    EXPECT_EQ(m_tracker->GetStatistics(tag, Source::MemoryAllocator).LiveBytes, 0);
+
+    slab.Destroy();
+}
+
+TEST_F(AllocationTrackerTest, FrameCounts) {
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_frame");
+    ysAllocationTagScope scope(tag);
+
+    ysFrameAllocator frameAllocator;
+    frameAllocator.Initialize(4096);
+
+    for (int i = 0; i < 5; ++i) frameAllocator.AllocateBlock(32);
+
+    ysAllocationTracker::Statistics s = m_tracker->GetStatistics(tag, Source::FrameAllocator);
+    EXPECT_EQ(s.FrameAllocations, 5);
+    EXPECT_EQ(s.FrameBytes, 160);
+
+    // Frame allocator memory is never live from the tracker's point of view
+    EXPECT_EQ(s.LiveAllocations, 0);
+
+    const uint64_t frame = m_tracker->GetFrameCount();
+    m_tracker->EndFrame();
+    EXPECT_EQ(m_tracker->GetFrameCount(), frame + 1);
+
+    s = m_tracker->GetStatistics(tag, Source::FrameAllocator);
+    EXPECT_EQ(s.FrameAllocations, 0);
+    EXPECT_EQ(s.LastFrameAllocations, 5);
+    EXPECT_EQ(s.LastFrameBytes, 160);
+    EXPECT_EQ(s.Allocations, 5);
+
+    frameAllocator.Destroy();
+}
+
+TEST_F(AllocationTrackerTest, CallSites) {
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_call_sites");
+    m_tracker->SetCaptureCallStacks(true);
+
+    void *blocks[8];
+    for (int i = 0; i < 8; ++i) blocks[i] = AllocateTagged(tag, 256);
+    void *other = AllocateTagged(tag, 16);
+
+    m_tracker->SetCaptureCallStacks(false);
+
+    const std::vector<ysAllocationTracker::CallSite> sites = m_tracker->GetTopCallSites(1);
+#if defined(_WIN32) || defined(__GLIBC__) || defined(__APPLE__)
+    ASSERT_EQ(sites.size(), 1);
+    EXPECT_EQ(sites[0].Tag, tag);
+    EXPECT_EQ(sites[0].AllocationSource, Source::Allocator);
+    EXPECT_EQ(sites[0].Bytes, 8 * 256);
+    EXPECT_EQ(sites[0].LiveBytes, 8 * 256);
+    EXPECT_GT(sites[0].Depth, 0);
+#endif
+
+    for (int i = 0; i < 8; ++i) ysAllocator::BlockFree(blocks[i], 16);
+    ysAllocator::BlockFree(other, 16);
+
+    EXPECT_EQ(m_tracker->WriteReport("allocation_report.txt", 4), ysError::None);
+}
+
+TEST_F(AllocationTrackerTest, OperatorNew) {
+#ifndef YDS_DISABLE_OPERATOR_NEW_TRACKING
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_new");
+
+    std::unique_ptr<int[]> data;
+    {
+        ysAllocationTagScope scope(tag);
+        data.reset(new int[64]);
+        s_escaped = data.get();
+    }
+
+    EXPECT_EQ(m_tracker->GetStatistics(tag, Source::OperatorNew).LiveBytes, 64 * sizeof(int));
+
+    data.reset();
+    EXPECT_EQ(m_tracker->GetStatistics(tag, Source::OperatorNew).LiveBytes, 0);
+#endif
+}
+
+TEST_F(AllocationTrackerTest, TagsArePerThread) {
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_thread");
+    ysAllocationTagScope scope(tag);
+
+    void *block = nullptr;
+    std::thread worker([&block]() {
+        block = ysAllocator::BlockAllocate<16>(512);
+    });
+    worker.join();
+
+    EXPECT_EQ(m_tracker->GetStatistics(tag, Source::Allocator).Allocations, 0);
+    EXPECT_EQ(
+        m_tracker->GetStatistics(ysAllocationTracker::UntaggedTag, Source::Allocator).LiveBytes, 512);
+
+    ysAllocator::BlockFree(block, 16);
+}
+
+TEST_F(AllocationTrackerTest, DisabledIsNoop) {
+    const ysAllocationTracker::TagId tag = m_tracker->RegisterTag("test_disabled");
+    m_tracker->SetEnabled(false);
+
+    void *block = AllocateTagged(tag, 64);
+    ysAllocator::BlockFree(block, 16);
+
+    const ysAllocationTracker::Statistics s = m_tracker->GetTagStatistics(tag);
+    EXPECT_EQ(s.Allocations, 0);
+    EXPECT_EQ(s.Frees, 0);
+}
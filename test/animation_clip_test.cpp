@@ -0,0 +1,194 @@
+#include <pch.h>
+
+#include "../include/yds_animation_action.h"
+#include "../include/yds_animation_action_binding.h"
+#include "../include/yds_animation_clip.h"
+#include "../include/yds_animation_target.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr int BoneCount = 4;
+    constexpr int KeyCount = 31;
+
+    std::string BoneName(int bone) {
+        return "Bone" + std::to_string(bone);
+    }
+
+    ysQuaternion KeyRotation(int bone, int key) {
+        // Large angles about different axes so every component gets to be
+        // the largest one
+        const float angle = 3.0f * std::sin(key * 0.2f + bone);
+        const ysVector axis = ysMath::Normalize(
+            ysMath::LoadVector(1.0f + bone, (float)(bone % 2), 0.5f * bone - 1.0f, 0.0f));
+
+        return ysMath::LoadQuaternion(angle, axis);
+    }
+
+    float KeyLocation(int bone, int key, int component) {
+        return 10.0f * std::sin(key * 0.3f + component) + bone;
+    }
+
+    // Keys at every integer s from 0 to KeyCount - 1, bone 0 has no Z curve
+    void BuildAction(ysAnimationAction *action) {
+        const ysAnimationCurve::CurveType types[] = {
+            ysAnimationCurve::CurveType::LocationX,
+            ysAnimationCurve::CurveType::LocationY,
+            ysAnimationCurve::CurveType::LocationZ,
+            ysAnimationCurve::CurveType::RotationQuatW,
+            ysAnimationCurve::CurveType::RotationQuatX,
+            ysAnimationCurve::CurveType::RotationQuatY,
+            ysAnimationCurve::CurveType::RotationQuatZ
+        };
+
+        action->SetLength((float)(KeyCount - 1));
+
+        for (int bone = 0; bone < BoneCount; ++bone) {
+            for (int c = 0; c < 7; ++c) {
+                if (bone == 0 && c == 2) continue;
+
+                ysAnimationCurve *curve = action->NewCurve(BoneName(bone));
+                curve->SetCurveType(types[c]);
+
+                for (int k = 0; k < KeyCount; ++k) {
+                    float q[4];
+                    _mm_storeu_ps(q, KeyRotation(bone, k));
+
+                    curve->AddLinearSamplePoint((float)k, (c < 3) ? KeyLocation(bone, k, c) : q[c - 3]);
+                }
+            }
+        }
+    }
+
+    struct Pose {
+        TransformTarget Locations[BoneCount];
+        TransformTarget Rotations[BoneCount];
+
+        void Clear() {
+            for (int i = 0; i < BoneCount; ++i) {
+                Locations[i].ClearLocation(ysMath::Constants::Zero);
+                Rotations[i].ClearRotation(ysMath::Constants::QuatIdentity);
+            }
+        }
+    };
+
+    void Bind(ysAnimationActionBinding *binding, ysAnimationAction *action, Pose *pose) {
+        binding->SetAction(action);
+        for (int i = 0; i < BoneCount; ++i) {
+            binding->AddTarget(BoneName(i), &pose->Locations[i], &pose->Rotations[i]);
+        }
+    }
+}
+
+TEST(AnimationClipTest, MatchesCurves) {
+    ysAnimationAction curves, compressed;
+    BuildAction(&curves);
+    BuildAction(&compressed);
+
+    ysAnimationClip::Settings settings;
+    settings.SampleRate = 1.0f;
+    EXPECT_EQ(compressed.Compress(settings), ysError::None);
+
+    Pose curvePose, clipPose;
+    ysAnimationActionBinding curveBinding, clipBinding;
+    Bind(&curveBinding, &curves, &curvePose);
+    Bind(&clipBinding, &compressed, &clipPose);
+
+    for (float s = -1.0f; s < KeyCount + 1.0f; s += 0.3f) {
+        curvePose.Clear();
+        clipPose.Clear();
+
+        curveBinding.Sample(s, 0.5f);
+        clipBinding.Sample(s, 0.5f);
+
+        for (int i = 0; i < BoneCount; ++i) {
+            const ysVector4 expectedLocation = ysMath::GetVector4(curvePose.Locations[i].GetLocationResult());
+            const ysVector4 location = ysMath::GetVector4(clipPose.Locations[i].GetLocationResult());
+
+            EXPECT_NEAR(location.x, expectedLocation.x, 1E-3);
+            EXPECT_NEAR(location.y, expectedLocation.y, 1E-3);
+            EXPECT_NEAR(location.z, expectedLocation.z, 1E-3);
+
+            // Curves interpolate each component on its own, compare directions
+            const ysVector4 expectedRotation = ysMath::GetVector4(
+                ysMath::Normalize(curvePose.Rotations[i].GetQuaternionResult()));
+            const ysVector4 rotation = ysMath::GetVector4(
+                ysMath::Normalize(clipPose.Rotations[i].GetQuaternionResult()));
+
+            const float sign =
+                (expectedRotation.x * rotation.x + expectedRotation.y * rotation.y +
+                expectedRotation.z * rotation.z + expectedRotation.w * rotation.w < 0) ? -1.0f : 1.0f;
+
+            EXPECT_NEAR(rotation.x * sign, expectedRotation.x, 1E-3);
+            EXPECT_NEAR(rotation.y * sign, expectedRotation.y, 1E-3);
+            EXPECT_NEAR(rotation.z * sign, expectedRotation.z, 1E-3);
+            EXPECT_NEAR(rotation.w * sign, expectedRotation.w, 1E-3);
+        }
+    }
+}
+
+TEST(AnimationClipTest, KeepsUnanimatedComponents) {
+    ysAnimationAction action;
+    BuildAction(&action);
+    EXPECT_EQ(action.Compress(ysAnimationClip::Settings()), ysError::None);
+
+    Pose pose;
+    ysAnimationActionBinding binding;
+    Bind(&binding, &action, &pose);
+
+    pose.Clear();
+    pose.Locations[0].ClearLocation(ysMath::LoadVector(0.0f, 0.0f, 7.0f));
+    binding.Sample(3.0f, 1.0f);
+
+    // Bone 0 has no Z curve
+    const ysVector4 location = ysMath::GetVector4(pose.Locations[0].GetLocationResult());
+    EXPECT_NEAR(location.x, KeyLocation(0, 3, 0), 1E-3);
+    EXPECT_NEAR(location.z, 7.0f, 1E-6);
+}
+
+TEST(AnimationClipTest, ReplacesCurves) {
+    ysAnimationAction action;
+    BuildAction(&action);
+
+    ysAnimationClip::Settings settings;
+    settings.SampleRate = 2.0f;
+    EXPECT_EQ(action.Compress(settings), ysError::None);
+
+    ysAnimationClip *clip = action.GetClip();
+    ASSERT_NE(clip, nullptr);
+    EXPECT_EQ(clip->GetBoneCount(), BoneCount);
+    EXPECT_EQ(clip->GetFrameCount(), (KeyCount - 1) * 2 + 1);
+    EXPECT_EQ(clip->FindBone("Bone2"), 2);
+    EXPECT_EQ(clip->FindBone("Bone4"), -1);
+
+    EXPECT_EQ(action.GetCurveCount(), 0);
+    EXPECT_EQ(action.GetCurve("Bone0", ysAnimationCurve::CurveType::LocationX), nullptr);
+    EXPECT_TRUE(action.IsAnimated("Bone3"));
+    EXPECT_FALSE(action.IsAnimated("Bone4"));
+
+    // 16 bytes per bone per frame
+    EXPECT_LT(clip->GetMemoryUsage(), (size_t)(clip->GetFrameCount() * BoneCount * 16 + 1024));
+
+    EXPECT_EQ(action.Compress(settings), ysError::InvalidOperation);
+}
+
+TEST(AnimationClipTest, SampleRest) {
+    ysAnimationAction action;
+    BuildAction(&action);
+    EXPECT_EQ(action.Compress(ysAnimationClip::Settings()), ysError::None);
+
+    Pose pose;
+    ysAnimationActionBinding binding;
+    Bind(&binding, &action, &pose);
+
+    pose.Clear();
+    binding.SampleRest(1.0f);
+
+    const ysVector4 rotation = ysMath::GetVector4(pose.Rotations[1].GetQuaternionResult());
+    EXPECT_NEAR(rotation.x, 1.0f, 1E-6);
+    EXPECT_NEAR(rotation.y, 0.0f, 1E-6);
+    EXPECT_NEAR(rotation.z, 0.0f, 1E-6);
+    EXPECT_NEAR(rotation.w, 0.0f, 1E-6);
+}
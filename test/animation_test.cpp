@@ -164,6 +164,76 @@ TEST(AnimationTest, CurveTest) {
     EXPECT_NEAR(s4, 0.25f, Epsilon);
 }
 
+TEST(AnimationTest, CurveCursorTest) {
+    ysAnimationCurve curve;
+    for (int i = 0; i < 100; ++i) {
+        curve.AddLinearSamplePoint((float)i, (float)(i * i));
+    }
+
+    int cursor = 0;
+    for (float s = -1.0f; s < 101.0f; s += 0.25f) {
+        EXPECT_NEAR(curve.Sample(s, &cursor), curve.Sample(s), Epsilon);
+    }
+
+    EXPECT_EQ(cursor, 98);
+
+    // Jumping backwards or far ahead
+    EXPECT_NEAR(curve.Sample(10.5f, &cursor), 110.5f, Epsilon);
+    EXPECT_EQ(cursor, 10);
+
+    EXPECT_NEAR(curve.Sample(80.5f, &cursor), 6480.5f, Epsilon);
+    EXPECT_EQ(cursor, 80);
+
+    // New sample points are baked on the next sample
+    curve.AddLinearSamplePoint(80.5f, 0.0f);
+    EXPECT_FALSE(curve.IsBaked());
+    EXPECT_NEAR(curve.Sample(80.5f, &cursor), 0.0f, Epsilon);
+    EXPECT_TRUE(curve.IsBaked());
+}
+
+TEST(AnimationTest, BakedBezierTest) {
+    ysAnimationCurve::CurveHandle handles[3];
+    const float s[] = { 0.0f, 10.0f, 30.0f };
+    const float v[] = { 0.0f, 2.0f, -1.0f };
+    for (int i = 0; i < 3; ++i) {
+        handles[i].mode = ysAnimationCurve::CurveHandle::InterpolationMode::Bezier;
+        handles[i].s = s[i];
+        handles[i].v = v[i];
+        handles[i].l_handle_x = s[i] - 3.0f;
+        handles[i].l_handle_y = v[i] - 1.0f;
+        handles[i].r_handle_x = s[i] + 5.0f;
+        handles[i].r_handle_y = v[i] + 1.0f;
+    }
+
+    ysAnimationCurve curve;
+    for (int i = 0; i < 3; ++i) curve.AddSamplePoint(handles[i]);
+    curve.Bake();
+
+    int cursor = 0;
+    for (float x = 0.0f; x <= 30.0f; x += 0.5f) {
+        const int k = (x < 10.0f) ? 0 : 1;
+        const ysAnimationCurve::CurveHandle &h1 = handles[k];
+        const ysAnimationCurve::CurveHandle &h2 = handles[k + 1];
+
+        // Slow reference, solves for t to a tighter tolerance than Bezier_t
+        float l = 0.0f, r = 1.0f, t = 0.0f;
+        for (int i = 0; i < 40; ++i) {
+            t = (l + r) / 2;
+            const float B_t_x =
+                (1 - t) * (1 - t) * (1 - t) * h1.s + 3 * t * (1 - t) * (1 - t) * h1.r_handle_x +
+                3 * t * t * (1 - t) * h2.l_handle_x + t * t * t * h2.s;
+            if (B_t_x < x) l = t;
+            else r = t;
+        }
+
+        const float expected =
+            (1 - t) * (1 - t) * (1 - t) * h1.v + 3 * t * (1 - t) * (1 - t) * h1.r_handle_y +
+            3 * t * t * (1 - t) * h2.l_handle_y + t * t * t * h2.v;
+
+        EXPECT_NEAR(curve.Sample(x, &cursor), expected, 1E-4);
+    }
+}
+
 TEST(AnimationTest, BindingTest) {
     ysAnimationAction action;
     action.SetLength(4.0f);
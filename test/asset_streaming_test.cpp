@@ -0,0 +1,198 @@
+#include <pch.h>
+
+#include "../include/yds_asset_streamer.h"
+#include "../include/yds_residency_set.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+    // Fills index bytes with the index, fails for negative indices
+    bool LoadBytes(void *context, int index, std::vector<char> *data) {
+        if (context != nullptr) {
+            reinterpret_cast<std::atomic<int> *>(context)->fetch_add(1);
+        }
+
+        if (index < 0) return false;
+
+        data->assign(index, (char)index);
+        return true;
+    }
+
+    struct Gate {
+        std::atomic<bool> Open{ false };
+    };
+
+    // Blocks the I/O thread until the gate is opened
+    bool WaitForGate(void *context, int index, std::vector<char> *data) {
+        Gate *gate = reinterpret_cast<Gate *>(context);
+        while (!gate->Open.load()) std::this_thread::yield();
+
+        data->assign(index, 0);
+        return true;
+    }
+}
+
+TEST(AssetStreamingTest, LoadsInRequestOrder) {
+    ysAssetStreamer streamer;
+    streamer.Initialize();
+
+    std::atomic<int> loads(0);
+    for (int i = 0; i < 100; ++i) {
+        streamer.Request(1000 + i, LoadBytes, &loads, i);
+    }
+
+    streamer.WaitIdle();
+    EXPECT_EQ(loads.load(), 100);
+    EXPECT_EQ(streamer.GetPendingCount(), 100);
+
+    std::vector<ysAssetStreamer::Completion> completed;
+    EXPECT_EQ(streamer.Collect(&completed), 100);
+    ASSERT_EQ(completed.size(), 100);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(completed[i].Key, 1000 + i);
+        EXPECT_TRUE(completed[i].Success);
+        EXPECT_EQ(completed[i].Data.size(), i);
+    }
+
+    EXPECT_EQ(streamer.GetPendingCount(), 0);
+    streamer.Destroy();
+}
+
+TEST(AssetStreamingTest, CollectRespectsByteBudget) {
+    ysAssetStreamer streamer;
+    streamer.Initialize();
+
+    streamer.Request(0, LoadBytes, nullptr, 60);
+    streamer.Request(1, LoadBytes, nullptr, 60);
+    streamer.Request(2, LoadBytes, nullptr, 200);
+    streamer.Request(3, LoadBytes, nullptr, -1);
+    streamer.WaitIdle();
+
+    std::vector<ysAssetStreamer::Completion> completed;
+    EXPECT_EQ(streamer.Collect(&completed, 100), 1);
+    EXPECT_EQ(streamer.Collect(&completed, 150), 1);
+
+    // Larger than the budget on its own, still collected so it can't stall
+    EXPECT_EQ(streamer.Collect(&completed, 100), 1);
+    EXPECT_EQ(completed.back().Data.size(), 200);
+
+    EXPECT_EQ(streamer.Collect(&completed, 100), 1);
+    EXPECT_EQ(completed.back().Key, 3);
+    EXPECT_FALSE(completed.back().Success);
+
+    EXPECT_EQ(streamer.Collect(&completed, 100), 0);
+}
+
+TEST(AssetStreamingTest, RequestsReturnImmediately) {
+    ysAssetStreamer streamer;
+    streamer.Initialize();
+
+    Gate gate;
+    streamer.Request(0, WaitForGate, &gate, 16);
+    streamer.Request(1, LoadBytes, nullptr, 8);
+
+    // Nothing can finish while the I/O thread is blocked
+    std::vector<ysAssetStreamer::Completion> completed;
+    EXPECT_EQ(streamer.Collect(&completed), 0);
+    EXPECT_EQ(streamer.GetPendingCount(), 2);
+
+    gate.Open = true;
+    streamer.WaitIdle();
+    EXPECT_EQ(streamer.Collect(&completed), 2);
+}
+
+TEST(AssetStreamingTest, DestroyDropsQueuedLoads) {
+    std::atomic<int> loads(0);
+
+    {
+        ysAssetStreamer streamer;
+        streamer.Initialize();
+
+        Gate gate;
+        streamer.Request(0, WaitForGate, &gate, 1);
+        for (int i = 0; i < 10; ++i) streamer.Request(i + 1, LoadBytes, &loads, i);
+
+        gate.Open = true;
+        streamer.Destroy();
+
+        EXPECT_FALSE(streamer.IsInitialized());
+        EXPECT_EQ(streamer.GetPendingCount(), 0);
+    }
+
+    EXPECT_LE(loads.load(), 10);
+}
+
+TEST(AssetStreamingTest, ResidencyEvictsLeastRecentlyUsed) {
+    ysResidencySet residency;
+    residency.SetBudget(300);
+
+    for (int i = 0; i < 4; ++i) residency.Add(i, 100);
+    EXPECT_EQ(residency.GetResidentBytes(), 400);
+
+    // Nothing is evicted while everything was used this frame
+    std::vector<uint64_t> evicted;
+    EXPECT_EQ(residency.Evict(&evicted), 0);
+
+    residency.NextFrame();
+    residency.NextFrame();
+    residency.Touch(0);
+
+    EXPECT_EQ(residency.Evict(&evicted), 1);
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], 1);
+
+    EXPECT_FALSE(residency.IsResident(1));
+    EXPECT_TRUE(residency.IsResident(0));
+    EXPECT_EQ(residency.GetResidentBytes(), 300);
+    EXPECT_EQ(residency.GetResidentCount(), 3);
+
+    residency.SetBudget(100);
+    evicted.clear();
+    EXPECT_EQ(residency.Evict(&evicted), 2);
+    EXPECT_EQ(evicted, std::vector<uint64_t>({ 2, 3 }));
+}
+
+TEST(AssetStreamingTest, ResidencyKeepsRecentlyUsedAssets) {
+    ysResidencySet residency;
+    residency.SetBudget(100);
+
+    residency.Add(0, 100);
+    residency.NextFrame();
+    residency.Add(1, 100);
+
+    // Used last frame, may still be referenced by the GPU
+    std::vector<uint64_t> evicted;
+    EXPECT_EQ(residency.Evict(&evicted), 0);
+
+    residency.NextFrame();
+    EXPECT_EQ(residency.Evict(&evicted), 1);
+    EXPECT_EQ(evicted[0], 0);
+
+    // Re-adding updates the size instead of counting twice
+    residency.Add(1, 50);
+    EXPECT_EQ(residency.GetResidentBytes(), 50);
+
+    residency.Remove(1);
+    residency.Touch(1);
+    EXPECT_EQ(residency.GetResidentBytes(), 0);
+    EXPECT_EQ(residency.GetResidentCount(), 0);
+}
+
+TEST(AssetStreamingTest, UnlimitedBudget) {
+    ysResidencySet residency;
+
+    for (int i = 0; i < 10; ++i) residency.Add(i, 1000);
+    residency.NextFrame();
+    residency.NextFrame();
+
+    std::vector<uint64_t> evicted;
+    EXPECT_EQ(residency.Evict(&evicted), 0);
+    EXPECT_EQ(residency.GetResidentCount(), 10);
+
+    residency.Clear();
+    EXPECT_EQ(residency.GetResidentCount(), 0);
+    EXPECT_EQ(residency.GetResidentBytes(), 0);
+    EXPECT_FALSE(residency.IsResident(3));
+}
@@ -0,0 +1,44 @@
+#include <pch.h>
+
+#include "../include/yds_breakdown_timer.h"
+#include "../include/yds_breakdown_timer_channel.h"
+
+TEST(BreakdownTimerTest, ChannelIds) {
+    ysBreakdownTimer timer;
+    ysBreakdownTimerChannel *a = timer.CreateChannel("A");
+    ysBreakdownTimerChannel *b = timer.CreateChannel("B");
+
+    EXPECT_EQ(a->GetId(), 0);
+    EXPECT_EQ(b->GetId(), 1);
+    EXPECT_EQ(timer.FindChannelId("B"), b->GetId());
+    EXPECT_EQ(timer.FindChannelId(ysBreakdownTimer::HashName("A")), a->GetId());
+    EXPECT_EQ(timer.FindChannelId("C"), ysBreakdownTimer::InvalidChannel);
+}
+
+TEST(BreakdownTimerTest, NestedScopes) {
+    ysBreakdownTimer timer;
+    const ysBreakdownTimer::ChannelId outer = timer.CreateChannel("Outer")->GetId();
+    const ysBreakdownTimer::ChannelId inner = timer.CreateChannel("Inner")->GetId();
+
+    timer.StartFrame();
+    {
+        YDS_PROFILE_SCOPE(&timer, outer);
+        {
+            YDS_PROFILE_SCOPE(&timer, inner);
+
+            // Re-entering a channel only measures the outermost scope
+            YDS_PROFILE_SCOPE(&timer, inner);
+            EXPECT_TRUE(timer.GetChannel(inner)->IsMidMeasurement());
+        }
+        EXPECT_FALSE(timer.GetChannel(inner)->IsMidMeasurement());
+    }
+    timer.EndFrame();
+
+    EXPECT_EQ(timer.GetChannel(outer)->GetEntryCount(), 1);
+    EXPECT_EQ(timer.GetChannel(inner)->GetEntryCount(), 1);
+    EXPECT_GE(timer.GetChannel(outer)->GetLastSample(), timer.GetChannel(inner)->GetLastSample());
+
+    EXPECT_EQ(timer.GetExecutionOrderLength(), 3);
+    EXPECT_EQ(timer.GetExecutionOrder(0), outer);
+    EXPECT_EQ(timer.GetExecutionOrder(1), inner);
+}
@@ -0,0 +1,129 @@
+#include <pch.h>
+
+#include "../include/yds_dynamic_array.h"
+#include "../include/yds_expanding_array.h"
+
+class TestElement : public ysDynamicArrayElement {
+public:
+    int Value = 0;
+};
+
+TEST(ContainerTest, DynamicArraySteadyStateNoAllocations) {
+    ysDynamicArray<TestElement> arr;
+
+    for (int i = 0; i < 64; i++) arr.New()->Value = i;
+
+    const int allocations = arr.GetAllocationCount();
+
+    // Oscillate around a power of two, as a per-frame contact list would
+    for (int frame = 0; frame < 100; frame++) {
+        for (int i = 0; i < 8; i++) arr.New();
+        for (int i = 0; i < 8; i++) arr.Delete(arr.GetNumObjects() - 1);
+    }
+
+    EXPECT_EQ(arr.GetAllocationCount(), allocations);
+    EXPECT_EQ(arr.GetNumObjects(), 64);
+}
+
+TEST(ContainerTest, DynamicArrayClearKeepsCapacity) {
+    ysDynamicArray<TestElement> arr;
+
+    for (int i = 0; i < 100; i++) arr.New();
+    const int capacity = arr.GetCapacity();
+    const int allocations = arr.GetAllocationCount();
+
+    for (int frame = 0; frame < 10; frame++) {
+        arr.Clear();
+        for (int i = 0; i < 100; i++) arr.New();
+    }
+
+    EXPECT_EQ(arr.GetCapacity(), capacity);
+    EXPECT_EQ(arr.GetAllocationCount(), allocations);
+}
+
+TEST(ContainerTest, DynamicArrayReserveAndShrink) {
+    ysDynamicArray<TestElement> arr;
+    arr.Reserve(256);
+
+    EXPECT_EQ(arr.GetCapacity(), 256);
+    EXPECT_EQ(arr.GetAllocationCount(), 1);
+
+    for (int i = 0; i < 256; i++) arr.New()->Value = i;
+    for (int i = 0; i < 250; i++) arr.Delete(arr.GetNumObjects() - 1);
+
+    // Reserved capacity is never condensed
+    EXPECT_EQ(arr.GetCapacity(), 256);
+    EXPECT_EQ(arr.GetAllocationCount(), 1);
+
+    arr.ShrinkToFit();
+    EXPECT_EQ(arr.GetCapacity(), 6);
+
+    for (int i = 0; i < arr.GetNumObjects(); i++) {
+        EXPECT_EQ(arr.Get(i)->Value, i);
+        EXPECT_EQ(arr.Get(i)->GetIndex(), i);
+    }
+}
+
+TEST(ContainerTest, DynamicArrayCondense) {
+    ysDynamicArray<TestElement> arr;
+
+    for (int i = 0; i < 1000; i++) arr.New();
+    const int capacity = arr.GetCapacity();
+
+    for (int i = 0; i < 990; i++) arr.Delete(0);
+
+    EXPECT_LT(arr.GetCapacity(), capacity);
+    EXPECT_EQ(arr.GetNumObjects(), 10);
+}
+
+TEST(ContainerTest, ExpandingArrayReservePreservesContents) {
+    ysExpandingArray<int> arr;
+    for (int i = 0; i < 10; i++) arr.New() = i;
+
+    arr.Reserve(1000);
+    EXPECT_EQ(arr.GetCapacity(), 1000);
+
+    for (int i = 0; i < 10; i++) EXPECT_EQ(arr[i], i);
+
+    const int allocations = arr.GetAllocationCount();
+    for (int i = 0; i < 990; i++) arr.New() = i;
+
+    EXPECT_EQ(arr.GetAllocationCount(), allocations);
+}
+
+TEST(ContainerTest, ExpandingArrayMoveTransfersAllocationCount) {
+    ysExpandingArray<int> arr;
+    for (int i = 0; i < 100; i++) arr.New() = i;
+
+    const int allocations = arr.GetAllocationCount();
+
+    ysExpandingArray<int> moved(std::move(arr));
+    EXPECT_EQ(moved.GetAllocationCount(), allocations);
+    EXPECT_EQ(arr.GetAllocationCount(), 0);
+
+    ysExpandingArray<int> assigned;
+    assigned.New() = 0;
+    assigned = std::move(moved);
+    EXPECT_EQ(assigned.GetAllocationCount(), allocations);
+    EXPECT_EQ(moved.GetAllocationCount(), 0);
+    EXPECT_EQ(assigned[99], 99);
+}
+
+TEST(ContainerTest, ExpandingArrayNestedGrowth) {
+    ysExpandingArray<ysExpandingArray<int, 4>> arr;
+
+    for (int i = 0; i < 100; i++) {
+        ysExpandingArray<int, 4> &inner = arr.New();
+        for (int j = 0; j < i; j++) inner.New() = j;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(arr[i].GetNumObjects(), i);
+        for (int j = 0; j < i; j++) EXPECT_EQ(arr[i][j], j);
+    }
+
+    arr.Insert(0).New() = -1;
+    EXPECT_EQ(arr[0].GetNumObjects(), 1);
+    EXPECT_EQ(arr[1].GetNumObjects(), 0);
+    EXPECT_EQ(arr[100].GetNumObjects(), 99);
+}
@@ -0,0 +1,111 @@
+#include <pch.h>
+
+#include "../include/yds_error_system.h"
+#include "../include/yds_error_handler.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+    class CountingErrorHandler : public ysErrorHandler {
+    public:
+        virtual void OnError(ysError error, unsigned int line, ysObject *object, const char *file) {
+            (void)line;
+            (void)object;
+            (void)file;
+
+            LastError = error;
+            ++Count;
+        }
+
+        ysError LastError = ysError::None;
+        int Count = 0;
+    };
+
+    class Caller : public ysObject {
+    public:
+        ysError Succeed() {
+            YDS_ERROR_DECLARE("Succeed");
+            return YDS_ERROR_RETURN(ysError::None);
+        }
+
+        ysError Fail() {
+            YDS_ERROR_DECLARE("Fail");
+            return YDS_ERROR_RETURN(ysError::InvalidParameter);
+        }
+
+        ysError Nested(int depth) {
+            YDS_ERROR_DECLARE("Nested");
+
+            if (depth > 0) {
+                YDS_NESTED_ERROR_CALL(Nested(depth - 1));
+            }
+            else {
+                YDS_NESTED_ERROR_CALL(Fail());
+            }
+
+            return YDS_ERROR_RETURN(ysError::None);
+        }
+
+        ysError Current(const char **call) {
+            YDS_ERROR_DECLARE("Current");
+            *call = ysErrorSystem::GetCall();
+            return YDS_ERROR_RETURN(ysError::None);
+        }
+    };
+}
+
+TEST(ErrorSystemTest, StackBalanced) {
+    Caller caller;
+    const int level = ysErrorSystem::GetStackLevel();
+
+    EXPECT_EQ(caller.Succeed(), ysError::None);
+    EXPECT_EQ(ysErrorSystem::GetStackLevel(), level);
+
+    EXPECT_EQ(caller.Nested(10), ysError::InvalidParameter);
+    EXPECT_EQ(ysErrorSystem::GetStackLevel(), level);
+
+#ifndef YDS_DISABLE_ERROR_STACK
+    const char *call = nullptr;
+    caller.Current(&call);
+    EXPECT_STREQ(call, "Current");
+#endif /* YDS_DISABLE_ERROR_STACK */
+}
+
+TEST(ErrorSystemTest, HandlersOnlyCalledOnError) {
+    CountingErrorHandler *handler = nullptr;
+    ASSERT_EQ(ysErrorSystem::GetInstance()->AttachErrorHandler(&handler), ysError::None);
+
+    Caller caller;
+    caller.Succeed();
+    EXPECT_EQ(handler->Count, 0);
+
+    caller.Nested(3);
+    EXPECT_EQ(handler->Count, 1);
+    EXPECT_EQ(handler->LastError, ysError::InvalidParameter);
+
+    EXPECT_EQ(ysErrorSystem::GetInstance()->DetachErrorHandler(handler), ysError::None);
+    ysErrorSystem::Destroy();
+}
+
+TEST(ErrorSystemTest, ThreadLocalStacks) {
+    constexpr int Threads = 4;
+    constexpr int Iterations = 10000;
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(Threads, 0);
+    for (int t = 0; t < Threads; ++t) {
+        threads.push_back(std::thread([&failures, t]() {
+            Caller caller;
+            for (int i = 0; i < Iterations; ++i) {
+                caller.Nested(i % 8);
+                if (ysErrorSystem::GetStackLevel() != 0) ++failures[t];
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+    for (int t = 0; t < Threads; ++t) EXPECT_EQ(failures[t], 0);
+
+    ysErrorSystem::Destroy();
+}
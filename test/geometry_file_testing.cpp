@@ -191,8 +191,9 @@ TEST(GeometryFile, FullRipCompilation) {
 
     int objectCount = 1;
 
+    // Checks the version 1 layout, which starts with the object count
     ysGeometryExportFile exportFile;
-    exportFile.Open("../../../test/geometry_files/cube.dca");
+    exportFile.Open("../../../test/geometry_files/cube.dca", 1);
     exportFile.WriteCustomData((void *)&objectCount, sizeof(int));
     exportFile.WriteObject(&obj);
     exportFile.Close();
@@ -0,0 +1,201 @@
+#include <pch.h>
+
+#include "../include/yds_geometry_preprocessing.h"
+#include "../include/yds_allocator.h"
+
+namespace {
+    void AddFace(ysObjectData *object, int face, int a, int b, int c) {
+        object->m_vertexIndexSet[face].x = a;
+        object->m_vertexIndexSet[face].y = b;
+        object->m_vertexIndexSet[face].z = c;
+        object->m_smoothingGroups[face] = 0;
+    }
+
+    void Allocate(ysObjectData *object, int vertexCount, int faceCount) {
+        object->m_objectInformation.ObjectType = ysObjectData::ObjectType::Geometry;
+        object->m_objectStatistics.NumVertices = vertexCount;
+        object->m_objectStatistics.NumFaces = faceCount;
+
+        object->m_vertices.Allocate(vertexCount);
+        object->m_vertexIndexSet.Allocate(faceCount);
+        object->m_smoothingGroups.Allocate(faceCount);
+    }
+
+    // Flat grid of size x size quads in the XY plane, two triangles per quad
+    void MakeGrid(ysObjectData *object, int size) {
+        const int row = size + 1;
+        Allocate(object, row * row, size * size * 2);
+
+        for (int y = 0; y <= size; ++y) {
+            for (int x = 0; x <= size; ++x) {
+                object->m_vertices[y * row + x] = ysVector3((float)x, (float)y, 0.0f);
+            }
+        }
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const int v = y * row + x;
+                const int face = (y * size + x) * 2;
+
+                AddFace(object, face + 0, v, v + 1, v + row + 1);
+                AddFace(object, face + 1, v, v + row + 1, v + row);
+            }
+        }
+    }
+
+    void MakeCube(ysObjectData *object) {
+        Allocate(object, 8, 12);
+
+        for (int i = 0; i < 8; ++i) {
+            object->m_vertices[i] = ysVector3((float)(i & 1), (float)((i >> 1) & 1), (float)((i >> 2) & 1));
+        }
+
+        const int quads[6][4] = {
+            { 0, 4, 6, 2 }, { 1, 3, 7, 5 },
+            { 0, 1, 5, 4 }, { 2, 6, 7, 3 },
+            { 0, 2, 3, 1 }, { 4, 5, 7, 6 }
+        };
+
+        for (int i = 0; i < 6; ++i) {
+            AddFace(object, i * 2 + 0, quads[i][0], quads[i][1], quads[i][2]);
+            AddFace(object, i * 2 + 1, quads[i][0], quads[i][2], quads[i][3]);
+        }
+    }
+
+    void Smooth(ysObjectData *object) {
+        ysGeometryPreprocessing::ResolveSmoothingGroupAmbiguity(object);
+        ysGeometryPreprocessing::CreateAutomaticSmoothingGroups(object);
+        ysGeometryPreprocessing::SeparateBySmoothingGroups(object);
+    }
+
+    void FreeCache(ysObjectData *object) {
+        ysAllocator::BlockFree(object->m_hardNormalCache, 16);
+        object->m_hardNormalCache = nullptr;
+    }
+}
+
+TEST(GeometryPreprocessingTest, FaceAdjacency) {
+    ysObjectData object;
+    MakeGrid(&object, 4);
+
+    ysGeometryPreprocessing::FaceAdjacency adjacency;
+    ysGeometryPreprocessing::BuildFaceAdjacency(&object, &adjacency);
+
+    EXPECT_EQ(adjacency.Faces.size(), 3 * 4 * 4 * 2);
+
+    // Corners on the split diagonal touch two faces, the others one
+    EXPECT_EQ(adjacency.GetFaceCount(0), 2);
+    EXPECT_EQ(adjacency.GetFaceCount(4), 1);
+
+    // Interior vertices are shared by six faces
+    const int interior = 2 * 5 + 2;
+    ASSERT_EQ(adjacency.GetFaceCount(interior), 6);
+    for (int i = 0; i < 6; ++i) {
+        const int face = adjacency.GetFaces(interior)[i];
+        EXPECT_TRUE(ysGeometryPreprocessing::IncludesVertex(&object, face, interior));
+    }
+}
+
+TEST(GeometryPreprocessingTest, SpreadSmoothingGroup) {
+    ysObjectData object;
+    MakeCube(&object);
+
+    // Alternating groups so that every pair of neighbours differs
+    object.m_extendedSmoothingGroups.Allocate(12);
+    for (int face = 0; face < 12; ++face) {
+        object.m_smoothingGroups[face] = 1 << (face % 2);
+        object.m_extendedSmoothingGroups[face] = -1;
+    }
+
+    ysVector *normals = ysGeometryPreprocessing::CalculateHardNormals(&object);
+
+    ysGeometryPreprocessing::FaceAdjacency adjacency;
+    ysGeometryPreprocessing::BuildFaceAdjacency(&object, &adjacency);
+
+    // Each side of the cube is its own group
+    for (int side = 0; side < 6; ++side) {
+        int count = 0;
+        ysGeometryPreprocessing::SpreadSmoothingGroup(&object, adjacency, side * 2, side, normals, &count);
+
+        EXPECT_EQ(count, 2);
+        EXPECT_EQ(object.m_extendedSmoothingGroups[side * 2 + 1], side);
+    }
+
+    FreeCache(&object);
+}
+
+TEST(GeometryPreprocessingTest, FlatGridIsOneGroup) {
+    ysObjectData object;
+    MakeGrid(&object, 8);
+
+    Smooth(&object);
+
+    // Neighbouring faces got different smoothing groups but all face the same way
+    for (int face = 0; face < object.m_objectStatistics.NumFaces; ++face) {
+        EXPECT_NE(object.m_smoothingGroups[face], 0);
+    }
+
+    EXPECT_EQ(object.m_numExtendedSmoothingGroups, 1);
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, 9 * 9);
+
+    FreeCache(&object);
+}
+
+TEST(GeometryPreprocessingTest, CubeHasHardEdges) {
+    ysObjectData object;
+    MakeCube(&object);
+
+    Smooth(&object);
+    EXPECT_EQ(object.m_numExtendedSmoothingGroups, 6);
+
+    // Every corner is split three ways
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, 24);
+
+    ysGeometryPreprocessing::CalculateNormals(&object);
+    for (int face = 0; face < object.m_objectStatistics.NumFaces; ++face) {
+        const ysVector3 n0 = object.m_normals[object.m_vertexIndexSet[face].x];
+        const ysVector3 n1 = object.m_normals[object.m_vertexIndexSet[face].y];
+
+        EXPECT_NEAR(n0.x * n1.x + n0.y * n1.y + n0.z * n1.z, 1.0f, 1E-4f);
+    }
+
+    FreeCache(&object);
+}
+
+TEST(GeometryPreprocessingTest, UVSeams) {
+    ysObjectData object;
+    MakeGrid(&object, 1);
+
+    object.m_objectStatistics.NumUVChannels = 1;
+    object.m_UVIndexSets.Allocate(1);
+    object.m_UVIndexSets[0].UVIndexSets.Allocate(2);
+
+    // The triangles agree on the shared corner at vertex 0 but not at vertex 3
+    object.m_UVIndexSets[0].UVIndexSets[0].x = 0;
+    object.m_UVIndexSets[0].UVIndexSets[0].y = 1;
+    object.m_UVIndexSets[0].UVIndexSets[0].z = 2;
+    object.m_UVIndexSets[0].UVIndexSets[1].x = 0;
+    object.m_UVIndexSets[0].UVIndexSets[1].y = 4;
+    object.m_UVIndexSets[0].UVIndexSets[1].z = 3;
+
+    ysGeometryPreprocessing::SeparateByUVGroups(&object, 0);
+
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, 5);
+    EXPECT_EQ(object.m_vertexIndexSet[1].x, 0);
+    EXPECT_EQ(object.m_vertexIndexSet[1].y, 4);
+    EXPECT_EQ(object.m_vertexIndexSet[0].z, 3);
+}
+
+TEST(GeometryPreprocessingTest, LargeMesh) {
+    // Large enough that a quadratic or recursive pass would not finish
+    ysObjectData object;
+    MakeGrid(&object, 300);
+
+    Smooth(&object);
+    ysGeometryPreprocessing::CalculateNormals(&object);
+
+    EXPECT_EQ(object.m_numExtendedSmoothingGroups, 1);
+    EXPECT_EQ(object.m_objectStatistics.NumVertices, 301 * 301);
+
+    FreeCache(&object);
+}
@@ -0,0 +1,124 @@
+#include <pch.h>
+
+#include "../include/yds_job_system.h"
+
+#include <vector>
+
+namespace {
+    void Increment(void *data, int) {
+        reinterpret_cast<std::atomic<int> *>(data)->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct SpawnData {
+        ysJobSystem *JobSystem;
+        std::atomic<int> *Total;
+        int Depth;
+    };
+
+    // Each job spawns two children and waits on them from inside the job
+    void Spawn(void *data, int) {
+        SpawnData *spawn = reinterpret_cast<SpawnData *>(data);
+        spawn->Total->fetch_add(1, std::memory_order_relaxed);
+
+        if (spawn->Depth == 0) return;
+
+        SpawnData child = *spawn;
+        child.Depth = spawn->Depth - 1;
+
+        ysJobSystem::Job jobs[2] = {
+            { Spawn, &child, 0 },
+            { Spawn, &child, 1 }
+        };
+
+        ysJobCounter counter;
+        spawn->JobSystem->Run(jobs, 2, &counter);
+        spawn->JobSystem->Wait(&counter);
+    }
+}
+
+TEST(JobSystemTest, RunAndWait) {
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(4);
+
+    std::atomic<int> total(0);
+    ysJobCounter counter;
+    for (int i = 0; i < 1000; ++i) {
+        jobSystem.Run({ Increment, &total, i }, &counter);
+    }
+
+    jobSystem.Wait(&counter);
+
+    EXPECT_TRUE(counter.IsDone());
+    EXPECT_EQ(total.load(), 1000);
+
+    jobSystem.Destroy();
+}
+
+TEST(JobSystemTest, ParallelFor) {
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(4);
+
+    std::vector<int> values(100000, 0);
+    jobSystem.ParallelFor(0, (int)values.size(), 64, [&values](int begin, int end) {
+        for (int i = begin; i < end; ++i) values[i] += i;
+    });
+
+    for (int i = 0; i < (int)values.size(); ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+
+    jobSystem.Destroy();
+}
+
+TEST(JobSystemTest, NestedWaits) {
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(4);
+
+    std::atomic<int> total(0);
+    SpawnData root = { &jobSystem, &total, 12 };
+
+    ysJobCounter counter;
+    jobSystem.Run({ Spawn, &root, 0 }, &counter);
+    jobSystem.Wait(&counter);
+
+    EXPECT_EQ(total.load(), (1 << 13) - 1);
+
+    jobSystem.Destroy();
+}
+
+TEST(JobSystemTest, StressExternalProducers) {
+    ysJobSystem jobSystem;
+    jobSystem.Initialize(4);
+
+    constexpr int Producers = 4;
+    constexpr int JobsPerProducer = 20000;
+
+    std::atomic<int> total(0);
+    ysJobCounter counters[Producers];
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < Producers; ++p) {
+        producers.push_back(std::thread([&jobSystem, &total, &counters, p]() {
+            EXPECT_EQ(jobSystem.GetCurrentWorkerIndex(), -1);
+
+            for (int i = 0; i < JobsPerProducer; ++i) {
+                jobSystem.Run({ Increment, &total, i }, &counters[p]);
+            }
+
+            jobSystem.Wait(&counters[p]);
+        }));
+    }
+
+    // The main thread is a worker too and helps until everything is done
+    for (int round = 0; round < 100; ++round) {
+        jobSystem.ParallelFor(0, 1000, 1, [&total](int begin, int end) {
+            total.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    }
+
+    for (std::thread &producer : producers) producer.join();
+
+    EXPECT_EQ(total.load(), Producers * JobsPerProducer + 100 * 1000);
+
+    jobSystem.Destroy();
+}
@@ -0,0 +1,158 @@
+#include <pch.h>
+
+#define YS_ENABLE_LOGGING
+#define YDS_LOG_MIN_LEVEL YDS_LOG_LEVEL_INFO
+#include "../include/yds_logger.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    class CaptureOutput : public ysLoggerOutput {
+    public:
+        CaptureOutput() : ysLoggerOutput("CaptureOutput") {
+            SetFormatParameters(0);
+            Flushes = 0;
+        }
+
+        virtual void Initialize() { /* void */ }
+        virtual void Close() { /* void */ }
+        virtual void Flush() { ++Flushes; }
+
+        std::vector<std::string> Messages;
+        int Flushes;
+
+    protected:
+        virtual void Write(const char *data) {
+            std::string message = data;
+            if (!message.empty() && message.back() == '\n') message.pop_back();
+            Messages.push_back(message);
+        }
+    };
+
+    void Encode(ysLogger::ArgumentWriter &writer, int value) { writer.WriteInt(value); }
+    void Encode(ysLogger::ArgumentWriter &writer, unsigned int value) { writer.WriteUnsignedInt(value); }
+    void Encode(ysLogger::ArgumentWriter &writer, double value) { writer.WriteDouble(value); }
+    void Encode(ysLogger::ArgumentWriter &writer, const char *value) { writer.WriteString(value); }
+
+    template<typename ... Args>
+    std::string Format(const char *format, Args ... args) {
+        ysLogger::Record record;
+        record.Header.Format = format;
+        record.Header.PayloadSize = 0;
+        record.Header.ArgumentCount = 0;
+        record.Header.Truncated = false;
+
+        ysLogger::ArgumentWriter writer(&record);
+        int expand[] = { 0, (Encode(writer, args), 0)... };
+        (void)expand;
+
+        char buffer[1024];
+        ysLogger::FormatRecord(record, buffer, sizeof(buffer));
+        return buffer;
+    }
+
+    int s_evaluations = 0;
+    int Evaluate() { return ++s_evaluations; }
+}
+
+TEST(LoggerTest, FormatRecord) {
+    EXPECT_EQ(Format("plain"), "plain");
+    EXPECT_EQ(Format("%d + %u = %s", -3, 5u, "two"), "-3 + 5 = two");
+    EXPECT_EQ(Format("%5.2f|%-4d|%x", 3.14159, 7, 255u), " 3.14|7   |ff");
+    EXPECT_EQ(Format("%*d", 4, 9), "   9");
+    EXPECT_EQ(Format("100%% %ld", 1), "100% 1");
+    EXPECT_EQ(Format("%d %d", 1), "1 <?>");
+
+    const std::string longString(1000, 'a');
+    const std::string truncated = Format("%s", longString.c_str());
+    EXPECT_LT(truncated.size(), longString.size());
+    EXPECT_EQ(truncated.substr(truncated.size() - 3), "...");
+}
+
+TEST(LoggerTest, DeferredWrites) {
+    ysLogger logger;
+    CaptureOutput *output = logger.NewLoggerOutput<CaptureOutput>();
+    ysLogger::LoggerCreate(&logger);
+
+    logger.Start();
+    for (int i = 0; i < 100; ++i) {
+        logger.LogMessage("message %d of %s", "test", i, YDS_LOG_LEVEL_INFO, i, "batch");
+    }
+
+    logger.Flush();
+
+    ASSERT_EQ(output->Messages.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(output->Messages[i], "message " + std::to_string(i) + " of batch");
+    }
+
+    EXPECT_GT(output->Flushes, 0);
+
+    logger.End();
+    EXPECT_FALSE(logger.IsRunning());
+}
+
+TEST(LoggerTest, CompileTimeLevelFilter) {
+    ysLogger logger;
+    CaptureOutput *output = logger.NewLoggerOutput<CaptureOutput>();
+    ysLogger::LoggerCreate(&logger);
+
+    s_evaluations = 0;
+    ysLogDebug("filtered %d", Evaluate());
+    ysLogInfo("kept %d", Evaluate());
+    ysLogMessage("also kept", YDS_LOG_LEVEL_ERROR);
+
+    // Not started, so messages are written synchronously
+    EXPECT_EQ(s_evaluations, 1);
+    ASSERT_EQ(output->Messages.size(), 2u);
+    EXPECT_EQ(output->Messages[0], "kept 1");
+    EXPECT_EQ(output->Messages[1], "also kept");
+}
+
+TEST(LoggerTest, MultipleProducers) {
+    constexpr int Threads = 4;
+    constexpr int MessagesPerThread = 5000;
+
+    for (int policy = 0; policy < 3; ++policy) {
+        ysLogger logger;
+        CaptureOutput *output = logger.NewLoggerOutput<CaptureOutput>();
+        logger.SetOverflowPolicy((ysLogger::OverflowPolicy)policy);
+        logger.Start();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < Threads; ++t) {
+            threads.push_back(std::thread([&logger, t]() {
+                for (int i = 0; i < MessagesPerThread; ++i) {
+                    logger.LogMessage("thread %d message %d", "test", 0, YDS_LOG_LEVEL_INFO, t, i);
+                }
+            }));
+        }
+
+        for (std::thread &thread : threads) thread.join();
+        logger.End();
+
+        const uint64_t written = output->Messages.size();
+        const uint64_t dropped = logger.GetDroppedMessageCount();
+        EXPECT_EQ(written + dropped, (uint64_t)(Threads * MessagesPerThread));
+
+        if (logger.GetOverflowPolicy() != ysLogger::OverflowPolicy::Drop) {
+            EXPECT_EQ(dropped, 0u);
+        }
+
+        // Each thread's messages stay in the order they were logged
+        int last[Threads] = { -1, -1, -1, -1 };
+        for (const std::string &message : output->Messages) {
+            const size_t split = message.find(" message ");
+            ASSERT_NE(split, std::string::npos);
+
+            const int t = std::stoi(message.substr(7, split - 7));
+            const int i = std::stoi(message.substr(split + 9));
+            ASSERT_TRUE(t >= 0 && t < Threads);
+            EXPECT_GT(i, last[t]);
+            last[t] = i;
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include <pch.h>
+
+#include "../include/yds_memory_mapped_file.h"
+
+#include <fstream>
+#include <string>
+
+namespace {
+    void WriteFile(const char *fname, const std::string &contents) {
+        std::ofstream file(fname, std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), contents.size());
+    }
+}
+
+TEST(MemoryMappedFileTest, MapsWholeFile) {
+    std::string contents;
+    for (int i = 0; i < 10000; ++i) contents += (char)(i * 31);
+    WriteFile("mapped_file_test.bin", contents);
+
+    ysMemoryMappedFile file;
+    ASSERT_EQ(file.Open("mapped_file_test.bin"), ysError::None);
+    EXPECT_TRUE(file.IsOpen());
+    ASSERT_EQ(file.GetSize(), contents.size());
+    EXPECT_EQ(std::string(file.GetData(), file.GetSize()), contents);
+
+    file.Close();
+    EXPECT_FALSE(file.IsOpen());
+    EXPECT_EQ(file.GetData(), nullptr);
+    EXPECT_EQ(file.GetSize(), 0);
+}
+
+TEST(MemoryMappedFileTest, EmptyFile) {
+    WriteFile("mapped_file_empty.bin", "");
+
+    ysMemoryMappedFile file;
+    ASSERT_EQ(file.Open("mapped_file_empty.bin"), ysError::None);
+    EXPECT_TRUE(file.IsOpen());
+    EXPECT_EQ(file.GetSize(), 0);
+    EXPECT_EQ(file.GetData(), nullptr);
+}
+
+TEST(MemoryMappedFileTest, MissingFile) {
+    ysMemoryMappedFile file;
+    EXPECT_EQ(file.Open("mapped_file_does_not_exist.bin"), ysError::CouldNotOpenFile);
+    EXPECT_FALSE(file.IsOpen());
+}
+
+TEST(MemoryMappedFileTest, Reopen) {
+    WriteFile("mapped_file_a.bin", "first");
+    WriteFile("mapped_file_b.bin", "second file");
+
+    ysMemoryMappedFile file;
+    ASSERT_EQ(file.Open("mapped_file_a.bin"), ysError::None);
+    ASSERT_EQ(file.Open("mapped_file_b.bin"), ysError::None);
+    EXPECT_EQ(std::string(file.GetData(), file.GetSize()), "second file");
+}
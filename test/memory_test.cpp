@@ -0,0 +1,246 @@
+#include <pch.h>
+
+#include "../include/yds_allocator.h"
+#include "../include/yds_frame_allocator.h"
+#include "../include/yds_slab_allocator.h"
+
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace {
+    int s_hookAllocations = 0;
+    int s_hookFrees = 0;
+
+    void CountingHook(ysAllocator::Event event, void *, size_t, int) {
+        if (event == ysAllocator::Event::Allocate) ++s_hookAllocations;
+        else ++s_hookFrees;
+    }
+}
+
+TEST(MemoryTest, AllocatorAlignment) {
+    for (int i = 1; i < 64; ++i) {
+        void *block = ysAllocator::BlockAllocate<64>(i);
+        EXPECT_EQ((uintptr_t)block % 64, 0);
+        ysAllocator::BlockFree(block, 64);
+    }
+
+    const size_t pageSize = ysAllocator::GetPageSize();
+    void *page = ysAllocator::PageAllocate(3 * pageSize);
+    EXPECT_EQ((uintptr_t)page % pageSize, 0);
+    ysAllocator::PageFree(page, 3 * pageSize);
+}
+
+TEST(MemoryTest, AllocatorHook) {
+    s_hookAllocations = s_hookFrees = 0;
+    ysAllocator::SetAllocationHook(CountingHook);
+
+    int *data = ysAllocator::TypeAllocate<int, 16>(8);
+    ysAllocator::TypeFree(data, 8, true, 16);
+
+    ysAllocator::SetAllocationHook(nullptr);
+
+    EXPECT_EQ(s_hookAllocations, 1);
+    EXPECT_EQ(s_hookFrees, 1);
+}
+
+TEST(MemoryTest, FrameAllocatorAlignment) {
+    ysFrameAllocator allocator;
+    allocator.Initialize(4 * KB);
+    allocator.StartFrame();
+
+    for (int i = 1; i < 64; ++i) {
+        void *block = allocator.AllocateBlock(i);
+        EXPECT_EQ((uintptr_t)block % ysFrameAllocator::Alignment, 0);
+    }
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, FrameAllocatorDoubleBuffered) {
+    ysFrameAllocator allocator;
+    allocator.Initialize(4 * KB);
+
+    allocator.StartFrame();
+    int *a = allocator.Allocate<int>(4);
+    a[0] = 10;
+
+    // Blocks from the previous frame are still valid
+    allocator.StartFrame();
+    int *b = allocator.Allocate<int>(4);
+    b[0] = 20;
+
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a[0], 10);
+
+    // Two frames later the first arena is reused
+    allocator.StartFrame();
+    int *c = allocator.Allocate<int>(4);
+
+    EXPECT_EQ(a, c);
+    EXPECT_EQ(b[0], 20);
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, FrameAllocatorGrowsToSteadyState) {
+    ysFrameAllocator allocator;
+    allocator.Initialize(1 * KB);
+
+    for (int frame = 0; frame < 4; ++frame) {
+        allocator.StartFrame();
+        for (int i = 0; i < 256; ++i) allocator.AllocateBlock(64);
+    }
+
+    const int overflows = allocator.GetOverflowCount();
+    EXPECT_GT(overflows, 0);
+
+    for (int frame = 0; frame < 16; ++frame) {
+        allocator.StartFrame();
+        for (int i = 0; i < 256; ++i) allocator.AllocateBlock(64);
+    }
+
+    EXPECT_EQ(allocator.GetOverflowCount(), overflows);
+    EXPECT_EQ(allocator.GetAllocationCount(), 256);
+    EXPECT_GE(allocator.GetHighWaterMark(), (size_t)(256 * 64));
+    EXPECT_GE(allocator.GetCapacity(), allocator.GetBytesAllocated());
+
+    allocator.StartFrame();
+    EXPECT_EQ(allocator.GetLastFrameAllocationCount(), 256);
+    EXPECT_EQ(allocator.GetAllocationCount(), 0);
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, FrameAllocatorFreeReturnsObjectCount) {
+    ysFrameAllocator *allocator = ysFrameAllocator::GetThreadAllocator();
+    allocator->StartFrame();
+
+    void *block = allocator->AllocateBlock(sizeof(float) * 12, 12);
+    EXPECT_EQ(allocator->FreeBlock(block), 12);
+}
+
+TEST(MemoryTest, SlabAllocatorReusesFreedBlocks) {
+    ysSlabAllocator allocator;
+
+    void *a = allocator.AllocateBlock(100);
+    allocator.FreeBlock(a);
+    void *b = allocator.AllocateBlock(100);
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ((uintptr_t)b % ysSlabAllocator::Alignment, 0);
+
+    allocator.FreeBlock(b);
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, SlabAllocatorObjectCount) {
+    ysSlabAllocator allocator;
+
+    float *small = allocator.Allocate<float>(16);
+    float *large = allocator.Allocate<float>(64 * KB);
+
+    EXPECT_EQ(allocator.GetStatistics().LargeBlocks, 1);
+    EXPECT_EQ(allocator.FreeBlock(small), 16);
+    EXPECT_EQ(allocator.FreeBlock(large), 64 * KB);
+    EXPECT_EQ(allocator.GetStatistics().LargeBlocks, 0);
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, SlabAllocatorManyLiveBlocks) {
+    ysSlabAllocator allocator;
+
+    // More than the 65535 block limit of ysDynamicAllocator
+    const int count = 100000;
+    std::vector<int *> blocks(count);
+    for (int i = 0; i < count; ++i) {
+        blocks[i] = allocator.Allocate<int>();
+        *blocks[i] = i;
+    }
+
+    ysSlabAllocator::Statistics stats = allocator.GetStatistics();
+    EXPECT_EQ(stats.LiveBlocks, (size_t)count);
+    EXPECT_EQ(stats.RequestedBytes, sizeof(int) * count);
+    EXPECT_GT(stats.InternalFragmentation, 0.0f);
+
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(*blocks[i], i);
+        allocator.Free(blocks[i]);
+    }
+
+    stats = allocator.GetStatistics();
+    EXPECT_EQ(stats.LiveBlocks, 0);
+    EXPECT_EQ(stats.AllocatedBytes, 0);
+    EXPECT_FLOAT_EQ(stats.ExternalFragmentation, 1.0f);
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, SlabAllocatorHugePages) {
+    ysSlabAllocator allocator;
+    allocator.Initialize(2 * MB, true);
+
+    int *blocks[64];
+    for (int i = 0; i < 64; ++i) {
+        blocks[i] = allocator.Allocate<int>(i + 1);
+        blocks[i][i] = i;
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        EXPECT_EQ(blocks[i][i], i);
+        EXPECT_EQ(allocator.FreeBlock(blocks[i]), i + 1);
+    }
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, SlabAllocatorMultithreaded) {
+    ysSlabAllocator allocator;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([&allocator, t]() {
+            std::vector<void *> blocks;
+            for (int i = 0; i < 10000; ++i) {
+                blocks.push_back(allocator.AllocateBlock(16 + (i % 512), t));
+                if (i % 3 == 0) {
+                    allocator.FreeBlock(blocks.back());
+                    blocks.pop_back();
+                }
+            }
+
+            for (void *block : blocks) allocator.FreeBlock(block);
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+
+    EXPECT_EQ(allocator.GetStatistics().LiveBlocks, 0);
+    EXPECT_EQ(allocator.GetStatistics().RequestedBytes, 0);
+
+    allocator.Destroy();
+}
+
+TEST(MemoryTest, SlabAllocatorReusesCachesOfExitedThreads) {
+    ysSlabAllocator allocator;
+
+    // More threads than there are caches, one at a time. Each picks up the
+    // cache left behind by the previous one and gets its block back.
+    void *previous = nullptr;
+    for (int t = 0; t < 2 * ysSlabAllocator::MaxThreadCaches; ++t) {
+        void *block = nullptr;
+        std::thread thread([&allocator, &block]() {
+            block = allocator.AllocateBlock(64);
+            allocator.FreeBlock(block);
+        });
+        thread.join();
+
+        if (previous != nullptr) EXPECT_EQ(block, previous);
+        previous = block;
+    }
+
+    EXPECT_EQ(allocator.GetStatistics().LiveBlocks, 0);
+
+    allocator.Destroy();
+}
@@ -0,0 +1,321 @@
+#include <pch.h>
+
+#include "../include/yds_mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <math.h>
+#include <random>
+
+namespace {
+    // Flat grid of size x size quads with one int per vertex as its data,
+    // two triangles per quad
+    void MakeGrid(int size, std::vector<char> *vertexData, std::vector<unsigned int> *indices) {
+        const int row = size + 1;
+
+        vertexData->resize(row * row * sizeof(int));
+        for (int i = 0; i < row * row; ++i) {
+            memcpy(vertexData->data() + i * sizeof(int), &i, sizeof(int));
+        }
+
+        indices->clear();
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const unsigned int v = y * row + x;
+                indices->insert(indices->end(), { v, v + 1, v + row + 1 });
+                indices->insert(indices->end(), { v, v + row + 1, v + row });
+            }
+        }
+    }
+
+    void ShuffleTriangles(std::vector<unsigned int> *indices, unsigned int seed) {
+        const int triangleCount = (int)(indices->size() / 3);
+
+        std::vector<int> order(triangleCount);
+        for (int i = 0; i < triangleCount; ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+        std::vector<unsigned int> shuffled;
+        for (int t : order) {
+            shuffled.insert(shuffled.end(), indices->begin() + t * 3, indices->begin() + t * 3 + 3);
+        }
+
+        indices->swap(shuffled);
+    }
+
+    // Triangles as sorted tuples of vertex data, independent of triangle
+    // order and vertex layout
+    std::vector<std::array<int, 3>> GetTriangleSet(
+        const std::vector<char> &vertexData, const std::vector<unsigned int> &indices)
+    {
+        std::vector<std::array<int, 3>> triangles;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            std::array<int, 3> triangle;
+            for (int j = 0; j < 3; ++j) {
+                memcpy(&triangle[j], vertexData.data() + indices[i + j] * sizeof(int), sizeof(int));
+            }
+
+            std::sort(triangle.begin(), triangle.end());
+            triangles.push_back(triangle);
+        }
+
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+} /* namespace */
+
+TEST(MeshOptimizerTest, WeldRemovesDuplicates) {
+    const int values[] = { 7, 3, 7, 5, 3, 7 };
+
+    std::vector<char> vertexData(sizeof(values));
+    memcpy(vertexData.data(), values, sizeof(values));
+
+    std::vector<unsigned int> indices = { 0, 1, 2, 3, 4, 5 };
+
+    const int vertexCount = ysMeshOptimizer::WeldVertices(vertexData, sizeof(int), indices);
+    EXPECT_EQ(vertexCount, 3);
+    EXPECT_EQ(vertexData.size(), 3 * sizeof(int));
+
+    const int *welded = reinterpret_cast<const int *>(vertexData.data());
+    EXPECT_EQ(welded[0], 7);
+    EXPECT_EQ(welded[1], 3);
+    EXPECT_EQ(welded[2], 5);
+
+    const std::vector<unsigned int> expected = { 0, 1, 0, 2, 1, 0 };
+    EXPECT_EQ(indices, expected);
+}
+
+TEST(MeshOptimizerTest, WeldKeepsUniqueVertices) {
+    std::vector<char> vertexData;
+    std::vector<unsigned int> indices;
+    MakeGrid(16, &vertexData, &indices);
+
+    const std::vector<char> originalData = vertexData;
+    const std::vector<unsigned int> originalIndices = indices;
+
+    EXPECT_EQ(ysMeshOptimizer::WeldVertices(vertexData, sizeof(int), indices), 17 * 17);
+    EXPECT_EQ(vertexData, originalData);
+    EXPECT_EQ(indices, originalIndices);
+}
+
+TEST(MeshOptimizerTest, AnalyzeVertexCache) {
+    // Two triangles sharing an edge, four transforms with any cache
+    const std::vector<unsigned int> quad = { 0, 1, 2, 2, 1, 3 };
+
+    ysMeshOptimizer::VertexCacheStatistics statistics =
+        ysMeshOptimizer::AnalyzeVertexCache(quad, 4);
+    EXPECT_EQ(statistics.TriangleCount, 2);
+    EXPECT_EQ(statistics.VertexCount, 4);
+    EXPECT_EQ(statistics.CacheMisses, 4);
+    EXPECT_FLOAT_EQ(statistics.Acmr, 2.0f);
+    EXPECT_FLOAT_EQ(statistics.Atvr, 1.0f);
+
+    // With a three entry FIFO vertex 0 is evicted by 3 before it's reused
+    const std::vector<unsigned int> fan = { 0, 1, 2, 1, 2, 3, 3, 0, 1 };
+
+    statistics = ysMeshOptimizer::AnalyzeVertexCache(fan, 4, 3);
+    EXPECT_EQ(statistics.CacheMisses, 6);
+    EXPECT_FLOAT_EQ(statistics.Atvr, 1.5f);
+}
+
+TEST(MeshOptimizerTest, VertexCacheImprovesShuffledGrid) {
+    std::vector<char> vertexData;
+    std::vector<unsigned int> indices;
+    MakeGrid(32, &vertexData, &indices);
+    ShuffleTriangles(&indices, 1234);
+
+    const int vertexCount = 33 * 33;
+    const std::vector<std::array<int, 3>> triangles = GetTriangleSet(vertexData, indices);
+    const ysMeshOptimizer::VertexCacheStatistics before =
+        ysMeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+
+    ysMeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+
+    const ysMeshOptimizer::VertexCacheStatistics after =
+        ysMeshOptimizer::AnalyzeVertexCache(indices, vertexCount);
+
+    EXPECT_EQ(GetTriangleSet(vertexData, indices), triangles);
+    EXPECT_GT(before.Acmr, 2.0f);
+    EXPECT_LT(after.Acmr, 0.8f);
+    EXPECT_LT(after.Atvr, 1.5f);
+}
+
+TEST(MeshOptimizerTest, VertexCacheKeepsDegenerateTriangles) {
+    std::vector<unsigned int> indices = { 0, 1, 2, 2, 2, 3, 3, 4, 5, 0, 0, 0 };
+    const int triangleCount = (int)(indices.size() / 3);
+
+    ysMeshOptimizer::OptimizeVertexCache(indices, 6);
+    ASSERT_EQ(indices.size(), triangleCount * 3);
+
+    std::vector<unsigned int> sorted = indices;
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<unsigned int> expected = { 0, 0, 0, 0, 1, 2, 2, 2, 3, 3, 4, 5 };
+    EXPECT_EQ(sorted, expected);
+}
+
+TEST(MeshOptimizerTest, VertexFetchOrdersByFirstUse) {
+    const int values[] = { 10, 11, 12, 13, 14 };
+
+    std::vector<char> vertexData(sizeof(values));
+    memcpy(vertexData.data(), values, sizeof(values));
+
+    // Vertex 1 is never referenced
+    std::vector<unsigned int> indices = { 4, 2, 0, 0, 3, 4 };
+
+    const int vertexCount = ysMeshOptimizer::OptimizeVertexFetch(vertexData, sizeof(int), indices);
+    EXPECT_EQ(vertexCount, 4);
+
+    const int *fetched = reinterpret_cast<const int *>(vertexData.data());
+    EXPECT_EQ(fetched[0], 14);
+    EXPECT_EQ(fetched[1], 12);
+    EXPECT_EQ(fetched[2], 10);
+    EXPECT_EQ(fetched[3], 13);
+
+    const std::vector<unsigned int> expected = { 0, 1, 2, 2, 3, 0 };
+    EXPECT_EQ(indices, expected);
+}
+
+TEST(MeshOptimizerTest, SplitMeshLimitsVertexCount) {
+    std::vector<char> vertexData;
+    std::vector<unsigned int> indices;
+    MakeGrid(16, &vertexData, &indices);
+
+    const int triangleCount = (int)(indices.size() / 3);
+    const std::vector<std::array<int, 3>> triangles = GetTriangleSet(vertexData, indices);
+
+    const std::vector<ysMeshOptimizer::Submesh> submeshes =
+        ysMeshOptimizer::SplitMesh(vertexData, sizeof(int), indices, 40);
+    ASSERT_GT(submeshes.size(), 1);
+
+    // Submeshes cover the triangles and vertices back to back
+    std::vector<unsigned int> absolute(indices.size());
+    int nextIndex = 0, nextVertex = 0;
+    for (const ysMeshOptimizer::Submesh &submesh : submeshes) {
+        EXPECT_EQ(submesh.BaseIndex, nextIndex);
+        EXPECT_EQ(submesh.BaseVertex, nextVertex);
+        EXPECT_LE(submesh.VertexCount, 40);
+
+        for (int i = 0; i < submesh.FaceCount * 3; ++i) {
+            const unsigned int index = indices[submesh.BaseIndex + i];
+            ASSERT_LT(index, (unsigned int)submesh.VertexCount);
+            absolute[submesh.BaseIndex + i] = index + submesh.BaseVertex;
+        }
+
+        nextIndex += submesh.FaceCount * 3;
+        nextVertex += submesh.VertexCount;
+    }
+
+    EXPECT_EQ(nextIndex, triangleCount * 3);
+    EXPECT_EQ(vertexData.size(), nextVertex * sizeof(int));
+    EXPECT_EQ(GetTriangleSet(vertexData, absolute), triangles);
+}
+
+namespace {
+    // Grid of size x size quads over [0, 1]^2 with heights from f, positions only
+    template <typename F>
+    void MakeHeightField(int size, F f, std::vector<float> *positions, std::vector<unsigned int> *indices) {
+        std::vector<char> unused;
+        MakeGrid(size, &unused, indices);
+
+        const int row = size + 1;
+        positions->clear();
+        for (int y = 0; y < row; ++y) {
+            for (int x = 0; x < row; ++x) {
+                const float u = (float)x / size, v = (float)y / size;
+                positions->insert(positions->end(), { u, v, f(u, v) });
+            }
+        }
+    }
+
+    bool IsBorder(const std::vector<float> &positions, unsigned int v) {
+        const float x = positions[v * 3 + 0], y = positions[v * 3 + 1];
+        return x == 0.0f || x == 1.0f || y == 0.0f || y == 1.0f;
+    }
+} /* namespace */
+
+TEST(MeshOptimizerTest, SimplifyFlatGridIsLossless) {
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    MakeHeightField(32, [](float, float) { return 0.0f; }, &positions, &indices);
+
+    float error = -1.0f;
+    const std::vector<unsigned int> simplified =
+        ysMeshOptimizer::SimplifyMesh(positions, indices, (int)indices.size() / 4, 1e-4f, &error);
+
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    EXPECT_GT(simplified.size(), 0);
+    EXPECT_LT(error, 1e-4f);
+
+    // Borders are locked, every border vertex is still there
+    std::vector<bool> used(positions.size() / 3, false);
+    for (unsigned int index : simplified) used[index] = true;
+
+    for (unsigned int v = 0; v < positions.size() / 3; ++v) {
+        if (IsBorder(positions, v)) {
+            EXPECT_TRUE(used[v]);
+        }
+    }
+
+    // Triangles keep facing +Z
+    for (size_t t = 0; t < simplified.size(); t += 3) {
+        const float *a = &positions[simplified[t] * 3];
+        const float *b = &positions[simplified[t + 1] * 3];
+        const float *c = &positions[simplified[t + 2] * 3];
+        const float z = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        EXPECT_GT(z, 0.0f);
+    }
+}
+
+TEST(MeshOptimizerTest, SimplifyRespectsErrorLimit) {
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    MakeHeightField(32, [](float u, float v) { return 0.1f * sinf(u * 3.0f) * cosf(v * 2.0f); }, &positions, &indices);
+
+    float error = 0.0f;
+    const std::vector<unsigned int> coarse = ysMeshOptimizer::SimplifyMesh(positions, indices, 0, 1e-3f, &error);
+    EXPECT_LE(error, 1e-3f);
+    EXPECT_LT(coarse.size(), indices.size());
+
+    // A looser limit goes further
+    const std::vector<unsigned int> coarser = ysMeshOptimizer::SimplifyMesh(positions, indices, 0, 1e-2f, &error);
+    EXPECT_LE(error, 1e-2f);
+    EXPECT_LT(coarser.size(), coarse.size());
+}
+
+TEST(MeshOptimizerTest, SimplifyKeepsSeams) {
+    std::vector<float> positions;
+    std::vector<unsigned int> indices;
+    MakeHeightField(16, [](float, float) { return 0.0f; }, &positions, &indices);
+
+    // Duplicate the vertices of the column at x = 0.5 for the right half as if
+    // it had different UVs
+    const int row = 17;
+    std::vector<unsigned int> seamCopies(row);
+    for (int y = 0; y < row; ++y) {
+        const unsigned int v = y * row + 8;
+        seamCopies[y] = (unsigned int)(positions.size() / 3);
+        positions.insert(positions.end(), { positions[v * 3], positions[v * 3 + 1], positions[v * 3 + 2] });
+    }
+
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        float centerX = 0.0f;
+        for (int i = 0; i < 3; ++i) centerX += positions[indices[t + i] * 3] / 3;
+        if (centerX < 0.5f) continue;
+
+        for (int i = 0; i < 3; ++i) {
+            const unsigned int v = indices[t + i];
+            if (v < (unsigned int)(row * row) && v % row == 8) indices[t + i] = seamCopies[v / row];
+        }
+    }
+
+    const std::vector<unsigned int> simplified = ysMeshOptimizer::SimplifyMesh(positions, indices, 0, 1e-4f);
+    EXPECT_LT(simplified.size(), indices.size());
+
+    std::vector<bool> used(positions.size() / 3, false);
+    for (unsigned int index : simplified) used[index] = true;
+
+    for (int y = 0; y < row; ++y) {
+        EXPECT_TRUE(used[y * row + 8]);
+        EXPECT_TRUE(used[seamCopies[y]]);
+    }
+}
@@ -0,0 +1,133 @@
+#include <pch.h>
+
+#include "../include/yds_metrics.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::string ReadFile(const char *fname) {
+        std::ifstream file(fname);
+        std::stringstream contents;
+        contents << file.rdbuf();
+
+        return contents.str();
+    }
+}
+
+TEST(MetricsTest, Registration) {
+    ysMetrics metrics;
+
+    const ysMetrics::MetricId contacts = metrics.RegisterCounter("Physics/Contacts");
+    const ysMetrics::MetricId memory = metrics.RegisterGauge("Assets/Memory");
+
+    EXPECT_NE(contacts, ysMetrics::InvalidMetric);
+    EXPECT_NE(memory, contacts);
+    EXPECT_EQ(metrics.RegisterCounter("Physics/Contacts"), contacts);
+    EXPECT_EQ(metrics.FindMetric("Assets/Memory"), memory);
+    EXPECT_EQ(metrics.FindMetric("Missing"), ysMetrics::InvalidMetric);
+
+    EXPECT_EQ(metrics.GetType(contacts), ysMetrics::Type::Counter);
+    EXPECT_EQ(metrics.GetType(memory), ysMetrics::Type::Gauge);
+    EXPECT_STREQ(metrics.GetName(contacts), "Physics/Contacts");
+}
+
+TEST(MetricsTest, CountersArePerFrame) {
+    ysMetrics metrics;
+    const ysMetrics::MetricId drawCalls = metrics.RegisterCounter("Render/DrawCalls");
+
+    metrics.Increment(drawCalls, 10);
+    metrics.Increment(drawCalls);
+    metrics.EndFrame();
+    EXPECT_EQ(metrics.GetValue(drawCalls), 11.0);
+
+    metrics.EndFrame();
+    EXPECT_EQ(metrics.GetValue(drawCalls), 0.0);
+
+    metrics.Increment(drawCalls, 4);
+    metrics.EndFrame();
+
+    const ysMetrics::Statistics &stats = metrics.GetStatistics(drawCalls);
+    EXPECT_EQ(stats.Min, 0.0);
+    EXPECT_EQ(stats.Max, 11.0);
+    EXPECT_EQ(stats.Total, 15.0);
+    EXPECT_EQ(stats.GetAverage(), 5.0);
+}
+
+TEST(MetricsTest, CountersAggregateThreads) {
+    constexpr int Threads = 8;
+    constexpr int Increments = 10000;
+
+    ysMetrics metrics;
+    const ysMetrics::MetricId counter = metrics.RegisterCounter("Jobs");
+
+    for (int frame = 0; frame < 3; ++frame) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < Threads; ++t) {
+            threads.push_back(std::thread([&metrics, counter]() {
+                for (int i = 0; i < Increments; ++i) metrics.Increment(counter);
+            }));
+        }
+
+        for (std::thread &thread : threads) thread.join();
+
+        metrics.EndFrame();
+        EXPECT_EQ(metrics.GetValue(counter), (double)(Threads * Increments));
+    }
+}
+
+TEST(MetricsTest, Gauges) {
+    ysMetrics metrics;
+    const ysMetrics::MetricId gauge = metrics.RegisterGauge("Assets/Textures");
+
+    metrics.SetGauge(gauge, 3.0);
+    metrics.AddGauge(gauge, 2.0);
+    metrics.EndFrame();
+    EXPECT_EQ(metrics.GetValue(gauge), 5.0);
+
+    // Gauges keep their value across frames
+    metrics.EndFrame();
+    EXPECT_EQ(metrics.GetValue(gauge), 5.0);
+}
+
+TEST(MetricsTest, WriteCsvAndJson) {
+    ysMetrics metrics;
+    const ysMetrics::MetricId counter = metrics.RegisterCounter("Counter");
+
+    metrics.StartRecording();
+    metrics.Increment(counter, 2);
+    metrics.EndFrame();
+
+    const ysMetrics::MetricId gauge = metrics.RegisterGauge("Gauge");
+    metrics.SetGauge(gauge, 7.5);
+    metrics.Increment(counter, 3);
+    metrics.EndFrame();
+    metrics.StopRecording();
+
+    EXPECT_EQ(metrics.GetRecordedFrameCount(), 2u);
+
+    ASSERT_EQ(metrics.WriteCsv("metrics_test.csv"), ysError::None);
+    EXPECT_EQ(ReadFile("metrics_test.csv"), "Frame,\"Counter\",\"Gauge\"\n0,2,\n1,3,7.5\n");
+
+    ASSERT_EQ(metrics.WriteJson("metrics_test.json"), ysError::None);
+    const std::string json = ReadFile("metrics_test.json");
+    EXPECT_NE(json.find("{\"name\":\"Counter\",\"type\":\"counter\",\"last\":3,\"min\":2,\"max\":3,\"average\":2.5,\"total\":5}"), std::string::npos);
+    EXPECT_NE(json.find("\"frames\":2"), std::string::npos);
+}
+
+TEST(MetricsTest, GetFromManyThreads) {
+    constexpr int Threads = 8;
+
+    // Threads racing on the first call must all see the same instance
+    ysMetrics *instances[Threads];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.push_back(std::thread([&instances, t]() { instances[t] = ysMetrics::Get(); }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+    for (int t = 0; t < Threads; ++t) EXPECT_EQ(instances[t], ysMetrics::Get());
+}
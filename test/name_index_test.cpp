@@ -0,0 +1,76 @@
+#include <pch.h>
+
+#include "../include/yds_name_index.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+    int Lookup(ysNameIndex *index, const std::vector<std::string> &names, const char *name) {
+        return index->Lookup(name, (int)names.size(), [&names](int i) { return names[i].c_str(); });
+    }
+}
+
+TEST(NameIndexTest, FindsEveryName) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 10000; ++i) names.push_back("Object_" + std::to_string(i));
+
+    ysNameIndex index;
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(Lookup(&index, names, names[i].c_str()), i);
+    }
+
+    EXPECT_EQ(index.GetIndexedCount(), 10000);
+    EXPECT_EQ(Lookup(&index, names, "Object_10000"), -1);
+    EXPECT_EQ(Lookup(&index, names, ""), -1);
+}
+
+TEST(NameIndexTest, IndexesNewObjectsLazily) {
+    std::vector<std::string> names = { "a", "b" };
+
+    ysNameIndex index;
+    EXPECT_EQ(Lookup(&index, names, "c"), -1);
+    EXPECT_EQ(index.GetIndexedCount(), 2);
+
+    names.push_back("c");
+    EXPECT_EQ(Lookup(&index, names, "c"), 2);
+    EXPECT_EQ(index.GetIndexedCount(), 3);
+
+    // Removing objects starts over
+    names.erase(names.begin());
+    EXPECT_EQ(Lookup(&index, names, "c"), 1);
+    EXPECT_EQ(Lookup(&index, names, "a"), -1);
+}
+
+TEST(NameIndexTest, FirstDuplicateWins) {
+    const std::vector<std::string> names = { "x", "Bone", "y", "Bone" };
+
+    ysNameIndex index;
+    EXPECT_EQ(Lookup(&index, names, "Bone"), 1);
+}
+
+TEST(NameIndexTest, RenamedObjects) {
+    std::vector<std::string> names = { "a", "b", "c" };
+
+    ysNameIndex index;
+    EXPECT_EQ(Lookup(&index, names, "b"), 1);
+
+    // The stale entry is caught and the linear search gives the right answer
+    names[1] = "d";
+    EXPECT_EQ(Lookup(&index, names, "b"), -1);
+
+    names[2] = "b";
+    EXPECT_EQ(Lookup(&index, names, "b"), 2);
+
+    // New names need the index to be rebuilt
+    EXPECT_EQ(Lookup(&index, names, "d"), -1);
+    index.Clear();
+    EXPECT_EQ(Lookup(&index, names, "d"), 1);
+}
+
+TEST(NameIndexTest, HashMatchesFnv1a) {
+    EXPECT_EQ(ysNameIndex::Hash(""), 14695981039346656037ull);
+    EXPECT_EQ(ysNameIndex::Hash("a"), 0xaf63dc4c8601ec8cull);
+
+    static_assert(ysNameIndex::Hash("a") == 0xaf63dc4c8601ec8cull, "Hash should be usable at compile time");
+}
@@ -0,0 +1,181 @@
+#include <pch.h>
+
+#include "../include/yds_profiler.h"
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST(ProfilerTest, DisabledRecordsNothing) {
+    ysProfiler profiler;
+    profiler.StartCapture();
+
+    profiler.BeginEvent("Test");
+    profiler.EndEvent("Test");
+    profiler.EndFrame();
+
+    EXPECT_TRUE(profiler.GetCapturedEvents().empty());
+}
+
+TEST(ProfilerTest, MultipleThreads) {
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+    profiler.SetThreadName("Main");
+    profiler.StartCapture();
+
+    profiler.BeginFrame();
+    std::thread worker([&profiler]() {
+        profiler.SetThreadName("Worker");
+        profiler.BeginEvent("Physics");
+        profiler.Counter("Contacts", 12);
+        profiler.EndEvent("Physics");
+    });
+
+    profiler.BeginEvent("Render");
+    profiler.Marker("Present");
+    profiler.EndEvent("Render");
+
+    worker.join();
+    profiler.EndFrame();
+    profiler.StopCapture();
+
+    ASSERT_EQ(profiler.GetThreadCount(), 2);
+    EXPECT_EQ(profiler.GetThreadName(0), "Main");
+    EXPECT_EQ(profiler.GetThreadName(1), "Worker");
+
+    const std::vector<ysProfiler::CapturedEvent> &events = profiler.GetCapturedEvents();
+    ASSERT_EQ(events.size(), 8);
+
+    int mainEvents = 0;
+    for (const ysProfiler::CapturedEvent &event : events) {
+        if (event.Thread == 0) ++mainEvents;
+    }
+
+    EXPECT_EQ(mainEvents, 5);
+}
+
+TEST(ProfilerTest, FullBufferDropsEvents) {
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+
+    for (int i = 0; i < ysProfiler::ThreadBufferCapacity + 10; ++i) {
+        profiler.Marker("Marker");
+    }
+
+    EXPECT_EQ(profiler.GetDroppedEventCount(), 10);
+
+    // Collecting makes room again
+    profiler.Collect();
+    profiler.Marker("Marker");
+    EXPECT_EQ(profiler.GetDroppedEventCount(), 10);
+}
+
+TEST(ProfilerTest, ChromeTraceExport) {
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+    profiler.StartCapture();
+
+    profiler.BeginFrame();
+    {
+        profiler.BeginEvent("Scene \"A\"");
+        profiler.Counter("Bodies", 3);
+        profiler.EndEvent("Scene \"A\"");
+    }
+    profiler.EndFrame();
+
+    EXPECT_EQ(profiler.WriteChromeTrace("profiler_test_trace.json"), ysError::None);
+
+    std::ifstream file("profiler_test_trace.json");
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    const std::string json = contents.str();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Scene \\\"A\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"C\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"E\""), std::string::npos);
+}
+
+TEST(ProfilerTest, PerfettoTraceExport) {
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+    profiler.StartCapture();
+
+    profiler.BeginFrame();
+    profiler.Counter("Bodies", 3);
+    profiler.EndFrame();
+
+    EXPECT_EQ(profiler.WritePerfettoTrace("profiler_test_trace.pftrace"), ysError::None);
+
+    std::ifstream file("profiler_test_trace.pftrace", std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    // Every packet is field 1 (TracePacket) of the Trace message
+    const std::string trace = contents.str();
+    ASSERT_FALSE(trace.empty());
+    EXPECT_EQ(trace[0], 0x0A);
+    EXPECT_NE(trace.find("Bodies"), std::string::npos);
+    EXPECT_NE(trace.find("Frame"), std::string::npos);
+}
+
+TEST(ProfilerTest, GetFromManyThreads) {
+    constexpr int Threads = 8;
+
+    // Threads racing on the first call must all see the same instance
+    ysProfiler *instances[Threads];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.push_back(std::thread([&instances, t]() { instances[t] = ysProfiler::Get(); }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+    for (int t = 0; t < Threads; ++t) EXPECT_EQ(instances[t], ysProfiler::Get());
+}
+
+TEST(ProfilerTest, ThreadSlotsAreRecycled) {
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+    profiler.StartCapture();
+
+    // More threads than there are buffers, one at a time
+    for (int t = 0; t < 2 * ysProfiler::MaxThreads; ++t) {
+        std::thread thread([&profiler]() { profiler.Marker("Marker"); });
+        thread.join();
+    }
+
+    profiler.StopCapture();
+
+    EXPECT_EQ(profiler.GetCapturedEvents().size(), 2 * ysProfiler::MaxThreads);
+    EXPECT_EQ(profiler.GetDroppedEventCount(), 0);
+    EXPECT_LT(profiler.GetThreadCount(), ysProfiler::MaxThreads);
+}
+
+TEST(ProfilerTest, TooManyThreadsDropEvents) {
+    constexpr int Threads = ysProfiler::MaxThreads + 4;
+
+    ysProfiler profiler;
+    profiler.SetEnabled(true);
+    profiler.StartCapture();
+
+    // All threads stay alive until every one of them has recorded
+    std::atomic<int> recorded(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < Threads; ++t) {
+        threads.push_back(std::thread([&profiler, &recorded]() {
+            profiler.Marker("Marker");
+            ++recorded;
+            while (recorded.load() < Threads) std::this_thread::yield();
+        }));
+    }
+
+    for (std::thread &thread : threads) thread.join();
+    profiler.StopCapture();
+
+    const uint64_t dropped = profiler.GetDroppedEventCount();
+    EXPECT_GE(dropped, 4);
+    EXPECT_EQ(profiler.GetCapturedEvents().size() + dropped, Threads);
+}
@@ -0,0 +1,581 @@
+#include <pch.h>
+
+#include "../include/yds_scene_compiler.h"
+#include "../include/yds_geometry_export_file_reader.h"
+#include "../include/yds_vertex_quantization.h"
+
+#include <fstream>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+    ysInterchangeObject MakeQuad(const std::string &name, float offset) {
+        ysInterchangeObject object;
+        object.Name = name;
+        object.MaterialName = "Material";
+        object.Type = ysInterchangeObject::ObjectType::Geometry;
+        object.ModelIndex = 0;
+        object.ParentIndex = -1;
+        object.InstanceIndex = -1;
+        object.Length = object.Width = 0.0f;
+        object.Scale = ysVector3(1.0f, 1.0f, 1.0f);
+
+        object.Vertices = {
+            ysVector3(offset, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 1.0f, 0.0f),
+            ysVector3(offset, 1.0f, 0.0f)
+        };
+
+        object.Normals = { ysVector3(0.0f, 0.0f, 1.0f) };
+
+        ysInterchangeObject::IndexSet a, b, n;
+        a.x = 0; a.y = 1; a.z = 2;
+        b.x = 0; b.y = 2; b.z = 3;
+        n.x = 0; n.y = 0; n.z = 0;
+        object.VertexIndices = { a, b };
+        object.NormalIndices = { n, n };
+
+        return object;
+    }
+
+    std::vector<ysInterchangeObject> MakeScene(int objectCount) {
+        std::vector<ysInterchangeObject> objects;
+        for (int i = 0; i < objectCount; ++i) {
+            objects.push_back(MakeQuad("Object_" + std::to_string(i), (float)i));
+        }
+
+        return objects;
+    }
+
+    std::vector<char> ReadFile(const char *fname) {
+        std::ifstream file(fname, std::ios::binary);
+        return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void Compile(std::vector<ysInterchangeObject> objects, const char *fname, const ysSceneCompiler::Settings &settings, ysSceneCompiler *compiler) {
+        ASSERT_EQ(compiler->Compile(objects, fname, settings), ysError::None);
+    }
+
+    // Same quad as MakeQuad() the way tool files store it
+    ysObjectData *MakeToolQuad(const std::string &name, float offset) {
+        ysObjectData *object = new ysObjectData;
+        strcpy(object->m_name, name.c_str());
+        strcpy(object->m_materialName, "Material");
+
+        object->m_objectInformation.ModelIndex = 0;
+        object->m_objectInformation.ObjectType = ysObjectData::ObjectType::Geometry;
+        object->m_objectTransformation.Scale = ysVector3(1.0f, 1.0f, 1.0f);
+
+        object->m_objectStatistics.NumVertices = 4;
+        object->m_objectStatistics.NumFaces = 2;
+
+        object->m_vertices.New() = ysVector3(offset, 0.0f, 0.0f);
+        object->m_vertices.New() = ysVector3(offset + 1.0f, 0.0f, 0.0f);
+        object->m_vertices.New() = ysVector3(offset + 1.0f, 1.0f, 0.0f);
+        object->m_vertices.New() = ysVector3(offset, 1.0f, 0.0f);
+
+        ysObjectData::IndexSet &a = object->m_vertexIndexSet.New();
+        a.x = 0; a.y = 1; a.z = 2;
+        ysObjectData::IndexSet &b = object->m_vertexIndexSet.New();
+        b.x = 0; b.y = 2; b.z = 3;
+
+        object->m_smoothingGroups.New() = 1;
+        object->m_smoothingGroups.New() = 1;
+
+        return object;
+    }
+
+    // Objects are rebuilt for every compile since compiling modifies them
+    void CompileToolScene(int objectCount, int movedObject, const char *fname, const ysSceneCompiler::Settings &settings, ysSceneCompiler *compiler) {
+        std::vector<std::unique_ptr<ysObjectData>> owned;
+        std::vector<ysObjectData *> objects;
+        for (int i = 0; i < objectCount; ++i) {
+            owned.emplace_back(MakeToolQuad("Object_" + std::to_string(i), (float)i));
+            objects.push_back(owned.back().get());
+        }
+
+        if (movedObject >= 0) objects[movedObject]->m_vertices[2].z = 5.0f;
+
+        const std::vector<ysSceneCompiler::ToolObjectSettings> objectSettings(objectCount);
+        ASSERT_EQ(compiler->Compile(objects, objectSettings, fname, settings), ysError::None);
+    }
+}
+
+TEST(SceneCompilerTest, OutputIsIndependentOfWorkerCount) {
+    const std::vector<ysInterchangeObject> objects = MakeScene(64);
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.Scale = 2.0f;
+    settings.UseCache = false;
+
+    settings.WorkerCount = 1;
+    Compile(objects, "scene_compiler_serial.ysce", settings, &compiler);
+
+    settings.WorkerCount = 4;
+    Compile(objects, "scene_compiler_parallel.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CompiledObjectCount, 64);
+
+    EXPECT_EQ(ReadFile("scene_compiler_serial.ysce"), ReadFile("scene_compiler_parallel.ysce"));
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_parallel.ysce"), ysError::None);
+    ASSERT_EQ(reader.GetObjectCount(), 64);
+
+    for (int i = 0; i < 64; ++i) {
+        ysGeometryExportFileReader::Object object;
+        ASSERT_EQ(reader.ReadObject(i, &object), ysError::None);
+        EXPECT_EQ(std::string(object.Header.ObjectName), "Object_" + std::to_string(i));
+        EXPECT_NE(reader.GetContentHash(i), 0);
+
+        float x;
+        memcpy(&x, object.VertexData, sizeof(float));
+        EXPECT_EQ(x, 2.0f * i);
+    }
+}
+
+TEST(SceneCompilerTest, OnlyChangedObjectsAreRecompiled) {
+    std::vector<ysInterchangeObject> objects = MakeScene(20);
+    remove("scene_compiler_incremental.ysce");
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+
+    Compile(objects, "scene_compiler_incremental.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().ObjectCount, 20);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 0);
+
+    Compile(objects, "scene_compiler_incremental.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 20);
+    EXPECT_EQ(compiler.GetStatistics().CompiledObjectCount, 0);
+
+    objects[7].Vertices[2].z = 5.0f;
+    Compile(objects, "scene_compiler_incremental.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 19);
+    EXPECT_EQ(compiler.GetStatistics().CompiledObjectCount, 1);
+
+    // Reusing cached objects has to give the same file as a full compile
+    settings.UseCache = false;
+    Compile(objects, "scene_compiler_full.ysce", settings, &compiler);
+    EXPECT_EQ(ReadFile("scene_compiler_incremental.ysce"), ReadFile("scene_compiler_full.ysce"));
+}
+
+TEST(SceneCompilerTest, SettingsInvalidateCache) {
+    const std::vector<ysInterchangeObject> objects = MakeScene(8);
+    remove("scene_compiler_settings.ysce");
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+
+    Compile(objects, "scene_compiler_settings.ysce", settings, &compiler);
+
+    settings.Scale = 0.5f;
+    Compile(objects, "scene_compiler_settings.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 0);
+
+    settings.VertexInfo.IncludeUVs = false;
+    Compile(objects, "scene_compiler_settings.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 0);
+
+    Compile(objects, "scene_compiler_settings.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 8);
+}
+
+TEST(SceneCompilerTest, ToolObjects) {
+    remove("scene_compiler_tool.ysce");
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.Scale = 2.0f;
+    settings.UseCache = false;
+
+    settings.WorkerCount = 1;
+    CompileToolScene(16, -1, "scene_compiler_tool_serial.ysce", settings, &compiler);
+
+    settings.WorkerCount = 4;
+    CompileToolScene(16, -1, "scene_compiler_tool.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CompiledObjectCount, 16);
+    EXPECT_EQ(ReadFile("scene_compiler_tool_serial.ysce"), ReadFile("scene_compiler_tool.ysce"));
+
+    settings.UseCache = true;
+    CompileToolScene(16, -1, "scene_compiler_tool.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 16);
+    EXPECT_EQ(ReadFile("scene_compiler_tool_serial.ysce"), ReadFile("scene_compiler_tool.ysce"));
+
+    CompileToolScene(16, 5, "scene_compiler_tool.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 15);
+    EXPECT_EQ(compiler.GetStatistics().CompiledObjectCount, 1);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_tool.ysce"), ysError::None);
+    ASSERT_EQ(reader.GetObjectCount(), 16);
+
+    for (int i = 0; i < 16; ++i) {
+        ysGeometryExportFileReader::Object object;
+        ASSERT_EQ(reader.ReadObject(i, &object), ysError::None);
+        EXPECT_EQ(std::string(object.Header.ObjectName), "Object_" + std::to_string(i));
+
+        float x;
+        memcpy(&x, object.VertexData, sizeof(float));
+        EXPECT_EQ(x, 2.0f * i);
+    }
+}
+
+TEST(SceneCompilerTest, InterchangeFile) {
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+
+    ASSERT_EQ(
+        compiler.Compile("../../../test/geometry_files/instance_test.dia", "scene_compiler_instance_test.ysce", settings),
+        ysError::None);
+
+    const ysSceneCompiler::Statistics &statistics = compiler.GetStatistics();
+    EXPECT_EQ(statistics.ObjectCount, 10);
+    EXPECT_GT(statistics.TotalTime, 0.0);
+    EXPECT_GE(statistics.TotalTime, statistics.ReadTime + statistics.ProcessTime + statistics.WriteTime);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_instance_test.ysce"), ysError::None);
+    EXPECT_EQ(reader.GetObjectCount(), 10);
+    EXPECT_GE(reader.FindObject("Instance_1"), 0);
+}
+
+TEST(SceneCompilerTest, MeshOptimizationWeldsDuplicates) {
+    // The quad's corners are stored twice, once per triangle
+    std::vector<ysInterchangeObject> objects = MakeScene(1);
+    ysInterchangeObject &quad = objects[0];
+    quad.Vertices.push_back(quad.Vertices[0]);
+    quad.Vertices.push_back(quad.Vertices[2]);
+    quad.VertexIndices[1].x = 4;
+    quad.VertexIndices[1].y = 5;
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    settings.VertexInfo.IncludeUVs = false;
+
+    settings.OptimizeMeshes = false;
+    Compile(objects, "scene_compiler_unoptimized.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().TriangleCount, 0);
+
+    settings.OptimizeMeshes = true;
+    Compile(objects, "scene_compiler_optimized.ysce", settings, &compiler);
+
+    const ysSceneCompiler::Statistics &statistics = compiler.GetStatistics();
+    EXPECT_EQ(statistics.TriangleCount, 2);
+    EXPECT_EQ(statistics.VertexCountBefore, 6);
+    EXPECT_EQ(statistics.VertexCountAfter, 4);
+    EXPECT_DOUBLE_EQ(statistics.AcmrBefore, 3.0);
+    EXPECT_DOUBLE_EQ(statistics.AcmrAfter, 2.0);
+    EXPECT_DOUBLE_EQ(statistics.AtvrAfter, 1.0);
+
+    ysGeometryExportFileReader unoptimized, optimized;
+    ASSERT_EQ(unoptimized.Open("scene_compiler_unoptimized.ysce"), ysError::None);
+    ASSERT_EQ(optimized.Open("scene_compiler_optimized.ysce"), ysError::None);
+
+    ysGeometryExportFileReader::Object before, after;
+    ASSERT_EQ(unoptimized.ReadObject(0, &before), ysError::None);
+    ASSERT_EQ(optimized.ReadObject(0, &after), ysError::None);
+    EXPECT_EQ(before.Header.NumVertices, 6);
+    EXPECT_EQ(after.Header.NumVertices, 4);
+    EXPECT_EQ(after.Header.NumFaces, 2);
+    EXPECT_EQ(after.VertexDataSize, before.VertexDataSize / 6 * 4);
+}
+
+namespace {
+    // Flat grid of size x size quads
+    ysInterchangeObject MakeGrid(const std::string &name, int size) {
+        const int row = size + 1;
+
+        ysInterchangeObject object = MakeQuad(name, 0.0f);
+        object.Vertices.clear();
+        object.VertexIndices.clear();
+        object.NormalIndices.clear();
+
+        for (int y = 0; y <= size; ++y) {
+            for (int x = 0; x <= size; ++x) {
+                object.Vertices.push_back(ysVector3((float)x, (float)y, 0.0f));
+            }
+        }
+
+        ysInterchangeObject::IndexSet n;
+        n.x = n.y = n.z = 0;
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const int v = y * row + x;
+
+                ysInterchangeObject::IndexSet a, b;
+                a.x = v; a.y = v + 1; a.z = v + row + 1;
+                b.x = v; b.y = v + row + 1; b.z = v + row;
+                object.VertexIndices.push_back(a);
+                object.VertexIndices.push_back(b);
+                object.NormalIndices.push_back(n);
+                object.NormalIndices.push_back(n);
+            }
+        }
+
+        return object;
+    }
+
+    // Grid with more vertices than 16 bit indices can address
+    ysInterchangeObject MakeLargeGrid() {
+        return MakeGrid("Large", 260);
+    }
+}
+
+TEST(SceneCompilerTest, LargeMeshesAreSplit) {
+    const std::vector<ysInterchangeObject> objects = { MakeLargeGrid() };
+    const int faceCount = (int)objects[0].VertexIndices.size();
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    settings.VertexInfo.IncludeUVs = false;
+
+    Compile(objects, "scene_compiler_large_split.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().SplitObjectCount, 1);
+    EXPECT_EQ(compiler.GetStatistics().WideIndexObjectCount, 0);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_large_split.ysce"), ysError::None);
+
+    ysGeometryExportFileReader::Object object;
+    ASSERT_EQ(reader.ReadObject(0, &object), ysError::None);
+    EXPECT_TRUE((object.Header.Flags & ysGeometryExportFile::MDF_SUBMESHES) != 0);
+    EXPECT_FALSE((object.Header.Flags & ysGeometryExportFile::MDF_32BIT_INDICES) != 0);
+    EXPECT_EQ(object.Header.NumFaces, faceCount);
+    EXPECT_EQ(object.IndexDataSize, faceCount * 3 * (int)sizeof(uint16_t));
+
+    std::vector<ysGeometryExportFile::Submesh> submeshes;
+    ASSERT_TRUE(ysGeometryExportFileReader::GetSubmeshes(object, &submeshes));
+    ASSERT_GT(submeshes.size(), 1);
+
+    int faces = 0;
+    for (const ysGeometryExportFile::Submesh &submesh : submeshes) {
+        EXPECT_LE(submesh.VertexCount, ysGeometryExportFile::MaxShortIndexVertexCount);
+
+        for (int i = 0; i < submesh.FaceCount * 3; ++i) {
+            uint16_t index;
+            memcpy(&index, object.IndexData + (submesh.BaseIndex + i) * sizeof(uint16_t), sizeof(uint16_t));
+            ASSERT_LT(index, submesh.VertexCount);
+        }
+
+        faces += submesh.FaceCount;
+    }
+
+    EXPECT_EQ(faces, faceCount);
+    reader.Close();
+
+    // Split objects reused from the cache have to come out the same
+    const std::vector<char> compiled = ReadFile("scene_compiler_large_split.ysce");
+    settings.UseCache = true;
+    Compile(objects, "scene_compiler_large_split.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 1);
+    EXPECT_EQ(ReadFile("scene_compiler_large_split.ysce"), compiled);
+}
+
+TEST(SceneCompilerTest, LargeMeshesWithWideIndices) {
+    const std::vector<ysInterchangeObject> objects = { MakeLargeGrid(), MakeQuad("Small", 0.0f) };
+    const int faceCount = (int)objects[0].VertexIndices.size();
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    settings.VertexInfo.IncludeUVs = false;
+    settings.LargeMeshes = ysSceneCompiler::LargeMeshMode::WideIndices;
+
+    Compile(objects, "scene_compiler_large_wide.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().SplitObjectCount, 0);
+    EXPECT_EQ(compiler.GetStatistics().WideIndexObjectCount, 1);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_large_wide.ysce"), ysError::None);
+
+    // Only the model that needs them gets 32 bit indices
+    ysGeometryExportFileReader::Object large, small;
+    ASSERT_EQ(reader.ReadObject(0, &large), ysError::None);
+    ASSERT_EQ(reader.ReadObject(1, &small), ysError::None);
+    EXPECT_TRUE((large.Header.Flags & ysGeometryExportFile::MDF_32BIT_INDICES) != 0);
+    EXPECT_FALSE((small.Header.Flags & ysGeometryExportFile::MDF_32BIT_INDICES) != 0);
+    EXPECT_EQ(large.IndexDataSize, faceCount * 3 * (int)sizeof(uint32_t));
+    EXPECT_EQ(small.IndexDataSize, 6 * (int)sizeof(uint16_t));
+
+    uint32_t maxIndex = 0;
+    for (int i = 0; i < faceCount * 3; ++i) {
+        uint32_t index;
+        memcpy(&index, large.IndexData + i * sizeof(uint32_t), sizeof(uint32_t));
+        if (index > maxIndex) maxIndex = index;
+    }
+
+    EXPECT_EQ(maxIndex, (uint32_t)large.Header.NumVertices - 1);
+    EXPECT_GT(large.Header.NumVertices, ysGeometryExportFile::MaxShortIndexVertexCount);
+
+    std::vector<ysGeometryExportFile::Submesh> submeshes;
+    ASSERT_TRUE(ysGeometryExportFileReader::GetSubmeshes(large, &submeshes));
+    ASSERT_EQ(submeshes.size(), 1);
+    EXPECT_EQ(submeshes[0].FaceCount, faceCount);
+}
+
+TEST(SceneCompilerTest, QuantizedVertices) {
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    Compile(MakeScene(4), "scene_compiler_full.ysce", settings, &compiler);
+
+    settings.VertexInfo.Quantize = true;
+    Compile(MakeScene(4), "scene_compiler_quantized.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().QuantizedObjectCount, 4);
+
+    ysGeometryExportFileReader full, quantized;
+    ASSERT_EQ(full.Open("scene_compiler_full.ysce"), ysError::None);
+    ASSERT_EQ(quantized.Open("scene_compiler_quantized.ysce"), ysError::None);
+    ASSERT_EQ(quantized.GetObjectCount(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        ysGeometryExportFileReader::Object fullObject, object;
+        ASSERT_EQ(full.ReadObject(i, &fullObject), ysError::None);
+        ASSERT_EQ(quantized.ReadObject(i, &object), ysError::None);
+
+        const ysGeometryExportFile::ObjectOutputHeader &header = object.Header;
+        EXPECT_NE(header.Flags & ysGeometryExportFile::MDF_QUANTIZED, 0u);
+        ASSERT_EQ(header.NumVertices, 4);
+
+        // Position, one UV channel and a normal: 8 + 4 + 4 bytes instead of 16 + 8 + 16
+        EXPECT_EQ(object.VertexDataSize, 16 * 4);
+        EXPECT_EQ(fullObject.VertexDataSize, 40 * 4);
+
+        for (int v = 0; v < header.NumVertices; ++v) {
+            uint16_t position[4];
+            int16_t normal[2];
+            memcpy(position, object.VertexData + v * 16, sizeof(position));
+            memcpy(normal, object.VertexData + v * 16 + 12, sizeof(normal));
+
+            const float x = ysVertexQuantization::DequantizeUnorm16(position[0], header.MinExtreme.x, header.MaxExtreme.x);
+            const float y = ysVertexQuantization::DequantizeUnorm16(position[1], header.MinExtreme.y, header.MaxExtreme.y);
+            const float z = ysVertexQuantization::DequantizeUnorm16(position[2], header.MinExtreme.z, header.MaxExtreme.z);
+
+            // The quad's corners are exactly representable
+            EXPECT_FLOAT_EQ(x, (x < i + 0.5f) ? (float)i : i + 1.0f);
+            EXPECT_TRUE(y == 0.0f || y == 1.0f);
+            EXPECT_EQ(z, 0.0f);
+            EXPECT_EQ(position[3], 0xFFFF);
+
+            float decoded[3];
+            ysVertexQuantization::DecodeOctahedral(normal, decoded);
+            EXPECT_NEAR(decoded[2], 1.0f, 1e-6f);
+        }
+    }
+}
+
+TEST(SceneCompilerTest, LevelsOfDetail) {
+    const std::vector<ysInterchangeObject> objects = { MakeGrid("Grid", 32), MakeQuad("Quad", 0.0f) };
+    const int faceCount = (int)objects[0].VertexIndices.size();
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    settings.VertexInfo.IncludeUVs = false;
+    settings.LodCount = 3;
+
+    Compile(objects, "scene_compiler_lods.ysce", settings, &compiler);
+
+    // The quad can't be simplified, its vertices are all on the border
+    EXPECT_EQ(compiler.GetStatistics().LodObjectCount, 1);
+    EXPECT_EQ(compiler.GetStatistics().SplitObjectCount, 0);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_lods.ysce"), ysError::None);
+
+    ysGeometryExportFileReader::Object quad;
+    ASSERT_EQ(reader.ReadObject(1, &quad), ysError::None);
+    EXPECT_EQ(quad.Header.Flags & ysGeometryExportFile::MDF_LODS, 0u);
+
+    ysGeometryExportFileReader::Object grid;
+    ASSERT_EQ(reader.ReadObject(0, &grid), ysError::None);
+    EXPECT_NE(grid.Header.Flags & ysGeometryExportFile::MDF_LODS, 0u);
+    EXPECT_EQ(grid.Header.NumFaces, faceCount);
+
+    std::vector<ysGeometryExportFile::Lod> lods;
+    std::vector<ysGeometryExportFile::Submesh> submeshes;
+    ASSERT_TRUE(ysGeometryExportFileReader::GetLods(grid, &lods, &submeshes));
+    ASSERT_EQ(lods.size(), 3);
+    ASSERT_EQ(submeshes.size(), 3);
+
+    int indexCount = 0;
+    for (size_t i = 0; i < lods.size(); ++i) {
+        const ysGeometryExportFile::Lod &lod = lods[i];
+        ASSERT_EQ(lod.SubmeshCount, 1);
+
+        // Levels share the vertices and follow each other in the index data
+        const ysGeometryExportFile::Submesh &submesh = submeshes[lod.FirstSubmesh];
+        EXPECT_EQ(submesh.BaseIndex, indexCount);
+        EXPECT_EQ(submesh.FaceCount, lod.FaceCount);
+        EXPECT_EQ(submesh.BaseVertex, 0);
+        EXPECT_EQ(submesh.VertexCount, grid.Header.NumVertices);
+
+        // A flat grid simplifies without error
+        EXPECT_LT(lod.Error, 1e-3f);
+        if (i > 0) {
+            EXPECT_LE(lod.FaceCount, lods[i - 1].FaceCount / 2);
+        }
+
+        indexCount += lod.FaceCount * 3;
+    }
+
+    EXPECT_EQ(lods[0].FaceCount, faceCount);
+    EXPECT_EQ(grid.IndexDataSize, indexCount * (int)sizeof(uint16_t));
+    EXPECT_EQ(compiler.GetStatistics().LodTriangleCount, lods[1].FaceCount + lods[2].FaceCount);
+}
+
+TEST(SceneCompilerTest, LevelsOfDetailOfLargeMeshes) {
+    const std::vector<ysInterchangeObject> objects = { MakeLargeGrid() };
+
+    ysSceneCompiler compiler;
+    ysSceneCompiler::Settings settings;
+    settings.UseCache = false;
+    settings.VertexInfo.IncludeUVs = false;
+    settings.LodCount = 2;
+
+    Compile(objects, "scene_compiler_large_lods.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().LodObjectCount, 1);
+    EXPECT_EQ(compiler.GetStatistics().SplitObjectCount, 1);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_compiler_large_lods.ysce"), ysError::None);
+
+    ysGeometryExportFileReader::Object object;
+    ASSERT_EQ(reader.ReadObject(0, &object), ysError::None);
+    EXPECT_EQ(object.Header.Flags & ysGeometryExportFile::MDF_32BIT_INDICES, 0u);
+
+    std::vector<ysGeometryExportFile::Lod> lods;
+    std::vector<ysGeometryExportFile::Submesh> submeshes;
+    ASSERT_TRUE(ysGeometryExportFileReader::GetLods(object, &lods, &submeshes));
+    ASSERT_EQ(lods.size(), 2);
+
+    // The full mesh is split, the reduced one fits in 16 bit indices
+    EXPECT_GT(lods[0].SubmeshCount, 1);
+    EXPECT_EQ(lods[1].SubmeshCount, 1);
+
+    for (const ysGeometryExportFile::Lod &lod : lods) {
+        int faces = 0;
+        for (int i = lod.FirstSubmesh; i < lod.FirstSubmesh + lod.SubmeshCount; ++i) {
+            EXPECT_LE(submeshes[i].VertexCount, ysGeometryExportFile::MaxShortIndexVertexCount);
+            faces += submeshes[i].FaceCount;
+        }
+
+        EXPECT_EQ(faces, lod.FaceCount);
+    }
+
+    reader.Close();
+
+    const std::vector<char> compiled = ReadFile("scene_compiler_large_lods.ysce");
+    settings.UseCache = true;
+    Compile(objects, "scene_compiler_large_lods.ysce", settings, &compiler);
+    EXPECT_EQ(compiler.GetStatistics().CachedObjectCount, 1);
+    EXPECT_EQ(ReadFile("scene_compiler_large_lods.ysce"), compiled);
+}
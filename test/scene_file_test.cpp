@@ -0,0 +1,180 @@
+#include <pch.h>
+
+#include "../include/yds_geometry_export_file.h"
+#include "../include/yds_geometry_export_file_reader.h"
+
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace {
+    ysInterchangeObject MakeQuad(const std::string &name, float offset) {
+        ysInterchangeObject object;
+        object.Name = name;
+        object.MaterialName = "Material";
+        object.Type = ysInterchangeObject::ObjectType::Geometry;
+        object.ModelIndex = -1;
+        object.ParentIndex = -1;
+        object.InstanceIndex = -1;
+        object.Length = object.Width = 0.0f;
+        object.Scale = ysVector3(1.0f, 1.0f, 1.0f);
+
+        object.Vertices = {
+            ysVector3(offset, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 0.0f, 0.0f),
+            ysVector3(offset + 1.0f, 1.0f, 0.0f),
+            ysVector3(offset, 1.0f, 0.0f)
+        };
+
+        ysInterchangeObject::IndexSet a, b;
+        a.x = 0; a.y = 1; a.z = 2;
+        b.x = 0; b.y = 2; b.z = 3;
+        object.VertexIndices = { a, b };
+
+        return object;
+    }
+
+    ysInterchangeObject MakeEmpty(const std::string &name) {
+        ysInterchangeObject object = MakeQuad(name, 0.0f);
+        object.Type = ysInterchangeObject::ObjectType::Empty;
+        object.Vertices.clear();
+        object.VertexIndices.clear();
+
+        return object;
+    }
+
+    void WriteScene(const char *fname, int version, int objectCount) {
+        ysGeometryExportFile file;
+        ASSERT_EQ(file.Open(fname, version), ysError::None);
+
+        if (version == 1) {
+            // Version 1 files need the caller to write the object count
+            file.WriteCustomData(&objectCount, sizeof(int));
+        }
+
+        for (int i = 0; i < objectCount; ++i) {
+            ysInterchangeObject object = (i % 3 == 2)
+                ? MakeEmpty("Object_" + std::to_string(i))
+                : MakeQuad("Object_" + std::to_string(i), (float)i);
+            ASSERT_EQ(file.WriteObject(&object), ysError::None);
+        }
+
+        ASSERT_EQ(file.Close(), ysError::None);
+    }
+
+    void CheckScene(ysGeometryExportFileReader *reader, int objectCount) {
+        ASSERT_EQ(reader->GetObjectCount(), objectCount);
+
+        for (int i = objectCount - 1; i >= 0; --i) {
+            ysGeometryExportFileReader::Object object;
+            ASSERT_EQ(reader->ReadObject(i, &object), ysError::None);
+            EXPECT_EQ(std::string(object.Header.ObjectName), "Object_" + std::to_string(i));
+
+            if (i % 3 == 2) {
+                EXPECT_EQ(object.Header.ObjectType, (int)ysObjectData::ObjectType::Empty);
+                EXPECT_EQ(object.VertexDataSize, 0);
+                continue;
+            }
+
+            ASSERT_EQ(object.Header.NumVertices, 4);
+            ASSERT_EQ(object.IndexDataSize, 6 * (int)sizeof(unsigned short));
+            ASSERT_EQ(object.VertexDataSize, object.Header.VertexDataSize);
+
+            float x;
+            memcpy(&x, object.VertexData, sizeof(float));
+            EXPECT_EQ(x, (float)i);
+
+            unsigned short indices[6];
+            memcpy(indices, object.IndexData, sizeof(indices));
+            EXPECT_EQ(indices[4], 2);
+            EXPECT_EQ(indices[5], 3);
+        }
+    }
+}
+
+TEST(SceneFileTest, Version2RoundTrip) {
+    WriteScene("scene_file_v2.ysce", 2, 50);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_file_v2.ysce"), ysError::None);
+    EXPECT_EQ(reader.GetVersion(), 2);
+
+    CheckScene(&reader, 50);
+
+    // The mapping is page aligned, so file offsets carry over to addresses
+    ysGeometryExportFileReader::Object object;
+    ASSERT_EQ(reader.ReadObject(4, &object), ysError::None);
+    EXPECT_EQ((uintptr_t)object.VertexData % ysGeometryExportFile::VertexDataAlignment, 0);
+    EXPECT_EQ((uintptr_t)object.IndexData % ysGeometryExportFile::IndexDataAlignment, 0);
+}
+
+TEST(SceneFileTest, Version1RoundTrip) {
+    WriteScene("scene_file_v1.ysce", 1, 10);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_file_v1.ysce"), ysError::None);
+    EXPECT_EQ(reader.GetVersion(), 1);
+
+    CheckScene(&reader, 10);
+}
+
+TEST(SceneFileTest, ClosedOnDestruction) {
+    {
+        ysGeometryExportFile file;
+        ASSERT_EQ(file.Open("scene_file_unclosed.ysce", 2), ysError::None);
+
+        for (int i = 0; i < 5; ++i) {
+            ysInterchangeObject object = (i % 3 == 2)
+                ? MakeEmpty("Object_" + std::to_string(i))
+                : MakeQuad("Object_" + std::to_string(i), (float)i);
+            ASSERT_EQ(file.WriteObject(&object), ysError::None);
+        }
+    }
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_file_unclosed.ysce"), ysError::None);
+
+    CheckScene(&reader, 5);
+}
+
+TEST(SceneFileTest, FindObject) {
+    for (int version = 1; version <= 2; ++version) {
+        WriteScene("scene_file_find.ysce", version, 40);
+
+        ysGeometryExportFileReader reader;
+        ASSERT_EQ(reader.Open("scene_file_find.ysce"), ysError::None);
+
+        for (int i = 0; i < 40; ++i) {
+            EXPECT_EQ(reader.FindObject(("Object_" + std::to_string(i)).c_str()), i);
+        }
+
+        EXPECT_EQ(reader.FindObject("Object_40"), -1);
+        EXPECT_EQ(reader.FindObject(""), -1);
+    }
+}
+
+TEST(SceneFileTest, EmptyScene) {
+    WriteScene("scene_file_empty.ysce", 2, 0);
+
+    ysGeometryExportFileReader reader;
+    ASSERT_EQ(reader.Open("scene_file_empty.ysce"), ysError::None);
+    EXPECT_EQ(reader.GetObjectCount(), 0);
+    EXPECT_EQ(reader.FindObject("Object_0"), -1);
+}
+
+TEST(SceneFileTest, TruncatedFiles) {
+    for (int version = 1; version <= 2; ++version) {
+        WriteScene("scene_file_truncated.ysce", version, 6);
+
+        std::ifstream file("scene_file_truncated.ysce", std::ios::binary);
+        const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        ysGeometryExportFileReader reader;
+        ASSERT_EQ(reader.Open(data.data(), data.size()), ysError::None);
+
+        // Cutting off the table of contents or the last object must be caught
+        EXPECT_NE(reader.Open(data.data(), data.size() - 8), ysError::None);
+        EXPECT_NE(reader.Open(data.data(), 2), ysError::None);
+    }
+}
@@ -0,0 +1,50 @@
+#include <pch.h>
+
+#include "../include/yds_timing.h"
+
+#include <chrono>
+#include <thread>
+
+TEST(TimingTest, ClockIsMonotonic) {
+    uint64_t last = ysTimingSystem::Now();
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t now = ysTimingSystem::Now();
+        ASSERT_GE(now, last);
+        last = now;
+    }
+}
+
+TEST(TimingTest, CalibratedAgainstSystemClock) {
+    EXPECT_NE(ysTimingSystem::GetClockSource(), ysTimingSystem::ClockSource::Uncalibrated);
+    EXPECT_GT(ysTimingSystem::GetTicksPerSecond(), 0);
+
+    const uint64_t t0 = ysTimingSystem::ReadSystemClock();
+    const uint64_t c0 = ysTimingSystem::Now();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const uint64_t t1 = ysTimingSystem::ReadSystemClock();
+    const uint64_t c1 = ysTimingSystem::Now();
+
+    const double expected = (double)(t1 - t0);
+    const double measured = (double)ysTimingSystem::TicksToNanoseconds(c1 - c0);
+    EXPECT_NEAR(measured / expected, 1.0, 0.01);
+    EXPECT_NEAR(ysTimingSystem::TicksToSeconds(c1 - c0), expected * 1e-9, expected * 1e-11);
+}
+
+TEST(TimingTest, PrecisionModes) {
+    ysTimingSystem timingSystem;
+
+    timingSystem.SetPrecisionMode(ysTimingSystem::Precision::Nanosecond);
+    const uint64_t ns = timingSystem.GetTime();
+
+    timingSystem.SetPrecisionMode(ysTimingSystem::Precision::Microsecond);
+    const uint64_t us = timingSystem.GetTime();
+
+    timingSystem.SetPrecisionMode(ysTimingSystem::Precision::Millisecond);
+    const uint64_t ms = timingSystem.GetTime();
+
+    EXPECT_LE(ns / 1000, us);
+    EXPECT_LE(us / 1000, ms);
+    EXPECT_DOUBLE_EQ(timingSystem.ConvertToSeconds(1500), 1.5);
+}
@@ -0,0 +1,130 @@
+#include <pch.h>
+
+#include "../include/yds_vertex_quantization.h"
+
+#include <math.h>
+#include <random>
+
+TEST(VertexQuantizationTest, HalfRoundTrip) {
+    const float exact[] = { 0.0f, 1.0f, -2.0f, 0.5f, 1024.0f, 65504.0f, 0.000061035156f, 5.9604645e-8f };
+    for (float value : exact) {
+        EXPECT_EQ(ysVertexQuantization::HalfToFloat(ysVertexQuantization::FloatToHalf(value)), value);
+    }
+
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1.0f), 0x3C00);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(-2.0f), 0xC000);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(-0.0f), 0x8000);
+
+    // Smallest subnormal and largest finite value
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(5.9604645e-8f), 0x0001);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(65504.0f), 0x7BFF);
+}
+
+TEST(VertexQuantizationTest, HalfRounding) {
+    // 1 + 2^-11 is halfway between 1 and the next half, ties go to even
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1.0f + 1.0f / 2048), 0x3C00);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1.0f + 3.0f / 2048), 0x3C02);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1.0f + 1.1f / 2048), 0x3C01);
+
+    // Overflow, infinity and NaN
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(65520.0f), 0x7C00);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1e10f), 0x7C00);
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(-INFINITY), 0xFC00);
+    EXPECT_TRUE(isnan(ysVertexQuantization::HalfToFloat(ysVertexQuantization::FloatToHalf(NAN))));
+
+    // Underflow
+    EXPECT_EQ(ysVertexQuantization::FloatToHalf(1e-9f), 0x0000);
+
+    // Relative error of normal values is at most 2^-11
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+    for (int i = 0; i < 10000; ++i) {
+        const float value = distribution(rng);
+        if (fabsf(value) < 0.001f) continue;
+
+        const float decoded = ysVertexQuantization::HalfToFloat(ysVertexQuantization::FloatToHalf(value));
+        EXPECT_LE(fabsf(decoded - value), fabsf(value) / 2048.0f);
+    }
+}
+
+TEST(VertexQuantizationTest, Unorm16) {
+    EXPECT_EQ(ysVertexQuantization::QuantizeUnorm16(-3.0f, -3.0f, 5.0f), 0);
+    EXPECT_EQ(ysVertexQuantization::QuantizeUnorm16(5.0f, -3.0f, 5.0f), 0xFFFF);
+    EXPECT_EQ(ysVertexQuantization::QuantizeUnorm16(10.0f, -3.0f, 5.0f), 0xFFFF);
+    EXPECT_EQ(ysVertexQuantization::QuantizeUnorm16(2.0f, 2.0f, 2.0f), 0);
+
+    EXPECT_EQ(ysVertexQuantization::DequantizeUnorm16(0, -3.0f, 5.0f), -3.0f);
+    EXPECT_EQ(ysVertexQuantization::DequantizeUnorm16(0xFFFF, -3.0f, 5.0f), 5.0f);
+
+    // Error is at most half a step
+    const float step = 8.0f / 65535.0f;
+    for (float value = -3.0f; value <= 5.0f; value += 0.01f) {
+        const uint16_t quantized = ysVertexQuantization::QuantizeUnorm16(value, -3.0f, 5.0f);
+        EXPECT_LE(fabsf(ysVertexQuantization::DequantizeUnorm16(quantized, -3.0f, 5.0f) - value), step * 0.5f + 1e-6f);
+    }
+}
+
+TEST(VertexQuantizationTest, Snorm16) {
+    EXPECT_EQ(ysVertexQuantization::FloatToSnorm16(1.0f), 32767);
+    EXPECT_EQ(ysVertexQuantization::FloatToSnorm16(-1.0f), -32767);
+    EXPECT_EQ(ysVertexQuantization::FloatToSnorm16(2.0f), 32767);
+    EXPECT_EQ(ysVertexQuantization::FloatToSnorm16(0.0f), 0);
+
+    EXPECT_EQ(ysVertexQuantization::Snorm16ToFloat(-32768), -1.0f);
+    EXPECT_EQ(ysVertexQuantization::Snorm16ToFloat(32767), 1.0f);
+}
+
+TEST(VertexQuantizationTest, OctahedralAxes) {
+    const float axes[][3] = {
+        { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f },
+        { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+        { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+    };
+
+    for (const float *axis : axes) {
+        int16_t encoded[2];
+        float decoded[3];
+        ysVertexQuantization::EncodeOctahedral(axis[0], axis[1], axis[2], encoded);
+        ysVertexQuantization::DecodeOctahedral(encoded, decoded);
+
+        for (int i = 0; i < 3; ++i) {
+            EXPECT_NEAR(decoded[i], axis[i], 1e-6f);
+        }
+    }
+
+    // Zero vectors decode to +Z
+    int16_t encoded[2];
+    float decoded[3];
+    ysVertexQuantization::EncodeOctahedral(0.0f, 0.0f, 0.0f, encoded);
+    ysVertexQuantization::DecodeOctahedral(encoded, decoded);
+    EXPECT_EQ(decoded[2], 1.0f);
+}
+
+TEST(VertexQuantizationTest, OctahedralError) {
+    std::mt19937 rng(7);
+    std::normal_distribution<float> distribution;
+
+    float maxError = 0.0f;
+    for (int i = 0; i < 100000; ++i) {
+        float v[3] = { distribution(rng), distribution(rng), distribution(rng) };
+        const float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (length < 1e-3f) continue;
+
+        for (float &c : v) c /= length;
+
+        int16_t encoded[2];
+        float decoded[3];
+        ysVertexQuantization::EncodeOctahedral(v[0], v[1], v[2], encoded);
+        ysVertexQuantization::DecodeOctahedral(encoded, decoded);
+
+        // Sine of the angle between them, acos() is too imprecise near 1
+        const float cx = v[1] * decoded[2] - v[2] * decoded[1];
+        const float cy = v[2] * decoded[0] - v[0] * decoded[2];
+        const float cz = v[0] * decoded[1] - v[1] * decoded[0];
+        const float error = sqrtf(cx * cx + cy * cy + cz * cz);
+        if (error > maxError) maxError = error;
+    }
+
+    // Well under a hundredth of a degree
+    EXPECT_LT(maxError, 1e-4f);
+}